@@ -0,0 +1,52 @@
+/*
+ * This program times the Gaussian filter implemented through the separable convolution, for different
+ * sigmas and data types. It shows the throughput of the 1D convolution code in dip::SeparableConvolution.
+ * Compile with optimizations that allow vectorization (e.g. `-O3 -march=native`) to see the effect of the
+ * vectorized inner loops.
+ */
+
+#include <iostream>
+#include "diplib.h"
+#include "diplib/multithreading.h"
+#include "diplib/generation.h"
+#include "diplib/testing.h"
+
+#include "diplib/linear.h"
+
+dip::Random rndGen( 0 );
+
+dip::dfloat TimeIt( dip::Image const& img, dip::Image& out, dip::dfloat sigma, dip::uint N ) {
+   dip::dfloat time = 1e9;
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      dip::testing::Timer timer;
+      for( dip::uint jj = 0; jj < N; ++jj ) {
+         dip::GaussFIR( img, out, { sigma } );
+      }
+      timer.Stop();
+      time = std::min( time, timer.GetCpu() / dip::dfloat( N ));
+   }
+   return time;
+}
+
+int main() {
+   dip::Image img( { 1800, 2100 }, 1, dip::DT_SFLOAT );
+   img.Fill( 50 );
+   dip::GaussianNoise( img, img, rndGen, 400.0 );
+   dip::Image imgD = dip::Convert( img, dip::DT_DFLOAT );
+   dip::dfloat mpixels = static_cast< dip::dfloat >( img.NumberOfPixels() ) * 1e-6;
+
+   dip::FloatArray sigmas = { 1, 2, 3, 5, 8, 10 };
+
+   dip::SetNumberOfThreads( 1 );
+
+   dip::Image out;
+   for( auto sigma : sigmas ) {
+      dip::dfloat timeS = TimeIt( img, out, sigma, 3 );
+      dip::dfloat timeD = TimeIt( imgD, out, sigma, 3 );
+      std::cout << "sigma = " << sigma
+                << ", sfloat: " << timeS * 1e3 << " ms (" << mpixels / timeS << " Mpixel/s)"
+                << ", dfloat: " << timeD * 1e3 << " ms (" << mpixels / timeD << " Mpixel/s)\n";
+   }
+
+   return 0;
+}
@@ -46,6 +46,26 @@ struct DIP_NO_EXPORT FeretValues {
    dfloat minAngle = 0.0;           ///< The angle at which `minDiameter` was measured
 };
 
+/// \brief Describes a rectangle with arbitrary orientation, as used in `dip::CaliperValues`.
+struct DIP_NO_EXPORT OrientedRectangle {
+   dfloat length = 0.0;             ///< The length of the longest side
+   dfloat width = 0.0;              ///< The length of the shortest side
+   dfloat angle = 0.0;              ///< The orientation of the longest side, in the range [0,&pi;)
+
+   /// Returns the area of the rectangle
+   dfloat Area() const { return length * width; }
+   /// Returns the perimeter of the rectangle
+   dfloat Perimeter() const { return 2.0 * ( length + width ); }
+};
+
+/// \brief Contains the values computed by the rotating calipers algorithm, as returned by
+/// `dip::ConvexHull::RotatingCalipers` and `dip::ConvexHullBatch::RotatingCalipers`.
+struct DIP_NO_EXPORT CaliperValues {
+   FeretValues feret;                        ///< The %Feret diameters
+   OrientedRectangle minAreaRectangle;       ///< The bounding rectangle with the smallest area
+   OrientedRectangle minPerimeterRectangle;  ///< The bounding rectangle with the smallest perimeter
+};
+
 /// \brief Holds the various output values of the `dip::RadiusStatistics` and `dip::ConvexHull::RadiusStatistics` function.
 class DIP_NO_EXPORT RadiusValues {
    public:
@@ -635,6 +655,25 @@ class DIP_NO_EXPORT ConvexHull {
       /// Returns the %Feret diameters of the convex hull
       DIP_EXPORT FeretValues Feret() const;
 
+      /// \brief Returns the %Feret diameters of the convex hull, as well as the minimum-area and minimum-perimeter
+      /// bounding rectangles, using a single pass of the rotating calipers algorithm.
+      ///
+      /// Both bounding rectangles have a side collinear with an edge of the convex hull (Freeman and Shapira, 1975;
+      /// Toussaint, 1983), so only one rectangle per edge needs to be examined. The calipers (the vertex farthest
+      /// from the edge, and the vertices with the smallest and largest projection onto the edge) advance
+      /// monotonically as the edge rotates, so the cost is linear in the number of vertices.
+      ///
+      /// The result is computed on the first call, and stored in the object, so that repeated calls (for example
+      /// from different measurement features) don't repeat the computation. To process many convex hulls at once,
+      /// see `dip::ConvexHullBatch` and `dip::ComputeRotatingCalipers`.
+      ///
+      /// **Literature**
+      /// - H. Freeman and R. Shapira, "Determining the minimum-area encasing rectangle for an arbitrary closed curve",
+      ///   Communications of the ACM 18(7):409-413, 1975.
+      /// - G.T. Toussaint, "Solving geometric problems with the rotating calipers", Proceedings of IEEE MELECON'83,
+      ///   Athens, Greece, 1983.
+      DIP_EXPORT CaliperValues const& RotatingCalipers() const;
+
       /// Returns the centroid of the convex hull
       VertexFloat Centroid() const {
          return vertices_.Centroid();
@@ -658,8 +697,76 @@ class DIP_NO_EXPORT ConvexHull {
 
    private:
       dip::Polygon vertices_;
+      mutable CaliperValues calipers_;
+      mutable bool hasCalipers_ = false;
+
+      friend void ComputeRotatingCalipers( std::vector< ConvexHull >& convexHulls );
+};
+
+/// \brief A collection of convex hulls stored in structure-of-arrays form, for batched processing.
+///
+/// The vertex coordinates of all convex hulls are stored in two contiguous arrays, one for the x
+/// and one for the y coordinates, with an offset array indicating where each hull starts. This avoids
+/// the per-object overhead of `dip::ConvexHull` when computing the same property for many objects, and
+/// allows the work to be distributed over multiple threads.
+///
+/// ```cpp
+///     dip::ConvexHullBatch batch;
+///     for( auto const& cc : chainCodes ) {
+///        batch.Add( cc.ConvexHull() );
+///     }
+///     std::vector< dip::CaliperValues > values = batch.RotatingCalipers();
+/// ```
+class DIP_NO_EXPORT ConvexHullBatch {
+   public:
+
+      /// Default-constructed batch (without convex hulls)
+      ConvexHullBatch() : offsets_{ 0 } {}
+
+      /// Reserves space for `nHulls` convex hulls with a total of `nVertices` vertices
+      void Reserve( dip::uint nHulls, dip::uint nVertices ) {
+         offsets_.reserve( nHulls + 1 );
+         x_.reserve( nVertices );
+         y_.reserve( nVertices );
+      }
+
+      /// Adds a convex hull to the batch
+      void Add( ConvexHull const& convexHull ) {
+         for( auto const& v : convexHull.Vertices() ) {
+            x_.push_back( v.x );
+            y_.push_back( v.y );
+         }
+         offsets_.push_back( x_.size() );
+      }
+
+      /// Returns the number of convex hulls in the batch
+      dip::uint Size() const {
+         return offsets_.size() - 1;
+      }
+
+      /// Returns the number of vertices of convex hull `index`
+      dip::uint NumberOfVertices( dip::uint index ) const {
+         return offsets_[ index + 1 ] - offsets_[ index ];
+      }
+
+      /// \brief Applies `dip::ConvexHull::RotatingCalipers` to each of the convex hulls in the batch. The output
+      /// array has one element per convex hull, in the order they were added.
+      DIP_EXPORT std::vector< CaliperValues > RotatingCalipers() const;
+
+   private:
+      std::vector< dfloat > x_;
+      std::vector< dfloat > y_;
+      std::vector< dip::uint > offsets_; // has Size()+1 elements, hull `ii` has vertices `offsets_[ii]` to `offsets_[ii+1]-1`
 };
 
+/// \brief Computes `dip::ConvexHull::RotatingCalipers` for all of `convexHulls` at once, using a
+/// `dip::ConvexHullBatch`, and stores the results in the convex hull objects.
+///
+/// Subsequent calls to `dip::ConvexHull::RotatingCalipers` on these objects return the stored results.
+/// `dip::MeasurementTool` uses this to compute the rotating calipers for all objects in parallel, and share
+/// the results among the features that need them ("Feret", "MinAreaRectangle", "MinPerimeterRectangle").
+DIP_EXPORT void ComputeRotatingCalipers( std::vector< ConvexHull >& convexHulls );
+
 // This function cannot be written inside the dip::Polygon class because it needs to know about the dip::ConvexHull
 // class, which in turn needs to know about the dip::Polygon class.
 inline dip::ConvexHull Polygon::ConvexHull() const {
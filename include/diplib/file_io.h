@@ -21,6 +21,9 @@
 #ifndef DIP_FILE_IO_H
 #define DIP_FILE_IO_H
 
+#include <functional>
+#include <memory>
+
 #include "diplib.h"
 
 
@@ -39,7 +42,7 @@ namespace dip {
 /// \brief A data structure with information about an image file.
 struct FileInformation {
       String        name;              ///< File name
-      String        fileType;          ///< File type (currently, "ICS" or "TIFF")
+      String        fileType;          ///< File type (currently, "ICS", "TIFF", "NPY", "NRRD" or "Zarr")
       DataType      dataType;          ///< Data type for all samples
       dip::uint     significantBits;   ///< Number of bits used for each sample
       UnsignedArray sizes;             ///< Size of image in pixels
@@ -50,6 +53,10 @@ struct FileInformation {
       StringArray   history;           ///< Assorted metadata in the file, in the form of strings.
 };
 
+/// \brief A function that reports progress of a long-running operation. It is called with the number of
+/// items completed so far and the total number of items.
+using ProgressCallback = std::function< void( dip::uint, dip::uint ) >;
+
 /// \brief Read the image in the ICS file `filename` and puts it in `out`.
 ///
 /// The ICS image file format (Image Cytometry Standard) can contain images with any dimensionality
@@ -68,6 +75,23 @@ struct FileInformation {
 /// interface set it might also be impossible to dictate what the strides will look like. In these cases,
 /// the flag is ignored.
 ///
+/// Reading an ROI from a gzip-compressed file normally requires decompressing all the data that precedes the
+/// pixels read. If the file has a seek index (see `dip::ImageWriteICSIndex`), decompression instead starts
+/// at the access point closest to each portion of the ROI, making reading a small ROI from a large file much
+/// faster. The index is used automatically if it exists and matches the file.
+///
+/// If `mode` is `"mmap"`, the file is mapped into memory, and `out` references the mapped data directly, with
+/// strides matching the storage order in the file. Nothing is read until pixels are accessed, and then only the
+/// memory pages containing those pixels are read from disk. This makes it cheap to open a very large file and
+/// access a small ROI. The mapping is copy-on-write: `out` can be modified, but the changes are not written to
+/// the file. This is only possible for uncompressed files with the byte order of the machine, and if `out` is not
+/// protected; otherwise the flag is ignored. If `out` has an external interface, the data will be copied.
+///
+/// Note that the mapped image is valid only as long as the file is not modified. Overwriting or truncating the
+/// file (including writing a new image to the same file name) while `out`, or any image that shares its data, still
+/// exists invalidates its pixel data, and accessing it can crash the program (e.g. with a `SIGBUS` signal on
+/// Linux). Strip or reforge the image before writing to the file.
+///
 /// Information about the file and all metadata is returned in the `FileInformation` output argument.
 // TODO: read sensor information also into the history strings
 DIP_EXPORT FileInformation ImageReadICS(
@@ -152,6 +176,15 @@ DIP_EXPORT bool ImageIsICS( String const& filename );
 ///    these two pieces into a single '.ics' file. `"v2"` is the default.
 ///  - '"uncompressed"` or '"gzip"`: Determine whether to compress the pixel data or not. `"gzip"` is the default.
 ///  - `"fast"`: Writes data in the order in which it is in memory, which is faster.
+///  - `"index"`: Together with `"gzip"`, writes a seek index for the compressed data, see `dip::ImageWriteICSIndex`.
+///    Has no effect if DIPlib is not linked against zlib.
+///
+/// `compressionLevel` is the gzip compression level, between 1 (fastest) and 9 (smallest file).
+///
+/// When DIPlib is linked against zlib, the pixel data is split into blocks of 1 MiB that are compressed in
+/// parallel (see \ref design_multithreading). Each block is compressed independently, and they are concatenated
+/// into a single gzip stream, in the same way as done by the *pigz* program. The result is a standard gzip
+/// stream, which is read by any ICS reader.
 ///
 /// Note that the `"fast"` option yields a file with permuted dimensions. The software reading the file must be
 /// aware of the possibility of permuted dimensions, and check the "order" tag in the file. If the image has
@@ -161,9 +194,28 @@ DIP_EXPORT void ImageWriteICS(
       String const& filename,
       StringArray const& history = {},
       dip::uint significantBits = 0,
-      StringSet const& options = {}
+      StringSet const& options = {},
+      dip::uint compressionLevel = 6
 );
 
+/// \brief Writes a seek index for the gzip-compressed pixel data of the ICS file `filename`.
+///
+/// gzip-compressed data can only be decompressed from the beginning. The seek index records access points,
+/// spaced about `spacing` bytes of uncompressed data apart, where decompression can start. Each access point
+/// stores up to 32 kiB of uncompressed data, needed to resume decompression, so the index is roughly
+/// 32 kiB per `spacing` bytes. `dip::ImageReadICS` uses the index when reading an ROI.
+///
+/// The index is written to a side-car file, with the name of the file containing the pixel data with
+/// ".gzidx" appended (i.e. "name.ids.gzidx" for a version 1 file, and "name.ics.gzidx" for a version 2 file).
+/// Overwriting the ICS file with `dip::ImageWriteICS` removes the index, unless it writes a new one.
+///
+/// `dip::ImageWriteICS` with the `"index"` option writes the index directly, at no additional cost, with an
+/// access point at each 1 MiB compressed block. Those access points do not need to store any uncompressed data.
+/// This function is meant for files written without that option, or by other software.
+///
+/// Requires DIPlib to be linked against zlib.
+DIP_EXPORT void ImageWriteICSIndex( String const& filename, dip::uint spacing = 1024 * 1024 );
+
 
 /// \brief Reads an image from the TIFF file `filename` and puts it in `out`.
 ///
@@ -184,9 +236,13 @@ DIP_EXPORT void ImageWriteICS(
 ///
 /// The pixels per inch value in the TIFF file will be used to set the pixel size of `out`.
 ///
+/// The tiles or strips of a compressed grey-value image are decompressed in parallel, each thread using
+/// its own handle to the file. The result is identical to that obtained with a single thread.
+/// Use `dip::SetNumberOfThreads` to limit the number of threads used.
+///
 /// TIFF is a very flexible file format. We have to limit the types of images that can be read to the
 /// more common ones. These are the most obvious limitations:
-///  - Tiled images are not supported.
+///  - Tiled binary and color-mapped images are not supported.
 ///  - Only 1, 4, 8, 16 and 32 bits per pixel integer grayvalues are read, as well as 32-bit and 64-bit
 ///    floating point.
 ///  - Only 4 and 8 bits per pixel colormapped images are read.
@@ -246,22 +302,79 @@ inline Image ImageReadTIFF(
    return out;
 }
 
+/// \brief Reads a resolution level of a multi-resolution (pyramid) TIFF file.
+///
+/// Pyramid TIFF files, as written by `dip::ImageWriteTIFFPyramid`, store the reduced-resolution versions of
+/// an image as sub-images (SubIFDs) of the full-resolution image. This is also how OME-TIFF files store
+/// pyramids. `level` 0 is the full-resolution image `imageNumber` in the file, `level` 1 is its first
+/// sub-image, etc. Use `dip::ImageReadTIFFNumberOfLevels` to find out how many levels are available.
+///
+/// `roi` and `channels` select a region of the requested level, and are handled as in `dip::ImageReadTIFF`.
+/// Combined with a tiled file, this allows reading a small region of a huge image at the resolution needed,
+/// only the tiles that overlap the region are read and decoded.
+DIP_EXPORT FileInformation ImageReadTIFFLevel(
+      Image& out,
+      String const& filename,
+      dip::uint level,
+      RangeArray const& roi = {},
+      Range const& channels = {},
+      dip::uint imageNumber = 0
+);
+inline Image ImageReadTIFFLevel(
+      String const& filename,
+      dip::uint level,
+      RangeArray const& roi = {},
+      Range const& channels = {},
+      dip::uint imageNumber = 0
+) {
+   Image out;
+   ImageReadTIFFLevel( out, filename, level, roi, channels, imageNumber );
+   return out;
+}
+
+/// \brief Returns the number of resolution levels for image `imageNumber` in the TIFF file `filename`.
+///
+/// This is 1 for a regular TIFF file. See `dip::ImageReadTIFFLevel`.
+DIP_EXPORT dip::uint ImageReadTIFFNumberOfLevels( String const& filename, dip::uint imageNumber = 0 );
+
 /// \brief Reads a set of 2D TIFF images as a single 3D image.
 ///
 /// `filenames` contains the paths to the TIFF files, which are read in the order given, and concatenated along the 3rd
 /// dimension. Only the first page of each TIFF file is read.
-DIP_EXPORT void ImageReadTIFFSeries(
+///
+/// `out` is forged once, using the header of the first file. The files are then opened and decoded concurrently
+/// (see \ref design_multithreading), each one directly into its plane of `out`. This is much faster than reading
+/// the files one after another, especially if they are compressed or on a network drive. All files must have the
+/// same sizes, number of channels and data type; use `dip::ImageReadTIFFSeriesInfo` to verify this before reading.
+/// The header of each file is checked before its data is read, and a mismatch causes an exception that names the
+/// file and the property that differs. If `out` is protected and of a different data type, each file is read into
+/// a temporary image and copied into `out` with conversion.
+///
+/// If given, `progress` is called after each file is read, with the number of files read so far and the total
+/// number of files. It can be called from different threads, but is never called concurrently.
+///
+/// The returned `dip::FileInformation` describes the first file, with its `sizes` extended to the 3D output image.
+DIP_EXPORT FileInformation ImageReadTIFFSeries(
       Image& out,
-      StringArray const& filenames
+      StringArray const& filenames,
+      ProgressCallback const& progress = {}
 );
 inline Image ImageReadTIFFSeries(
-      StringArray const& filenames
+      StringArray const& filenames,
+      ProgressCallback const& progress = {}
 ) {
    Image out;
-   ImageReadTIFFSeries( out, filenames );
+   ImageReadTIFFSeries( out, filenames, progress );
    return out;
 }
 
+/// \brief Reads the headers of a set of 2D TIFF images, and returns the information of the 3D image that
+/// `dip::ImageReadTIFFSeries` would produce.
+///
+/// The headers are read concurrently. Throws if the files do not all have the same sizes, number of channels
+/// and data type. The result can be used to forge an image once, before reading the series into it.
+DIP_EXPORT FileInformation ImageReadTIFFSeriesInfo( StringArray const& filenames );
+
 /// \brief Reads image information and metadata from the TIFF file `filename`, without reading the actual
 /// pixel data.
 DIP_EXPORT FileInformation ImageReadTIFFInfo( String const& filename, dip::uint imageNumber = 0 );
@@ -293,13 +406,345 @@ DIP_EXPORT bool ImageIsTIFF( String const& filename );
 ///    by compliant TIFF readers. Even small amounts of noise can cause this method to yield larger files than `"none"`.
 ///  - `"JPEG"`: uses **lossy** JPEG compression. `jpegLevel` determines the amount of compression applied. `jpegLevel`
 ///    is an integer between 1 and 100, with increasing numbers yielding larger files and fewer compression artifacts.
+///
+/// If `tileSize` is empty (the default), the image is written as strips. Otherwise it is written as tiles of
+/// the given size; if `tileSize` has a single element, square tiles are used. Tile sizes are rounded up to a
+/// multiple of 16, as required by the TIFF standard. Tiles at the right and bottom edges of the image are padded
+/// with zeros. Tiled files allow other programs to efficiently read a small region of a large image.
+///
+/// With `"deflate"` compression, strips or tiles are compressed in parallel, see \ref design_multithreading.
+///
+/// If the pixel data is too large to fit in a classic TIFF file (which is limited to 4 GiB), a BigTIFF file is
+/// written instead. Not all TIFF readers support BigTIFF.
 DIP_EXPORT void ImageWriteTIFF(
       Image const& image,
       String const& filename,
       String const& compression = "",
-      dip::uint jpegLevel = 80
+      dip::uint jpegLevel = 80,
+      UnsignedArray const& tileSize = {}
+);
+
+/// \brief Writes `image` as a multi-resolution (pyramid) TIFF file.
+///
+/// The full-resolution image is written as the main image in the file. It is followed by `levels - 1`
+/// reduced-resolution versions, each half the size of the previous one, stored as sub-images (SubIFDs) of the
+/// main image. This is the layout used by OME-TIFF, and is understood by many tile-based image viewers.
+/// If `levels` is 0, levels are added until the smallest one fits in a single tile.
+///
+/// Each level is computed from the previous one by averaging blocks of 2x2 pixels; binary images are reduced with
+/// a logical OR, so that thin structures remain visible. The levels are computed and written one at the time,
+/// only two consecutive levels are held in memory at any one time.
+///
+/// All levels are written as tiles of size `tileSize`, which cannot be empty. `compression` and `jpegLevel` are
+/// as in `dip::ImageWriteTIFF`. Use `dip::ImageReadTIFFLevel` to read a specific level.
+DIP_EXPORT void ImageWriteTIFFPyramid(
+      Image const& image,
+      String const& filename,
+      dip::uint levels = 0,
+      String const& compression = "",
+      dip::uint jpegLevel = 80,
+      UnsignedArray const& tileSize = { 256 }
+);
+
+
+/// \brief Reads the image in the NumPy NPY file `filename` and puts it in `out`.
+///
+/// The NPY file format stores a single array, with any number of dimensions, in the native memory layout of
+/// NumPy. Arrays with a boolean, integer (up to 32 bits), floating-point or complex data type can be read, in
+/// either byte order. `filename` can be given without extension, in which case ".npy" is added if the file
+/// doesn't exist.
+///
+/// Arrays stored in C order (the NumPy default) have their dimensions reversed, such that the last array
+/// dimension becomes the first image dimension (x). This is consistent with how *PyDIP* maps NumPy arrays
+/// to images. The resulting image is always scalar. NPY files don't store a pixel size.
+///
+/// The pixel data is read in parallel chunks directly into `out`, if `out` has the data type and strides that
+/// match the file, see \ref design_multithreading. If `mode` is `"mmap"`, the file is instead mapped into
+/// memory, and `out` points at the mapped data. This is only possible if the data in the file has the machine's
+/// byte order. If `out` is protected, it is not mapped, and the data is converted to its data type as usual.
+DIP_EXPORT FileInformation ImageReadNPY(
+      Image& out,
+      String const& filename,
+      String const& mode = ""
+);
+inline Image ImageReadNPY(
+      String const& filename,
+      String const& mode = ""
+) {
+   Image out;
+   ImageReadNPY( out, filename, mode );
+   return out;
+}
+
+/// \brief Reads array information from the NPY file `filename`, without reading the actual pixel data.
+/// See `dip::ImageReadNPY` for more details.
+DIP_EXPORT FileInformation ImageReadNPYInfo( String const& filename );
+
+/// \brief Returns true if the file `filename` is an NPY file.
+DIP_EXPORT bool ImageIsNPY( String const& filename );
+
+/// \brief Writes `image` as a NumPy NPY file.
+///
+/// The array is written in C order, with the image dimensions reversed, such that NumPy reads it with the
+/// same shape *PyDIP* would give the image. If `image` is a tensor image, the tensor dimension is added as
+/// the last array dimension. Binary images are written with a boolean data type. The pixel size is not written.
+///
+/// If `filename` doesn't have an extension, ".npy" is added. The pixel data is written in parallel chunks,
+/// see \ref design_multithreading.
+DIP_EXPORT void ImageWriteNPY(
+      Image const& image,
+      String const& filename
 );
 
+/// \brief Reads the image in the NRRD file `filename` and puts it in `out`.
+///
+/// The NRRD file format (Nearly Raw Raster Data) consists of a simple text header followed by raw pixel data,
+/// or a detached header (".nhdr") that points at a separate raw data file. It can be used to read raw volumes
+/// written by many other programs, by writing a header for them. `filename` can be given without extension,
+/// in which case ".nrrd" and ".nhdr" are tried if the file doesn't exist.
+///
+/// Only the "raw" encoding is supported, with integer (up to 32 bits) and floating-point data types, in either
+/// byte order. Data files are given relative to the header file, and can be preceded by data that is skipped
+/// ("line skip" and "byte skip" fields). A single data file is supported. If the first axis is not a spatial
+/// axis ("kinds" field), it is read as the tensor dimension; the RGB, HSV and XYZ color kinds set the color space.
+/// The pixel size is read from the "spacings" and "units" fields, or from the lengths of the "space directions"
+/// vectors and the "space units" field. Key/value pairs are returned in the `history` field of the output.
+///
+/// `mode` is as in `dip::ImageReadNPY`: the pixel data is read in parallel chunks, or mapped into memory.
+DIP_EXPORT FileInformation ImageReadNRRD(
+      Image& out,
+      String const& filename,
+      String const& mode = ""
+);
+inline Image ImageReadNRRD(
+      String const& filename,
+      String const& mode = ""
+) {
+   Image out;
+   ImageReadNRRD( out, filename, mode );
+   return out;
+}
+
+/// \brief Reads image information and metadata from the NRRD file `filename`, without reading the actual
+/// pixel data. See `dip::ImageReadNRRD` for more details.
+DIP_EXPORT FileInformation ImageReadNRRDInfo( String const& filename );
+
+/// \brief Returns true if the file `filename` is an NRRD file.
+DIP_EXPORT bool ImageIsNRRD( String const& filename );
+
+/// \brief Writes `image` as an NRRD file.
+///
+/// The header and the raw pixel data are written to a single file. If `image` is a tensor image, the tensor
+/// dimension is written as the first axis, with a "kinds" field that records the color space if it is RGB,
+/// HSV or XYZ. The pixel size is written in the "spacings" and "units" fields. Binary images are written as
+/// 8-bit unsigned integers; complex images cannot be written.
+///
+/// If `filename` doesn't have an extension, ".nrrd" is added. The pixel data is written in parallel chunks,
+/// see \ref design_multithreading.
+DIP_EXPORT void ImageWriteNRRD(
+      Image const& image,
+      String const& filename
+);
+
+/// \brief Reads an image from an ICS or multi-page TIFF file in slabs, for processing images that don't fit in memory.
+///
+/// A slab is a set of consecutive planes along the last image dimension (z for a 3D image). The image in the file
+/// is split into slabs of `slabSize` planes, which are returned one at the time by `Next`. Each slab is extended by
+/// up to `halo` planes on either side, taken from the neighboring slabs, such that a neighborhood filter applied to
+/// the slab produces correct results for the planes at its core, as long as the filter doesn't reach further than
+/// `halo` pixels. At the first and last slab the halo is cut off at the image edge, such that the filter sees the
+/// same image edge it would see when applied to the whole image. `CorePlanes` and `Core` give access to the core
+/// of the last slab returned, without the halo.
+///
+/// While the caller processes one slab, the next `readAhead` slabs are read in background threads. Planes in the
+/// halo are read from the file only once. The file is read sequentially if possible: ICS files must have the last
+/// image dimension as the last dimension in the file, which is not the case for tensor images written by
+/// `dip::ImageWriteICS`; for other files each slab is read as a ROI, which for compressed files means the file
+/// is decompressed from the start for each slab, unless it has a seek index (see `dip::ImageWriteICSIndex`).
+/// Multi-page TIFF files are read one page per plane; each page must have the same sizes and data type.
+///
+/// The file type is determined by the extension: "tif" and "tiff" are read as TIFF, anything else as ICS.
+///
+/// Use together with `dip::ImageSlabWriter` to process a large image and write the result to file:
+///
+/// ```cpp
+///     dip::ImageSlabReader reader( "in.ics", 32, 12 );
+///     dip::ImageSlabWriter writer( "out.ics", reader.Information() );
+///     dip::Image slab;
+///     while( reader.Next( slab )) {
+///        dip::Image result = dip::Gauss( slab, { 3 } );
+///        writer.Write( reader.Core( result ));
+///     }
+///     writer.Close();
+/// ```
+class DIP_NO_EXPORT ImageSlabReader {
+   public:
+      /// \brief Opens the file `filename` for reading in slabs of `slabSize` planes, extended by `halo` planes.
+      DIP_EXPORT ImageSlabReader( String const& filename, dip::uint slabSize, dip::uint halo = 0, dip::uint readAhead = 1 );
+      DIP_EXPORT ~ImageSlabReader();
+      ImageSlabReader( ImageSlabReader const& ) = delete;
+      ImageSlabReader& operator=( ImageSlabReader const& ) = delete;
+
+      /// \brief Returns information on the image in the file. `sizes` are the sizes of the whole image.
+      DIP_EXPORT FileInformation const& Information() const;
+
+      /// \brief Returns the number of slabs the image is split into.
+      DIP_EXPORT dip::uint NumberOfSlabs() const;
+
+      /// \brief Puts the next slab in `out`, returns false if there are no more slabs. `out` is replaced, even if
+      /// it is protected.
+      DIP_EXPORT bool Next( Image& out );
+
+      /// \brief Returns the index in the file of the first plane of the last slab returned by `Next`.
+      DIP_EXPORT dip::uint FirstPlane() const;
+
+      /// \brief Returns the planes of the last slab returned by `Next` that are not part of its halo, as indices
+      /// into the slab.
+      DIP_EXPORT Range CorePlanes() const;
+
+      /// \brief Returns a view of `slab` without its halo. `slab` is the last slab returned by `Next`, or
+      /// an image computed from it with the same sizes.
+      DIP_EXPORT Image Core( Image const& slab ) const;
+
+   private:
+      class Impl;
+      std::unique_ptr< Impl > impl_;
+};
+
+/// \brief Writes an image to an ICS or multi-page TIFF file in slabs, for processing images that don't fit in memory.
+///
+/// The image written has the sizes, pixel size and history given in `information`. Slabs of consecutive
+/// planes along the last image dimension are given in order to `Write`, they can have any number of planes. The
+/// data type, tensor and color space of the file are taken from the first slab, the other slabs must have the
+/// same data type and number of tensor elements. `Close` must be called after the last slab has been written.
+///
+/// Each slab is written in a background thread, while the caller prepares the next slab. The pixel data of a
+/// slab cannot be modified until the next call to `Write` or `Close`. A new image must be created for each slab,
+/// for example as the output of a filter; reusing the same image as output for the filter would overwrite the
+/// data while it's being written.
+///
+/// The file type is determined by the extension: "tif" and "tiff" are written as TIFF, anything else as ICS.
+/// For ICS files, `options` are as in `dip::ImageWriteICS` ("v1", "v2", "uncompressed", "gzip", "index"; but not
+/// "fast"), tensor images are written with the tensor dimension first. For TIFF files, `options` can contain the
+/// compression method, as in `dip::ImageWriteTIFF`, and the image must be 3D: each plane is written as a page.
+class DIP_NO_EXPORT ImageSlabWriter {
+   public:
+      /// \brief Creates the file `filename` to write an image with the properties given by `information`.
+      DIP_EXPORT ImageSlabWriter( String const& filename, FileInformation const& information, StringSet const& options = {} );
+      /// \brief Closes the file if `Close` wasn't called, ignoring any errors.
+      DIP_EXPORT ~ImageSlabWriter();
+      ImageSlabWriter( ImageSlabWriter const& ) = delete;
+      ImageSlabWriter& operator=( ImageSlabWriter const& ) = delete;
+
+      /// \brief Writes `slab` as the next set of planes.
+      DIP_EXPORT void Write( Image const& slab );
+
+      /// \brief Waits for all data to be written and closes the file. Throws if not all planes were written.
+      DIP_EXPORT void Close();
+
+   private:
+      class Impl;
+      std::unique_ptr< Impl > impl_;
+};
+
+/// \brief An image stored on disk as a set of independently compressed chunks, for images too large to handle
+/// at once, and for processing different parts of an image in parallel.
+///
+/// The image is split into chunks of `ChunkSizes` pixels, along a regular grid. Each chunk is stored in its own
+/// file, and can be read and written independently of the others. `ChunkRegion` gives the region of the image
+/// that a chunk covers; chunks at the image edge are smaller. `ReadChunk` and `WriteChunk` read and write one
+/// chunk, and can be called from multiple threads at the same time, as long as no two threads write the same
+/// chunk. A chunk is written to a temporary file that is renamed when complete, so that a concurrent reader never
+/// sees a partially written chunk. Chunks that were never written read as zeros. `Read` and `Write` read and write
+/// larger portions of the image, processing chunks in parallel (see \ref design_multithreading).
+///
+/// Chunks are read into an existing image if it has the right sizes, which can be a view into a larger image:
+///
+/// ```cpp
+///     dip::ImageChunkStore store( "data.zarr" );
+///     dip::Image image( store.Information().sizes, store.Information().tensorElements, store.Information().dataType );
+///     dip::Image view = image.At( store.ChunkRegion( { 2, 3, 0 } ));
+///     store.ReadChunk( { 2, 3, 0 }, view );
+/// ```
+///
+/// The store is a directory in the [Zarr version 2](https://zarr.readthedocs.io/en/stable/spec/v2.html) format,
+/// and can be accessed by other tools that support Zarr. The metadata is in the ".zarray" file, the chunks are in
+/// files named after their indices. Array dimensions are in the reverse order of the image dimensions, as
+/// *PyDIP* would map a NumPy array with the same shape. The tensor dimension is stored as the first array
+/// dimension, all tensor elements are in the same chunk. The tensor size, color space and pixel size are stored
+/// as attributes in the ".zattrs" file. Zarr arrays written by other tools can be read if they use no compression,
+/// or "zlib" or "gzip" compression, and no filters; other compressors are not supported.
+class DIP_NO_EXPORT ImageChunkStore {
+   public:
+      /// \brief Opens the existing store in directory `directory`.
+      DIP_EXPORT explicit ImageChunkStore( String const& directory );
+
+      /// \brief Creates a store in directory `directory` for an image with the sizes, number of tensor elements,
+      /// data type, color space and pixel size given in `information`.
+      ///
+      /// The image is split into chunks of size `chunkSizes`; if it has a single element, it is used for all
+      /// dimensions. `compression` is "zlib" (the default), "gzip" or "none". `compressionLevel` is the zlib
+      /// compression level, from 1 (fastest) to 9 (smallest files).
+      ///
+      /// The directory is created if it doesn't exist. If it already contains a store, its metadata is
+      /// overwritten, but chunk files are not removed.
+      DIP_EXPORT ImageChunkStore(
+            String const& directory,
+            FileInformation const& information,
+            UnsignedArray const& chunkSizes,
+            String const& compression = "zlib",
+            dip::uint compressionLevel = 6
+      );
+
+      /// \brief Returns information on the image in the store.
+      FileInformation const& Information() const { return information_; }
+
+      /// \brief Returns the size of the chunks.
+      UnsignedArray const& ChunkSizes() const { return chunkSizes_; }
+
+      /// \brief Returns the number of chunks along each dimension.
+      UnsignedArray const& NumberOfChunks() const { return numberOfChunks_; }
+
+      /// \brief Returns the region of the image covered by chunk `chunk`, which is given by its indices in
+      /// the chunk grid.
+      DIP_EXPORT RangeArray ChunkRegion( UnsignedArray const& chunk ) const;
+
+      /// \brief Reads chunk `chunk` into `out`. If `out` is forged and has the sizes of the chunk region, the data
+      /// is copied into it, otherwise it is reforged.
+      DIP_EXPORT void ReadChunk( UnsignedArray const& chunk, Image& out ) const;
+
+      /// \brief Writes `data` as chunk `chunk`. `data` must have the sizes of the chunk region and the number of
+      /// tensor elements of the store; it is converted to the data type of the store.
+      DIP_EXPORT void WriteChunk( UnsignedArray const& chunk, Image const& data ) const;
+
+      /// \brief Reads the region `roi` of the image into `out`. `roi` is as in `dip::ImageReadICS`, but its step
+      /// sizes must be 1. If `roi` is empty, the whole image is read. Chunks are read in parallel.
+      DIP_EXPORT void Read( Image& out, RangeArray const& roi = {} ) const;
+      Image Read( RangeArray const& roi = {} ) const {
+         Image out;
+         Read( out, roi );
+         return out;
+      }
+
+      /// \brief Writes `image` to the store. It must have the sizes and number of tensor elements of the store.
+      /// Chunks are written in parallel.
+      DIP_EXPORT void Write( Image const& image ) const;
+
+   private:
+      String ChunkFileName( UnsignedArray const& chunk ) const;
+      Image NewChunkBuffer() const;
+
+      String directory_;
+      FileInformation information_;
+      UnsignedArray chunkSizes_;
+      UnsignedArray numberOfChunks_;
+      String compression_;             // "zlib", "gzip", or empty for no compression
+      dip::uint compressionLevel_ = 6;
+      dfloat fillValue_ = 0;           // value of chunks not yet written
+      bool swapBytes_ = false;         // samples are stored in the opposite byte order from this machine
+      char separator_ = '.';           // separates the indices in the chunk file names
+};
+
 
 /// \brief Returns the location of the dot that separates the extension, or `dip::String::npos` if there is no dot.
 inline String::size_type FileGetExtensionPosition(
@@ -598,6 +598,13 @@ inline std::unique_ptr< ScanLineFilter > NewTetradicScanLineFilter( F const& fun
 /// `SeparableOption::DontResizeOutput`     | The output image has the right size; it can differ from the input size.
 /// `SeparableOption::UseInputBuffer`       | The line filter can modify the input data without affecting the input image; samples are guaranteed to be contiguous.
 /// `SeparableOption::UseOutputBuffer`      | The output buffer is guaranteed to have contiguous samples.
+/// `SeparableOption::InterleavedLines`     | The line filter is given up to `dip::Framework::separableInterleavedLines` image lines at once, interleaved in the buffers. Implies `UseInputBuffer` and `UseOutputBuffer`.
+///
+/// With `SeparableOption::InterleavedLines`, the line filter is handed a block of adjacent image lines in a single call.
+/// `dip::Framework::SeparableLineFilterParameters::nLines` gives the number of lines in the block. Sample `jj` of
+/// tensor element `kk` of line `ll` is found at `buffer[ jj * stride + ll * tensorLength + kk * tensorStride ]`. That is,
+/// the lines are stored next to each other for each pixel, such that a recursive filter can process
+/// all lines together, one pixel at the time, using SIMD instructions.
 ///
 /// Combine options by adding constants together.
 enum class SeparableOption {
@@ -607,10 +614,15 @@ enum class SeparableOption {
       UseOutputBorder,
       DontResizeOutput,
       UseInputBuffer,
-      UseOutputBuffer
+      UseOutputBuffer,
+      InterleavedLines
 };
 DIP_DECLARE_OPTIONS( SeparableOption, SeparableOptions );
 
+/// \brief The maximum number of image lines handed to a line filter at once by `dip::Framework::Separable` when
+/// `dip::Framework::SeparableOption::InterleavedLines` is given.
+constexpr dip::uint separableInterleavedLines = 8;
+
 /// \brief Structure that holds information about input or output pixel buffers
 /// for the `dip::Framework::Separable` callback function object.
 ///
@@ -638,6 +650,9 @@ struct DIP_NO_EXPORT SeparableBuffer {
 /// corresponds to the tensor dimension. `dimension` will never be equal to the last dimension in this case.
 /// That is, `position` will have one more element than the original image(s) we're iterating over, but
 /// `position[ dimension ]` will always correspond to a position in the original image(s).
+///
+/// If `dip::Framework::SeparableOption::InterleavedLines` was given, `nLines` is the number of image lines
+/// stored interleaved in the buffers, and `position` refers to the first of these. Otherwise `nLines` is 1.
 struct DIP_NO_EXPORT SeparableLineFilterParameters {
    SeparableBuffer const& inBuffer;   ///< Input buffer (1D)
    SeparableBuffer& outBuffer;        ///< Output buffer (1D)
@@ -647,6 +662,7 @@ struct DIP_NO_EXPORT SeparableLineFilterParameters {
    UnsignedArray const& position;     ///< Coordinates of first pixel in line
    bool tensorToSpatial;              ///< `true` if the tensor dimension was converted to spatial dimension
    dip::uint thread;                  ///< Thread number
+   dip::uint nLines = 1;              ///< Number of image lines interleaved in the buffers
 };
 
 /// \brief Prototype line filter for `dip::Framework::Separable`.
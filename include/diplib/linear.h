@@ -129,7 +129,10 @@ inline Image SeparableConvolution(
 /// to `"frequency"`. Similarly, if `outRepresentation` is `"frequency"`, the output will not be
 /// inverse-transformed, so will be in the frequency domain.
 ///
-/// \see dip::GeneralConvolution, dip::SeparableConvolution
+/// To compute the convolution of a large image with a filter that is much smaller, use `dip::OverlapSaveConvolution`,
+/// which transforms the image tile by tile and applies the boundary condition like `dip::GeneralConvolution` does.
+///
+/// \see dip::GeneralConvolution, dip::SeparableConvolution, dip::OverlapSaveConvolution
 DIP_EXPORT void ConvolveFT(
       Image const& in,
       Image const& filter,
@@ -150,24 +153,73 @@ inline Image ConvolveFT(
    return out;
 }
 
-/// \brief Applies a convolution with a filter kernel (PSF) by direct implementation of the convolution sum.
+/// \brief Applies a convolution with a filter kernel (PSF) by multiplication in the Fourier domain, tile by tile.
+///
+/// The image is divided into tiles, each of which is extended by the size of `filter` minus one, using the
+/// boundary condition where the extended tile falls outside the image. Each tile is Fourier transformed,
+/// multiplied by the spectrum of `filter`, and inverse transformed. Only the part of the result that is not
+/// affected by the circular nature of the transform is kept (the overlap-save method). The spectrum of `filter`
+/// is computed only once, and the tiles are processed in parallel.
+///
+/// Unlike `dip::ConvolveFT`, the result is identical (up to rounding errors) to that of `dip::GeneralConvolution`
+/// with the same boundary condition. And because the transform size is determined by the size of `filter` rather
+/// than the size of `in`, this is the most efficient way to apply a large filter that cannot be separated to a
+/// large image.
+///
+/// `filter` must be a scalar image. If it has fewer dimensions than `in`, singleton dimensions are appended.
+/// Along dimensions where `filter` has a size of 1, no transform is computed. As elsewhere, the origin of `filter`
+/// is in the middle of the image, on the pixel to the right of the center in case of an even-sized image. If both
+/// `in` and `filter` are real, `out` will be real too, otherwise it will have a complex type.
+///
+/// `blockSizes` is the size of the transform along each dimension, each tile yields `blockSizes - filter.Sizes() + 1`
+/// output pixels along each dimension. If empty, sizes that are multiples of 2, 3 and 5 are chosen to minimize the
+/// estimated computational cost, limiting the memory used by each tile.
+///
+/// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
+///
+/// \see dip::ConvolveFT, dip::GeneralConvolution, dip::OptimalFourierTransformSize
+DIP_EXPORT void OverlapSaveConvolution(
+      Image const& in,
+      Image const& filter,
+      Image& out,
+      StringArray const& boundaryCondition = {},
+      UnsignedArray blockSizes = {}
+);
+inline Image OverlapSaveConvolution(
+      Image const& in,
+      Image const& filter,
+      StringArray const& boundaryCondition = {},
+      UnsignedArray const& blockSizes = {}
+) {
+   Image out;
+   OverlapSaveConvolution( in, filter, out, boundaryCondition, blockSizes );
+   return out;
+}
+
+/// \brief Applies a convolution with a filter kernel (PSF), choosing the most efficient method.
 ///
 /// `filter` is an image, and must be equal in size or smaller than `in`. `filter` must be real-valued.
 ///
 /// As elsewhere, the origin of `filter` is in the middle of the image, on the pixel to the right of
 /// the center in case of an even-sized image.
 ///
-/// Note that this is a really expensive way to compute the convolution for any `filter` that has more than a
-/// small amount of non-zero values. It is always advantageous to try to separate your filter into a set of 1D
-/// filters (see `dip::SeparateFilter` and `dip::SeparableConvolution`). If this is not possible, use
-/// `dip::ConvolveFT` with larger filters to compute the convolution in the Fourier domain.
+/// The convolution is computed with one of three methods, whichever is estimated to be cheapest given the
+/// sizes of `in` and `filter`:
+///  - the direct implementation of the convolution sum, which is only efficient for a `filter` with a small
+///    number of pixels;
+///  - `dip::SeparableConvolution`, if `dip::SeparateFilter` finds that `filter` is separable;
+///  - `dip::OverlapSaveConvolution`, which computes the convolution in the Fourier domain, tile by tile.
+///
+/// All three methods yield the same result, up to rounding errors. The direct implementation ignores
+/// pixels in `filter` that are not finite (NaN or infinity), and is always used if `filter` has such pixels.
+/// This allows defining a filter with an arbitrary shape. Pixels that are zero are not ignored.
 ///
 /// Also, if all non-zero filter weights have the same value, `dip::Uniform` implements a more efficient
 /// algorithm. If `filter` is a binary image, `dip::Uniform` is called.
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
-/// \see dip::ConvolveFT, dip::SeparableConvolution, dip::SeparateFilter, dip::Uniform
+/// \see dip::ConvolveFT, dip::OverlapSaveConvolution, dip::SeparableConvolution, dip::SeparateFilter, dip::Uniform
 DIP_EXPORT void GeneralConvolution(
       Image const& in,
       Image const& filter,
@@ -191,7 +243,12 @@ inline Image GeneralConvolution(
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
-/// \see dip::ConvolveFT, dip::SeparableConvolution, dip::GeneralConvolution
+/// A rectangular kernel is applied separably, with a running sum along each dimension. For other kernel
+/// shapes, the sum over the kernel is updated as it slides along the image line, taking into account only
+/// the pixels that enter and leave the kernel at each end of each of its pixel runs. The cost per pixel is
+/// thus proportional to the number of runs in the kernel, not to its number of pixels.
+///
+/// \see dip::ConvolveFT, dip::SeparableConvolution, dip::GeneralConvolution, dip::SummedAreaTable
 DIP_EXPORT void Uniform(
       Image const& in,
       Image& out,
@@ -293,7 +350,8 @@ inline Image GaussFT(
 /// The value of sigma determines the smoothing effect. For smaller values, the result is an
 /// increasingly poor approximation to the Gaussian filter. This function is efficient only for
 /// very large sigmas. Dimensions where sigma is 0 or negative are not processed, even if the
-/// derivative order is non-zero.
+/// derivative order is non-zero. For complex images, the real and imaginary components are filtered
+/// together, in the same pass over the image.
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
@@ -335,6 +393,51 @@ inline Image GaussIIR(
    return out;
 }
 
+/// \brief Approximation of the Gaussian filter by iterated extended box filters
+///
+/// Convolves the image `iterations` times with an extended box filter along each dimension. An extended box
+/// filter is a uniform filter with an additional sample with a fractional weight at each end, which allows
+/// its variance to match any value exactly. The result has the variance of the Gaussian with the given
+/// `sigmas`, and approximates the Gaussian filter increasingly well as `iterations` increases. The cost per
+/// pixel is independent of sigma, and is proportional to `iterations`. Dimensions where sigma is 0 or negative
+/// are not processed. Only smoothing is supported, this function cannot compute derivatives.
+///
+/// The difference between the 1D impulse response and a sampled Gaussian has an L1 norm of at most 5.5% for
+/// 3 iterations, 4% for 4 iterations, and 3.1% for 5 iterations (for sigmas of 2 and larger). Therefore, along
+/// each processed dimension, the result differs from that of the Gaussian filter by at most 2.8%, 2% and 1.6%
+/// respectively of the range of values in the input. Smaller sigmas are poorly approximated; use `dip::GaussFIR`
+/// or `dip::GaussFT` for those.
+///
+/// If `in` is of type `dip::DT_UINT8` or `dip::DT_UINT16` and `out` is protected with the same data type, the
+/// filter is computed without converting the image to floating-point, using fixed-point arithmetic. The result
+/// is rounded to the data type after processing each dimension. This reduces the memory bandwidth required,
+/// useful for example for 8-bit video frames. Otherwise, the output is floating-point, as with the other
+/// Gaussian filters.
+///
+/// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
+///
+/// \see dip::Gauss, dip::GaussFIR, dip::GaussIIR, dip::GaussFT, dip::Uniform
+///
+/// See: P. Gwosdek, S. Grewenig, A. Bruhn and J. Weickert, Theoretical foundations of Gaussian convolution by
+/// extended box filtering, in: Scale Space and Variational Methods in Computer Vision, LNCS 6667:447-458, 2012.
+DIP_EXPORT void GaussBox(
+      Image const& in,
+      Image& out,
+      FloatArray sigmas = { 1.0 },
+      dip::uint iterations = 4,
+      StringArray const& boundaryCondition = {}
+);
+inline Image GaussBox(
+      Image const& in,
+      FloatArray const& sigmas = { 1.0 },
+      dip::uint iterations = 4,
+      StringArray const& boundaryCondition = {}
+) {
+   Image out;
+   GaussBox( in, out, sigmas, iterations, boundaryCondition );
+   return out;
+}
+
 /// \brief Convolution with a Gaussian kernel and its derivatives
 ///
 /// Convolves the image with a Gaussian kernel. For each dimension, provide a value in `sigmas` and
@@ -346,15 +449,18 @@ inline Image GaussIIR(
 /// - `"FIR"`: Finite impulse response implementation, see `dip::GaussFIR`.
 /// - `"IIR"`: Infinite impulse response implementation, see `dip::GaussIIR`.
 /// - `"FT"`: Fourier domain implementation, see `dip::GaussFT`.
+/// - `"box"`: Iterated extended box filters, see `dip::GaussBox`. Uses 4 iterations, and cannot compute derivatives.
 /// - `"best"`: Picks the best method, according to the values of `sigmas` and `derivativeOrder`:
 ///     - if any `derivativeOrder` is larger than 3, use the FT method,
 ///     - else if any `sigmas` is smaller than 0.8, use the FT method,
-///     - else if any `sigmas` is larger than 10, use the IIR method,
+///     - else if any `sigmas` is larger than 10, use the box method if no derivatives are computed, no `sigmas`
+///       is smaller than 2, and it can compute in fixed-point arithmetic (see `dip::GaussBox`); otherwise use
+///       the IIR method,
 ///     - else use the FIR method.
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
-/// \see dip::GaussFIR, dip::GaussFT, dip::GaussIIR, dip::Derivative, dip::FiniteDifference, dip::Uniform
+/// \see dip::GaussFIR, dip::GaussFT, dip::GaussIIR, dip::GaussBox, dip::Derivative, dip::FiniteDifference, dip::Uniform
 DIP_EXPORT void Gauss(
       Image const& in,
       Image& out,
@@ -491,6 +597,45 @@ inline Image Derivative(
    return out;
 }
 
+/// \brief Computes a set of Gaussian derivatives of a scalar image, sharing computations between them
+///
+/// `derivativeOrders` lists the derivatives to compute, each element is an array with the derivative order
+/// along each image dimension, as the `derivativeOrder` parameter to `dip::Derivative`. `out` is a vector
+/// image with one tensor element for each derivative, in the order given.
+///
+/// The Gaussian derivative is separable: it is computed as a sequence of 1D filters, one along each image
+/// dimension. Derivatives that have the same order along some dimensions can share the result of the filters
+/// along those dimensions. This function computes the 1D filters as a tree, such that each intermediate result is
+/// computed only once. For example, the six elements of the Hessian of a 3D image require 15 1D filters,
+/// instead of 18 when computing them independently. One intermediate image per image dimension is kept in memory.
+///
+/// `sigmas`, `method`, `boundaryCondition` and `truncation` are as in `dip::Derivative`. Computations are shared
+/// only with the Gaussian FIR and IIR implementations; the FT implementation and finite differences compute each
+/// derivative independently.
+///
+/// `dip::Gradient`, `dip::Hessian`, `dip::Dgg` and related functions use this function.
+DIP_EXPORT void DerivativeBank(
+      Image const& in,
+      Image& out,
+      std::vector< UnsignedArray > const& derivativeOrders,
+      FloatArray sigmas = { 1.0 },
+      String const& method = S::BEST,
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+);
+inline Image DerivativeBank(
+      Image const& in,
+      std::vector< UnsignedArray > const& derivativeOrders,
+      FloatArray const& sigmas = { 1.0 },
+      String const& method = S::BEST,
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+) {
+   Image out;
+   DerivativeBank( in, out, derivativeOrders, sigmas, method, boundaryCondition, truncation );
+   return out;
+}
+
 /// \brief Computes the first derivative along x, see `dip::Derivative`.
 inline void Dx(
       Image const& in,
@@ -1049,6 +1194,117 @@ inline Image LaplaceMinusDgg(
    return out;
 }
 
+/// \brief A Gaussian scale space: an image smoothed with Gaussians of increasing size, computed incrementally.
+///
+/// The levels of the scale space are the input image convolved with a Gaussian of the given `scales` (sigmas, in
+/// input pixels). Each level is computed from the previous one, by smoothing it with a Gaussian of sigma
+/// \f$\sqrt{\sigma_k^2 - \sigma_{k-1}^2}\f$, which is cheaper than smoothing the input image with \f$\sigma_k\f$.
+/// `inputScale` is the sigma of the blur already present in the input image, the first level is computed from
+/// the input by smoothing with \f$\sqrt{\sigma_0^2 - \sigma_\text{in}^2}\f$. `scales` must be increasing, and larger
+/// than `inputScale`. Each filter uses all available threads.
+///
+/// If `downsample` is `true`, each level is subsampled by the largest power of two not larger than its scale
+/// (so that the scale is at least one pixel at the level's sampling). When a level has a larger subsampling
+/// factor than the previous one, it is smoothed before subsampling, and the smoothing suppresses the frequencies
+/// that would cause aliasing. Pixel `p` of a level with subsampling factor `f` corresponds to input pixel `f * p`.
+///
+/// Levels are computed when first requested, and kept in memory. If `memoryBudget` is larger than zero, the
+/// least recently used levels are discarded when keeping a new level would use more than `memoryBudget` bytes.
+/// Discarded levels are computed again, from the closest lower level available, if requested later.
+///
+/// Derivatives at a level are computed as Gaussian derivatives of the previous level (or the input image
+/// for the first level), with the same incremental sigma used to compute the level. This yields the derivative
+/// of the input image convolved with a Gaussian of the level's scale. Derivatives are with respect to the input
+/// image's pixel coordinates, also for subsampled levels. To obtain scale-normalized derivatives, multiply
+/// the result by \f$\sigma^n\f$, with \f$n\f$ the total derivative order:
+///
+/// ```cpp
+///     dip::GaussianScaleSpace scaleSpace( img, { 1, 1.5, 2.2, 3.3, 5, 7.5, 11 }, true );
+///     for( dip::uint ii = 0; ii < scaleSpace.NumberOfLevels(); ++ii ) {
+///        dip::dfloat s = scaleSpace.Scale( ii );
+///        dip::Image blobs = dip::Trace( scaleSpace.Hessian( ii )) * ( s * s );
+///        ...
+///     }
+/// ```
+///
+/// `method`, `boundaryCondition` and `truncation` are passed to `dip::Gauss`, `dip::Derivative`,
+/// `dip::Gradient` and `dip::Hessian`.
+///
+/// \see dip::Gauss, dip::Derivative, dip::Gradient, dip::Hessian, dip::Subsampling
+class DIP_NO_EXPORT GaussianScaleSpace {
+   public:
+
+      /// \brief A default-constructed scale space has no levels.
+      GaussianScaleSpace() = default;
+
+      /// \brief Prepares the scale space for `in`. No levels are computed until they are requested.
+      DIP_EXPORT GaussianScaleSpace(
+            Image const& in,
+            FloatArray const& scales,
+            bool downsample = false,
+            dfloat inputScale = 0.0,
+            dip::uint memoryBudget = 0,
+            String const& method = S::BEST,
+            StringArray const& boundaryCondition = {},
+            dfloat truncation = 3
+      );
+
+      /// \brief Returns the number of levels in the scale space.
+      dip::uint NumberOfLevels() const { return scales_.size(); }
+
+      /// \brief Returns the scale (sigma, in input pixels) of level `level`.
+      dfloat Scale( dip::uint level ) const {
+         DIP_THROW_IF( level >= scales_.size(), E::INDEX_OUT_OF_RANGE );
+         return scales_[ level ];
+      }
+
+      /// \brief Returns the subsampling factor of level `level`, 1 if it is not subsampled.
+      dip::uint SubsamplingFactor( dip::uint level ) const {
+         DIP_THROW_IF( level >= scales_.size(), E::INDEX_OUT_OF_RANGE );
+         return factors_[ level ];
+      }
+
+      /// \brief Returns the number of bytes used by the levels currently kept in memory.
+      dip::uint MemoryUsage() const { return memoryUsage_; }
+
+      /// \brief Returns level `level`, computing it (and the lower levels not in memory) if necessary.
+      ///
+      /// The returned image shares its data with the level kept in memory, it must not be modified.
+      DIP_EXPORT Image Level( dip::uint level );
+
+      /// \brief Returns the derivative of order `derivativeOrder` at level `level`, see `dip::Derivative`.
+      DIP_EXPORT Image Derivative( dip::uint level, UnsignedArray const& derivativeOrder );
+
+      /// \brief Returns the gradient at level `level`, see `dip::Gradient`.
+      DIP_EXPORT Image Gradient( dip::uint level );
+
+      /// \brief Returns the Hessian at level `level`, see `dip::Hessian`.
+      DIP_EXPORT Image Hessian( dip::uint level );
+
+   private:
+      Image input_;
+      FloatArray scales_;
+      std::vector< dip::uint > factors_;     // subsampling factor for each level
+      dfloat inputScale_ = 0.0;
+      dip::uint memoryBudget_ = 0;
+      String method_;
+      StringArray boundaryCondition_;
+      dfloat truncation_ = 3;
+      std::vector< Image > levels_;          // not forged if not in memory
+      std::vector< dip::uint > lastUse_;     // for each level, the value of `clock_` when it was last used
+      dip::uint clock_ = 0;
+      dip::uint memoryUsage_ = 0;
+
+      // Returns the image that `level` is computed from: the previous level, or the input image
+      Image Parent( dip::uint level );
+      // Returns the sigma, in pixels of the parent image, of the Gaussian that takes the parent to `level`
+      dfloat IncrementalSigma( dip::uint level ) const;
+      // Subsamples the result of filtering the parent image to the sampling of `level`
+      Image ToLevelSampling( Image const& img, dip::uint level ) const;
+      // Keeps `img` as level `level`, discarding other levels if needed to stay within the memory budget
+      void Keep( dip::uint level, Image const& img );
+};
+
 /// \brief Sharpens `in` by subtracting the Laplacian of the image.
 ///
 /// The actual operation applied is:
@@ -1116,12 +1372,79 @@ inline Image UnsharpMask(
 }
 
 
-DIP_EXPORT void OrientedGauss( // TODO: port dip_OrientedGauss (from dip_linear.h)
+/// \brief A bank of 2D anisotropic, oriented Gaussian filters, computed recursively
+///
+/// Applies one Gaussian filter for each element of `orientations`, and writes the responses to the tensor elements
+/// of `out`, in the order given. `sigmas[ ii ]` has two elements: the sigma along the orientation `orientations[ ii ]`,
+/// and the sigma perpendicular to it. If `sigmas` has only one element, it is used for all filters. Orientations
+/// are angles in radian, with the same convention as the `direction` parameter to `dip::Gabor2D`: 0 is the x-axis,
+/// and `pi/2` is the y-axis.
+///
+/// Each filter is decomposed into a Gaussian along one of the image axes, computed as `dip::Gauss` would, followed
+/// by a recursive (IIR) Gaussian along sheared lines, which step one pixel along the other image axis and at most
+/// one pixel along the first axis (see Geusebroek et al., IEEE Trans. Image Process. 12(8):938-943, 2003). For
+/// the second pass, the image rows are shifted with linear interpolation such that the sheared lines become columns,
+/// which are filtered with `dip::GaussIIR`, and the result is shifted back. The cost of this pass is thus independent
+/// of the sigmas and of the orientation. The two interpolations add a variance of at most 0.5 pixel<sup>2</sup>
+/// across the sheared lines, which for sigmas of a few pixels and more is negligible. Filters with the same sigmas
+/// and orientations `x` and `pi - x` share the first pass. The passes are vectorized across image lines, not
+/// across filters.
+///
+/// If `out` is not forged or does not have the right sizes, it is allocated with each tensor element stored as
+/// a contiguous image, as in `dip::GaborIIRBank`. The output is always real-valued and of a floating-point type.
+///
+/// `in` must be scalar, real-valued, and 2D. Oriented Gaussian filters in 3D are not supported. `boundaryCondition`
+/// indicates how the boundary should be expanded in each dimension, see `dip::BoundaryCondition`. `truncation`
+/// is as in `dip::Gauss`.
+///
+/// \see dip::OrientedGauss, dip::Gauss, dip::GaborIIRBank
+DIP_EXPORT void OrientedGaussBank(
       Image const& in,
       Image& out,
-      FloatArray,
-      FloatArray
+      std::vector< FloatArray > const& sigmas,
+      FloatArray const& orientations,
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
 );
+inline Image OrientedGaussBank(
+      Image const& in,
+      std::vector< FloatArray > const& sigmas,
+      FloatArray const& orientations,
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+) {
+   Image out;
+   OrientedGaussBank( in, out, sigmas, orientations, boundaryCondition, truncation );
+   return out;
+}
+
+/// \brief 2D anisotropic, oriented Gaussian filter, computed recursively
+///
+/// `sigmas` has two elements: the sigma along `orientation`, and the sigma perpendicular to it. See
+/// `dip::OrientedGaussBank` for details on the parameters and on the implementation.
+///
+/// \see dip::OrientedGaussBank, dip::Gauss
+inline void OrientedGauss(
+      Image const& in,
+      Image& out,
+      FloatArray const& sigmas = { 5.0, 1.0 },
+      dfloat orientation = 0.0,
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+) {
+   OrientedGaussBank( in, out, { sigmas }, { orientation }, boundaryCondition, truncation );
+}
+inline Image OrientedGauss(
+      Image const& in,
+      FloatArray const& sigmas = { 5.0, 1.0 },
+      dfloat orientation = 0.0,
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+) {
+   Image out;
+   OrientedGauss( in, out, sigmas, orientation, boundaryCondition, truncation );
+   return out;
+}
 
 
 DIP_EXPORT void GaborFIR( // TODO: implement a separable FIR Gabor filter
@@ -1206,6 +1529,110 @@ inline Image Gabor2D(
    return out;
 }
 
+/// \brief A bank of recursive infinite impulse response Gabor filters, sharing computation between filters
+///
+/// Applies one Gabor filter for each element of `frequencies`, each one as `dip::GaborIIR` would, and writes
+/// the responses to the tensor elements of `out`, in the order given. `frequencies[ ii ]` has one frequency for
+/// each dimension. `sigmas[ ii ]` gives the sigmas for filter `ii`, as for `dip::GaborIIR`. If `sigmas` has only one
+/// element, it is used for all filters.
+///
+/// Because `in` is real-valued, filtering it along one dimension with frequency `-f` yields the complex conjugate
+/// of filtering it with frequency `f`. Filters with the same sigmas whose frequencies along the first dimension
+/// processed are equal or opposite share that first pass. The first dimension is chosen to maximize this sharing.
+/// For example, in a bank of 8 orientations at one scale, as produced by `dip::Gabor2DBank`, the first pass is
+/// computed 5 times rather than 8.
+///
+/// If `out` is not forged or does not have the right sizes, it is allocated with each tensor element stored as
+/// a contiguous image, rather than with interleaved tensor elements, to improve memory access.
+///
+/// If `outputMode` is `"complex"`, `out` contains the complex filter responses. If it is `"magnitude"`, `out`
+/// contains only their magnitude, and uses half the memory. In both cases, only one intermediate complex image
+/// is kept at the time, plus one for the response of the current filter in `"magnitude"` mode.
+///
+/// The computational savings come only from the shared first pass; the remaining passes are computed for each
+/// filter separately, vectorized across image lines rather than across filters. `"magnitude"` mode limits memory
+/// usage, it is not faster than `"complex"` mode. For oriented filters without modulation, see `dip::OrientedGaussBank`.
+///
+/// `in` must be scalar and real-valued.
+///
+/// `boundaryCondition`, `process` and `truncation` are as in `dip::GaborIIR`.
+///
+/// \see dip::GaborIIR, dip::Gabor2DBank
+DIP_EXPORT void GaborIIRBank(
+      Image const& in,
+      Image& out,
+      std::vector< FloatArray > const& sigmas,
+      std::vector< FloatArray > const& frequencies,
+      String const& outputMode = "complex",
+      StringArray const& boundaryCondition = {},
+      BooleanArray const& process = {},
+      dfloat truncation = 3
+);
+inline Image GaborIIRBank(
+      Image const& in,
+      std::vector< FloatArray > const& sigmas,
+      std::vector< FloatArray > const& frequencies,
+      String const& outputMode = "complex",
+      StringArray const& boundaryCondition = {},
+      BooleanArray const& process = {},
+      dfloat truncation = 3
+) {
+   Image out;
+   GaborIIRBank( in, out, sigmas, frequencies, outputMode, boundaryCondition, process, truncation );
+   return out;
+}
+
+/// \brief A bank of 2D Gabor filters at several scales and orientations
+///
+/// For each scale `ii`, applies `nOrientations` Gabor filters with an isotropic sigma `sigmas[ ii ]` and a frequency
+/// magnitude `frequencies[ ii ]`, at directions `jj * pi / nOrientations`. Directions are as in `dip::Gabor2D`.
+/// `sigmas` and `frequencies` must have the same number of elements. The response for scale `ii` and orientation `jj` is
+/// written to tensor element `ii * nOrientations + jj` of `out`.
+///
+/// The filters are computed by `dip::GaborIIRBank`, see there for the meaning of `outputMode`. The frequencies for
+/// directions `x` and `pi - x` are computed to be exactly opposite along the x-axis, so that they share computation.
+inline void Gabor2DBank(
+      Image const& in,
+      Image& out,
+      FloatArray const& sigmas = { 2.0, 4.0, 8.0, 16.0 },
+      FloatArray const& frequencies = { 0.25, 0.125, 0.0625, 0.03125 },
+      dip::uint nOrientations = 8,
+      String const& outputMode = "complex",
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+) {
+   DIP_THROW_IF( in.Dimensionality() != 2, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_THROW_IF( sigmas.size() != frequencies.size(), E::ARRAY_SIZES_DONT_MATCH );
+   DIP_THROW_IF( nOrientations == 0, E::INVALID_PARAMETER );
+   std::vector< FloatArray > bankSigmas;
+   std::vector< FloatArray > bankFrequencies;
+   for( dip::uint ii = 0; ii < sigmas.size(); ++ii ) {
+      DIP_THROW_IF( frequencies[ ii ] >= 0.5, "Frequency must be < 0.5" );
+      for( dip::uint jj = 0; jj < nOrientations; ++jj ) {
+         // Direction `pi - x` has the opposite cosine and the same sine as direction `x`
+         dip::uint mirrored = std::min( jj, nOrientations - jj );
+         dfloat direction = static_cast< dfloat >( mirrored ) * pi / static_cast< dfloat >( nOrientations );
+         dfloat cosine = mirrored == jj ? std::cos( direction ) : -std::cos( direction );
+         bankSigmas.push_back( { sigmas[ ii ], sigmas[ ii ] } );
+         bankFrequencies.push_back( { frequencies[ ii ] * cosine, frequencies[ ii ] * std::sin( direction ) } );
+      }
+   }
+   GaborIIRBank( in, out, bankSigmas, bankFrequencies, outputMode, boundaryCondition, {}, truncation );
+}
+inline Image Gabor2DBank(
+      Image const& in,
+      FloatArray const& sigmas = { 2.0, 4.0, 8.0, 16.0 },
+      FloatArray const& frequencies = { 0.25, 0.125, 0.0625, 0.03125 },
+      dip::uint nOrientations = 8,
+      String const& outputMode = "complex",
+      StringArray const& boundaryCondition = {},
+      dfloat truncation = 3
+) {
+   Image out;
+   Gabor2DBank( in, out, sigmas, frequencies, nOrientations, outputMode, boundaryCondition, truncation );
+   return out;
+}
+
 
 /// \brief Computes the normalized convolution with a Gaussian kernel: a Gaussian convolution for missing or
 /// uncertain data.
@@ -1220,10 +1647,14 @@ inline Image Gabor2D(
 /// of the parameters. `boundaryCondition` defaults to `"add zeros"`, the normalized convolution then takes pixels
 /// outside of the image domain as missing values.
 ///
+/// For real-valued `in`, the two convolutions are computed together: `in * mask` and `mask` are stored as the real
+/// and imaginary components of one complex image, which is filtered once. The output has the floating-point type
+/// suggested by `dip::DataType::SuggestFlex` for `in`.
+///
 /// **Literature**
 /// - H. Knutsson and C. F. Westin, "Normalized and differential convolution," Proceedings of IEEE Conference on
 ///   Computer Vision and Pattern Recognition, New York, NY, 1993, pp. 515-523.
-inline void NormalizedConvolution(
+DIP_EXPORT void NormalizedConvolution(
       Image const& in,
       Image const& mask,
       Image& out,
@@ -1231,17 +1662,7 @@ inline void NormalizedConvolution(
       String const& method = S::BEST,
       StringArray const& boundaryCondition = { S::ADD_ZEROS },
       dfloat truncation = 3
-) {
-   DIP_THROW_IF( !in.IsForged() || !mask.IsForged(), E::IMAGE_NOT_FORGED );
-   DIP_THROW_IF( !mask.IsScalar(), E::IMAGE_NOT_SCALAR );
-   DIP_THROW_IF( mask.DataType().IsComplex(), E::DATA_TYPE_NOT_SUPPORTED );
-   DIP_THROW_IF( mask.Sizes() != in.Sizes(), E::SIZES_DONT_MATCH );
-   Image denominator;
-   DIP_STACK_TRACE_THIS( Gauss( mask, denominator, sigmas, { 0 }, method, boundaryCondition, truncation ));
-   DIP_STACK_TRACE_THIS( MultiplySampleWise( in, mask, out ));
-   DIP_STACK_TRACE_THIS( Gauss( out, out, sigmas, { 0 }, method, boundaryCondition, truncation ));
-   DIP_STACK_TRACE_THIS( SafeDivide( out, denominator, out, out.DataType() ));
-}
+);
 inline Image NormalizedConvolution(
       Image const& in,
       Image const& mask,
@@ -1278,6 +1699,10 @@ inline Image NormalizedConvolution(
 /// This function uses `dip::Gauss`. See that function for the meaning of the parameters. `boundaryCondition` defaults
 /// to `"add zeros"`, the normalized convolution then takes pixels outside of the image domain as missing values.
 ///
+/// As in `dip::NormalizedConvolution`, for real-valued `in` the convolutions of \f$f \, m\f$ and \f$m\f$ are computed
+/// together by filtering one complex image. For a scalar `in`, the smoothing and the derivative share the passes
+/// along all dimensions except `dimension` (see `dip::DerivativeBank`).
+///
 /// **Literature**
 /// - H. Knutsson and C. F. Westin, "Normalized and differential convolution," Proceedings of IEEE Conference on
 ///   Computer Vision and Pattern Recognition, New York, NY, 1993, pp. 515-523.
@@ -718,6 +718,10 @@ class DIP_CLASS_EXPORT ConvexHullBased : public Base {
    public:
       explicit ConvexHullBased( Information const& information ) : Base( information, Type::CONVEXHULL_BASED ) {};
 
+      /// \brief Returns true if `Measure` uses `dip::ConvexHull::RotatingCalipers`. If any of the selected features
+      /// does, the rotating calipers are computed for all objects at once, in parallel, before `Measure` is called.
+      virtual bool UsesRotatingCalipers() const { return false; }
+
       /// \brief Called once for each object
       virtual void Measure( ConvexHull const& convexHull, Measurement::ValueIterator output ) = 0;
 };
@@ -770,7 +774,10 @@ class DIP_CLASS_EXPORT Composite : public Base {
 /// <tr><td> "Maximum"                 <td> Maximum coordinates of the object <td>
 /// <tr><td> "Perimeter"               <td> Length of the object perimeter <td> 2D (CC)
 /// <tr><td> "SurfaceArea"             <td> Surface area of object <td> 3D
+/// <tr><td> "MinkowskiFunctionals"    <td> Volume, surface area, mean breadth and Euler number of object <td> 3D
 /// <tr><td> "Feret"                   <td> Maximum and minimum object diameters <td> 2D (CC)
+/// <tr><td> "MinAreaRectangle"        <td> Minimum-area bounding rectangle <td> 2D (CC)
+/// <tr><td> "MinPerimeterRectangle"   <td> Minimum-perimeter bounding rectangle <td> 2D (CC)
 /// <tr><td> "SolidArea"               <td> Area of object with any holes filled <td> 2D (CC)
 /// <tr><td> "ConvexArea"              <td> Area of the convex hull <td> 2D (CC)
 /// <tr><td> "ConvexPerimeter"         <td> Perimeter of the convex hull <td> 2D (CC)
@@ -901,6 +908,94 @@ class DIP_NO_EXPORT MeasurementTool {
             dip::uint connectivity = 0
       ) const;
 
+      /// \brief Accumulates measurements over a sequence of image slabs, for images that do not fit in memory.
+      ///
+      /// Obtain an object of this class through `dip::MeasurementTool::MeasureIncremental`. Call `Scan` once for
+      /// each slab of the image, then call `Finish` to obtain the measurement results. The slabs can be of any
+      /// size, but together they should cover the image exactly once.
+      ///
+      /// Because the line-based features accumulate their data per object, an object that is split over
+      /// multiple slabs is measured as if the whole image had been seen at once. The labels must therefore be
+      /// consistent across slabs (i.e. the slabs are parts of a single labeled image).
+      ///
+      /// The object refers to the `dip::MeasurementTool` that created it, and keeps its state in that tool's
+      /// feature objects. The tool must therefore outlive it, and must not be used for any other measurement
+      /// (neither `Measure` nor a second incremental measurement) until `Finish` is called or the object is
+      /// destroyed. The object can be moved but not copied. If it is destroyed before `Finish` is called, the
+      /// features' state is cleaned up, and the tool can be used again.
+      class DIP_NO_EXPORT IncrementalMeasurement {
+         public:
+            IncrementalMeasurement( IncrementalMeasurement const& ) = delete;
+            IncrementalMeasurement& operator=( IncrementalMeasurement const& ) = delete;
+            DIP_EXPORT IncrementalMeasurement( IncrementalMeasurement&& other ) noexcept;
+            DIP_EXPORT IncrementalMeasurement& operator=( IncrementalMeasurement&& other ) noexcept;
+            DIP_EXPORT ~IncrementalMeasurement();
+
+            /// \brief Accumulates measurements for one slab of the image. `label` and `grey` are as in
+            /// `dip::MeasurementTool::Measure`, `origin` gives the coordinates of the first pixel of the slab
+            /// within the full image.
+            ///
+            /// The first call to this function initializes the measurement features using `label` and `grey`,
+            /// so the pixel sizes of the first slab are used for all slabs.
+            DIP_EXPORT void Scan( Image const& label, Image const& grey, UnsignedArray const& origin );
+
+            /// \brief Finalizes the measurement, and returns the results. Afterwards, the object can no longer be used.
+            DIP_EXPORT Measurement Finish();
+
+         private:
+            // Cleans up the features' state, if they were prepared and not yet finished
+            void Release() noexcept;
+
+            friend class MeasurementTool;
+            IncrementalMeasurement( MeasurementTool const& tool, StringArray features, UnsignedArray const& objectIDs ) :
+                  tool_( &tool ), featureNames_( std::move( features )), objectIDs_( objectIDs ) {}
+            MeasurementTool const* tool_;
+            StringArray featureNames_;
+            UnsignedArray objectIDs_;
+            Measurement measurement_;
+            std::vector< Feature::Base* > featureArray_;
+            std::vector< Feature::LineBased* > lineBasedFeatures_;
+            dip::uint nDims_ = 0;
+            bool hasGrey_ = false;
+            bool finished_ = false;
+      };
+
+      /// \brief Prepares to measure one or more features on one or more objects in a labeled image that is
+      /// given as a sequence of slabs.
+      ///
+      /// This is useful for images that do not fit in memory, and are read from file in parts (for example
+      /// using the ROI options of `dip::ImageReadICS` or `dip::ImageReadTIFF`):
+      ///
+      /// ```cpp
+      ///     dip::MeasurementTool tool;
+      ///     auto incremental = tool.MeasureIncremental( { "Size", "Center", "Mean" }, objectIDs );
+      ///     for( dip::uint z = 0; z < depth; z += 64 ) {
+      ///        dip::uint n = std::min< dip::uint >( 64, depth - z );
+      ///        dip::Image label = dip::ImageReadICS( "label", { 0, 0, z }, { width, height, n } );
+      ///        dip::Image grey = dip::ImageReadICS( "grey", { 0, 0, z }, { width, height, n } );
+      ///        incremental.Scan( label, grey, { 0, 0, z } );
+      ///     }
+      ///     dip::Measurement msr = incremental.Finish();
+      /// ```
+      ///
+      /// Only line-based features, and composite features that depend only on line-based features, can
+      /// be measured this way. `objectIDs` is the list of object IDs to measure, which cannot be empty (as
+      /// the full image is never seen, the object IDs cannot be extracted from it). The other arguments are
+      /// as for `dip::MeasurementTool::Measure`.
+      ///
+      /// The measurement features are owned by the `%MeasurementTool` object, and keep their state while
+      /// measuring. Thus, the tool must outlive the returned object, and it is not possible to perform other
+      /// measurements with this tool before `dip::MeasurementTool::IncrementalMeasurement::Finish` is called
+      /// or the returned object is destroyed.
+      IncrementalMeasurement MeasureIncremental(
+            StringArray features,
+            UnsignedArray const& objectIDs
+      ) const {
+         DIP_THROW_IF( features.empty(), "No features given" );
+         DIP_THROW_IF( objectIDs.empty(), "No object IDs given" );
+         return { *this, std::move( features ), objectIDs };
+      }
+
       /// \brief Returns a table with known feature names and descriptions, which can directly be shown to the user.
       /// (Note: data is copied to output array, not a trivial function).
       Feature::InformationArray Features() const {
@@ -925,6 +1020,15 @@ class DIP_NO_EXPORT MeasurementTool {
          DIP_THROW_IF( it == featureIndices_.end(), "Feature name not known: " + name );
          return it->second;
       }
+
+      // Adds the features in `features`, and the features they depend on, to `measurement`, and initializes them.
+      // Returns pointers to the features, in the order they were added. `features` is modified.
+      std::vector< Feature::Base* > PrepareFeatures(
+            StringArray& features,
+            Image const& label,
+            Image const& grey,
+            Measurement& measurement
+      ) const;
 };
 
 
@@ -967,6 +1071,41 @@ inline Image ObjectToMeasurement(
    return out;
 }
 
+/// \brief Paints each object with the values of multiple measurement features, in a single pass over the image.
+///
+/// `measurement` is assumed to have been obtained through measurement of the input `label` image. `features`
+/// lists the features to paint, all features in `measurement` are used if it is empty. `out` will be a vector
+/// image with one tensor element for each value of the selected features, in the order given.
+///
+/// All values are collected in a single look-up table indexed by object ID, which is applied to the label image
+/// in one (parallel) pass. This is more efficient than painting each feature with a separate call to
+/// `dip::ObjectToMeasurement`. Pixels with a label that is not in `measurement` are set to 0.
+///
+/// If `scaling` is `"don't normalize"`, `out` will be of type `DT_SFLOAT`, and contain the measured values. If it
+/// is `"normalize"`, each value is linearly mapped such that, over all objects, it ranges from 1 to the maximum
+/// value representable in the output type, leaving 0 for the background. Values that are not finite (NaN or
+/// infinity) are ignored when determining this range, and are painted as 0. `out` will then be of type `DT_UINT16`.
+/// This is useful for visualization, as it reduces memory usage and allows direct use of a color map.
+/// As with the single-feature function, a different output type can be selected by protecting `out`.
+/// When normalizing, this must be an unsigned integer type of at most 32 bits.
+DIP_EXPORT void ObjectToMeasurement(
+      Image const& label,
+      Image& out,
+      Measurement const& measurement,
+      StringArray const& features = {},
+      String const& scaling = S::DONT_NORMALIZE
+);
+inline Image ObjectToMeasurement(
+      Image const& label,
+      Measurement const& measurement,
+      StringArray const& features = {},
+      String const& scaling = S::DONT_NORMALIZE
+) {
+   Image out;
+   ObjectToMeasurement( label, out, measurement, features, scaling );
+   return out;
+}
+
 
 /// \brief Writes a `dip::Measurement` structure to a CSV file.
 ///
@@ -1000,6 +1139,42 @@ DIP_EXPORT void WriteCSV(
       StringSet const& options = {}
 );
 
+/// \brief Writes a `dip::Measurement` structure to a binary, column-oriented file.
+///
+/// Writing a CSV file (see `dip::WriteCSV`) requires formatting each value as text, which for tables with
+/// millions of objects can take longer than the measurement itself. This function instead writes the data
+/// in binary form, one column after another, such that the file can be memory-mapped by other software and
+/// each feature value accessed as a contiguous array, without a parse step.
+///
+/// The file has the following layout. All integers are unsigned 64-bit values, and all values are
+/// written in the native byte order of the machine:
+///
+///  - A header: the 8-byte magic string `"DIPMSR\0\1"` (the last byte is the format version), a byte-order
+///    mark (the integer 0x0102030405060708), the number of objects, the number of features, the number of
+///    values, and the byte offset to the data section.
+///  - The feature table: for each feature, its name (written as the number of bytes followed by the
+///    characters) and the number of values. This is followed, for each value, by its name and its units
+///    (the units as given by `dip::Units::String`), written in the same way as the feature names.
+///  - Zero padding up to the data section offset, which is always a multiple of 64.
+///  - The data section: the object IDs as an array of integers, followed by one array of `dip::dfloat`
+///    values for each column of the table. Each array has as many elements as objects are in the table,
+///    so that column `ii` starts at byte `offset + ( ii + 1 ) * 8 * nObjects`.
+///
+/// Use `dip::ReadColumnar` to read the file back into a `dip::Measurement` object.
+DIP_EXPORT void WriteColumnar(
+      Measurement const& measurement,
+      String const& filename
+);
+
+/// \brief Reads a file written by `dip::WriteColumnar` into a `dip::Measurement` structure.
+///
+/// If `features` is not empty, only the given features are read. Because the data are stored column-wise,
+/// only the data for the requested features is read from disk.
+DIP_EXPORT Measurement ReadColumnar(
+      String const& filename,
+      StringArray const& features = {}
+);
+
 
 /// \brief Returns the smallest feature value in the first column of `featureValues`.
 ///
@@ -100,7 +100,11 @@ inline Image MedianFilter(
 ///
 /// `boundaryCondition` indicates how the boundary should be expanded in each dimension. See `dip::BoundaryCondition`.
 ///
-/// Uses `dip::FastVarianceAccumulator` for the computation.
+/// Computes the sum and the sum of squares of the values within the window, as `dip::FastVarianceAccumulator`
+/// does. These sums are updated as the window slides along the image line, using only the pixels that enter
+/// and leave the window at each end of each of its pixel runs, as is done in `dip::Uniform`. For a rectangular
+/// window and a scalar, real-valued image, the sums are instead obtained from a `dip::SummedAreaTable`, at a cost
+/// that does not depend on the size of the window.
 DIP_EXPORT void VarianceFilter(
       Image const& in,
       Image& out,
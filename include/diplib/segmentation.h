@@ -316,6 +316,69 @@ inline Image MultipleThresholds(
    return out;
 }
 
+/// \brief Local threshold by Niblack's method: a pixel is foreground if it is larger or equal to `m + k * s`, with
+/// `m` and `s` the mean and standard deviation in a rectangular window of size `sizes` around it.
+///
+/// `sizes` is the size of the window along each dimension, if it has only one element, the same size is used for all
+/// dimensions. `boundaryCondition` determines how the image is extended beyond its edges (see
+/// \ref boundary_conditions). The local mean and standard deviation are computed with a `dip::SummedAreaTable`,
+/// such that the cost does not depend on the window size.
+///
+/// `in` must be scalar and real-valued. The output image is binary.
+///
+/// \see dip::SauvolaThreshold
+///
+/// **Literature**:
+/// - W. Niblack, "An Introduction to Digital Image Processing", Prentice-Hall, Englewood Cliffs, NJ, 1986.
+DIP_EXPORT void NiblackThreshold(
+      Image const& in,
+      Image& out,
+      UnsignedArray const& sizes = { 15 },
+      dfloat k = -0.2,
+      StringArray const& boundaryCondition = {}
+);
+inline Image NiblackThreshold(
+      Image const& in,
+      UnsignedArray const& sizes = { 15 },
+      dfloat k = -0.2,
+      StringArray const& boundaryCondition = {}
+) {
+   Image out;
+   NiblackThreshold( in, out, sizes, k, boundaryCondition );
+   return out;
+}
+
+/// \brief Local threshold by Sauvola's method: a pixel is foreground if it is larger or equal to
+/// `m * ( 1 + k * ( s / range - 1 ))`, with `m` and `s` the mean and standard deviation in a rectangular window
+/// of size `sizes` around it.
+///
+/// `range` is the dynamic range of the standard deviation, 128 for 8-bit images. Parameters and the computation of
+/// `m` and `s` are as in `dip::NiblackThreshold`.
+///
+/// `in` must be scalar and real-valued. The output image is binary.
+///
+/// **Literature**:
+/// - J. Sauvola and M. Pietik&auml;inen, "Adaptive document image binarization", Pattern Recognition 33(2):225-236, 2000.
+DIP_EXPORT void SauvolaThreshold(
+      Image const& in,
+      Image& out,
+      UnsignedArray const& sizes = { 15 },
+      dfloat k = 0.5,
+      dfloat range = 128.0,
+      StringArray const& boundaryCondition = {}
+);
+inline Image SauvolaThreshold(
+      Image const& in,
+      UnsignedArray const& sizes = { 15 },
+      dfloat k = 0.5,
+      dfloat range = 128.0,
+      StringArray const& boundaryCondition = {}
+) {
+   Image out;
+   SauvolaThreshold( in, out, sizes, k, range, boundaryCondition );
+   return out;
+}
+
 /// \brief Automated threshold using `method`.
 ///
 /// This function computes an optimal threshold value for `in` using `method`, and applies it. Returns the found
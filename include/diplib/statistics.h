@@ -73,6 +73,8 @@ DIP_EXPORT UnsignedArray MinimumPixel( Image const& in, Image const& mask = {},
 /// For tensor images, the output has the same tensor size and shape as the input.
 ///
 /// If `mask` is forged, those pixels not selected by the mask are presumed to be 0.
+///
+/// \see dip::SummedAreaTable
 DIP_EXPORT void CumulativeSum( Image const& in, Image const& mask, Image& out, BooleanArray const& process = {} );
 inline Image CumulativeSum( Image const& in, Image const& mask = {}, BooleanArray const& process = {} ) {
    Image out;
@@ -80,6 +82,111 @@ inline Image CumulativeSum( Image const& in, Image const& mask = {}, BooleanArra
    return out;
 }
 
+/// \brief A summed-area table (integral image), to compute the sum, mean and variance of the pixel values within
+/// any rectangular box in constant time.
+///
+/// The table is computed once from a scalar, real-valued image of any dimensionality, using `dip::CumulativeSum`.
+/// After that, the sum over a box is obtained from the table values at its \f$2^n\f$ corners, independently of the
+/// size of the box. If the table of squared values is also computed (the default), variances can be computed
+/// as well.
+///
+/// Queries can be made for individual boxes, for a list of boxes, or for a box of a given size at every
+/// position in the image:
+///
+/// ```cpp
+///     dip::SummedAreaTable table( img );
+///     dip::dfloat m = table.Mean( { { 10, 20 }, { 30, 30 }} );    // mean of img.At( Range{ 10, 39 }, Range{ 20, 49 } )
+///     dip::Image variances;
+///     table.BoxVariances( { 15, 15 }, variances );                 // variance in each 15x15 window
+/// ```
+///
+/// The tables store sums of the pixel values minus their mean, in double-precision floating-point format.
+/// Removing the mean from the pixel values reduces the magnitude of the sums, and thus the cancellation error
+/// when computing variances for small boxes in a large image.
+///
+/// \see dip::CumulativeSum, dip::VarianceFilter, dip::NiblackThreshold, dip::SauvolaThreshold
+class DIP_NO_EXPORT SummedAreaTable {
+   public:
+
+      /// \brief Represents a rectangular box within the image: the box has its first pixel at `origin`, and
+      /// `sizes` pixels along each dimension.
+      struct DIP_NO_EXPORT Box {
+         UnsignedArray origin;   ///< Coordinates of the first pixel in the box
+         UnsignedArray sizes;    ///< Number of pixels along each dimension
+      };
+
+      /// \brief A default-constructed table cannot be queried.
+      SummedAreaTable() = default;
+
+      /// \brief Computes the summed-area table for `in`, which must be scalar and real-valued. If `squares` is
+      /// `true`, also computes the table of squared values, which is needed to compute variances.
+      DIP_EXPORT explicit SummedAreaTable( Image const& in, bool squares = true );
+
+      /// \brief Returns `true` if the table has been computed.
+      bool IsForged() const { return sums_.IsForged(); }
+
+      /// \brief Returns the dimensionality of the image the table was computed for.
+      dip::uint Dimensionality() const { return sizes_.size(); }
+
+      /// \brief Returns the sizes of the image the table was computed for. The table itself has one more
+      /// pixel along each dimension.
+      UnsignedArray const& Sizes() const { return sizes_; }
+
+      /// \brief Returns `true` if the table of squared values was computed.
+      bool HasSquares() const { return squares_.IsForged(); }
+
+      /// \brief Returns the value subtracted from the pixel values before accumulating them: the mean of the image.
+      dfloat Shift() const { return shift_; }
+
+      /// \brief Returns the table of sums. Pixel `p` contains the sum of `in - Shift()` over all pixels with
+      /// coordinates smaller than `p` along all dimensions.
+      Image const& Table() const { return sums_; }
+
+      /// \brief Returns the table of sums of squares, similar to `Table`.
+      Image const& SquaresTable() const { return squares_; }
+
+      /// \brief Returns the sum of the pixel values within `box`.
+      DIP_EXPORT dfloat Sum( Box const& box ) const;
+
+      /// \brief Returns the mean of the pixel values within `box`.
+      DIP_EXPORT dfloat Mean( Box const& box ) const;
+
+      /// \brief Returns the variance of the pixel values within `box`. This is the unbiased estimator, as computed
+      /// by `dip::FastVarianceAccumulator`.
+      DIP_EXPORT dfloat Variance( Box const& box ) const;
+
+      /// \brief Returns the sum of the pixel values within each of the boxes in `boxes`. Boxes are processed in
+      /// parallel.
+      DIP_EXPORT std::vector< dfloat > Sums( std::vector< Box > const& boxes ) const;
+
+      /// \brief Returns the mean of the pixel values within each of the boxes in `boxes`. Boxes are processed in
+      /// parallel.
+      DIP_EXPORT std::vector< dfloat > Means( std::vector< Box > const& boxes ) const;
+
+      /// \brief Returns the variance of the pixel values within each of the boxes in `boxes`. Boxes are processed in
+      /// parallel.
+      DIP_EXPORT std::vector< dfloat > Variances( std::vector< Box > const& boxes ) const;
+
+      /// \brief Computes the sum over a box of size `boxSizes` at every position where it fits within the image.
+      ///
+      /// `out` is a `dip::DT_DFLOAT` image of size `Sizes() - boxSizes + 1`, where pixel `p` contains the sum of
+      /// the box that has its first pixel at `p`. To obtain a box filter, extend the image by `boxSizes / 2`
+      /// (using `dip::ExtendImage`) before computing the table.
+      DIP_EXPORT void BoxSums( UnsignedArray boxSizes, Image& out ) const;
+
+      /// \brief Computes the mean over a box of size `boxSizes` at every position, see `BoxSums`.
+      DIP_EXPORT void BoxMeans( UnsignedArray boxSizes, Image& out ) const;
+
+      /// \brief Computes the variance over a box of size `boxSizes` at every position, see `BoxSums`.
+      DIP_EXPORT void BoxVariances( UnsignedArray boxSizes, Image& out ) const;
+
+   private:
+      Image sums_;            // sizes_ + 1 along each dimension, first pixel along each dimension is 0
+      Image squares_;         // same, for the squared values; not forged if not requested
+      UnsignedArray sizes_;   // sizes of the input image
+      dfloat shift_ = 0.0;    // subtracted from the pixel values before accumulating them
+};
+
 /// \brief Finds the largest and smallest value in the image, within an optional mask.
 ///
 /// If `mask` is not forged, all input pixels are considered. In case of a tensor
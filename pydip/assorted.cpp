@@ -120,15 +120,29 @@ void init_assorted( py::module& m ) {
    m.def( "ImageReadICS", py::overload_cast< dip::String const&, dip::UnsignedArray const&, dip::UnsignedArray const&, dip::UnsignedArray const&, dip::Range const&, dip::String const& >( &dip::ImageReadICS ),
           "filename"_a, "origin"_a = dip::UnsignedArray{}, "sizes"_a = dip::UnsignedArray{}, "spacing"_a = dip::UnsignedArray{}, "channels"_a = dip::Range{}, "mode"_a = "" );
    m.def( "ImageIsICS", &dip::ImageIsICS, "filename"_a );
-   m.def( "ImageWriteICS", py::overload_cast< dip::Image const&, dip::String const&, dip::StringArray const&, dip::uint, dip::StringSet const& >( &dip::ImageWriteICS ),
-          "image"_a, "filename"_a, "history"_a = dip::StringArray{}, "significantBits"_a = 0, "options"_a = dip::StringSet {} );
+   m.def( "ImageWriteICS", py::overload_cast< dip::Image const&, dip::String const&, dip::StringArray const&, dip::uint, dip::StringSet const&, dip::uint >( &dip::ImageWriteICS ),
+          "image"_a, "filename"_a, "history"_a = dip::StringArray{}, "significantBits"_a = 0, "options"_a = dip::StringSet {}, "compressionLevel"_a = 6 );
+   m.def( "ImageWriteICSIndex", &dip::ImageWriteICSIndex, "filename"_a, "spacing"_a = 1024 * 1024 );
 
    m.def( "ImageReadTIFF", py::overload_cast< dip::String const&, dip::Range const&, dip::RangeArray const&, dip::Range const& >( &dip::ImageReadTIFF ),
           "filename"_a, "imageNumbers"_a = dip::Range{ 0 }, "roi"_a = dip::RangeArray{}, "channels"_a = dip::Range{} );
-   m.def( "ImageReadTIFFSeries", py::overload_cast< dip::StringArray const& >( &dip::ImageReadTIFFSeries ), "filenames"_a );
+   m.def( "ImageReadTIFFLevel", py::overload_cast< dip::String const&, dip::uint, dip::RangeArray const&, dip::Range const&, dip::uint >( &dip::ImageReadTIFFLevel ),
+          "filename"_a, "level"_a, "roi"_a = dip::RangeArray{}, "channels"_a = dip::Range{}, "imageNumber"_a = 0 );
+   m.def( "ImageReadTIFFNumberOfLevels", &dip::ImageReadTIFFNumberOfLevels, "filename"_a, "imageNumber"_a = 0 );
+   m.def( "ImageReadTIFFSeries", []( dip::StringArray const& filenames ) { return dip::ImageReadTIFFSeries( filenames ); }, "filenames"_a );
    m.def( "ImageIsTIFF", &dip::ImageIsTIFF, "filename"_a );
-   m.def( "ImageWriteTIFF", py::overload_cast< dip::Image const&, dip::String const&, dip::String const&, dip::uint >( &dip::ImageWriteTIFF ),
-          "image"_a, "filename"_a, "compression"_a = "", "jpegLevel"_a = 80 );
+   m.def( "ImageWriteTIFF", py::overload_cast< dip::Image const&, dip::String const&, dip::String const&, dip::uint, dip::UnsignedArray const& >( &dip::ImageWriteTIFF ),
+          "image"_a, "filename"_a, "compression"_a = "", "jpegLevel"_a = 80, "tileSize"_a = dip::UnsignedArray{} );
+   m.def( "ImageWriteTIFFPyramid", &dip::ImageWriteTIFFPyramid,
+          "image"_a, "filename"_a, "levels"_a = 0, "compression"_a = "", "jpegLevel"_a = 80, "tileSize"_a = dip::UnsignedArray{ 256 } );
+
+   m.def( "ImageReadNPY", py::overload_cast< dip::String const&, dip::String const& >( &dip::ImageReadNPY ), "filename"_a, "mode"_a = "" );
+   m.def( "ImageIsNPY", &dip::ImageIsNPY, "filename"_a );
+   m.def( "ImageWriteNPY", &dip::ImageWriteNPY, "image"_a, "filename"_a );
+
+   m.def( "ImageReadNRRD", py::overload_cast< dip::String const&, dip::String const& >( &dip::ImageReadNRRD ), "filename"_a, "mode"_a = "" );
+   m.def( "ImageIsNRRD", &dip::ImageIsNRRD, "filename"_a );
+   m.def( "ImageWriteNRRD", &dip::ImageWriteNRRD, "image"_a, "filename"_a );
 
    // diplib/generation.h
    m.def( "FillDelta", &dip::FillDelta, "out"_a, "origin"_a = "" );
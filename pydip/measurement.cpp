@@ -121,7 +121,11 @@ void init_measurement( py::module& m ) {
 
    // Other functions
    m.def( "ObjectToMeasurement", py::overload_cast< dip::Image const&, dip::Measurement::IteratorFeature const& >( &dip::ObjectToMeasurement ), "label"_a, "featureValues"_a );
+   m.def( "ObjectToMeasurement", py::overload_cast< dip::Image const&, dip::Measurement const&, dip::StringArray const&, dip::String const& >( &dip::ObjectToMeasurement ),
+          "label"_a, "measurement"_a, "features"_a = dip::StringArray{}, "scaling"_a = dip::S::DONT_NORMALIZE );
    m.def( "WriteCSV", &dip::WriteCSV, "measurement"_a, "filename"_a, "options"_a = dip::StringSet{} );
+   m.def( "WriteColumnar", &dip::WriteColumnar, "measurement"_a, "filename"_a );
+   m.def( "ReadColumnar", &dip::ReadColumnar, "filename"_a, "features"_a = dip::StringArray{} );
    m.def( "Minimum", py::overload_cast< dip::Measurement::IteratorFeature const& >( &dip::Minimum ), "featureValues"_a  );
    m.def( "Maximum", py::overload_cast< dip::Measurement::IteratorFeature const& >( &dip::Maximum ), "featureValues"_a  );
    m.def( "Percentile", py::overload_cast< dip::Measurement::IteratorFeature const&, dip::dfloat >( &dip::Percentile ), "featureValues"_a, "percentile"_a  );
@@ -85,9 +85,15 @@ distance/gdt.cpp
 distance/vdt.cpp
 file_io/file_io_support.cpp
 file_io/file_io_support.h
+file_io/gzip_index.cpp
+file_io/gzip_index.h
 file_io/ics.cpp
+file_io/npy.cpp
+file_io/nrrd.cpp
+file_io/slab_io.cpp
 file_io/tiff_read.cpp
 file_io/tiff_write.cpp
+file_io/zarr.cpp
 generation/coordinates.cpp
 generation/draw_bandlimited.cpp
 generation/draw_discrete.cpp
@@ -125,9 +131,12 @@ linear/derivative.cpp
 linear/finitediff.cpp
 linear/gaboriir.cpp
 linear/gauss.cpp
+linear/gaussbox.cpp
 linear/gaussiir.cpp
+linear/scale_space.cpp
 linear/separate_filter.cpp
 linear/sharpen.cpp
+linear/sliding_sums.h
 linear/uniform.cpp
 mapping/equalization.cpp
 mapping/lookup_table.cpp
@@ -143,10 +152,12 @@ math/projection.cpp
 math/radial.cpp
 math/select.cpp
 math/statistics.cpp
+math/summed_area_table.cpp
 math/tensor_operators.cpp
 measurement/convex_hull.cpp
 measurement/feature_aspect_ratio_feret.h
 measurement/feature_bending_energy.h
+measurement/feature_bounding_rectangle.h
 measurement/feature_cartesian_box.h
 measurement/feature_center.h
 measurement/feature_circularity.h
@@ -173,6 +184,8 @@ measurement/feature_maximum.h
 measurement/feature_mean.h
 measurement/feature_min_val.h
 measurement/feature_minimum.h
+measurement/feature_minkowski_functionals.cpp
+measurement/feature_minkowski_functionals.h
 measurement/feature_mu.h
 measurement/feature_p2a.h
 measurement/feature_perimeter.h
@@ -18,7 +18,24 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+
 #include "file_io_support.h"
+#include "diplib/library/copy_buffer.h"
+#include "diplib/multithreading.h"
+
+#ifdef _WIN32
+   #define NOMINMAX // windows.h must not define min() and max(), which are conflicting with std::min() and std::max()
+   #include <windows.h>
+#else
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+#endif
 
 namespace dip {
 
@@ -101,4 +118,310 @@ RoiSpec CheckAndConvertRoi(
    return roiSpec;
 }
 
+DataSegment MapFileIntoMemory(
+      String const& filename,
+      dip::uint offset,
+      dip::uint length,
+      void*& origin
+) {
+#ifdef _WIN32
+   HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+   if( file == INVALID_HANDLE_VALUE ) {
+      DIP_THROW_RUNTIME( "Could not open the file for memory mapping" );
+   }
+   LARGE_INTEGER fileSize;
+   if( !GetFileSizeEx( file, &fileSize ) || ( offset + length > static_cast< dip::uint >( fileSize.QuadPart ))) {
+      CloseHandle( file );
+      DIP_THROW_RUNTIME( "File is too short" );
+   }
+   HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+   CloseHandle( file ); // The mapping keeps the file open
+   if( mapping == nullptr ) {
+      DIP_THROW_RUNTIME( "Could not map the file into memory" );
+   }
+   // The view must start at a multiple of the allocation granularity
+   SYSTEM_INFO info;
+   GetSystemInfo( &info );
+   dip::uint start = offset / info.dwAllocationGranularity * info.dwAllocationGranularity;
+   void* base = MapViewOfFile( mapping, FILE_MAP_COPY,
+                               static_cast< DWORD >( static_cast< uint64 >( start ) >> 32 ),
+                               static_cast< DWORD >( start & 0xFFFFFFFFu ),
+                               length + offset - start );
+   CloseHandle( mapping ); // The view keeps the mapping alive
+   if( base == nullptr ) {
+      DIP_THROW_RUNTIME( "Could not map the file into memory" );
+   }
+   origin = static_cast< uint8* >( base ) + ( offset - start );
+   return DataSegment{ base, []( void* ptr ){ UnmapViewOfFile( ptr ); }};
+#else
+   int file = open( filename.c_str(), O_RDONLY );
+   if( file < 0 ) {
+      DIP_THROW_RUNTIME( "Could not open the file for memory mapping" );
+   }
+   struct stat fileStatus;
+   if(( fstat( file, &fileStatus ) != 0 ) || ( offset + length > static_cast< dip::uint >( fileStatus.st_size ))) {
+      close( file );
+      DIP_THROW_RUNTIME( "File is too short" );
+   }
+   // The mapping must start at a multiple of the page size
+   dip::uint pageSize = static_cast< dip::uint >( sysconf( _SC_PAGESIZE ));
+   dip::uint start = offset / pageSize * pageSize;
+   dip::uint mapLength = length + offset - start;
+   void* base = mmap( nullptr, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast< off_t >( start ));
+   close( file ); // The mapping keeps the file open
+   if( base == MAP_FAILED ) {
+      DIP_THROW_RUNTIME( "Could not map the file into memory" );
+   }
+   origin = static_cast< uint8* >( base ) + ( offset - start );
+   return DataSegment{ base, [ mapLength ]( void* ptr ){ munmap( ptr, mapLength ); }};
+#endif
+}
+
+void CopyLinearRange( Image const& image, dip::uint first, dip::uint count, uint8* dest ) {
+   UnsignedArray const& sizes = image.Sizes();
+   IntegerArray const& strides = image.Strides();
+   DataType dataType = image.DataType();
+   dip::uint sizeOf = dataType.SizeOf();
+   dip::uint nDims = sizes.size();
+   if( nDims == 0 ) {
+      DIP_ASSERT(( first == 0 ) && ( count <= 1 ));
+      detail::CopyBuffer( image.Origin(), dataType, 1, 1, dest, dataType, 1, 1, count, 1 );
+      return;
+   }
+   UnsignedArray coords( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      coords[ ii ] = first % sizes[ ii ];
+      first /= sizes[ ii ];
+   }
+   while( count > 0 ) {
+      dip::uint n = std::min( count, sizes[ 0 ] - coords[ 0 ] );
+      detail::CopyBuffer( image.Pointer( coords ), dataType, strides[ 0 ], 1, dest, dataType, 1, 1, n, 1 );
+      dest += n * sizeOf;
+      count -= n;
+      coords[ 0 ] += n;
+      for( dip::uint ii = 0; ( ii < nDims - 1 ) && ( coords[ ii ] == sizes[ ii ] ); ++ii ) {
+         coords[ ii ] = 0;
+         ++coords[ ii + 1 ];
+      }
+   }
+}
+
+void SwapBytes( uint8* data, dip::uint count, dip::uint size ) {
+   for( dip::uint ii = 0; ii < count; ++ii, data += size ) {
+      std::reverse( data, data + size );
+   }
+}
+
+DataType DataTypeFromNumPyTypeString( String const& typestr, bool& swapBytes, char const* fileType ) {
+   DataType dataType;
+   bool supported = typestr.size() >= 3;
+   if( supported ) {
+      char kind = typestr[ 1 ];
+      dip::uint size = std::strtoull( typestr.c_str() + 2, nullptr, 10 );
+      if(( kind == 'b' ) && ( size == 1 )) {
+         dataType = DT_BIN;
+      } else if(( kind == 'u' ) && ( size == 1 )) {
+         dataType = DT_UINT8;
+      } else if(( kind == 'u' ) && ( size == 2 )) {
+         dataType = DT_UINT16;
+      } else if(( kind == 'u' ) && ( size == 4 )) {
+         dataType = DT_UINT32;
+      } else if(( kind == 'i' ) && ( size == 1 )) {
+         dataType = DT_SINT8;
+      } else if(( kind == 'i' ) && ( size == 2 )) {
+         dataType = DT_SINT16;
+      } else if(( kind == 'i' ) && ( size == 4 )) {
+         dataType = DT_SINT32;
+      } else if(( kind == 'f' ) && ( size == 4 )) {
+         dataType = DT_SFLOAT;
+      } else if(( kind == 'f' ) && ( size == 8 )) {
+         dataType = DT_DFLOAT;
+      } else if(( kind == 'c' ) && ( size == 8 )) {
+         dataType = DT_SCOMPLEX;
+      } else if(( kind == 'c' ) && ( size == 16 )) {
+         dataType = DT_DCOMPLEX;
+      } else {
+         supported = false;
+      }
+   }
+   if( !supported ) {
+      DIP_THROW_RUNTIME( String( fileType ) + " file with unsupported data type: " + typestr );
+   }
+   char byteOrder = typestr[ 0 ];
+   swapBytes = ( dataType.SizeOf() > 1 ) && (( byteOrder == '<' ) || ( byteOrder == '>' )) &&
+               (( byteOrder == '<' ) != IsLittleEndianMachine() );
+   return dataType;
+}
+
+String NumPyTypeString( DataType dataType ) {
+   String typestr;
+   switch( dataType ) {
+      case DT_BIN:      typestr = "|b1";  break;
+      case DT_UINT8:    typestr = "|u1";  break;
+      case DT_SINT8:    typestr = "|i1";  break;
+      case DT_UINT16:   typestr = "u2";   break;
+      case DT_SINT16:   typestr = "i2";   break;
+      case DT_UINT32:   typestr = "u4";   break;
+      case DT_SINT32:   typestr = "i4";   break;
+      case DT_SFLOAT:   typestr = "f4";   break;
+      case DT_DFLOAT:   typestr = "f8";   break;
+      case DT_SCOMPLEX: typestr = "c8";   break;
+      case DT_DCOMPLEX: typestr = "c16";  break;
+      default:
+         DIP_THROW( E::DATA_TYPE_NOT_SUPPORTED ); // Should not happen
+   }
+   if( typestr[ 0 ] != '|' ) {
+      typestr = ( IsLittleEndianMachine() ? "<" : ">" ) + typestr;
+   }
+   return typestr;
+}
+
+namespace {
+
+// Size of the chunks that raw pixel data is read and written in, each chunk by one thread
+constexpr dip::uint RAW_CHUNK_SIZE = 8 * 1024 * 1024;
+
+// Reads `length` bytes at byte `offset` of file `filename` into `dest`, in parallel. If `swapSize` is larger than 1,
+// the byte order of each `swapSize` bytes is reversed.
+void ReadFileChunks( String const& filename, dip::uint offset, uint8* dest, dip::uint length, dip::uint swapSize ) {
+   {
+      std::ifstream file( filename, std::ios::binary | std::ios::ate );
+      if( !file ) {
+         DIP_THROW_RUNTIME( "Couldn't open file for reading" );
+      }
+      if( static_cast< dip::uint >( file.tellg() ) < offset + length ) {
+         DIP_THROW_RUNTIME( "File is too short" );
+      }
+   }
+   dip::uint chunkSize = std::max< dip::uint >( RAW_CHUNK_SIZE / swapSize, 1 ) * swapSize; // don't split samples
+   dip::uint nChunks = div_ceil( length, chunkSize );
+   dip::uint nThreads = std::min( GetNumberOfThreads(), nChunks );
+   std::atomic< bool > failed( false );
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      // Each thread has its own file handle
+      std::ifstream file( filename, std::ios::binary );
+      if( !file ) {
+         failed = true;
+      }
+      #pragma omp for schedule( dynamic )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( nChunks ); ++ii ) {
+         if( failed ) {
+            continue;
+         }
+         dip::uint start = static_cast< dip::uint >( ii ) * chunkSize;
+         dip::uint size = std::min( chunkSize, length - start );
+         file.seekg( static_cast< std::streamoff >( offset + start ));
+         file.read( reinterpret_cast< char* >( dest + start ), static_cast< std::streamsize >( size ));
+         if( !file ) {
+            failed = true;
+            continue;
+         }
+         if( swapSize > 1 ) {
+            SwapBytes( dest + start, size / swapSize, swapSize );
+         }
+      }
+   }
+   if( failed ) {
+      DIP_THROW_RUNTIME( "Couldn't read pixel data from file" );
+   }
+}
+
+} // namespace
+
+void ReadRawImageData(
+      Image& out,
+      String const& filename,
+      dip::uint offset,
+      FileInformation const& information,
+      bool swapBytes,
+      bool mapped
+) {
+   DataType dataType = information.dataType;
+   dip::uint sizeOf = dataType.SizeOf();
+   dip::uint tensorElements = information.tensorElements;
+   dip::uint length = information.sizes.product() * tensorElements * sizeOf;
+   if( mapped && !swapBytes && !out.IsProtected() ) {
+      void* origin;
+      DataSegment segment;
+      DIP_STACK_TRACE_THIS( segment = MapFileIntoMemory( filename, offset, length, origin ));
+      IntegerArray strides( information.sizes.size() );
+      dip::sint stride = static_cast< dip::sint >( tensorElements );
+      for( dip::uint ii = 0; ii < strides.size(); ++ii ) {
+         strides[ ii ] = stride;
+         stride *= static_cast< dip::sint >( information.sizes[ ii ] );
+      }
+      out.Strip();
+      out = Image( segment, origin, dataType, information.sizes, strides, Tensor( tensorElements ), 1 );
+   } else {
+      out.ReForge( information.sizes, tensorElements, dataType );
+      // Complex values are swapped per component
+      dip::uint swapSize = swapBytes ? ( dataType.IsComplex() ? sizeOf / 2 : sizeOf ) : 1;
+      if(( out.DataType() == dataType ) && out.HasNormalStrides() ) {
+         DIP_STACK_TRACE_THIS( ReadFileChunks( filename, offset, static_cast< uint8* >( out.Origin() ), length, swapSize ));
+      } else {
+         // `out` is protected or has an external interface, read into a temporary image and copy
+         Image tmp( information.sizes, tensorElements, dataType );
+         DIP_STACK_TRACE_THIS( ReadFileChunks( filename, offset, static_cast< uint8* >( tmp.Origin() ), length, swapSize ));
+         out.Copy( tmp );
+      }
+   }
+   if( out.TensorElements() == tensorElements ) {
+      out.SetColorSpace( information.colorSpace );
+   }
+   out.SetPixelSize( information.pixelSize );
+}
+
+void WriteRawImageData(
+      Image const& c_image,
+      String const& filename,
+      dip::uint offset
+) {
+   DIP_THROW_IF( !c_image.IsForged(), E::IMAGE_NOT_FORGED );
+   Image image = c_image.QuickCopy();
+   if( image.TensorElements() > 1 ) {
+      image.TensorToSpatial( 0 );
+   }
+   dip::uint sizeOf = image.DataType().SizeOf();
+   dip::uint nSamples = image.NumberOfPixels();
+   dip::uint chunkSamples = std::max< dip::uint >( RAW_CHUNK_SIZE / sizeOf, 1 );
+   dip::uint nChunks = div_ceil( nSamples, chunkSamples );
+   dip::uint nThreads = std::min( GetNumberOfThreads(), nChunks );
+   bool direct = image.HasNormalStrides();
+   std::atomic< bool > failed( false );
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      // Each thread has its own file handle, opened without truncating the file
+      std::fstream file( filename, std::ios::binary | std::ios::in | std::ios::out );
+      if( !file ) {
+         failed = true;
+      }
+      std::vector< uint8 > buffer;
+      #pragma omp for schedule( dynamic )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( nChunks ); ++ii ) {
+         if( failed ) {
+            continue;
+         }
+         dip::uint start = static_cast< dip::uint >( ii ) * chunkSamples;
+         dip::uint count = std::min( chunkSamples, nSamples - start );
+         uint8 const* data;
+         if( direct ) {
+            data = static_cast< uint8 const* >( image.Origin() ) + start * sizeOf;
+         } else {
+            buffer.resize( count * sizeOf );
+            CopyLinearRange( image, start, count, buffer.data() );
+            data = buffer.data();
+         }
+         file.seekp( static_cast< std::streamoff >( offset + start * sizeOf ));
+         file.write( reinterpret_cast< char const* >( data ), static_cast< std::streamsize >( count * sizeOf ));
+         if( !file ) {
+            failed = true;
+         }
+      }
+   }
+   if( failed ) {
+      DIP_THROW_RUNTIME( "Couldn't write pixel data to file" );
+   }
+}
+
 } // namespace
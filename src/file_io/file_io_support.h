@@ -21,6 +21,8 @@
 #ifndef DIP_FILE_IO_SUPPORT_H
 #define DIP_FILE_IO_SUPPORT_H
 
+#include <memory>
+
 #include "diplib.h"
 #include "diplib/file_io.h"
 
@@ -48,6 +50,128 @@ RoiSpec CheckAndConvertRoi(
       dip::uint nDims
 );
 
+// Maps `length` bytes of the file `filename`, starting at byte `offset`, into memory. `origin` is set to point at
+// byte `offset`. The mapping is copy-on-write: the data can be modified, but changes are not written to the file.
+// The returned data segment unmaps the file when the last image referencing it is destroyed.
+DataSegment MapFileIntoMemory(
+      String const& filename,
+      dip::uint offset,
+      dip::uint length,
+      void*& origin
+);
+
+// Copies `count` samples of `image`, starting at linear index `first`, to `dest`. Linear indices are computed
+// as if `image` had normal strides, without considering the tensor dimension.
+void CopyLinearRange( Image const& image, dip::uint first, dip::uint count, uint8* dest );
+
+// True if this machine stores multi-byte values with the least significant byte first
+inline bool IsLittleEndianMachine() {
+   uint16 test = 1;
+   return *reinterpret_cast< uint8* >( &test ) == 1;
+}
+
+// Reverses the byte order of `count` values of `size` bytes each
+void SwapBytes( uint8* data, dip::uint count, dip::uint size );
+
+// Returns the data type for the NumPy array-protocol type string `typestr` (such as "<u2"), as used in NPY and Zarr
+// files. `swapBytes` is set if the values are stored in the opposite byte order from this machine. Throws if the
+// type is not supported; `fileType` is used in the error message.
+DataType DataTypeFromNumPyTypeString( String const& typestr, bool& swapBytes, char const* fileType );
+
+#ifdef DIP__HAS_TIFF
+// Sets the libtiff error and warning handlers, once for the whole program. Call before opening a TIFF file.
+void SetTIFFHandlers();
+#endif
+
+// Returns the NumPy array-protocol type string for `dataType`, in the byte order of this machine
+String NumPyTypeString( DataType dataType );
+
+// Reads the pixel data for the image described by `information` from file `filename`, where it is stored
+// uncompressed starting at byte `offset`, with the tensor dimension first and then the image dimensions in
+// order (normal strides). If `swapBytes`, samples are stored in the opposite byte order from this machine.
+// Large images are read in chunks, in parallel. If `mapped`, the file is mapped into memory instead, if
+// possible; see `dip::ImageReadICS`. `out` is forged with normal strides if not protected, and gets the data
+// type, color space and pixel size in `information`.
+void ReadRawImageData(
+      Image& out,
+      String const& filename,
+      dip::uint offset,
+      FileInformation const& information,
+      bool swapBytes,
+      bool mapped
+);
+
+// Writes the pixel data of `image` uncompressed to file `filename` starting at byte `offset`, with the tensor
+// dimension first and then the image dimensions in order, in the byte order of this machine. The file must exist,
+// its contents before `offset` are preserved. Large images are written in chunks, in parallel.
+void WriteRawImageData(
+      Image const& image,
+      String const& filename,
+      dip::uint offset
+);
+
+// Reads an image from file a few planes at the time, in order along the last image dimension. This is the interface
+// used by `dip::ImageSlabReader` to read the various file formats.
+class ImagePlaneSource {
+   public:
+      virtual ~ImagePlaneSource() = default;
+
+      // Information about the image in the file
+      FileInformation const& Information() const { return information_; }
+
+      // Forges `out` to hold `planes` planes, with the memory layout that `ReadPlanes` can fill most efficiently
+      virtual void ForgePlanes( Image& out, dip::uint planes ) {
+         UnsignedArray sizes = information_.sizes;
+         sizes.back() = planes;
+         out.ReForge( sizes, information_.tensorElements, information_.dataType );
+         out.SetColorSpace( information_.colorSpace );
+         out.SetPixelSize( information_.pixelSize );
+      }
+
+      // Reads the next `dest.Sizes().back()` planes into `dest`, which has the sizes, tensor and data type
+      // of the file, except along the last dimension
+      virtual void ReadPlanes( Image& dest ) = 0;
+
+   protected:
+      FileInformation information_;
+};
+
+// Writes an image to file a few planes at the time, in order along the last image dimension. This is the interface
+// used by `dip::ImageSlabWriter` to write the various file formats.
+class ImagePlaneSink {
+   public:
+      virtual ~ImagePlaneSink() = default;
+
+      // Writes the next `planes.Sizes().back()` planes
+      virtual void WritePlanes( Image const& planes ) = 0;
+
+      // Completes the file. Must be called after all planes have been written.
+      virtual void Close() = 0;
+};
+
+// Opens an ICS file for reading planes. Defined in `ics.cpp`.
+std::unique_ptr< ImagePlaneSource > OpenICSPlaneSource( String const& filename );
+
+// Opens a multi-page TIFF file for reading planes, each page is a plane. Defined in `tiff_read.cpp`.
+std::unique_ptr< ImagePlaneSource > OpenTIFFPlaneSource( String const& filename );
+
+// Creates an ICS file for writing planes. `image` is a raw image with the sizes, tensor, data type, color space and
+// pixel size of the image to write. `options` are as in `dip::ImageWriteICS`. Defined in `ics.cpp`.
+std::unique_ptr< ImagePlaneSink > CreateICSPlaneSink(
+      String const& filename,
+      Image const& image,
+      StringArray const& history,
+      StringSet const& options
+);
+
+// Creates a multi-page TIFF file for writing planes, each plane becomes a page. `image` is a raw image with the
+// sizes, tensor, data type, color space and pixel size of the image to write. Defined in `tiff_write.cpp`.
+std::unique_ptr< ImagePlaneSink > CreateTIFFPlaneSink(
+      String const& filename,
+      Image const& image,
+      String const& compression
+);
+
 } // namespace dip
 
 #endif //DIP_FILE_IO_SUPPORT_H
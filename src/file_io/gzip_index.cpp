@@ -0,0 +1,329 @@
+/*
+ * DIPlib 3.0
+ * This file contains functions for random access into gzip streams.
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The approach here follows that of `zran.c` in the zlib distribution: while decompressing the stream once,
+// we record the state at deflate block boundaries. This state consists of the position in the compressed
+// stream (in bits) and the last 32 kiB of uncompressed data, which the next block can reference. With this
+// information, decompression can start at any of these access points.
+
+#ifdef DIP__HAS_ZLIB
+
+#include "gzip_index.h"
+
+namespace dip {
+
+namespace {
+
+constexpr dip::uint WINDOW_SIZE = 32768;  // the maximum distance of a back reference in a deflate stream
+constexpr dip::uint INPUT_CHUNK = 65536;  // how much compressed data we read at once
+
+constexpr char INDEX_MAGIC[ 8 ] = { 'D', 'I', 'P', 'G', 'Z', 'I', 'X', '1' };
+
+void WriteUInt64( std::ostream& file, dip::uint value ) {
+   std::uint64_t v = value;
+   for( dip::uint ii = 0; ii < 8; ++ii ) {
+      file.put( static_cast< char >( v & 0xFFu ));
+      v >>= 8;
+   }
+}
+
+dip::uint ReadUInt64( std::istream& file ) {
+   std::uint64_t v = 0;
+   for( dip::uint ii = 0; ii < 8; ++ii ) {
+      v |= static_cast< std::uint64_t >( static_cast< uint8 >( file.get() )) << ( 8 * ii );
+   }
+   return static_cast< dip::uint >( v );
+}
+
+dip::uint FileSize( std::istream& file ) {
+   file.seekg( 0, std::ios::end );
+   return static_cast< dip::uint >( file.tellg() );
+}
+
+} // namespace
+
+void WriteGzipIndex( GzipIndex const& index, String const& filename ) {
+   std::ofstream file( filename, std::ios::binary | std::ios::trunc );
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't open index file for writing" );
+   }
+   file.write( INDEX_MAGIC, 8 );
+   WriteUInt64( file, index.offset );
+   WriteUInt64( file, index.fileSize );
+   WriteUInt64( file, index.dataSize );
+   WriteUInt64( file, index.points.size() );
+   for( auto const& point : index.points ) {
+      WriteUInt64( file, point.uncompressed );
+      WriteUInt64( file, point.compressed );
+      WriteUInt64( file, point.bits );
+      WriteUInt64( file, point.window.size() );
+      file.write( reinterpret_cast< char const* >( point.window.data() ), static_cast< std::streamsize >( point.window.size() ));
+   }
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't write index file" );
+   }
+}
+
+bool ReadGzipIndex( String const& filename, GzipIndex& index ) {
+   std::ifstream file( filename, std::ios::binary );
+   if( !file ) {
+      return false;
+   }
+   char magic[ 8 ];
+   file.read( magic, 8 );
+   if( !file || !std::equal( magic, magic + 8, INDEX_MAGIC )) {
+      return false;
+   }
+   index.offset = ReadUInt64( file );
+   index.fileSize = ReadUInt64( file );
+   index.dataSize = ReadUInt64( file );
+   dip::uint nPoints = ReadUInt64( file );
+   if( !file ) {
+      return false;
+   }
+   index.points.clear();
+   for( dip::uint ii = 0; ii < nPoints; ++ii ) {
+      GzipAccessPoint point;
+      point.uncompressed = ReadUInt64( file );
+      point.compressed = ReadUInt64( file );
+      point.bits = ReadUInt64( file );
+      dip::uint windowSize = ReadUInt64( file );
+      if( !file || ( point.bits > 7 ) || ( windowSize > WINDOW_SIZE )) {
+         return false;
+      }
+      point.window.resize( windowSize );
+      file.read( reinterpret_cast< char* >( point.window.data() ), static_cast< std::streamsize >( windowSize ));
+      if( !file || ( !index.points.empty() && ( point.uncompressed < index.points.back().uncompressed ))) {
+         return false;
+      }
+      index.points.push_back( std::move( point ));
+   }
+   // Decompression of any part of the data must be able to start at an access point
+   return !index.points.empty() && ( index.points.front().uncompressed == 0 );
+}
+
+GzipIndex BuildGzipIndex( String const& filename, dip::uint offset, dip::uint spacing ) {
+   std::ifstream file( filename, std::ios::binary );
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't open file" );
+   }
+   GzipIndex index;
+   index.offset = offset;
+   index.fileSize = FileSize( file );
+   file.seekg( static_cast< std::streamoff >( offset ));
+
+   z_stream stream{};
+   if( inflateInit2( &stream, 32 + MAX_WBITS ) != Z_OK ) { // 32: parse the zlib or gzip header
+      DIP_THROW_RUNTIME( "Couldn't initialize decompression" );
+   }
+   std::vector< uint8 > input( INPUT_CHUNK );
+   std::vector< uint8 > window( WINDOW_SIZE ); // circular buffer with the last uncompressed data
+   dip::uint totalIn = 0;
+   dip::uint totalOut = 0;
+   dip::uint last = 0;
+   int result = Z_OK;
+   do {
+      file.read( reinterpret_cast< char* >( input.data() ), static_cast< std::streamsize >( INPUT_CHUNK ));
+      stream.avail_in = static_cast< uInt >( file.gcount() );
+      if( stream.avail_in == 0 ) {
+         inflateEnd( &stream );
+         DIP_THROW_RUNTIME( "Compressed data is truncated" );
+      }
+      stream.next_in = input.data();
+      do {
+         if( stream.avail_out == 0 ) {
+            stream.avail_out = static_cast< uInt >( WINDOW_SIZE );
+            stream.next_out = window.data();
+         }
+         totalIn += stream.avail_in;
+         totalOut += stream.avail_out;
+         result = inflate( &stream, Z_BLOCK ); // stops at the end of each deflate block
+         totalIn -= stream.avail_in;
+         totalOut -= stream.avail_out;
+         if(( result != Z_OK ) && ( result != Z_STREAM_END ) && ( result != Z_BUF_ERROR )) {
+            inflateEnd( &stream );
+            DIP_THROW_RUNTIME( "Compressed data is corrupt" );
+         }
+         if( result == Z_STREAM_END ) {
+            break;
+         }
+         // At the end of a block that is not the last one, we record an access point
+         if(( stream.data_type & 128 ) && !( stream.data_type & 64 ) &&
+            (( totalOut == 0 ) || ( totalOut - last > spacing ))) {
+            GzipAccessPoint point;
+            point.uncompressed = totalOut;
+            point.compressed = offset + totalIn;
+            point.bits = static_cast< dip::uint >( stream.data_type & 7 );
+            dip::uint size = std::min( totalOut, WINDOW_SIZE );
+            dip::uint end = WINDOW_SIZE - stream.avail_out; // where the next output byte goes
+            point.window.resize( size );
+            for( dip::uint ii = 0; ii < size; ++ii ) {
+               point.window[ ii ] = window[ ( end + WINDOW_SIZE - size + ii ) % WINDOW_SIZE ];
+            }
+            index.points.push_back( std::move( point ));
+            last = totalOut;
+         }
+      } while( stream.avail_in != 0 );
+   } while( result != Z_STREAM_END );
+   inflateEnd( &stream );
+   index.dataSize = totalOut;
+   return index;
+}
+
+GzipIndexedReader::GzipIndexedReader( String const& filename, GzipIndex index )
+      : file_( filename, std::ios::binary ), index_( std::move( index )), input_( INPUT_CHUNK ), discard_( WINDOW_SIZE ) {
+   DIP_THROW_IF( index_.points.empty(), "Empty gzip index" );
+   if( !file_ ) {
+      DIP_THROW_RUNTIME( "Couldn't open file" );
+   }
+}
+
+GzipIndexedReader::~GzipIndexedReader() {
+   if( active_ ) {
+      inflateEnd( &stream_ );
+   }
+}
+
+void GzipIndexedReader::Read( dip::uint offset, uint8* dest, dip::uint length ) {
+   DIP_THROW_IF( offset + length > index_.dataSize, E::INDEX_OUT_OF_RANGE );
+   // Find the last access point at or before `offset`
+   auto it = std::upper_bound( index_.points.begin(), index_.points.end(), offset,
+                               []( dip::uint value, GzipAccessPoint const& point ) { return value < point.uncompressed; } );
+   if( it == index_.points.begin() ) {
+      DIP_THROW_RUNTIME( "Invalid gzip index: no access point at the start of the data" );
+   }
+   GzipAccessPoint const& point = *( it - 1 );
+   // Continue from where we are if we don't pass that access point on the way
+   if( !active_ || ( position_ > offset ) || ( position_ < point.uncompressed )) {
+      Restart( point );
+   }
+   Inflate( nullptr, offset - position_ );
+   Inflate( dest, length );
+}
+
+void GzipIndexedReader::Restart( GzipAccessPoint const& point ) {
+   if( active_ ) {
+      inflateEnd( &stream_ );
+      active_ = false;
+   }
+   stream_ = z_stream{};
+   if( inflateInit2( &stream_, -MAX_WBITS ) != Z_OK ) { // raw deflate data, no header
+      DIP_THROW_RUNTIME( "Couldn't initialize decompression" );
+   }
+   active_ = true;
+   file_.clear();
+   file_.seekg( static_cast< std::streamoff >( point.compressed - ( point.bits ? 1 : 0 )));
+   if( point.bits ) {
+      int byte = file_.get();
+      if( byte == EOF ) {
+         DIP_THROW_RUNTIME( "Compressed data is truncated" );
+      }
+      inflatePrime( &stream_, static_cast< int >( point.bits ), byte >> ( 8 - point.bits ));
+   }
+   if( !point.window.empty() ) {
+      inflateSetDictionary( &stream_, point.window.data(), static_cast< uInt >( point.window.size() ));
+   }
+   position_ = point.uncompressed;
+}
+
+void GzipIndexedReader::Inflate( uint8* dest, dip::uint length ) {
+   while( length > 0 ) {
+      if( stream_.avail_in == 0 ) {
+         file_.read( reinterpret_cast< char* >( input_.data() ), static_cast< std::streamsize >( INPUT_CHUNK ));
+         stream_.avail_in = static_cast< uInt >( file_.gcount() );
+         stream_.next_in = input_.data();
+         if( stream_.avail_in == 0 ) {
+            DIP_THROW_RUNTIME( "Compressed data is truncated" );
+         }
+      }
+      dip::uint chunk = dest ? std::min< dip::uint >( length, std::numeric_limits< uInt >::max() )
+                             : std::min( length, WINDOW_SIZE );
+      stream_.next_out = dest ? dest : discard_.data();
+      stream_.avail_out = static_cast< uInt >( chunk );
+      int result = inflate( &stream_, Z_NO_FLUSH );
+      if(( result != Z_OK ) && ( result != Z_BUF_ERROR ) && ( result != Z_STREAM_END )) {
+         DIP_THROW_RUNTIME( "Compressed data is corrupt" );
+      }
+      dip::uint produced = chunk - stream_.avail_out;
+      if(( result == Z_STREAM_END ) && ( produced < length )) {
+         DIP_THROW_RUNTIME( "Compressed data is truncated" );
+      }
+      if( dest ) {
+         dest += produced;
+      }
+      length -= produced;
+      position_ += produced;
+   }
+}
+
+} // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+#include "doctest.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing random access into gzip streams" ) {
+   // A gzip file with data that compresses into many deflate blocks with back references
+   dip::uint size = 3 * 1024 * 1024;
+   std::vector< dip::uint8 > data( size );
+   dip::uint32 state = 1;
+   for( dip::uint ii = 0; ii < size; ++ii ) {
+      state = state * 1103515245u + 12345u;
+      data[ ii ] = static_cast< dip::uint8 >(( state >> 16 ) % 16 + ( ii / 100 ) % 8 );
+   }
+   char const* filename = "test_gzip_index.gz";
+   gzFile gz = gzopen( filename, "wb6" );
+   DOCTEST_REQUIRE( gz != nullptr );
+   gzwrite( gz, data.data(), static_cast< unsigned >( size ));
+   gzclose( gz );
+
+   dip::GzipIndex index = dip::BuildGzipIndex( filename, 0, 256 * 1024 );
+   DOCTEST_CHECK( index.dataSize == size );
+   DOCTEST_CHECK( index.points.size() > 4 );
+   DOCTEST_CHECK( index.points[ 0 ].uncompressed == 0 );
+   dip::WriteGzipIndex( index, dip::GzipIndexFileName( filename ));
+   dip::GzipIndex index2;
+   DOCTEST_REQUIRE( dip::ReadGzipIndex( dip::GzipIndexFileName( filename ), index2 ));
+   DOCTEST_CHECK( index2.points.size() == index.points.size() );
+   DOCTEST_CHECK( index2.points.back().window == index.points.back().window );
+
+   dip::GzipIndexedReader reader( filename, std::move( index2 ));
+   std::vector< dip::uint8 > buffer( 1000 );
+   bool match = true;
+   for( dip::uint offset : { dip::uint( 2900000 ), dip::uint( 2950000 ), dip::uint( 10 ), dip::uint( 1500000 ), size - 1000 } ) {
+      reader.Read( offset, buffer.data(), buffer.size() );
+      match &= std::equal( buffer.begin(), buffer.end(), data.begin() + static_cast< dip::sint >( offset ));
+   }
+   DOCTEST_CHECK( match );
+   DOCTEST_CHECK_THROWS( reader.Read( size - 10, buffer.data(), buffer.size() ));
+
+   // An index without an access point at the start of the data is rejected
+   index.points[ 0 ].uncompressed = 1;
+   dip::WriteGzipIndex( index, dip::GzipIndexFileName( filename ));
+   DOCTEST_CHECK( !dip::ReadGzipIndex( dip::GzipIndexFileName( filename ), index2 ));
+   dip::GzipIndexedReader badReader( filename, std::move( index ));
+   DOCTEST_CHECK_THROWS( badReader.Read( 0, buffer.data(), buffer.size() ));
+
+   std::remove( filename );
+   std::remove( dip::GzipIndexFileName( filename ).c_str() );
+}
+
+#endif // DIP__ENABLE_DOCTEST
+
+#endif // DIP__HAS_ZLIB
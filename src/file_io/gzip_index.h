@@ -0,0 +1,100 @@
+/*
+ * DIPlib 3.0
+ * This file contains declarations for random access into gzip streams.
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIP_GZIP_INDEX_H
+#define DIP_GZIP_INDEX_H
+
+#ifdef DIP__HAS_ZLIB
+
+#include <fstream>
+
+#include "diplib.h"
+
+#include <zlib.h>
+
+namespace dip {
+
+// A location in a gzip stream where decompression can start: `compressed` is the offset in the file of the first
+// full byte of the deflate block that starts at uncompressed offset `uncompressed`. The `bits` lowest bits of the
+// previous byte also belong to this block. `window` is the uncompressed data preceding this point (up to 32 kiB),
+// needed to resolve back references. If the compressed stream doesn't reference data before this point, `window`
+// is empty.
+struct GzipAccessPoint {
+   dip::uint uncompressed = 0;
+   dip::uint compressed = 0;
+   dip::uint bits = 0;
+   std::vector< uint8 > window;
+};
+
+// The index of a gzip stream. `offset` is where the gzip stream starts in its file, `fileSize` the size of that
+// file, and `dataSize` the size of the uncompressed data. These three are used to check that the index matches
+// the file. Access points are sorted by offset.
+struct GzipIndex {
+   dip::uint offset = 0;
+   dip::uint fileSize = 0;
+   dip::uint dataSize = 0;
+   std::vector< GzipAccessPoint > points;
+};
+
+// The name of the index file that belongs to data file `filename`.
+inline String GzipIndexFileName( String const& filename ) {
+   return filename + ".gzidx";
+}
+
+// Writes `index` to file `filename`.
+void WriteGzipIndex( GzipIndex const& index, String const& filename );
+
+// Reads an index from file `filename`. Returns false if the file doesn't exist, is not an index file, or is not
+// a valid index (e.g. its first access point is not at the start of the data).
+bool ReadGzipIndex( String const& filename, GzipIndex& index );
+
+// Decompresses the gzip stream that starts at byte `offset` of file `filename`, and creates an index with
+// access points spaced at least `spacing` bytes of uncompressed data apart.
+GzipIndex BuildGzipIndex( String const& filename, dip::uint offset, dip::uint spacing );
+
+// Reads arbitrary portions of an indexed gzip stream. Reads at increasing offsets continue decompressing from
+// the previous read if that is cheaper than starting at an access point.
+class GzipIndexedReader {
+   public:
+      GzipIndexedReader( String const& filename, GzipIndex index );
+      ~GzipIndexedReader();
+      GzipIndexedReader( GzipIndexedReader const& ) = delete;
+      GzipIndexedReader& operator=( GzipIndexedReader const& ) = delete;
+
+      // Reads `length` bytes of uncompressed data, starting at uncompressed offset `offset`, into `dest`.
+      void Read( dip::uint offset, uint8* dest, dip::uint length );
+
+   private:
+      void Restart( GzipAccessPoint const& point );
+      void Inflate( uint8* dest, dip::uint length ); // `dest` can be null to skip data
+
+      std::ifstream file_;
+      GzipIndex index_;
+      z_stream stream_{};
+      bool active_ = false;
+      dip::uint position_ = 0; // uncompressed offset of the next byte `stream_` produces
+      std::vector< uint8 > input_;
+      std::vector< uint8 > discard_;
+};
+
+} // namespace dip
+
+#endif // DIP__HAS_ZLIB
+
+#endif //DIP_GZIP_INDEX_H
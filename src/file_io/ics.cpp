@@ -21,15 +21,26 @@
 #ifdef DIP__HAS_ICS
 
 #include <cstdlib> // std::strtoul
+#include <cstdio> // std::remove
+#include <atomic>
+#include <fstream>
+#include <memory>
 
 #include "diplib.h"
 #include "diplib/file_io.h"
 #include "diplib/generic_iterators.h"
 #include "diplib/library/copy_buffer.h"
+#include "diplib/multithreading.h"
 
 #include "file_io_support.h"
+#include "gzip_index.h"
 
 #include "libics.h"
+#include "libics_ll.h"
+
+#ifdef DIP__HAS_ZLIB
+#include <zlib.h>
+#endif
 
 // Fix strcasecmp for MSVC compilation
 #ifdef _MSC_VER
@@ -277,6 +288,18 @@ class IcsFile {
             }
          }
       }
+      // When writing, closing the file writes the header and the pixel data. If no pixel data was given, libics
+      // writes only the header, and reports the missing data, which we ignore here. The caller then writes the
+      // pixel data.
+      void CloseHeaderOnly() {
+         if( ics_ ) {
+            Ics_Error error = IcsClose( ics_ );
+            ics_ = nullptr;
+            if(( error != IcsErr_Ok ) && ( error != IcsErr_MissingData )) {
+               DIP_THROW_RUNTIME( String( "Couldn't close ICS file: " ) + IcsGetErrorText( error ) );
+            }
+         }
+      }
       // Implicit cast to ICS*
       operator ICS*() { return ics_; }
    private:
@@ -400,6 +423,155 @@ GetICSInfoData GetICSInfo( IcsFile& icsFile ) {
    return data;
 }
 
+// Strides of the pixel data in the file, in the order of the image dimensions, with the tensor dimension last
+// if there is one.
+IntegerArray ICSFileStrides( GetICSInfoData const& data ) {
+   UnsignedArray tmp( data.fileSizes.size() );
+   tmp[ 0 ] = 1;
+   for( dip::uint ii = 1; ii < tmp.size(); ++ii ) {
+      tmp[ ii ] = tmp[ ii - 1 ] * data.fileSizes[ ii - 1 ];
+   }
+   IntegerArray strides( tmp.size() );
+   for( dip::uint ii = 0; ii < tmp.size(); ++ii ) {
+      strides[ ii ] = static_cast< dip::sint >( tmp[ data.order[ ii ]] );
+   }
+   return strides;
+}
+
+// Sets the tensor shape of `out` as recorded in the history of the ICS file, if it's there.
+void SetICSTensorShape( IcsFile& icsFile, Image& out ) {
+   Ics_HistoryIterator it;
+   Ics_Error e = IcsNewHistoryIterator( icsFile, &it, "tensor" );
+   if( e == IcsErr_Ok ) {
+      char line[ ICS_LINE_LENGTH ];
+      e = IcsGetHistoryKeyValueI( icsFile, &it, nullptr, line );
+      if( e == IcsErr_Ok ) {
+         // parse `value`
+         char* ptr = std::strtok( line, "\t" );
+         if( ptr != nullptr ) {
+            char* shape = ptr;
+            ptr = std::strtok( nullptr, "\t" );
+            if( ptr != nullptr ) {
+               dip::uint rows = std::stoul( ptr );
+               ptr = std::strtok( nullptr, "\t" );
+               if( ptr != nullptr ) {
+                  dip::uint columns = std::stoul( ptr );
+                  try {
+                     out.ReshapeTensor( Tensor{ shape, rows, columns } );
+                  } catch ( Error const& ) {
+                     // Let this error slip, we don't really care
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+// Returns true if the samples in the ICS file are stored in the byte order of this machine. `bytes` is the
+// size of a sample (or of a complex sample's component).
+bool IcsHasNativeByteOrder( ICS const* ics, dip::uint bytes ) {
+   uint16 test = 1;
+   bool littleEndian = *reinterpret_cast< uint8* >( &test ) == 1;
+   for( dip::uint ii = 0; ii < bytes; ++ii ) {
+      if( ics->byteOrder[ ii ] == 0 ) {
+         return true; // Byte order not given, libics doesn't reorder either
+      }
+      dip::uint native = littleEndian ? ii + 1 : bytes - ii;
+      if( static_cast< dip::uint >( ics->byteOrder[ ii ] ) != native ) {
+         return false;
+      }
+   }
+   return true;
+}
+
+// Finds where the pixel data is: in the ".ids" file for version 1, in the file given by the header for version 2.
+// `dataFile` must have space for `ICS_MAXPATHLEN` characters. Returns false if the header doesn't say.
+bool GetICSDataFile( ICS const* ics, char* dataFile, dip::uint& offset ) {
+   offset = 0;
+   if( ics->version == 1 ) {
+      IcsGetIdsName( dataFile, ics->filename );
+   } else {
+      if( ics->srcFile[ 0 ] == '\0' ) {
+         return false;
+      }
+      std::strncpy( dataFile, ics->srcFile, ICS_MAXPATHLEN );
+      offset = static_cast< dip::uint >( ics->srcOffset );
+   }
+   return true;
+}
+
+#ifdef DIP__HAS_ZLIB
+
+// Returns a reader for random access into the gzip-compressed pixel data, if the file has a valid seek index.
+// Returns null otherwise.
+std::unique_ptr< GzipIndexedReader > OpenICSGzipIndex( ICS const* ics, DataType dataType ) {
+   dip::uint sizeOf = dataType.SizeOf();
+   if(( ics->compression != IcsCompr_gzip ) ||
+      !IcsHasNativeByteOrder( ics, dataType.IsComplex() ? sizeOf / 2 : sizeOf )) {
+      return nullptr;
+   }
+   char dataFile[ ICS_MAXPATHLEN ];
+   dip::uint offset;
+   if( !GetICSDataFile( ics, dataFile, offset )) {
+      return nullptr;
+   }
+   GzipIndex index;
+   if( !ReadGzipIndex( GzipIndexFileName( dataFile ), index )) {
+      return nullptr;
+   }
+   // Ignore the index if it doesn't match the file
+   std::ifstream file( dataFile, std::ios::binary | std::ios::ate );
+   if( !file || ( static_cast< dip::uint >( file.tellg() ) != index.fileSize ) ||
+       ( index.offset != offset ) || ( index.dataSize != IcsGetDataSize( ics ))) {
+      return nullptr;
+   }
+   return std::make_unique< GzipIndexedReader >( dataFile, std::move( index ));
+}
+
+#endif // DIP__HAS_ZLIB
+
+// Maps the pixel data of an uncompressed ICS file into memory, and returns an image that references the ROI
+// given by `roiSpec` within it. `strides` are the strides of the data in the file, in the order of the image
+// dimensions, with the tensor dimension last if there is one. Returns a raw image if the data cannot be mapped.
+Image MapICSData(
+      IcsFile& icsFile,
+      GetICSInfoData const& data,
+      RoiSpec const& roiSpec,
+      IntegerArray const& strides
+) {
+   ICS* ics = icsFile;
+   DataType dataType = data.fileInformation.dataType;
+   dip::uint sizeOf = dataType.SizeOf();
+   if(( ics->compression != IcsCompr_uncompressed ) ||
+      !IcsHasNativeByteOrder( ics, dataType.IsComplex() ? sizeOf / 2 : sizeOf )) {
+      return {};
+   }
+   char dataFile[ ICS_MAXPATHLEN ];
+   dip::uint offset;
+   if( !GetICSDataFile( ics, dataFile, offset )) {
+      return {};
+   }
+   void* base;
+   DataSegment segment;
+   DIP_STACK_TRACE_THIS( segment = MapFileIntoMemory( dataFile, offset, IcsGetDataSize( ics ), base ));
+   // Construct a view on the ROI within the mapped data
+   dip::uint nDims = roiSpec.sizes.size();
+   dip::sint origin = 0;
+   IntegerArray roiStrides( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      origin += static_cast< dip::sint >( roiSpec.roi[ ii ].Offset() ) * strides[ ii ];
+      roiStrides[ ii ] = static_cast< dip::sint >( roiSpec.roi[ ii ].step ) * strides[ ii ];
+   }
+   dip::sint tensorStride = 1;
+   if( data.fileInformation.tensorElements > 1 ) {
+      origin += static_cast< dip::sint >( roiSpec.channels.Offset() ) * strides.back();
+      tensorStride = static_cast< dip::sint >( roiSpec.channels.step ) * strides.back();
+   }
+   return Image( segment, static_cast< uint8* >( base ) + origin * static_cast< dip::sint >( sizeOf ), dataType,
+                 roiSpec.sizes, roiStrides, Tensor( roiSpec.tensorElements ), tensorStride );
+}
+
 } // namespace
 
 FileInformation ImageReadICS(
@@ -409,8 +581,15 @@ FileInformation ImageReadICS(
       Range channels,
       String const& mode
 ) {
-   bool fast;
-   DIP_STACK_TRACE_THIS( fast = BooleanFromString( mode, "fast", "" ));
+   bool fast = false;
+   bool mapped = false;
+   if( mode == "fast" ) {
+      fast = true;
+   } else if( mode == "mmap" ) {
+      mapped = true;
+   } else if( !mode.empty() ) {
+      DIP_THROW_INVALID_FLAG( mode );
+   }
 
    // open the ICS file
    IcsFile icsFile( filename, "r" );
@@ -434,20 +613,27 @@ FileInformation ImageReadICS(
    if( !roiSpec.isFullImage || !roiSpec.isAllChannels ) {
       fast = false;
    }
+   roi = roiSpec.roi;
 
    // prepare the strides of the image on file (including tensor dimension)
-   UnsignedArray tmp( data.fileSizes.size() );
-   tmp[ 0 ] = 1;
-   for( dip::uint ii = 1; ii < tmp.size(); ++ii ) {
-      tmp[ ii ] = tmp[ ii - 1 ] * data.fileSizes[ ii - 1 ];
-   }
-   IntegerArray strides( tmp.size() );
-   for( dip::uint ii = 0; ii < tmp.size(); ++ii ) {
-      strides[ ii ] = static_cast< dip::sint >( tmp[ data.order[ ii ]] );
-   }
+   IntegerArray strides = ICSFileStrides( data );
    // if there's a tensor dimension, it's sorted last in `strides`.
    //std::cout << "[ImageReadICS] strides = " << strides << std::endl;
 
+   // if "mmap", try to map the file into memory and use it as the pixel data
+   if( mapped && !out.IsProtected() ) {
+      Image image;
+      DIP_STACK_TRACE_THIS( image = MapICSData( icsFile, data, roiSpec, strides ));
+      if( image.IsForged() ) {
+         out.Strip();
+         out = std::move( image );
+      } else {
+         mapped = false;
+      }
+   } else {
+      mapped = false;
+   }
+
    // if "fast", try to match strides with those in the file
    if( fast ) {
       IntegerArray reqStrides( nDims );
@@ -477,40 +663,22 @@ FileInformation ImageReadICS(
 
    // get tensor shape if necessary
    if(( roiSpec.tensorElements > 1 ) && ( roiSpec.tensorElements == data.fileInformation.tensorElements )) {
-      Ics_HistoryIterator it;
-      Ics_Error e = IcsNewHistoryIterator( icsFile, &it, "tensor" );
-      if( e == IcsErr_Ok ) {
-         char line[ ICS_LINE_LENGTH ];
-         e = IcsGetHistoryKeyValueI( icsFile, &it, nullptr, line );
-         if( e == IcsErr_Ok ) {
-            // parse `value`
-            char* ptr = std::strtok( line, "\t" );
-            if( ptr != nullptr ) {
-               char* shape = ptr;
-               ptr = std::strtok( nullptr, "\t" );
-               if( ptr != nullptr ) {
-                  dip::uint rows = std::stoul( ptr );
-                  ptr = std::strtok( nullptr, "\t" );
-                  if( ptr != nullptr ) {
-                     dip::uint columns = std::stoul( ptr );
-                     try {
-                        out.ReshapeTensor( Tensor{ shape, rows, columns } );
-                     } catch ( Error const& ) {
-                        // Let this error slip, we don't really care
-                     }
-                  }
-               }
-            }
-         }
-      }
+      SetICSTensorShape( icsFile, out );
    }
    //std::cout << "[ImageReadICS] out = " << out << std::endl;
 
+   if( mapped ) {
+      // The pixel data is in the mapped file, we're done
+      out.Mirror( roiSpec.mirror );
+      icsFile.Close();
+      return data.fileInformation;
+   }
+
    // make a quick copy and place the tensor dimension at the back
    Image outRef = out.QuickCopy();
    if( data.fileInformation.tensorElements > 1 ) {
       outRef.TensorToSpatial();
-      roi.push_back( channels );
+      roi.push_back( roiSpec.channels );
       sizes.push_back( roiSpec.tensorElements );
       ++nDims;
    }
@@ -562,6 +730,11 @@ FileInformation ImageReadICS(
       dip::uint bufSize = sizeOf * (( outRef.Size( procDim ) - 1 ) * roi[ procDim ].step + 1 );
       std::vector< uint8 > buffer( bufSize );
 
+      // with a seek index, we can skip over compressed data without decompressing it all
+#ifdef DIP__HAS_ZLIB
+      std::unique_ptr< GzipIndexedReader > indexedReader = OpenICSGzipIndex( icsFile, data.fileInformation.dataType );
+#endif
+
       // read the data
       dip::uint cur_loc = 0;
       GenericImageIterator<> it( outRef, procDim );
@@ -577,12 +750,18 @@ FileInformation ImageReadICS(
          }
          // read line portion into buffer
          DIP_ASSERT( new_loc >= cur_loc ); // we cannot move backwards!
-         if( new_loc > cur_loc ) {
-            IcsSkipDataBlock( icsFile, new_loc - cur_loc );
-            cur_loc = new_loc;
+#ifdef DIP__HAS_ZLIB
+         if( indexedReader ) {
+            DIP_STACK_TRACE_THIS( indexedReader->Read( new_loc, buffer.data(), bufSize ));
+         } else
+#endif
+         {
+            if( new_loc > cur_loc ) {
+               IcsSkipDataBlock( icsFile, new_loc - cur_loc );
+            }
+            CALL_ICS( IcsGetDataBlock( icsFile, buffer.data(), bufSize ), "Couldn't read pixel data from ICS file" );
          }
-         CALL_ICS( IcsGetDataBlock( icsFile, buffer.data(), bufSize ), "Couldn't read pixel data from ICS file" );
-         cur_loc += bufSize;
+         cur_loc = new_loc + bufSize;
          // copy buffer to image
          detail::CopyBuffer( buffer.data(), data.fileInformation.dataType, static_cast< dip::sint >( roi[ procDim ].step ), 1,
                              it.Pointer(), outRef.DataType(), outRef.Stride( procDim ), 1,
@@ -641,46 +820,209 @@ inline bool StridesArePositive( IntegerArray strides ) {
    return true;
 }
 
-} // namespace
+// Size of the blocks that are compressed independently
+constexpr dip::uint ICS_BLOCK_SIZE = 1024 * 1024;
 
-void ImageWriteICS(
-      Image const& c_image,
-      String const& filename,
-      StringArray const& history,
-      dip::uint significantBits,
-      StringSet const& options
-) {
-   // parse options
-   bool oldStyle = false; // true if v1
-   bool compress = true;
-   bool fast = false;
-   for( auto& option : options ) {
-      if( option == "v1" ) {
-         oldStyle = true;
-      } else if( option == "v2" ) {
-         oldStyle = false;
-      } else if( option == "uncompressed" ) {
-         compress = false;
-      } else if( option == "gzip" ) {
-         compress = true;
-      } else if( option == "fast" ) {
-         fast = true;
-      } else {
-         DIP_THROW_INVALID_FLAG( option );
-      }
+#ifdef DIP__HAS_ZLIB
+
+// Compresses `length` bytes at `data` into `out` as a raw deflate stream, ended with a sync flush instead of a
+// final block, such that the next block's stream can be appended to it.
+bool DeflateBlock( uint8 const* data, dip::uint length, int level, std::vector< uint8 >& out ) {
+   z_stream stream{};
+   if( deflateInit2( &stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK ) {
+      return false;
    }
+   out.resize( deflateBound( &stream, static_cast< uLong >( length )) + 16 ); // room for the sync flush marker
+   stream.next_in = const_cast< uint8* >( data ); // older zlib versions don't declare `next_in` as const
+   stream.avail_in = static_cast< uInt >( length );
+   stream.next_out = out.data();
+   stream.avail_out = static_cast< uInt >( out.size() );
+   int result = deflate( &stream, Z_SYNC_FLUSH );
+   bool success = ( result == Z_OK ) && ( stream.avail_in == 0 );
+   out.resize( out.size() - stream.avail_out );
+   deflateEnd( &stream );
+   return success;
+}
 
-   // should we reorder dimensions?
-   if( fast ) {
-      if( !c_image.HasContiguousData() || !StridesArePositive( c_image.Strides() )) {
-         fast = false;
-      }
+void WriteLittleEndian32( std::ostream& file, uLong value ) {
+   for( dip::uint ii = 0; ii < 4; ++ii ) {
+      file.put( static_cast< char >( value & 0xFFu ));
+      value >>= 8;
    }
+}
+
+#endif // DIP__HAS_ZLIB
+
+// Writes pixel data to an ICS data file, in one or more pieces, appending to the file if `append`. If `level` is
+// not 0, the data is written as a gzip stream: it is split into blocks of 1 MiB that are compressed independently
+// and in parallel. If also `writeIndex`, the start of each block is recorded in a seek index, written to a
+// side-car file.
+class ICSDataWriter {
+   public:
+      ICSDataWriter( String const& filename, bool append, int level, bool writeIndex )
+            : filename_( filename ), level_( level ), writeIndex_( writeIndex ),
+              file_( filename, std::ios::binary | ( append ? std::ios::app : std::ios::trunc )) {
+         if( !file_ ) {
+            DIP_THROW_RUNTIME( "Couldn't open ICS data file for writing" );
+         }
+#ifdef DIP__HAS_ZLIB
+         if( level_ > 0 ) {
+            // Minimal gzip header: magic number, deflate, no flags, no time stamp, no extra flags, unknown OS
+            char const header[ 10 ] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+            file_.write( header, 10 );
+            index_.offset = static_cast< dip::uint >( file_.tellp() ) - 10;
+            compressedOffset_ = index_.offset + 10;
+            crc_ = crc32( 0, nullptr, 0 );
+         }
+#else
+         DIP_ASSERT( level_ == 0 );
+#endif
+      }
+
+      // Writes the samples of `image`, in linear index order, following the data written previously
+      void Write( Image const& image ) {
+         dip::uint sizeOf = image.DataType().SizeOf();
+         dip::uint nSamples = image.NumberOfPixels();
+         dip::uint blockSamples = std::max< dip::uint >( ICS_BLOCK_SIZE / sizeOf, 1 );
+         dip::uint nBlocks = div_ceil( nSamples, blockSamples );
+         bool direct = image.HasNormalStrides();
+#ifdef DIP__HAS_ZLIB
+         if( level_ > 0 ) {
+            dip::uint nThreads = std::min( GetNumberOfThreads(), nBlocks );
+            // Compress a batch of blocks in parallel, then write them in order. Limiting the batch size limits
+            // the amount of compressed data we hold in memory.
+            dip::uint batchSize = std::min( nBlocks, nThreads * 4 );
+            std::vector< std::vector< uint8 >> compressed( batchSize );
+            std::vector< uLong > crcs( batchSize );
+            std::atomic< bool > failed( false );
+            for( dip::uint first = 0; first < nBlocks; first += batchSize ) {
+               dip::uint last = std::min( first + batchSize, nBlocks );
+               #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+               {
+                  std::vector< uint8 > buffer;
+                  #pragma omp for schedule( dynamic )
+                  for( dip::sint ii = static_cast< dip::sint >( first ); ii < static_cast< dip::sint >( last ); ++ii ) {
+                     if( failed ) {
+                        continue;
+                     }
+                     dip::uint block = static_cast< dip::uint >( ii );
+                     dip::uint start = block * blockSamples;
+                     dip::uint count = std::min( blockSamples, nSamples - start );
+                     uint8 const* data;
+                     if( direct ) {
+                        data = static_cast< uint8 const* >( image.Origin() ) + start * sizeOf;
+                     } else {
+                        buffer.resize( count * sizeOf );
+                        CopyLinearRange( image, start, count, buffer.data() );
+                        data = buffer.data();
+                     }
+                     crcs[ block - first ] = crc32( 0, data, static_cast< uInt >( count * sizeOf ));
+                     if( !DeflateBlock( data, count * sizeOf, level_, compressed[ block - first ] )) {
+                        failed = true;
+                     }
+                  }
+               }
+               if( failed ) {
+                  DIP_THROW_RUNTIME( "Couldn't compress data for ICS file" );
+               }
+               for( dip::uint block = first; block < last; ++block ) {
+                  std::vector< uint8 > const& out = compressed[ block - first ];
+                  if( writeIndex_ ) {
+                     // Blocks don't reference data in previous blocks, so the access point doesn't need a window
+                     GzipAccessPoint point;
+                     point.uncompressed = dataSize_;
+                     point.compressed = compressedOffset_;
+                     index_.points.push_back( std::move( point ));
+                  }
+                  file_.write( reinterpret_cast< char const* >( out.data() ), static_cast< std::streamsize >( out.size() ));
+                  compressedOffset_ += out.size();
+                  dip::uint length = std::min( blockSamples, nSamples - block * blockSamples ) * sizeOf;
+                  crc_ = crc32_combine( crc_, crcs[ block - first ], static_cast< z_off_t >( length ));
+                  dataSize_ += length;
+               }
+            }
+         } else
+#endif
+         {
+            std::vector< uint8 > buffer;
+            for( dip::uint block = 0; block < nBlocks; ++block ) {
+               dip::uint start = block * blockSamples;
+               dip::uint count = std::min( blockSamples, nSamples - start );
+               uint8 const* data;
+               if( direct ) {
+                  data = static_cast< uint8 const* >( image.Origin() ) + start * sizeOf;
+               } else {
+                  buffer.resize( count * sizeOf );
+                  CopyLinearRange( image, start, count, buffer.data() );
+                  data = buffer.data();
+               }
+               file_.write( reinterpret_cast< char const* >( data ), static_cast< std::streamsize >( count * sizeOf ));
+               dataSize_ += count * sizeOf;
+            }
+         }
+         if( !file_ ) {
+            DIP_THROW_RUNTIME( "Couldn't write data to ICS file" );
+         }
+      }
+
+      // Ends the gzip stream and closes the file
+      void Finish() {
+#ifdef DIP__HAS_ZLIB
+         if( level_ > 0 ) {
+            // An empty final block, followed by the gzip trailer: CRC and the data length modulo 2^32
+            char const finalBlock[ 2 ] = { 3, 0 };
+            file_.write( finalBlock, 2 );
+            WriteLittleEndian32( file_, crc_ );
+            WriteLittleEndian32( file_, static_cast< uLong >( dataSize_ & 0xFFFFFFFFu ));
+         }
+#endif
+         if( !file_ ) {
+            DIP_THROW_RUNTIME( "Couldn't write data to ICS file" );
+         }
+#ifdef DIP__HAS_ZLIB
+         if(( level_ > 0 ) && writeIndex_ ) {
+            index_.fileSize = static_cast< dip::uint >( file_.tellp() );
+            index_.dataSize = dataSize_;
+            file_.close();
+            DIP_STACK_TRACE_THIS( WriteGzipIndex( index_, GzipIndexFileName( filename_ )));
+         }
+#endif
+         file_.close();
+      }
+
+   private:
+      String filename_;
+      int level_;
+      bool writeIndex_;
+      std::ofstream file_;
+      dip::uint dataSize_ = 0;
+#ifdef DIP__HAS_ZLIB
+      uLong crc_ = 0;
+      dip::uint compressedOffset_ = 0;
+      GzipIndex index_;
+#endif
+};
+
+} // namespace
+
+namespace {
 
+// Sets the layout and all metadata of `image` in `icsFile`, everything except the pixel data. `image` doesn't
+// need to be forged. The tensor dimension is stored as the last dimension. If `order` is not empty, it is the
+// order in which the dimensions (including the tensor dimension) are stored in the file.
+void WriteICSHeader(
+      IcsFile& icsFile,
+      Image const& image,
+      StringArray const& history,
+      dip::uint significantBits,
+      bool compress,
+      int level,
+      UnsignedArray const& order
+) {
    // find info on image
    Ics_DataType dt;
    dip::uint maxSignificantBits;
-   switch( c_image.DataType()) {
+   switch( image.DataType()) {
       case DT_BIN:      dt = Ics_uint8;     maxSignificantBits = 1;  break;
       case DT_UINT8:    dt = Ics_uint8;     maxSignificantBits = 8;  break;
       case DT_UINT16:   dt = Ics_uint16;    maxSignificantBits = 16; break;
@@ -701,34 +1043,31 @@ void ImageWriteICS(
       significantBits = std::min( significantBits, maxSignificantBits );
    }
 
-   // Quick copy of the image, with tensor dimension moved to the end
-   Image image = c_image.QuickCopy();
+   // sizes, with tensor dimension at the end
+   UnsignedArray sizes = image.Sizes();
    bool isTensor = false;
    if( image.TensorElements() > 1 ) {
       isTensor = true;
-      image.TensorToSpatial(); // last dimension
+      sizes.push_back( image.TensorElements() );
    }
 
-   // open the ICS file
-   IcsFile icsFile( filename, oldStyle ? "w1" : "w2" );
-
    // set info on image
-   int nDims = static_cast< int >( image.Dimensionality() );
-   CALL_ICS( IcsSetLayout( icsFile, dt, nDims, image.Sizes().data() ), "Couldn't write to ICS file" );
+   int nDims = static_cast< int >( sizes.size() );
+   CALL_ICS( IcsSetLayout( icsFile, dt, nDims, sizes.data() ), "Couldn't write to ICS file" );
    if( nDims >= 5 ) {
       // By default, 5th dimension is called "probe", but this is turned into a tensor dimension...
       CALL_ICS( IcsSetOrder( icsFile, 4, "dim_4", 0 ), "Couldn't write to ICS file" );
    }
    CALL_ICS( IcsSetSignificantBits( icsFile, significantBits ), "Couldn't write to ICS file" );
-   if( c_image.IsColor() ) {
-      CALL_ICS( IcsSetOrder( icsFile, nDims - 1, c_image.ColorSpace().c_str(), 0 ), "Couldn't write to ICS file" );
+   if( image.IsColor() ) {
+      CALL_ICS( IcsSetOrder( icsFile, nDims - 1, image.ColorSpace().c_str(), 0 ), "Couldn't write to ICS file" );
    } else if( isTensor ) {
       CALL_ICS( IcsSetOrder( icsFile, nDims - 1, "tensor", 0 ), "Couldn't write to ICS file" );
    }
-   if( c_image.HasPixelSize() ) {
+   if( image.HasPixelSize() ) {
       if( isTensor ) { nDims--; }
       for( int ii = 0; ii < nDims; ii++ ) {
-         auto pixelSize = c_image.PixelSize( static_cast< dip::uint >( ii ));
+         auto pixelSize = image.PixelSize( static_cast< dip::uint >( ii ));
          CALL_ICS( IcsSetPosition( icsFile, ii, 0.0, pixelSize.magnitude, pixelSize.units.String().c_str() ), "Couldn't write to ICS file" );
       }
       if( isTensor ) {
@@ -736,36 +1075,26 @@ void ImageWriteICS(
       }
    }
    if( isTensor ) {
-      String tensorShape = c_image.Tensor().TensorShapeAsString() + "\t" +
-                           std::to_string( c_image.Tensor().Rows() ) + "\t" +
-                           std::to_string( c_image.Tensor().Columns() );
+      String tensorShape = image.Tensor().TensorShapeAsString() + "\t" +
+                           std::to_string( image.Tensor().Rows() ) + "\t" +
+                           std::to_string( image.Tensor().Columns() );
       CALL_ICS( IcsAddHistory( icsFile, "tensor", tensorShape.c_str() ), "Couldn't write metadata to ICS file" );
    }
 
    // set type of compression
-   CALL_ICS( IcsSetCompression( icsFile, compress ? IcsCompr_gzip : IcsCompr_uncompressed, 9 ),
+   CALL_ICS( IcsSetCompression( icsFile, compress ? IcsCompr_gzip : IcsCompr_uncompressed, level ),
                  "Couldn't write to ICS file" );
 
-   // set the image data
-   if( fast ) {
-      UnsignedArray order = image.Strides().sorted_indices();
-      image.PermuteDimensions( order ); // This is the same as `image.StandardizeStrides()`, but with a lot of redundant checking
-      DIP_ASSERT( image.HasNormalStrides() ); // Otherwise things go bad...
+   // reorder dimensions
+   if( !order.empty() ) {
       ICS* ics = icsFile;
       Ics_DataRepresentation dim[ ICS_MAXDIM ];
       dip::uint nd = order.size();
-      for( dip::uint ii = 0; ii < image.Dimensionality(); ++ii ) {
+      for( dip::uint ii = 0; ii < nd; ++ii ) {
          std::memcpy( &( dim[ ii ] ), &( ics->dim[ order[ ii ]] ), sizeof( Ics_DataRepresentation ));
       }
       std::memcpy( ics->dim, dim, sizeof( Ics_DataRepresentation ) * nd ); // Copy only the dimensions we've set.
    }
-   if( image.HasNormalStrides() ) {
-      CALL_ICS( IcsSetData( icsFile, image.Origin(), image.NumberOfPixels() * image.DataType().SizeOf() ), "Couldn't write data to ICS file" );
-   } else {
-      CALL_ICS( IcsSetDataWithStrides( icsFile, image.Origin(), image.NumberOfPixels() * image.DataType().SizeOf(),
-                                       image.Strides().data(), static_cast< int >( image.Dimensionality() )),
-                "Couldn't write data to ICS file" );
-   }
 
    // tag the data
    CALL_ICS( IcsAddHistory( icsFile, "software", "DIPlib " DIP_VERSION_STRING ), "Couldn't write metadata to ICS file" );
@@ -779,16 +1108,284 @@ void ImageWriteICS(
       }
       CALL_ICS( error, "Couldn't write metadata to ICS file" );
    }
+}
+
+// Finds the name of the file that the pixel data of the ICS file being written goes to: the ".ids" file (v1), or
+// the ".ics" file itself (v2). `dataFile` must have space for `ICS_MAXPATHLEN` characters.
+void GetICSDataFileForWriting( ICS const* ics, bool oldStyle, char* dataFile ) {
+   if( oldStyle ) {
+      IcsGetIdsName( dataFile, ics->filename );
+   } else {
+      std::strncpy( dataFile, ics->filename, ICS_MAXPATHLEN );
+   }
+#ifdef DIP__HAS_ZLIB
+   // a seek index left over from a previous file with the same name is no longer valid
+   std::remove( GzipIndexFileName( dataFile ).c_str() );
+#endif
+}
+
+} // namespace
+
+void ImageWriteICS(
+      Image const& c_image,
+      String const& filename,
+      StringArray const& history,
+      dip::uint significantBits,
+      StringSet const& options,
+      dip::uint compressionLevel
+) {
+   // parse options
+   bool oldStyle = false; // true if v1
+   bool compress = true;
+   bool fast = false;
+   bool writeIndex = false;
+   for( auto& option : options ) {
+      if( option == "v1" ) {
+         oldStyle = true;
+      } else if( option == "v2" ) {
+         oldStyle = false;
+      } else if( option == "uncompressed" ) {
+         compress = false;
+      } else if( option == "gzip" ) {
+         compress = true;
+      } else if( option == "fast" ) {
+         fast = true;
+      } else if( option == "index" ) {
+         writeIndex = true;
+      } else {
+         DIP_THROW_INVALID_FLAG( option );
+      }
+   }
+   int level = static_cast< int >( clamp< dip::uint >( compressionLevel, 1, 9 ));
+
+   // should we reorder dimensions?
+   if( fast ) {
+      if( !c_image.HasContiguousData() || !StridesArePositive( c_image.Strides() )) {
+         fast = false;
+      }
+   }
+
+   // Quick copy of the image, with tensor dimension moved to the end
+   Image image = c_image.QuickCopy();
+   if( image.TensorElements() > 1 ) {
+      image.TensorToSpatial(); // last dimension
+   }
+   UnsignedArray order;
+   if( fast ) {
+      order = image.Strides().sorted_indices();
+      image.PermuteDimensions( order ); // This is the same as `image.StandardizeStrides()`, but with a lot of redundant checking
+      DIP_ASSERT( image.HasNormalStrides() ); // Otherwise things go bad...
+   }
+
+   // open the ICS file and write the header
+   IcsFile icsFile( filename, oldStyle ? "w1" : "w2" );
+   DIP_STACK_TRACE_THIS( WriteICSHeader( icsFile, c_image, history, significantBits, compress, level, order ));
+   char dataFile[ ICS_MAXPATHLEN ];
+   GetICSDataFileForWriting( icsFile, oldStyle, dataFile );
+
+   // if we have zlib, we compress the data ourselves, using multiple threads
+#ifdef DIP__HAS_ZLIB
+   if( compress ) {
+      // write the header by closing the file, then write the data
+      icsFile.CloseHeaderOnly();
+      ICSDataWriter writer( dataFile, !oldStyle, level, writeIndex );
+      DIP_STACK_TRACE_THIS( writer.Write( image ));
+      DIP_STACK_TRACE_THIS( writer.Finish() );
+      return;
+   }
+#endif
+
+   // set the image data
+   if( image.HasNormalStrides() ) {
+      CALL_ICS( IcsSetData( icsFile, image.Origin(), image.NumberOfPixels() * image.DataType().SizeOf() ), "Couldn't write data to ICS file" );
+   } else {
+      CALL_ICS( IcsSetDataWithStrides( icsFile, image.Origin(), image.NumberOfPixels() * image.DataType().SizeOf(),
+                                       image.Strides().data(), static_cast< int >( image.Dimensionality() )),
+                "Couldn't write data to ICS file" );
+   }
 
    // write everything to file by closing it
    icsFile.Close();
 }
 
+void ImageWriteICSIndex( String const& filename, dip::uint spacing ) {
+#ifdef DIP__HAS_ZLIB
+   IcsFile icsFile( filename, "r" );
+   ICS* ics = icsFile;
+   DIP_THROW_IF( ics->compression != IcsCompr_gzip, "The ICS file does not contain gzip-compressed data" );
+   char dataFile[ ICS_MAXPATHLEN ];
+   dip::uint offset;
+   DIP_THROW_IF( !GetICSDataFile( ics, dataFile, offset ), "Couldn't find the pixel data of the ICS file" );
+   icsFile.Close();
+   GzipIndex index;
+   DIP_STACK_TRACE_THIS( index = BuildGzipIndex( dataFile, offset, std::max< dip::uint >( spacing, 1 )));
+   DIP_STACK_TRACE_THIS( WriteGzipIndex( index, GzipIndexFileName( dataFile )));
+#else
+   ( void )filename;
+   ( void )spacing;
+   DIP_THROW( "DIPlib was compiled without zlib support." );
+#endif
+}
+
+namespace {
+
+class ICSPlaneSource : public ImagePlaneSource {
+   public:
+      explicit ICSPlaneSource( String const& filename ) : icsFile_( filename, "r" ) {
+         GetICSInfoData data;
+         DIP_STACK_TRACE_THIS( data = GetICSInfo( icsFile_ ));
+         information_ = data.fileInformation;
+         DIP_THROW_IF( information_.sizes.empty(), E::DIMENSIONALITY_NOT_SUPPORTED );
+         strides_ = ICSFileStrides( data );
+         // We can read planes one after the other if the last image dimension is the last dimension in the file.
+         // Otherwise each set of planes is read as a ROI.
+         sequential_ = data.order[ information_.sizes.size() - 1 ] == data.fileSizes.size() - 1;
+      }
+
+      void ForgePlanes( Image& out, dip::uint planes ) override {
+         if( sequential_ ) {
+            // Use the strides of the file, such that planes can be read directly into the image
+            UnsignedArray sizes = information_.sizes;
+            sizes.back() = planes;
+            out.Strip();
+            out.SetStrides( ImageStrides() );
+            out.SetTensorStride( information_.tensorElements > 1 ? strides_.back() : 1 );
+            out.ReForge( sizes, information_.tensorElements, information_.dataType );
+            out.SetColorSpace( information_.colorSpace );
+            out.SetPixelSize( information_.pixelSize );
+         } else {
+            ImagePlaneSource::ForgePlanes( out, planes );
+         }
+         if( information_.tensorElements > 1 ) {
+            SetICSTensorShape( icsFile_, out );
+         }
+      }
+
+      void ReadPlanes( Image& dest ) override {
+         dip::uint planes = dest.Sizes().back();
+         if( sequential_ ) {
+            bool direct = ( dest.DataType() == information_.dataType ) &&
+                          ( dest.Strides() == ImageStrides() ) &&
+                          (( information_.tensorElements == 1 ) || ( dest.TensorStride() == strides_.back() ));
+            if( direct ) {
+               CALL_ICS( IcsGetDataBlock( icsFile_, dest.Origin(), dest.NumberOfSamples() * dest.DataType().SizeOf() ),
+                         "Couldn't read pixel data from ICS file" );
+            } else {
+               Image tmp;
+               ForgePlanes( tmp, planes );
+               ReadPlanes( tmp );
+               dest.Copy( tmp );
+               return;
+            }
+         } else {
+            RangeArray roi( information_.sizes.size() );
+            roi.back() = Range{ static_cast< dip::sint >( next_ ), static_cast< dip::sint >( next_ + planes - 1 ) };
+            // `tmp` shares the data of `dest`, if they match it is read into directly
+            Image tmp = dest;
+            DIP_STACK_TRACE_THIS( ImageReadICS( tmp, information_.name, roi ));
+            if( tmp.Origin() != dest.Origin() ) {
+               dest.Copy( tmp );
+            }
+         }
+         next_ += planes;
+      }
+
+   private:
+      IcsFile icsFile_;
+      IntegerArray strides_; // strides in the file, tensor dimension last
+      bool sequential_ = false;
+      dip::uint next_ = 0;
+
+      IntegerArray ImageStrides() const {
+         IntegerArray strides = strides_;
+         strides.resize( information_.sizes.size() );
+         return strides;
+      }
+};
+
+class ICSPlaneSink : public ImagePlaneSink {
+   public:
+      ICSPlaneSink( String const& dataFile, bool append, int level, bool writeIndex )
+            : writer_( dataFile, append, level, writeIndex ) {}
+
+      void WritePlanes( Image const& planes ) override {
+         // The tensor dimension is the first dimension in the file
+         Image tmp = planes.QuickCopy();
+         if( tmp.TensorElements() > 1 ) {
+            tmp.TensorToSpatial( 0 );
+         }
+         DIP_STACK_TRACE_THIS( writer_.Write( tmp ));
+      }
+
+      void Close() override {
+         DIP_STACK_TRACE_THIS( writer_.Finish() );
+      }
+
+   private:
+      ICSDataWriter writer_;
+};
+
+} // namespace
+
+std::unique_ptr< ImagePlaneSource > OpenICSPlaneSource( String const& filename ) {
+   return std::make_unique< ICSPlaneSource >( filename );
+}
+
+std::unique_ptr< ImagePlaneSink > CreateICSPlaneSink(
+      String const& filename,
+      Image const& image,
+      StringArray const& history,
+      StringSet const& options
+) {
+   bool oldStyle = false;
+   bool compress = true;
+   bool writeIndex = false;
+   for( auto& option : options ) {
+      if( option == "v1" ) {
+         oldStyle = true;
+      } else if( option == "v2" ) {
+         oldStyle = false;
+      } else if( option == "uncompressed" ) {
+         compress = false;
+      } else if( option == "gzip" ) {
+         compress = true;
+      } else if( option == "index" ) {
+         writeIndex = true;
+      } else {
+         DIP_THROW_INVALID_FLAG( option );
+      }
+   }
+#ifndef DIP__HAS_ZLIB
+   compress = false; // We can only compress the data a piece at the time if we have zlib
+#endif
+   int level = compress ? 6 : 0;
+
+   // The tensor dimension goes first in the file, such that the last image dimension is the last one in the file
+   UnsignedArray order;
+   if( image.TensorElements() > 1 ) {
+      dip::uint nDims = image.Dimensionality();
+      order.resize( nDims + 1 );
+      order[ 0 ] = nDims;
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         order[ ii + 1 ] = ii;
+      }
+   }
+
+   // Write the header, the pixel data is written as the planes come in
+   IcsFile icsFile( filename, oldStyle ? "w1" : "w2" );
+   DIP_STACK_TRACE_THIS( WriteICSHeader( icsFile, image, history, 0, compress, level, order ));
+   char dataFile[ ICS_MAXPATHLEN ];
+   GetICSDataFileForWriting( icsFile, oldStyle, dataFile );
+   icsFile.CloseHeaderOnly();
+   return std::make_unique< ICSPlaneSink >( dataFile, !oldStyle, level, writeIndex );
+}
+
 } // namespace dip
 
 #ifdef DIP__ENABLE_DOCTEST
 #include "doctest.h"
 #include "diplib/testing.h"
+#include "diplib/generation.h"
 
 DOCTEST_TEST_CASE( "[DIPlib] testing ICS file reading and writing" ) {
    dip::Image image = dip::ImageReadICS( DIP__EXAMPLES_DIR "/chromo3d.ics" );
@@ -824,6 +1421,67 @@ DOCTEST_TEST_CASE( "[DIPlib] testing ICS file reading and writing" ) {
 
    result = dip::ImageReadICS( "test2", dip::RangeArray{}, {}, "fast" );
    DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   // Memory-mapped reading, from a version 1 file (separate ".ids" file) and a version 2 file
+   result = dip::ImageReadICS( "test2f", dip::RangeArray{}, {}, "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   dip::ImageWriteICS( image, "test3.ics", {}, 7, { "v2", "uncompressed" } );
+   result = dip::ImageReadICS( "test3", dip::RangeArray{}, {}, "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   dip::RangeArray roi{ dip::Range{ 2, 14, 3 }, dip::Range{ 30, 4, 2 }, dip::Range{ 1, -2 } };
+   result = dip::ImageReadICS( "test3", roi, {}, "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image.At( roi ), result ));
+   // Writing to the mapped data doesn't modify the file
+   result.Fill( 0 );
+   result = dip::ImageReadICS( "test3", dip::RangeArray{}, {}, "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   // Compressed files are read normally. This is a different file: `result` still maps "test3.ics", which must
+   // not be overwritten while it is mapped
+   dip::ImageWriteICS( image, "test3z.ics", {}, 7, { "v2", "gzip" } );
+   result = dip::ImageReadICS( "test3z", dip::RangeArray{}, {}, "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+
+   // Channel selection on a tensor image
+   dip::Image color( { 30, 20 }, 3, dip::DT_UINT16 );
+   for( dip::uint y = 0; y < 20; ++y ) {
+      for( dip::uint x = 0; x < 30; ++x ) {
+         color.At( x, y ) = { dip::uint16( x ), dip::uint16( y ), dip::uint16( 7 ) };
+      }
+   }
+   dip::ImageWriteICS( color, "test4.ics", {}, 0, { "v1", "uncompressed" } );
+   result = dip::ImageReadICS( "test4", dip::RangeArray{}, dip::Range{ 1, 2 }, "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( color[ dip::Range{ 1, 2 } ], result ));
+
+   // Compressed writing of data that spans multiple compression blocks, with non-standard strides
+   dip::Image big( { 300, 200, 8 }, 1, dip::DT_SFLOAT );
+   dip::FillRadiusCoordinate( big );
+   big.SwapDimensions( 0, 1 );
+   dip::ImageWriteICS( big, "test5.ics", {}, 0, { "v1", "gzip" }, 1 );
+   result = dip::ImageReadICS( "test5" );
+   DOCTEST_CHECK( dip::testing::CompareImages( big, result ));
+   dip::ImageWriteICS( big, "test5.ics", {}, 0, { "v2", "gzip" } );
+   result = dip::ImageReadICS( "test5" );
+   DOCTEST_CHECK( dip::testing::CompareImages( big, result ));
+
+#ifdef DIP__HAS_ZLIB
+   // ROI reading with a seek index, written together with the file and built afterwards
+   roi = { dip::Range{ 150, 190 }, dip::Range{ 10, 290, 7 }, dip::Range{ 6, 2, 2 } };
+   dip::ImageWriteICS( big, "test5.ics", {}, 0, { "v1", "gzip", "index" } );
+   result = dip::ImageReadICS( "test5", roi );
+   DOCTEST_CHECK( dip::testing::CompareImages( big.At( roi ), result ));
+   dip::ImageWriteICS( big, "test5.ics", {}, 0, { "v2", "gzip" } );
+   dip::ImageWriteICSIndex( "test5", 256 * 1024 );
+   result = dip::ImageReadICS( "test5", roi );
+   DOCTEST_CHECK( dip::testing::CompareImages( big.At( roi ), result ));
+   DOCTEST_CHECK_THROWS( dip::ImageWriteICSIndex( "test2" )); // not compressed
+   std::remove( "test5.ics.gzidx" );
+   std::remove( "test5.ids.gzidx" );
+#endif
+
+   result.Strip(); // don't hold on to any mapped file
+   for( char const* name : { "test1", "test1f", "test2", "test2f", "test3", "test3z", "test4", "test5" } ) {
+      std::remove(( dip::String( name ) + ".ics" ).c_str() );
+      std::remove(( dip::String( name ) + ".ids" ).c_str() );
+   }
 }
 
 #endif // DIP__ENABLE_DOCTEST
@@ -833,15 +1491,17 @@ DOCTEST_TEST_CASE( "[DIPlib] testing ICS file reading and writing" ) {
 #include "diplib.h"
 #include "diplib/file_io.h"
 
+#include "file_io_support.h"
+
 namespace dip {
 
 static const char* NOT_AVAILABLE = "DIPlib was compiled without ICS support.";
 
-FileInformation ImageReadICS( Image&, String const&, RangeArray ) {
+FileInformation ImageReadICS( Image&, String const&, RangeArray, Range, String const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
-FileInformation ImageReadICS( Image&, String const&, UnsignedArray const&, UnsignedArray const&, UnsignedArray const& ) {
+FileInformation ImageReadICS( Image&, String const&, UnsignedArray const&, UnsignedArray const&, UnsignedArray const&, Range const&, String const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
@@ -853,7 +1513,19 @@ bool ImageIsICS( String const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
-void ImageWriteICS( Image const&, String const&, StringArray const&, dip::uint, StringSet const& ) {
+void ImageWriteICS( Image const&, String const&, StringArray const&, dip::uint, StringSet const&, dip::uint ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+void ImageWriteICSIndex( String const&, dip::uint ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+std::unique_ptr< ImagePlaneSource > OpenICSPlaneSource( String const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+std::unique_ptr< ImagePlaneSink > CreateICSPlaneSink( String const&, Image const&, StringArray const&, StringSet const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
@@ -0,0 +1,309 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for NumPy NPY reading and writing
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#include "diplib.h"
+#include "diplib/file_io.h"
+
+#include "file_io_support.h"
+
+namespace dip {
+
+namespace {
+
+constexpr char const* NPY_MAGIC = "\x93NUMPY";
+constexpr dip::uint NPY_MAGIC_LENGTH = 6;
+constexpr char const* NPY_INVALID = "Invalid NPY file";
+
+// Finds the value for `key` in the Python dictionary literal `header`, returns the position of its first character
+String::size_type FindNPYValue( String const& header, char const* key ) {
+   String quoted = String( "'" ) + key + "'";
+   auto pos = header.find( quoted );
+   if( pos == String::npos ) {
+      DIP_THROW_RUNTIME( NPY_INVALID );
+   }
+   pos = header.find( ':', pos + quoted.size() );
+   if( pos == String::npos ) {
+      DIP_THROW_RUNTIME( NPY_INVALID );
+   }
+   pos = header.find_first_not_of( ' ', pos + 1 );
+   if( pos == String::npos ) {
+      DIP_THROW_RUNTIME( NPY_INVALID );
+   }
+   return pos;
+}
+
+struct GetNPYInfoData {
+   FileInformation fileInformation;
+   dip::uint offset = 0;      // where the pixel data starts
+   bool swapBytes = false;    // the file's byte order doesn't match the machine's
+};
+
+GetNPYInfoData GetNPYInfo( String filename ) {
+   GetNPYInfoData data;
+   std::ifstream file( filename, std::ios::binary );
+   if( !file && !FileHasExtension( filename )) {
+      filename = FileAddExtension( filename, "npy" ); // Try with "npy" extension
+      file.open( filename, std::ios::binary );
+   }
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't open NPY file" );
+   }
+   data.fileInformation.name = filename;
+   data.fileInformation.fileType = "NPY";
+   data.fileInformation.numberOfImages = 1;
+   data.fileInformation.tensorElements = 1;
+
+   // Magic string, version and header length
+   char preamble[ 12 ];
+   file.read( preamble, 10 );
+   if( !file || ( String( preamble, NPY_MAGIC_LENGTH ) != NPY_MAGIC )) {
+      DIP_THROW_RUNTIME( "Not an NPY file" );
+   }
+   dip::uint major = static_cast< uint8 >( preamble[ 6 ] );
+   dip::uint headerLength = static_cast< uint8 >( preamble[ 8 ] ) + ( static_cast< dip::uint >( static_cast< uint8 >( preamble[ 9 ] )) << 8 );
+   data.offset = 10;
+   if( major >= 2 ) {
+      // Version 2.0 and later have a 4-byte header length
+      file.read( preamble + 10, 2 );
+      headerLength += ( static_cast< dip::uint >( static_cast< uint8 >( preamble[ 10 ] )) << 16 ) +
+                      ( static_cast< dip::uint >( static_cast< uint8 >( preamble[ 11 ] )) << 24 );
+      data.offset = 12;
+   }
+   String header( headerLength, '\0' );
+   file.read( &header[ 0 ], static_cast< std::streamsize >( headerLength ));
+   if( !file ) {
+      DIP_THROW_RUNTIME( NPY_INVALID );
+   }
+   data.offset += headerLength;
+
+   // Data type: a string such as '<f4'. Structured arrays have a list here instead.
+   auto pos = FindNPYValue( header, "descr" );
+   if(( header[ pos ] != '\'' ) || ( pos + 4 > header.size() )) {
+      DIP_THROW_RUNTIME( "NPY file with structured data type not supported" );
+   }
+   auto end = header.find( '\'', pos + 1 );
+   if( end == String::npos ) {
+      DIP_THROW_RUNTIME( NPY_INVALID );
+   }
+   DataType& dataType = data.fileInformation.dataType;
+   DIP_STACK_TRACE_THIS( dataType = DataTypeFromNumPyTypeString( header.substr( pos + 1, end - pos - 1 ), data.swapBytes, "NPY" ));
+   data.fileInformation.significantBits = dataType.IsBinary() ? 1 : dataType.SizeOf() * 8;
+
+   // Storage order
+   pos = FindNPYValue( header, "fortran_order" );
+   bool fortranOrder = header.compare( pos, 4, "True" ) == 0;
+
+   // Shape: a tuple of integers
+   pos = FindNPYValue( header, "shape" );
+   end = header.find( ')', pos );
+   if(( header[ pos ] != '(' ) || ( end == String::npos )) {
+      DIP_THROW_RUNTIME( NPY_INVALID );
+   }
+   UnsignedArray& sizes = data.fileInformation.sizes;
+   char const* ptr = header.c_str() + pos + 1;
+   char const* stop = header.c_str() + end;
+   while( ptr < stop ) {
+      char* next;
+      dip::uint value = std::strtoull( ptr, &next, 10 );
+      if( next == ptr ) {
+         break; // no more numbers
+      }
+      sizes.push_back( value );
+      ptr = next;
+      while(( ptr < stop ) && (( *ptr == ',' ) || ( *ptr == ' ' ) || ( *ptr == 'L' ))) {
+         ++ptr;
+      }
+   }
+   // The first array dimension varies fastest in Fortran order, the last one in C order. In DIPlib, the first
+   // image dimension varies fastest.
+   if( !fortranOrder ) {
+      std::reverse( sizes.begin(), sizes.end() );
+   }
+   return data;
+}
+
+} // namespace
+
+FileInformation ImageReadNPY(
+      Image& out,
+      String const& filename,
+      String const& mode
+) {
+   bool mapped = false;
+   if( mode == "mmap" ) {
+      mapped = true;
+   } else if( !mode.empty() ) {
+      DIP_THROW_INVALID_FLAG( mode );
+   }
+   GetNPYInfoData data;
+   DIP_STACK_TRACE_THIS( data = GetNPYInfo( filename ));
+   DIP_STACK_TRACE_THIS( ReadRawImageData( out, data.fileInformation.name, data.offset, data.fileInformation, data.swapBytes, mapped ));
+   return data.fileInformation;
+}
+
+FileInformation ImageReadNPYInfo( String const& filename ) {
+   GetNPYInfoData data;
+   DIP_STACK_TRACE_THIS( data = GetNPYInfo( filename ));
+   return data.fileInformation;
+}
+
+bool ImageIsNPY( String const& filename ) {
+   std::ifstream file( filename, std::ios::binary );
+   char magic[ NPY_MAGIC_LENGTH ];
+   file.read( magic, NPY_MAGIC_LENGTH );
+   return file && ( String( magic, NPY_MAGIC_LENGTH ) == NPY_MAGIC );
+}
+
+void ImageWriteNPY(
+      Image const& image,
+      String const& filename
+) {
+   DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
+
+   String descr = NumPyTypeString( image.DataType() );
+
+   // Shape, in C order: the image dimensions in reverse order, followed by the tensor dimension
+   String shape = "(";
+   UnsignedArray const& sizes = image.Sizes();
+   for( dip::uint ii = sizes.size(); ii > 0; ) {
+      --ii;
+      shape += std::to_string( sizes[ ii ] ) + ", ";
+   }
+   if( image.TensorElements() > 1 ) {
+      shape += std::to_string( image.TensorElements() ) + ", ";
+   }
+   if( shape.size() > 1 ) {
+      shape.pop_back(); // a 1-tuple is written as "(n,)", others as "(n, m)"
+      if( image.Dimensionality() + ( image.TensorElements() > 1 ? 1 : 0 ) > 1 ) {
+         shape.pop_back();
+      }
+   }
+   shape += ")";
+
+   // Header, padded with spaces such that the pixel data is aligned to 64 bytes
+   String header = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': " + shape + ", }";
+   dip::uint total = NPY_MAGIC_LENGTH + 4 + header.size() + 1;
+   header.append( div_ceil< dip::uint >( total, 64 ) * 64 - total, ' ' );
+   header.push_back( '\n' );
+   DIP_THROW_IF( header.size() > 0xFFFFu, "NPY header too long" ); // Not possible with less than 6000 dimensions
+
+   String name = FileHasExtension( filename ) ? filename : FileAddExtension( filename, "npy" );
+   {
+      std::ofstream file( name, std::ios::binary | std::ios::trunc );
+      if( !file ) {
+         DIP_THROW_RUNTIME( "Couldn't open NPY file for writing" );
+      }
+      file.write( NPY_MAGIC, NPY_MAGIC_LENGTH );
+      char const version[ 4 ] = { 1, 0, static_cast< char >( header.size() & 0xFFu ), static_cast< char >( header.size() >> 8 ) };
+      file.write( version, 4 );
+      file.write( header.data(), static_cast< std::streamsize >( header.size() ));
+      if( !file ) {
+         DIP_THROW_RUNTIME( "Couldn't write to NPY file" );
+      }
+   }
+   DIP_STACK_TRACE_THIS( WriteRawImageData( image, name, NPY_MAGIC_LENGTH + 4 + header.size() ));
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+#include "doctest.h"
+#include "diplib/testing.h"
+#include "diplib/iterators.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing NPY file reading and writing" ) {
+   dip::Image image( { 30, 20, 10 }, 1, dip::DT_SINT16 );
+   dip::ImageIterator< dip::sint16 > it( image );
+   dip::sint16 value = -1000;
+   do {
+      *it = value;
+      value = static_cast< dip::sint16 >( value + 7 );
+   } while( ++it );
+
+   dip::ImageWriteNPY( image, "test1.npy" );
+   DOCTEST_CHECK( dip::ImageIsNPY( "test1.npy" ));
+   dip::FileInformation info = dip::ImageReadNPYInfo( "test1.npy" );
+   DOCTEST_CHECK( info.sizes == image.Sizes() );
+   DOCTEST_CHECK( info.dataType == dip::DT_SINT16 );
+   dip::Image result = dip::ImageReadNPY( "test1.npy" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   result = dip::ImageReadNPY( "test1.npy", "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+
+   // Non-normal strides are written in the right order
+   dip::Image swapped = image;
+   swapped.SwapDimensions( 0, 2 );
+   dip::ImageWriteNPY( swapped, "test2" );
+   result = dip::ImageReadNPY( "test2" );
+   DOCTEST_CHECK( dip::testing::CompareImages( swapped, result ));
+
+   // Tensor images have the tensor dimension as the last array dimension, which is read as the first image dimension
+   dip::Image tensor( { 15, 8 }, 3, dip::DT_SFLOAT );
+   tensor.Fill( 0 );
+   tensor.At( 3, 4 ) = { 1, 2, 3 };
+   dip::ImageWriteNPY( tensor, "test3.npy" );
+   result = dip::ImageReadNPY( "test3.npy" );
+   DOCTEST_REQUIRE( result.Sizes() == dip::UnsignedArray{ 3, 15, 8 } );
+   result.SpatialToTensor( 0 );
+   DOCTEST_CHECK( dip::testing::CompareImages( tensor, result ));
+
+   // A 1D complex image
+   dip::Image complex( { 100 }, 1, dip::DT_DCOMPLEX );
+   complex.Fill( dip::dcomplex{ 1.5, -3 } );
+   dip::ImageWriteNPY( complex, "test4.npy" );
+   result = dip::ImageReadNPY( "test4.npy" );
+   DOCTEST_CHECK( dip::testing::CompareImages( complex, result ));
+
+   // A file in Fortran order and the opposite byte order, as written by NumPy
+   {
+      std::ofstream file( "test5.npy", std::ios::binary );
+      dip::String header = "{'descr': '>u2', 'fortran_order': True, 'shape': (3, 2), }";
+      header.append( 128 - 10 - header.size() - 1, ' ' );
+      header.push_back( '\n' );
+      file.write( "\x93NUMPY\x01\x00", 8 );
+      file.put( static_cast< char >( header.size() ));
+      file.put( 0 );
+      file.write( header.data(), static_cast< std::streamsize >( header.size() ));
+      for( int ii = 0; ii < 6; ++ii ) {
+         file.put( 0 );
+         file.put( static_cast< char >( ii * 10 ));
+      }
+   }
+   result = dip::ImageReadNPY( "test5.npy" );
+   DOCTEST_REQUIRE( result.Sizes() == dip::UnsignedArray{ 3, 2 } );
+   DOCTEST_CHECK( result.DataType() == dip::DT_UINT16 );
+   DOCTEST_CHECK( result.At( 1, 0 ).As< dip::uint16 >() == 10 );
+   DOCTEST_CHECK( result.At( 0, 1 ).As< dip::uint16 >() == 30 );
+   DOCTEST_CHECK( result.At( 2, 1 ).As< dip::uint16 >() == 50 );
+
+   DOCTEST_CHECK( !dip::ImageIsNPY( DIP__EXAMPLES_DIR "/trui.ics" ));
+
+   result.Strip(); // don't hold on to any mapped file
+   for( char const* name : { "test1.npy", "test2.npy", "test3.npy", "test4.npy", "test5.npy" } ) {
+      std::remove( name );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,510 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for NRRD reading and writing
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "diplib.h"
+#include "diplib/file_io.h"
+
+#include "file_io_support.h"
+
+namespace dip {
+
+namespace {
+
+constexpr char const* NRRD_MAGIC = "NRRD000";
+constexpr dip::uint NRRD_MAGIC_LENGTH = 7;
+
+// Splits a field value into its white-space separated elements. Quoted strings are one element, without the quotes.
+StringArray SplitNRRDValue( String const& value ) {
+   StringArray elements;
+   dip::uint ii = 0;
+   while( ii < value.size() ) {
+      if(( value[ ii ] == ' ' ) || ( value[ ii ] == '\t' )) {
+         ++ii;
+      } else if( value[ ii ] == '"' ) {
+         auto end = value.find( '"', ii + 1 );
+         if( end == String::npos ) {
+            end = value.size();
+         }
+         elements.push_back( value.substr( ii + 1, end - ii - 1 ));
+         ii = end + 1;
+      } else {
+         auto end = value.find_first_of( " \t", ii );
+         if( end == String::npos ) {
+            end = value.size();
+         }
+         elements.push_back( value.substr( ii, end - ii ));
+         ii = end;
+      }
+   }
+   return elements;
+}
+
+DataType NRRDDataType( String const& type ) {
+   if(( type == "signed char" ) || ( type == "int8" ) || ( type == "int8_t" )) {
+      return DT_SINT8;
+   }
+   if(( type == "uchar" ) || ( type == "unsigned char" ) || ( type == "uint8" ) || ( type == "uint8_t" )) {
+      return DT_UINT8;
+   }
+   if(( type == "short" ) || ( type == "short int" ) || ( type == "signed short" ) || ( type == "signed short int" ) ||
+      ( type == "int16" ) || ( type == "int16_t" )) {
+      return DT_SINT16;
+   }
+   if(( type == "ushort" ) || ( type == "unsigned short" ) || ( type == "unsigned short int" ) ||
+      ( type == "uint16" ) || ( type == "uint16_t" )) {
+      return DT_UINT16;
+   }
+   if(( type == "int" ) || ( type == "signed int" ) || ( type == "int32" ) || ( type == "int32_t" )) {
+      return DT_SINT32;
+   }
+   if(( type == "uint" ) || ( type == "unsigned int" ) || ( type == "uint32" ) || ( type == "uint32_t" )) {
+      return DT_UINT32;
+   }
+   if( type == "float" ) {
+      return DT_SFLOAT;
+   }
+   if( type == "double" ) {
+      return DT_DFLOAT;
+   }
+   DIP_THROW_RUNTIME( "NRRD file with unsupported data type: " + type );
+}
+
+// Axis kinds that represent image dimensions, all other kinds represent the values of a pixel
+bool IsNRRDSpatialKind( String const& kind ) {
+   return ( kind == "domain" ) || ( kind == "space" ) || ( kind == "time" ) || ( kind == "none" ) || ( kind == "???" );
+}
+
+// Reads `value` as a physical quantity, as we do in the ICS reader
+PhysicalQuantity NRRDPhysicalQuantity( dfloat value, String const& units ) {
+   if( units.empty() ) {
+      return value;
+   }
+   try {
+      PhysicalQuantity pq{ value, Units{ units }};
+      pq.Normalize();
+      return pq;
+   } catch( Error const& ) {
+      // `Units` failed to parse the string
+      return value;
+   }
+}
+
+struct GetNRRDInfoData {
+   FileInformation fileInformation;
+   String dataFile;           // the file with the pixel data
+   dip::uint offset = 0;      // where the pixel data starts
+   bool swapBytes = false;    // the file's byte order doesn't match the machine's
+};
+
+GetNRRDInfoData GetNRRDInfo( String filename ) {
+   GetNRRDInfoData data;
+   std::ifstream file( filename, std::ios::binary );
+   if( !file && !FileHasExtension( filename )) {
+      filename = FileAddExtension( filename, "nrrd" ); // Try with "nrrd" extension
+      file.open( filename, std::ios::binary );
+      if( !file ) {
+         filename = FileAddExtension( filename, "nhdr" ); // Try with "nhdr" extension
+         file.open( filename, std::ios::binary );
+      }
+   }
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't open NRRD file" );
+   }
+   data.fileInformation.name = filename;
+   data.fileInformation.fileType = "NRRD";
+   data.fileInformation.numberOfImages = 1;
+   data.fileInformation.tensorElements = 1;
+
+   // Read the header: fields until the first empty line or the end of the file
+   String line;
+   std::getline( file, line );
+   if( !file || ( line.compare( 0, NRRD_MAGIC_LENGTH, NRRD_MAGIC ) != 0 )) {
+      DIP_THROW_RUNTIME( "Not an NRRD file" );
+   }
+   std::map< String, String > fields;
+   while( std::getline( file, line )) {
+      if( !line.empty() && ( line.back() == '\r' )) {
+         line.pop_back();
+      }
+      if( line.empty() ) {
+         break;
+      }
+      if( line[ 0 ] == '#' ) {
+         continue; // comment
+      }
+      auto pos = line.find( ":=" );
+      if( pos != String::npos ) {
+         // key/value pair: we keep these as metadata
+         data.fileInformation.history.push_back( line.substr( 0, pos ) + "=" + line.substr( pos + 2 ));
+         continue;
+      }
+      pos = line.find( ": " );
+      if( pos == String::npos ) {
+         DIP_THROW_RUNTIME( "Invalid NRRD file: " + line );
+      }
+      fields[ line.substr( 0, pos ) ] = line.substr( pos + 2 );
+   }
+   dip::uint headerEnd = file ? static_cast< dip::uint >( file.tellg() ) : 0;
+   auto field = [ & ]( char const* name ) -> String {
+      auto it = fields.find( name );
+      return it == fields.end() ? String{} : it->second;
+   };
+
+   // Data type and sizes
+   DataType dataType;
+   DIP_STACK_TRACE_THIS( dataType = NRRDDataType( field( "type" )));
+   data.fileInformation.dataType = dataType;
+   data.fileInformation.significantBits = dataType.SizeOf() * 8;
+   dip::uint nDims = std::strtoull( field( "dimension" ).c_str(), nullptr, 10 );
+   StringArray elements = SplitNRRDValue( field( "sizes" ));
+   if(( nDims == 0 ) || ( elements.size() != nDims )) {
+      DIP_THROW_RUNTIME( "Invalid NRRD file: sizes don't match dimension" );
+   }
+   UnsignedArray sizes( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      sizes[ ii ] = std::strtoull( elements[ ii ].c_str(), nullptr, 10 );
+   }
+
+   // Encoding and byte order
+   String encoding = field( "encoding" );
+   if( encoding != "raw" ) {
+      DIP_THROW_RUNTIME( "NRRD file with unsupported encoding: " + encoding );
+   }
+   String endian = field( "endian" );
+   if(( dataType.SizeOf() > 1 ) && !endian.empty() ) {
+      data.swapBytes = ( endian == "little" ) != IsLittleEndianMachine();
+   }
+
+   // A first axis that is not spatial is the tensor dimension
+   StringArray kinds = SplitNRRDValue( field( "kinds" ));
+   dip::uint firstSpatial = 0;
+   if(( kinds.size() == nDims ) && ( nDims > 1 ) && !IsNRRDSpatialKind( kinds[ 0 ] )) {
+      firstSpatial = 1;
+      data.fileInformation.tensorElements = sizes[ 0 ];
+      if( kinds[ 0 ] == "RGB-color" ) {
+         data.fileInformation.colorSpace = "RGB";
+      } else if( kinds[ 0 ] == "HSV-color" ) {
+         data.fileInformation.colorSpace = "HSV";
+      } else if( kinds[ 0 ] == "XYZ-color" ) {
+         data.fileInformation.colorSpace = "XYZ";
+      }
+   }
+   data.fileInformation.sizes = sizes;
+   if( firstSpatial > 0 ) {
+      data.fileInformation.sizes.erase( 0 );
+   }
+
+   // Pixel size: either per-axis spacings and units, or space directions and space units
+   StringArray spacings = SplitNRRDValue( field( "spacings" ));
+   StringArray units = SplitNRRDValue( field( "units" ));
+   StringArray directions = SplitNRRDValue( field( "space directions" ));
+   StringArray spaceUnits = SplitNRRDValue( field( "space units" ));
+   dip::uint spaceAxis = 0;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      dfloat magnitude = std::nan( "" );
+      String unit;
+      if( spacings.size() == nDims ) {
+         magnitude = std::strtod( spacings[ ii ].c_str(), nullptr );
+         if( units.size() == nDims ) {
+            unit = units[ ii ];
+         }
+      } else if(( directions.size() == nDims ) && ( directions[ ii ] != "none" )) {
+         // The length of the vector "(x,y,z)"
+         dfloat sum = 0;
+         char const* ptr = directions[ ii ].c_str();
+         while( *ptr != '\0' ) {
+            if(( *ptr == '(' ) || ( *ptr == ',' )) {
+               ++ptr;
+            }
+            char* next;
+            dfloat value = std::strtod( ptr, &next );
+            if( next == ptr ) {
+               break;
+            }
+            sum += value * value;
+            ptr = next;
+         }
+         magnitude = std::sqrt( sum );
+         if( spaceAxis < spaceUnits.size() ) {
+            unit = spaceUnits[ spaceAxis ];
+         }
+         ++spaceAxis;
+      }
+      if(( ii >= firstSpatial ) && std::isfinite( magnitude ) && ( magnitude > 0 )) {
+         data.fileInformation.pixelSize.Set( ii - firstSpatial, NRRDPhysicalQuantity( magnitude, unit ));
+      }
+   }
+
+   // Location of the pixel data: after the header, or in a separate file
+   String dataFile = field( "data file" );
+   if( dataFile.empty() ) {
+      dataFile = field( "datafile" );
+   }
+   dip::uint offset = headerEnd;
+   if( !dataFile.empty() ) {
+      if(( dataFile.compare( 0, 4, "LIST" ) == 0 ) || ( dataFile.find( '%' ) != String::npos ) ||
+         ( dataFile.find( ' ' ) != String::npos )) {
+         DIP_THROW_RUNTIME( "NRRD file with multiple data files not supported" );
+      }
+      if(( dataFile[ 0 ] != '/' ) && ( dataFile.find( ':' ) == String::npos )) {
+         // Relative to the directory of the header file
+         auto sep = filename.find_last_of( "/\\" );
+         if( sep != String::npos ) {
+            dataFile = filename.substr( 0, sep + 1 ) + dataFile;
+         }
+      }
+      offset = 0;
+   } else {
+      if( headerEnd == 0 ) {
+         DIP_THROW_RUNTIME( "NRRD file without pixel data" );
+      }
+      dataFile = filename;
+   }
+   dip::uint length = data.fileInformation.sizes.product() * data.fileInformation.tensorElements * dataType.SizeOf();
+   dip::uint lineSkip = std::strtoull( field( "line skip" ).c_str(), nullptr, 10 );
+   if( lineSkip > 0 ) {
+      std::ifstream dfile( dataFile, std::ios::binary );
+      dfile.seekg( static_cast< std::streamoff >( offset ));
+      for( dip::uint ii = 0; ii < lineSkip; ++ii ) {
+         std::getline( dfile, line );
+      }
+      if( !dfile ) {
+         DIP_THROW_RUNTIME( "NRRD data file is too short" );
+      }
+      offset = static_cast< dip::uint >( dfile.tellg() );
+   }
+   dip::sint byteSkip = std::strtoll( field( "byte skip" ).c_str(), nullptr, 10 );
+   if( byteSkip == -1 ) {
+      // The pixel data is at the end of the file
+      std::ifstream dfile( dataFile, std::ios::binary | std::ios::ate );
+      dip::uint fileSize = static_cast< dip::uint >( dfile.tellg() );
+      if( !dfile || ( fileSize < offset + length )) {
+         DIP_THROW_RUNTIME( "NRRD data file is too short" );
+      }
+      offset = fileSize - length;
+   } else if( byteSkip > 0 ) {
+      offset += static_cast< dip::uint >( byteSkip );
+   }
+   data.dataFile = dataFile;
+   data.offset = offset;
+   return data;
+}
+
+} // namespace
+
+FileInformation ImageReadNRRD(
+      Image& out,
+      String const& filename,
+      String const& mode
+) {
+   bool mapped = false;
+   if( mode == "mmap" ) {
+      mapped = true;
+   } else if( !mode.empty() ) {
+      DIP_THROW_INVALID_FLAG( mode );
+   }
+   GetNRRDInfoData data;
+   DIP_STACK_TRACE_THIS( data = GetNRRDInfo( filename ));
+   DIP_STACK_TRACE_THIS( ReadRawImageData( out, data.dataFile, data.offset, data.fileInformation, data.swapBytes, mapped ));
+   return data.fileInformation;
+}
+
+FileInformation ImageReadNRRDInfo( String const& filename ) {
+   GetNRRDInfoData data;
+   DIP_STACK_TRACE_THIS( data = GetNRRDInfo( filename ));
+   return data.fileInformation;
+}
+
+bool ImageIsNRRD( String const& filename ) {
+   std::ifstream file( filename, std::ios::binary );
+   char magic[ NRRD_MAGIC_LENGTH ];
+   file.read( magic, NRRD_MAGIC_LENGTH );
+   return file && ( String( magic, NRRD_MAGIC_LENGTH ) == NRRD_MAGIC );
+}
+
+void ImageWriteNRRD(
+      Image const& image,
+      String const& filename
+) {
+   DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( image.Dimensionality() == 0, E::DIMENSIONALITY_NOT_SUPPORTED );
+
+   // Data type
+   String type;
+   switch( image.DataType()) {
+      case DT_BIN:      type = "uint8";  break; // Read back as `DT_UINT8`
+      case DT_UINT8:    type = "uint8";  break;
+      case DT_SINT8:    type = "int8";   break;
+      case DT_UINT16:   type = "uint16"; break;
+      case DT_SINT16:   type = "int16";  break;
+      case DT_UINT32:   type = "uint32"; break;
+      case DT_SINT32:   type = "int32";  break;
+      case DT_SFLOAT:   type = "float";  break;
+      case DT_DFLOAT:   type = "double"; break;
+      default:
+         DIP_THROW( E::DATA_TYPE_NOT_SUPPORTED ); // NRRD doesn't have complex types
+   }
+
+   // The tensor dimension is the first axis
+   bool isTensor = image.TensorElements() > 1;
+   std::ostringstream header;
+   header << std::setprecision( 15 );
+   header << "NRRD0004\n";
+   header << "# Written by DIPlib " DIP_VERSION_STRING "\n";
+   header << "type: " << type << '\n';
+   header << "dimension: " << image.Dimensionality() + ( isTensor ? 1 : 0 ) << '\n';
+   header << "sizes:";
+   if( isTensor ) {
+      header << ' ' << image.TensorElements();
+   }
+   for( auto s : image.Sizes() ) {
+      header << ' ' << s;
+   }
+   header << '\n';
+   if( isTensor ) {
+      header << "kinds: ";
+      if(( image.ColorSpace() == "RGB" ) || ( image.ColorSpace() == "HSV" ) || ( image.ColorSpace() == "XYZ" )) {
+         header << image.ColorSpace() << "-color";
+      } else {
+         header << "vector";
+      }
+      for( dip::uint ii = 0; ii < image.Dimensionality(); ++ii ) {
+         header << " domain";
+      }
+      header << '\n';
+   }
+   if( image.DataType().SizeOf() > 1 ) {
+      header << "endian: " << ( IsLittleEndianMachine() ? "little" : "big" ) << '\n';
+   }
+   header << "encoding: raw\n";
+   if( image.HasPixelSize() ) {
+      header << "spacings:";
+      if( isTensor ) {
+         header << " nan";
+      }
+      for( dip::uint ii = 0; ii < image.Dimensionality(); ++ii ) {
+         header << ' ' << image.PixelSize( ii ).magnitude;
+      }
+      header << "\nunits:";
+      if( isTensor ) {
+         header << " \"\"";
+      }
+      for( dip::uint ii = 0; ii < image.Dimensionality(); ++ii ) {
+         auto const& units = image.PixelSize( ii ).units;
+         header << " \"" << ( units.IsPhysical() ? units.String() : String{} ) << '"';
+      }
+      header << '\n';
+   }
+   header << '\n';
+   String headerString = header.str();
+
+   String name = FileHasExtension( filename ) ? filename : FileAddExtension( filename, "nrrd" );
+   {
+      std::ofstream file( name, std::ios::binary | std::ios::trunc );
+      if( !file ) {
+         DIP_THROW_RUNTIME( "Couldn't open NRRD file for writing" );
+      }
+      file.write( headerString.data(), static_cast< std::streamsize >( headerString.size() ));
+      if( !file ) {
+         DIP_THROW_RUNTIME( "Couldn't write to NRRD file" );
+      }
+   }
+   DIP_STACK_TRACE_THIS( WriteRawImageData( image, name, headerString.size() ));
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+#include "doctest.h"
+#include "diplib/testing.h"
+#include "diplib/generation.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing NRRD file reading and writing" ) {
+   dip::Image image( { 40, 30, 12 }, 1, dip::DT_SFLOAT );
+   dip::FillRadiusCoordinate( image );
+   image.SetPixelSize( dip::PhysicalQuantityArray{ 0.25 * dip::Units::Micrometer(), 0.25 * dip::Units::Micrometer(),
+                                                   1.1 * dip::Units::Micrometer() } );
+
+   dip::ImageWriteNRRD( image, "test1.nrrd" );
+   DOCTEST_CHECK( dip::ImageIsNRRD( "test1.nrrd" ));
+   dip::FileInformation info = dip::ImageReadNRRDInfo( "test1" );
+   DOCTEST_CHECK( info.sizes == image.Sizes() );
+   DOCTEST_CHECK( info.pixelSize == image.PixelSize() );
+   dip::Image result = dip::ImageReadNRRD( "test1" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result, dip::Option::CompareImagesMode::FULL ));
+   result = dip::ImageReadNRRD( "test1.nrrd", "mmap" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result, dip::Option::CompareImagesMode::FULL ));
+
+   // A color image with non-normal strides
+   dip::Image color( { 20, 15 }, 1, dip::DT_UINT16 );
+   dip::FillXCoordinate( color );
+   color = color + dip::Image::Pixel{ 0, 10, 100 };
+   color.Convert( dip::DT_UINT16 );
+   color.SetColorSpace( "RGB" );
+   color.Rotation90( 1 );
+   dip::ImageWriteNRRD( color, "test2.nrrd" );
+   result = dip::ImageReadNRRD( "test2.nrrd" );
+   DOCTEST_CHECK( result.ColorSpace() == "RGB" );
+   DOCTEST_CHECK( dip::testing::CompareImages( color, result ));
+
+   // A detached header with big-endian pixel data following some other data
+   {
+      std::ofstream file( "test3.raw", std::ios::binary );
+      file.write( "some junk\nmore junk\n", 20 );
+      file.write( "0123", 4 );
+      for( int ii = 0; ii < 6; ++ii ) {
+         file.put( 0 );
+         file.put( static_cast< char >( ii * 10 ));
+      }
+   }
+   {
+      std::ofstream file( "test3.nhdr" );
+      file << "NRRD0004\n# comment\ntype: ushort\ndimension: 2\nsizes: 3 2\nendian: big\nencoding: raw\n"
+              "space directions: (0.5,0,0) (0,2,0)\nspace units: \"mm\" \"mm\"\n"
+              "data file: test3.raw\nline skip: 2\nbyte skip: 4\nmy key:=my value\n";
+   }
+   result = dip::ImageReadNRRD( "test3.nhdr" );
+   DOCTEST_REQUIRE( result.Sizes() == dip::UnsignedArray{ 3, 2 } );
+   DOCTEST_CHECK( result.DataType() == dip::DT_UINT16 );
+   DOCTEST_CHECK( result.At( 1, 0 ).As< dip::uint16 >() == 10 );
+   DOCTEST_CHECK( result.At( 2, 1 ).As< dip::uint16 >() == 50 );
+   DOCTEST_CHECK( result.PixelSize( 1 ) == 2 * dip::Units::Millimeter() );
+   info = dip::ImageReadNRRDInfo( "test3.nhdr" );
+   DOCTEST_REQUIRE( info.history.size() == 1 );
+   DOCTEST_CHECK( info.history[ 0 ] == "my key=my value" );
+
+   DOCTEST_CHECK_THROWS( dip::ImageWriteNRRD( dip::Image( { 10 }, 1, dip::DT_SCOMPLEX ), "test4.nrrd" ));
+   DOCTEST_CHECK( !dip::ImageIsNRRD( DIP__EXAMPLES_DIR "/trui.ics" ));
+
+   result.Strip(); // don't hold on to any mapped file
+   for( char const* name : { "test1.nrrd", "test2.nrrd", "test3.nhdr", "test3.raw" } ) {
+      std::remove( name );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,469 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for reading and writing images in slabs
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <deque>
+#include <future>
+
+#include "diplib.h"
+#include "diplib/file_io.h"
+
+#include "file_io_support.h"
+
+namespace dip {
+
+namespace {
+
+bool IsTIFFFileName( String const& filename ) {
+   return FileCompareExtension( filename, "tif" ) || FileCompareExtension( filename, "tiff" );
+}
+
+// A view of the planes `first` through `last` (inclusive) along the last dimension of `image`
+Image Planes( Image const& image, dip::uint first, dip::uint last ) {
+   RangeArray ranges( image.Dimensionality() );
+   ranges.back() = Range( static_cast< dip::sint >( first ), static_cast< dip::sint >( last ));
+   return image.At( ranges );
+}
+
+} // namespace
+
+class ImageSlabReader::Impl {
+   public:
+      Impl( String const& filename, dip::uint slabSize, dip::uint halo, dip::uint readAhead )
+            : slabSize_( slabSize ), halo_( halo ), readAhead_( readAhead ) {
+         DIP_THROW_IF( slabSize_ == 0, E::INVALID_PARAMETER );
+         if( IsTIFFFileName( filename )) {
+            source_ = OpenTIFFPlaneSource( filename );
+         } else {
+            source_ = OpenICSPlaneSource( filename );
+         }
+         nPlanes_ = source_->Information().sizes.back();
+         nSlabs_ = div_ceil( nPlanes_, slabSize_ );
+      }
+
+      ~Impl() {
+         // The tasks reference `this`, wait for them to finish
+         for( auto& task : pending_ ) {
+            task.wait();
+         }
+      }
+
+      FileInformation const& Information() const { return source_->Information(); }
+
+      dip::uint NumberOfSlabs() const { return nSlabs_; }
+
+      bool Next( Image& out ) {
+         if( nextToReturn_ >= nSlabs_ ) {
+            return false;
+         }
+         // Start reading the following slabs while the caller processes this one
+         while(( nextToLaunch_ < nSlabs_ ) && ( nextToLaunch_ <= nextToReturn_ + readAhead_ )) {
+            Launch( nextToLaunch_ );
+            ++nextToLaunch_;
+         }
+         std::future< Slab > task = std::move( pending_.front() );
+         pending_.pop_front();
+         ++nextToReturn_;
+         Slab slab = task.get();
+         out = std::move( slab.image );
+         firstPlane_ = slab.first;
+         core_ = slab.core;
+         return true;
+      }
+
+      dip::uint FirstPlane() const {
+         DIP_THROW_IF( nextToReturn_ == 0, "No slab has been read yet" );
+         return firstPlane_;
+      }
+
+      Range CorePlanes() const {
+         DIP_THROW_IF( nextToReturn_ == 0, "No slab has been read yet" );
+         return core_;
+      }
+
+   private:
+      struct Slab {
+         Image image;
+         dip::uint first;  // index in the file of the first plane in `image`
+         Range core;       // planes in `image` that are not part of the halo
+      };
+
+      std::unique_ptr< ImagePlaneSource > source_;
+      dip::uint slabSize_;
+      dip::uint halo_;
+      dip::uint readAhead_;
+      dip::uint nPlanes_;
+      dip::uint nSlabs_;
+      dip::uint nextToLaunch_ = 0;
+      dip::uint nextToReturn_ = 0;
+      std::deque< std::future< Slab >> pending_;
+      std::future< Image > overlap_;   // the planes of the last slab launched that are needed by the next one
+      dip::uint firstPlane_ = 0;
+      Range core_;
+
+      // The first and one-past-the-last planes of slab `index`, including the halo
+      dip::uint SlabStart( dip::uint index ) const {
+         dip::uint start = index * slabSize_;
+         return start - std::min( start, halo_ );
+      }
+      dip::uint SlabEnd( dip::uint index ) const {
+         return std::min(( index + 1 ) * slabSize_ + halo_, nPlanes_ );
+      }
+
+      // Starts reading slab `index` in a background thread. Slabs are read one after the other, each task waits
+      // for the previous one to hand over the planes the two slabs have in common. Planes are thus read from the
+      // source in order, and only once, and only one task uses the source at the time.
+      void Launch( dip::uint index ) {
+         std::promise< Image > overlapPromise;
+         std::future< Image > overlapFuture = overlapPromise.get_future();
+         pending_.push_back( std::async( std::launch::async,
+               [ this, index, previous = std::move( overlap_ ), promise = std::move( overlapPromise ) ]() mutable {
+            try {
+               Slab slab;
+               slab.first = SlabStart( index );
+               dip::uint end = SlabEnd( index );
+               dip::uint coreStart = index * slabSize_;
+               dip::uint coreEnd = std::min( coreStart + slabSize_, nPlanes_ );
+               slab.core = Range( static_cast< dip::sint >( coreStart - slab.first ),
+                                  static_cast< dip::sint >( coreEnd - slab.first - 1 ));
+               // Wait for the previous slab to be done with the source, even `ForgePlanes` can use the source
+               Image previousPlanes;
+               if( index > 0 ) {
+                  previousPlanes = previous.get();
+               }
+               source_->ForgePlanes( slab.image, end - slab.first );
+               // Copy the planes we have in common with the previous slab
+               dip::uint have = 0;
+               if( previousPlanes.IsForged() ) {
+                  have = previousPlanes.Sizes().back();
+                  Image dest = Planes( slab.image, 0, have - 1 );
+                  dest.Copy( previousPlanes );
+               }
+               // Read the remaining planes
+               if( slab.first + have < end ) {
+                  Image dest = Planes( slab.image, have, end - slab.first - 1 );
+                  source_->ReadPlanes( dest );
+               }
+               // Hand over the planes the next slab needs. These must be copied, the caller can modify this slab.
+               Image common;
+               if( index + 1 < nSlabs_ ) {
+                  dip::uint nextStart = SlabStart( index + 1 );
+                  if( nextStart < end ) {
+                     common.Copy( Planes( slab.image, nextStart - slab.first, end - slab.first - 1 ));
+                  }
+               }
+               promise.set_value( std::move( common ));
+               return slab;
+            } catch( ... ) {
+               // The next slabs cannot be read either
+               promise.set_exception( std::current_exception() );
+               throw;
+            }
+         } ));
+         overlap_ = std::move( overlapFuture );
+      }
+};
+
+ImageSlabReader::ImageSlabReader( String const& filename, dip::uint slabSize, dip::uint halo, dip::uint readAhead )
+      : impl_( std::make_unique< Impl >( filename, slabSize, halo, readAhead )) {}
+
+ImageSlabReader::~ImageSlabReader() = default;
+
+FileInformation const& ImageSlabReader::Information() const {
+   return impl_->Information();
+}
+
+dip::uint ImageSlabReader::NumberOfSlabs() const {
+   return impl_->NumberOfSlabs();
+}
+
+bool ImageSlabReader::Next( Image& out ) {
+   return impl_->Next( out );
+}
+
+dip::uint ImageSlabReader::FirstPlane() const {
+   return impl_->FirstPlane();
+}
+
+Range ImageSlabReader::CorePlanes() const {
+   return impl_->CorePlanes();
+}
+
+Image ImageSlabReader::Core( Image const& slab ) const {
+   DIP_THROW_IF( !slab.IsForged(), E::IMAGE_NOT_FORGED );
+   Range core = impl_->CorePlanes();
+   DIP_THROW_IF( slab.Dimensionality() != Information().sizes.size(), E::DIMENSIONALITIES_DONT_MATCH );
+   DIP_THROW_IF( static_cast< dip::uint >( core.stop ) >= slab.Sizes().back(), E::SIZES_DONT_MATCH );
+   return Planes( slab, core.Offset(), static_cast< dip::uint >( core.stop ));
+}
+
+class ImageSlabWriter::Impl {
+   public:
+      Impl( String const& filename, FileInformation const& information, StringSet const& options )
+            : filename_( filename ), information_( information ), options_( options ) {
+         DIP_THROW_IF( information_.sizes.empty(), E::DIMENSIONALITY_NOT_SUPPORTED );
+         if( IsTIFFFileName( filename_ )) {
+            DIP_THROW_IF( options_.size() > 1, E::ARRAY_PARAMETER_WRONG_LENGTH );
+         }
+      }
+
+      ~Impl() {
+         if( !closed_ ) {
+            try {
+               Close();
+            } catch( ... ) {
+               // Ignore errors, we cannot throw here
+            }
+         }
+      }
+
+      void Write( Image const& slab ) {
+         DIP_THROW_IF( closed_, "The file has been closed" );
+         DIP_THROW_IF( !slab.IsForged(), E::IMAGE_NOT_FORGED );
+         dip::uint nDims = information_.sizes.size();
+         DIP_THROW_IF( slab.Dimensionality() != nDims, E::DIMENSIONALITIES_DONT_MATCH );
+         for( dip::uint ii = 0; ii < nDims - 1; ++ii ) {
+            DIP_THROW_IF( slab.Size( ii ) != information_.sizes[ ii ], E::SIZES_DONT_MATCH );
+         }
+         DIP_THROW_IF( written_ + slab.Size( nDims - 1 ) > information_.sizes.back(), "Too many planes written" );
+         Wait();
+         if( !sink_ ) {
+            DIP_STACK_TRACE_THIS( CreateSink( slab ));
+         } else {
+            DIP_THROW_IF(( slab.DataType() != dataType_ ) || ( slab.TensorElements() != tensorElements_ ),
+                         "Slab doesn't match previous slabs" );
+         }
+         written_ += slab.Size( nDims - 1 );
+         // `image` shares the data with `slab`, keeping it alive until written
+         pending_ = std::async( std::launch::async, [ this, image = slab ]() {
+            sink_->WritePlanes( image );
+         } );
+      }
+
+      void Close() {
+         DIP_THROW_IF( closed_, "The file has been closed" );
+         closed_ = true;
+         Wait();
+         DIP_THROW_IF( written_ != information_.sizes.back(), "Not all planes were written" );
+         DIP_STACK_TRACE_THIS( sink_->Close() );
+      }
+
+   private:
+      String filename_;
+      FileInformation information_;
+      StringSet options_;
+      std::unique_ptr< ImagePlaneSink > sink_;
+      std::future< void > pending_;
+      DataType dataType_;
+      dip::uint tensorElements_ = 1;
+      dip::uint written_ = 0;
+      bool closed_ = false;
+
+      // Waits for the previous slab to be written, rethrows any exception it threw
+      void Wait() {
+         if( pending_.valid() ) {
+            pending_.get();
+         }
+      }
+
+      // Creates the file, with a header that describes the image of which `slab` is a part
+      void CreateSink( Image const& slab ) {
+         Image header;
+         header.SetSizes( information_.sizes );
+         header.SetTensorSizes( slab.TensorElements() );
+         header.ReshapeTensor( slab.Tensor() );
+         header.SetDataType( slab.DataType() );
+         header.SetColorSpace( slab.ColorSpace() );
+         header.SetPixelSize( information_.pixelSize );
+         if( IsTIFFFileName( filename_ )) {
+            sink_ = CreateTIFFPlaneSink( filename_, header, options_.empty() ? String{} : *options_.begin() );
+         } else {
+            sink_ = CreateICSPlaneSink( filename_, header, information_.history, options_ );
+         }
+         dataType_ = slab.DataType();
+         tensorElements_ = slab.TensorElements();
+      }
+};
+
+ImageSlabWriter::ImageSlabWriter( String const& filename, FileInformation const& information, StringSet const& options )
+      : impl_( std::make_unique< Impl >( filename, information, options )) {}
+
+ImageSlabWriter::~ImageSlabWriter() = default;
+
+void ImageSlabWriter::Write( Image const& slab ) {
+   impl_->Write( slab );
+}
+
+void ImageSlabWriter::Close() {
+   impl_->Close();
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+#include "doctest.h"
+#include "diplib/testing.h"
+#include "diplib/linear.h"
+
+#ifdef DIP__HAS_ICS
+
+DOCTEST_TEST_CASE( "[DIPlib] testing reading and writing images in slabs" ) {
+   dip::Image image = dip::ImageReadICS( DIP__EXAMPLES_DIR "/chromo3d.ics" );
+   DOCTEST_REQUIRE( image.Dimensionality() == 3 );
+   dip::uint nPlanes = image.Size( 2 );
+
+   // Filtering slab by slab, with a large enough halo, gives the same result as filtering the whole image
+   dip::ImageWriteICS( image, "test_slab1.ics" );
+   dip::Image filtered = dip::Gauss( image, { 1 }, { 0 }, "FIR" );
+   {
+      dip::ImageSlabReader reader( "test_slab1", 3, 4 );
+      DOCTEST_CHECK( reader.Information().sizes == image.Sizes() );
+      DOCTEST_CHECK( reader.NumberOfSlabs() == dip::div_ceil< dip::uint >( nPlanes, 3 ));
+      dip::ImageSlabWriter writer( "test_slab2.ics", reader.Information(), { "v1", "uncompressed" } );
+      dip::Image slab;
+      dip::uint count = 0;
+      while( reader.Next( slab )) {
+         dip::uint first = reader.FirstPlane() + reader.CorePlanes().Offset();
+         DOCTEST_CHECK( first == count * 3 );
+         DOCTEST_CHECK( dip::testing::CompareImages( slab, image.At( dip::Range{}, dip::Range{},
+               dip::Range( static_cast< dip::sint >( reader.FirstPlane() ),
+                           static_cast< dip::sint >( reader.FirstPlane() + slab.Size( 2 ) - 1 )))));
+         dip::Image result = dip::Gauss( slab, { 1 }, { 0 }, "FIR" );
+         writer.Write( reader.Core( result ));
+         ++count;
+      }
+      DOCTEST_CHECK( count == reader.NumberOfSlabs() );
+      writer.Close();
+   }
+   dip::Image result = dip::ImageReadICS( "test_slab2" );
+   DOCTEST_CHECK( dip::testing::CompareImages( filtered, result ));
+
+   // A tensor image, written by `ImageWriteICS` with the tensor dimension last, and read back as ROIs
+   dip::Image tensor = dip::Gradient( image );
+   dip::ImageWriteICS( tensor, "test_slab3.ics", {}, 0, { "gzip" } );
+   {
+      dip::ImageSlabReader reader( "test_slab3", 4, 0, 2 );
+      dip::ImageSlabWriter writer( "test_slab4.ics", reader.Information(), { "index" } );
+      dip::Image slab;
+      while( reader.Next( slab )) {
+         DOCTEST_CHECK( slab.TensorElements() == 3 );
+         writer.Write( slab );
+      }
+      writer.Close();
+   }
+   result = dip::ImageReadICS( "test_slab4" );
+   DOCTEST_CHECK( dip::testing::CompareImages( tensor, result ));
+
+   // The file written by `ImageSlabWriter` has the tensor dimension first, it's read sequentially
+   {
+      dip::ImageSlabReader reader( "test_slab4", 5, 1 );
+      dip::Image slab;
+      dip::uint planes = 0;
+      while( reader.Next( slab )) {
+         dip::Image core = reader.Core( slab );
+         DOCTEST_CHECK( dip::testing::CompareImages( core, tensor.At( dip::Range{}, dip::Range{},
+               dip::Range( static_cast< dip::sint >( planes ), static_cast< dip::sint >( planes + core.Size( 2 ) - 1 )))));
+         planes += core.Size( 2 );
+      }
+      DOCTEST_CHECK( planes == nPlanes );
+   }
+
+   // An image written with permuted dimensions is read as ROIs
+   dip::Image permuted = image;
+   permuted.PermuteDimensions( { 2, 0, 1 } );
+   permuted = permuted.Copy();
+   permuted.PermuteDimensions( { 1, 2, 0 } ); // same as `image`, but z has the smallest stride
+   dip::ImageWriteICS( permuted, "test_slab5.ics", {}, 0, { "uncompressed", "fast" } );
+   {
+      dip::ImageSlabReader reader( "test_slab5", 4, 2 );
+      dip::Image slab;
+      while( reader.Next( slab )) {
+         dip::Image core = reader.Core( slab );
+         dip::sint first = static_cast< dip::sint >( reader.FirstPlane() ) + reader.CorePlanes().start;
+         DOCTEST_CHECK( dip::testing::CompareImages( core, image.At( dip::Range{}, dip::Range{},
+               dip::Range( first, first + static_cast< dip::sint >( core.Size( 2 )) - 1 ))));
+      }
+   }
+
+   // Errors
+   DOCTEST_CHECK_THROWS( dip::ImageSlabReader( "test_slab1", 0 ));
+   {
+      dip::ImageSlabWriter writer( "test_slab6.ics", dip::ImageReadICSInfo( "test_slab1" ));
+      writer.Write( image.At( dip::Range{}, dip::Range{}, dip::Range{ 0, 1 } ));
+      DOCTEST_CHECK_THROWS( writer.Write( image.At( dip::Range{ 0, 3 }, dip::Range{}, dip::Range{ 2, 3 } )));
+      DOCTEST_CHECK_THROWS( writer.Write( tensor.At( dip::Range{}, dip::Range{}, dip::Range{ 2, 3 } )));
+      DOCTEST_CHECK_THROWS( writer.Close() );
+   }
+
+   for( char const* name : { "test_slab1", "test_slab2", "test_slab3", "test_slab4", "test_slab5", "test_slab6" } ) {
+      for( char const* extension : { ".ics", ".ids", ".ics.gzidx", ".ids.gzidx" } ) {
+         std::remove(( dip::String( name ) + extension ).c_str() );
+      }
+   }
+}
+
+#endif // DIP__HAS_ICS
+
+#ifdef DIP__HAS_TIFF
+
+DOCTEST_TEST_CASE( "[DIPlib] testing reading and writing multi-page TIFF files in slabs" ) {
+   dip::Image image( { 37, 23, 9 }, 1, dip::DT_UINT16 );
+   for( dip::uint z = 0; z < 9; ++z ) {
+      for( dip::uint y = 0; y < 23; ++y ) {
+         for( dip::uint x = 0; x < 37; ++x ) {
+            image.At( x, y, z ) = x + 40 * y + 1000 * z;
+         }
+      }
+   }
+   dip::FileInformation info;
+   info.sizes = image.Sizes();
+   info.tensorElements = 1;
+   info.dataType = image.DataType();
+   {
+      dip::ImageSlabWriter writer( "test_slab7.tif", info, { "deflate" } );
+      writer.Write( image.At( dip::Range{}, dip::Range{}, dip::Range{ 0, 3 } ));
+      writer.Write( image.At( dip::Range{}, dip::Range{}, dip::Range{ 4, 8 } ));
+      writer.Close();
+   }
+   {
+      dip::ImageSlabReader reader( "test_slab7.tif", 2, 1, 2 );
+      DOCTEST_CHECK( reader.Information().sizes == image.Sizes() );
+      dip::Image slab;
+      dip::uint planes = 0;
+      while( reader.Next( slab )) {
+         DOCTEST_CHECK( dip::testing::CompareImages( slab, image.At( dip::Range{}, dip::Range{},
+               dip::Range( static_cast< dip::sint >( reader.FirstPlane() ),
+                           static_cast< dip::sint >( reader.FirstPlane() + slab.Size( 2 ) - 1 )))));
+         planes += reader.Core( slab ).Size( 2 );
+      }
+      DOCTEST_CHECK( planes == 9 );
+   }
+   // Each page must match the image size
+   {
+      dip::ImageSlabWriter writer( "test_slab8.tif", info );
+      DOCTEST_CHECK_THROWS( writer.Write( image.At( dip::Range{ 0, 9 }, dip::Range{}, dip::Range{ 0, 1 } )));
+   }
+   std::remove( "test_slab7.tif" );
+   std::remove( "test_slab8.tif" );
+}
+
+#endif // DIP__HAS_TIFF
+
+#endif // DIP__ENABLE_DOCTEST
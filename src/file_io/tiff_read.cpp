@@ -20,9 +20,12 @@
 
 #ifdef DIP__HAS_TIFF
 
+#include <atomic>
+
 #include "diplib.h"
 #include "diplib/file_io.h"
 #include "diplib/generic_iterators.h"
+#include "diplib/multithreading.h"
 
 #include "file_io_support.h"
 
@@ -30,6 +33,18 @@
 
 namespace dip {
 
+// Sets the error and warning handlers. These are library-wide, so we set them only once, the first time a file
+// is opened for reading or writing. Files can be opened from multiple threads, the initialization of a static
+// local is thread safe.
+void SetTIFFHandlers() {
+   static bool const done = [] {
+      TIFFSetErrorHandler( nullptr );
+      TIFFSetWarningHandler( nullptr );
+      return true;
+   }();
+   ( void )done;
+}
+
 namespace {
 
 constexpr char const* TIFF_NO_TAG = "Invalid TIFF: Required tag not found";
@@ -40,9 +55,7 @@ constexpr char const* TIFF_DIRECTORY_NOT_FOUND = "Could not find the requested i
 class TiffFile {
    public:
       explicit TiffFile( String filename ) : filename_( std::move( filename )) {
-         // Set error and warning handlers, these are library-wide!
-         TIFFSetErrorHandler( nullptr );
-         TIFFSetWarningHandler( nullptr );
+         SetTIFFHandlers();
          // Open the file for reading
          tiff_ = TIFFOpen( filename_.c_str(), "rc" ); // c == Disable the use of strip chopping when reading images.
          if( tiff_ == nullptr ) {
@@ -59,6 +72,19 @@ class TiffFile {
             DIP_THROW_RUNTIME( "Could not open the specified TIFF file" );
          }
       }
+      // Opens another handle to the file opened by `other`, and sets it to the directory at file offset
+      // `directoryOffset`. The offset also identifies SubIFDs, which are not in the main chain of directories
+      // and thus cannot be reached by their index. This is used from within parallel regions: it doesn't set
+      // the handlers, and doesn't try other file names.
+      TiffFile( TiffFile const& other, toff_t directoryOffset ) : filename_( other.filename_ ) {
+         tiff_ = TIFFOpen( filename_.c_str(), "rc" );
+         if( tiff_ == nullptr ) {
+            DIP_THROW_RUNTIME( "Could not open the specified TIFF file" );
+         }
+         if( !TIFFSetSubDirectory( tiff_, directoryOffset )) {
+            DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+         }
+      }
       TiffFile( TiffFile const& ) = delete;
       TiffFile( TiffFile&& ) = delete;
       TiffFile& operator=( TiffFile const& ) = delete;
@@ -133,6 +159,19 @@ struct GetTIFFInfoData {
    uint16 photometricInterpretation;
 };
 
+// Hack by Bernd Rieger to recognize Leica 12 bit TIFFs
+// These are written as color-mapped images, but they are not
+bool IsLeicaGreyValueTIFF( TiffFile& tiff ) {
+   uint16 bitsPerSample;
+   char* artist = nullptr;
+   if(( TIFFGetField( tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample )) &&
+      ( TIFFGetField( tiff, TIFFTAG_ARTIST, &artist )) && ( artist != nullptr )) {
+      String name( artist );
+      return ( name == "Yves Nicodem" ) || ( name == "TCS User" );
+   }
+   return false;
+}
+
 GetTIFFInfoData GetTIFFInfo( TiffFile& tiff ) {
    GetTIFFInfoData data;
 
@@ -154,6 +193,9 @@ GetTIFFInfoData GetTIFFInfo( TiffFile& tiff ) {
    if( !TIFFGetField( tiff, TIFFTAG_PHOTOMETRIC, &data.photometricInterpretation )) {
       data.photometricInterpretation = PHOTOMETRIC_MINISBLACK;
    }
+   if(( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) && IsLeicaGreyValueTIFF( tiff )) {
+      data.photometricInterpretation = PHOTOMETRIC_MINISBLACK;
+   }
    switch( data.photometricInterpretation ) {
       case PHOTOMETRIC_YCBCR:
          DIP_THROW_RUNTIME( "Unsupported TIFF: Class Y image (YCbCr)" );
@@ -612,6 +654,91 @@ inline bool StridesAreNormal(
    return true;
 }
 
+// A tile or strip to be read from the file, and where in the image to copy its data to
+struct TIFFChunk {
+   uint32 index;           // the tile or strip number
+   uint8* dest;            // pointer to the first image sample to write to
+   dip::uint offset;       // offset in bytes into the decoded chunk of the first sample to copy
+   dip::uint copyWidth;    // number of image pixels to copy along x
+   dip::uint copyHeight;   // number of image pixels to copy along y
+};
+
+bool ReadTIFFChunk( TIFF* tiff, bool tiled, uint32 index, uint8* buffer, tmsize_t size ) {
+   if( tiled ) {
+      return TIFFReadEncodedTile( tiff, index, buffer, size ) >= 0;
+   }
+   return TIFFReadEncodedStrip( tiff, index, buffer, size ) >= 0;
+}
+
+// Reads all `chunks` (tiles if `tiled`, strips otherwise), and copies them into the image using `copy`. If `direct`,
+// chunks are decoded directly into `chunk.dest`, and `copy` is not used.
+//
+// Decompression is the most expensive part of reading a compressed TIFF file, so for compressed files we decode
+// the chunks in parallel. libtiff's decoders keep their state in the `TIFF` handle, so each thread opens its
+// own handle to the file. Each chunk is decoded by the same libtiff code as in the single-threaded case, and is
+// written to a different part of the image, so the result does not depend on the number of threads.
+template< typename CopyFunction >
+void ReadTIFFChunks(
+      TiffFile& tiff,
+      bool tiled,
+      std::vector< TIFFChunk > const& chunks,
+      tmsize_t chunkSize,
+      bool direct,
+      CopyFunction const& copy
+) {
+   char const* errorMessage = tiled ? "Error reading data (tile)" : "Error reading data (strip)";
+   dip::uint nChunks = chunks.size();
+   dip::uint nThreads = std::min( GetNumberOfThreads(), nChunks );
+   uint16 compression;
+   TIFFGetFieldDefaulted( tiff, TIFFTAG_COMPRESSION, &compression );
+   if( compression == COMPRESSION_NONE ) {
+      nThreads = 1; // Reading is I/O bound, multiple threads would just compete for the file
+   }
+   if( nThreads <= 1 ) {
+      std::vector< uint8 > buf( direct ? 0 : static_cast< dip::uint >( chunkSize ));
+      for( auto const& chunk : chunks ) {
+         uint8* dest = direct ? chunk.dest : buf.data();
+         if( !ReadTIFFChunk( tiff, tiled, chunk.index, dest, chunkSize )) {
+            DIP_THROW_RUNTIME( errorMessage );
+         }
+         if( !direct ) {
+            copy( chunk.dest, buf.data() + chunk.offset, chunk.copyWidth, chunk.copyHeight );
+         }
+      }
+      return;
+   }
+   toff_t directoryOffset = TIFFCurrentDirOffset( tiff );
+   std::atomic< bool > failed( false );
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      std::unique_ptr< TiffFile > threadTiff;
+      try {
+         threadTiff.reset( new TiffFile( tiff, directoryOffset ));
+      } catch( ... ) {
+         failed = true;
+      }
+      std::vector< uint8 > buf( direct ? 0 : static_cast< dip::uint >( chunkSize ));
+      #pragma omp for schedule( dynamic )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( nChunks ); ++ii ) {
+         if( failed ) {
+            continue;
+         }
+         TIFFChunk const& chunk = chunks[ static_cast< dip::uint >( ii ) ];
+         uint8* dest = direct ? chunk.dest : buf.data();
+         if( !ReadTIFFChunk( *threadTiff, tiled, chunk.index, dest, chunkSize )) {
+            failed = true;
+            continue;
+         }
+         if( !direct ) {
+            copy( chunk.dest, buf.data() + chunk.offset, chunk.copyWidth, chunk.copyHeight );
+         }
+      }
+   }
+   if( failed ) {
+      DIP_THROW_RUNTIME( errorMessage );
+   }
+}
+
 void ReadTIFFData(
       uint8* imagedata,
       IntegerArray const& strides,
@@ -631,6 +758,37 @@ void ReadTIFFData(
       }
    }
 
+   // Copy functions for the two planar configurations, `srcStrideY` is the number of samples per line in the chunk
+   auto copyContiguous = [ & ]( dip::uint srcStrideY ) {
+      return [ &, srcStrideY ]( uint8* dest, uint8 const* src, dip::uint copyWidth, dip::uint copyHeight ) {
+         if( sizeOf == 1 ) {
+            CopyBuffer3D_8bit( dest, src, roiSpec.tensorElements, copyWidth, copyHeight,
+                               tensorStride, strides[ 0 ], strides[ 1 ],
+                               roiSpec.channels.step, data.tensorElements * roiSpec.roi[ 0 ].step, srcStrideY * roiSpec.roi[ 1 ].step );
+         } else {
+            CopyBuffer3D( dest, src, roiSpec.tensorElements, copyWidth, copyHeight,
+                          tensorStride, strides[ 0 ], strides[ 1 ],
+                          roiSpec.channels.step, data.tensorElements * roiSpec.roi[ 0 ].step, srcStrideY * roiSpec.roi[ 1 ].step, sizeOf );
+         }
+      };
+   };
+   auto copySeparate = [ & ]( dip::uint srcStrideY ) {
+      return [ &, srcStrideY ]( uint8* dest, uint8 const* src, dip::uint copyWidth, dip::uint copyHeight ) {
+         if( sizeOf == 1 ) {
+            CopyBuffer2D_8bit( dest, src, copyWidth, copyHeight,
+                               strides[ 0 ], strides[ 1 ],
+                               roiSpec.roi[ 0 ].step, srcStrideY * roiSpec.roi[ 1 ].step );
+         } else {
+            CopyBuffer2D( dest, src, copyWidth, copyHeight,
+                          strides[ 0 ], strides[ 1 ],
+                          roiSpec.roi[ 0 ].step, srcStrideY * roiSpec.roi[ 1 ].step, sizeOf );
+         }
+      };
+   };
+   auto noCopy = []( uint8*, uint8 const*, dip::uint, dip::uint ) {};
+
+   std::vector< TIFFChunk > chunks;
+
    // Strips or tiles?
    uint32 tileWidth;
    if( TIFFGetField( tiff, TIFFTAG_TILEWIDTH, &tileWidth )) {
@@ -638,7 +796,6 @@ void ReadTIFFData(
       uint32 tileLength;
       READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_TILELENGTH, &tileLength );
       auto tileSize = TIFFTileSize( tiff );
-      std::vector< uint8 > buf( static_cast< dip::uint >( tileSize ));
       //uint32 nTiles = TIFFNumberOfTiles( tiff );
       dip::uint firstTileX = ( roiSpec.roi[ 0 ].Offset() / tileWidth ) * tileWidth;
       dip::uint firstTileY = ( roiSpec.roi[ 1 ].Offset() / tileLength ) * tileLength;
@@ -668,23 +825,14 @@ void ReadTIFFData(
                dip::uint copyWidth = div_ceil( tileEndX - xPos, roiSpec.roi[ 0 ].step );
                dip::uint offset = ( offsetY + ( xPos - x ) * data.tensorElements + roiSpec.channels.Offset() );
                uint32 tile = TIFFComputeTile( tiff, static_cast< uint32 >( x ), static_cast< uint32 >( y ), 0, 0 );
-               TIFFReadEncodedTile( tiff, tile, buf.data(), tileSize );
-               if( sizeOf == 1 ) {
-                  CopyBuffer3D_8bit( imagedataPtr, buf.data() + offset, roiSpec.tensorElements, copyWidth, copyHeight,
-                                     tensorStride, strides[ 0 ], strides[ 1 ],
-                                     roiSpec.channels.step, data.tensorElements * roiSpec.roi[ 0 ].step, tileStrideY * roiSpec.roi[ 1 ].step );
-                  imagedataPtr += static_cast< dip::sint >( copyWidth ) * strides[ 0 ];
-               } else {
-                  CopyBuffer3D( imagedataPtr, buf.data() + offset * sizeOf, roiSpec.tensorElements, copyWidth, copyHeight,
-                                tensorStride, strides[ 0 ], strides[ 1 ],
-                                roiSpec.channels.step, data.tensorElements * roiSpec.roi[ 0 ].step, tileStrideY * roiSpec.roi[ 1 ].step, sizeOf );
-                  imagedataPtr += static_cast< dip::sint >( copyWidth * sizeOf ) * strides[ 0 ];
-               }
+               chunks.push_back( { tile, imagedataPtr, offset * sizeOf, copyWidth, copyHeight } );
+               imagedataPtr += static_cast< dip::sint >( copyWidth * sizeOf ) * strides[ 0 ];
                xPos += roiSpec.roi[ 0 ].step * copyWidth;
             }
             imagedata += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
             yPos += roiSpec.roi[ 1 ].step * copyHeight;
          }
+         ReadTIFFChunks( tiff, true, chunks, tileSize, false, copyContiguous( tileStrideY ));
       } else if( planarConfiguration == PLANARCONFIG_SEPARATE ) {
          // 1111...2222...3333...4444...
          //std::cout << "[ReadTIFFData] Tiles, Separate\n";
@@ -712,19 +860,8 @@ void ReadTIFFData(
                   dip::uint copyWidth = div_ceil( tileEndX - xPos, roiSpec.roi[ 0 ].step );
                   dip::uint offset = ( offsetY + ( xPos - x ));
                   uint32 tile = TIFFComputeTile( tiff, static_cast< uint32 >( x ), static_cast< uint32 >( y ), 0, static_cast< uint16 >( plane ));
-                  TIFFReadEncodedTile( tiff, tile, buf.data(), tileSize );
-                  if( sizeOf == 1 ) {
-                     //std::cout << "Copying " << copyWidth << "x" << copyHeight << " pixels from tile, pos = " << xPos << ", " << yPos << std::endl;
-                     CopyBuffer2D_8bit( imagedataPtr, buf.data() + offset, copyWidth, copyHeight,
-                                        strides[ 0 ], strides[ 1 ],
-                                        roiSpec.roi[ 0 ].step, tileStrideY * roiSpec.roi[ 1 ].step );
-                     imagedataPtr += static_cast< dip::sint >( copyWidth ) * strides[ 0 ];
-                  } else {
-                     CopyBuffer2D( imagedataPtr, buf.data() + offset * sizeOf, copyWidth, copyHeight,
-                                   strides[ 0 ], strides[ 1 ],
-                                   roiSpec.roi[ 0 ].step, tileStrideY * roiSpec.roi[ 1 ].step, sizeOf );
-                     imagedataPtr += static_cast< dip::sint >( copyWidth * sizeOf ) * strides[ 0 ];
-                  }
+                  chunks.push_back( { tile, imagedataPtr, offset * sizeOf, copyWidth, copyHeight } );
+                  imagedataPtr += static_cast< dip::sint >( copyWidth * sizeOf ) * strides[ 0 ];
                   xPos += roiSpec.roi[ 0 ].step * copyWidth;
                }
                imagedataRow += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
@@ -732,6 +869,7 @@ void ReadTIFFData(
             }
             imagedata += static_cast< dip::sint >( sizeOf ) * tensorStride;
          }
+         ReadTIFFChunks( tiff, true, chunks, tileSize, false, copySeparate( tileStrideY ));
       } else {
          DIP_THROW_RUNTIME( "Unsupported TIFF: unknown PlanarConfiguration value" );
       }
@@ -751,15 +889,13 @@ void ReadTIFFData(
             uint32 yPos = 0;
             for( uint32 strip = 0; strip < nStrips; ++strip ) {
                dip::uint copyHeight = ( yPos + stripHeight > data.sizes[ 1 ] ? data.sizes[ 1 ] - yPos : stripHeight );
-               if( TIFFReadEncodedStrip( tiff, strip, imagedata, stripSize ) < 0 ) {
-                  DIP_THROW_RUNTIME( "Error reading data (planar config cont)" );
-               }
+               chunks.push_back( { strip, imagedata, 0, data.sizes[ 0 ], copyHeight } );
                imagedata += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
                yPos += stripHeight;
             }
+            ReadTIFFChunks( tiff, false, chunks, stripSize, true, noCopy );
          } else {
             //std::cout << "[ReadTIFFData] Stripes, Contiguous\n";
-            std::vector< uint8 > buf( static_cast< dip::uint >( stripSize ));
             dip::uint yPos = roiSpec.roi[ 1 ].Offset();
             dip::uint yStride = data.tensorElements * data.sizes[ 0 ];
             for( dip::uint y = firstStrip; y <= roiSpec.roi[ 1 ].Last(); y += stripHeight ) {
@@ -772,25 +908,11 @@ void ReadTIFFData(
                dip::uint offsetY = ( yPos - y ) * yStride;
                dip::uint offset = ( offsetY + roiSpec.roi[ 0 ].Offset() * data.tensorElements + roiSpec.channels.Offset() );
                uint32 strip = TIFFComputeStrip( tiff, static_cast< uint32 >( y ), 0 );
-               if( TIFFReadEncodedStrip( tiff, strip, buf.data(), stripSize ) < 0 ) {
-                  DIP_THROW_RUNTIME( "Error reading data (planar config cont)" );
-               }
-               if( sizeOf == 1 ) {
-                  //std::cout << "Copying " << roiSpec.sizes[ 0 ] << "x" << copyHeight << " pixels from stripe, pos = " << roiSpec.roi[ 0 ].Offset() << ", " << yPos << std::endl;
-                  CopyBuffer3D_8bit(
-                        imagedata, buf.data() + offset, roiSpec.tensorElements, roiSpec.sizes[ 0 ], copyHeight,
-                        tensorStride, strides[ 0 ], strides[ 1 ],
-                        roiSpec.channels.step, data.tensorElements * roiSpec.roi[ 0 ].step, yStride * roiSpec.roi[ 1 ].step );
-                  imagedata += static_cast< dip::sint >( copyHeight ) * strides[ 1 ];
-               } else {
-                  CopyBuffer3D(
-                        imagedata, buf.data() + offset * sizeOf, roiSpec.tensorElements, roiSpec.sizes[ 0 ], copyHeight,
-                        tensorStride, strides[ 0 ], strides[ 1 ],
-                        roiSpec.channels.step, data.tensorElements * roiSpec.roi[ 0 ].step, yStride * roiSpec.roi[ 1 ].step, sizeOf );
-                  imagedata += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
-               }
+               chunks.push_back( { strip, imagedata, offset * sizeOf, roiSpec.sizes[ 0 ], copyHeight } );
+               imagedata += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
                yPos += roiSpec.roi[ 1 ].step * copyHeight;
             }
+            ReadTIFFChunks( tiff, false, chunks, stripSize, false, copyContiguous( yStride ));
          }
       } else if( planarConfiguration == PLANARCONFIG_SEPARATE ) {
          // 1111...2222...3333...4444...
@@ -805,17 +927,15 @@ void ReadTIFFData(
                uint32 yPos = 0;
                for( uint32 strip = 0; strip < nStrips; ++strip ) {
                   dip::uint copyHeight = ( yPos + stripHeight > data.sizes[ 1 ] ? data.sizes[ 1 ] - yPos : stripHeight );
-                  if( TIFFReadEncodedStrip( tiff, stripOffset + strip, imagedataRow, stripSize ) < 0 ) {
-                     DIP_THROW_RUNTIME( "Error reading data (planar config separate)" );
-                  }
+                  chunks.push_back( { stripOffset + strip, imagedataRow, 0, data.sizes[ 0 ], copyHeight } );
                   imagedataRow += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
                   yPos += stripHeight;
                }
                imagedata += static_cast< dip::sint >( sizeOf ) * tensorStride;
             }
+            ReadTIFFChunks( tiff, false, chunks, stripSize, true, noCopy );
          } else {
             //std::cout << "[ReadTIFFData] Stripes, Separate\n";
-            std::vector< uint8 > buf( static_cast< dip::uint >( stripSize ));
             dip::uint yStride = data.sizes[ 0 ];
             for( auto plane : roiSpec.channels ) {
                uint8* imagedataRow = imagedata;
@@ -830,24 +950,13 @@ void ReadTIFFData(
                   dip::uint offsetY = ( yPos - y ) * yStride;
                   dip::uint offset = ( offsetY + roiSpec.roi[ 0 ].Offset() );
                   uint32 strip = TIFFComputeStrip( tiff, static_cast< uint32 >( y ), static_cast< uint16 >( plane ));
-                  if( TIFFReadEncodedStrip( tiff, strip, buf.data(), stripSize ) < 0 ) {
-                     DIP_THROW_RUNTIME( "Error reading data (planar config separate)" );
-                  }
-                  if( sizeOf == 1 ) {
-                     CopyBuffer2D_8bit( imagedataRow, buf.data() + offset, roiSpec.sizes[ 0 ], copyHeight,
-                                        strides[ 0 ], strides[ 1 ],
-                                        roiSpec.roi[ 0 ].step, yStride * roiSpec.roi[ 1 ].step );
-                     imagedataRow += static_cast< dip::sint >( copyHeight ) * strides[ 1 ];
-                  } else {
-                     CopyBuffer2D( imagedataRow, buf.data() + offset * sizeOf, roiSpec.sizes[ 0 ], copyHeight,
-                                   strides[ 0 ], strides[ 1 ],
-                                   roiSpec.roi[ 0 ].step, yStride * roiSpec.roi[ 1 ].step, sizeOf );
-                     imagedataRow += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
-                  }
+                  chunks.push_back( { strip, imagedataRow, offset * sizeOf, roiSpec.sizes[ 0 ], copyHeight } );
+                  imagedataRow += static_cast< dip::sint >( copyHeight * sizeOf ) * strides[ 1 ];
                   yPos += roiSpec.roi[ 1 ].step * copyHeight;
                }
                imagedata += static_cast< dip::sint >( sizeOf ) * tensorStride;
             }
+            ReadTIFFChunks( tiff, false, chunks, stripSize, false, copySeparate( yStride ));
          }
       } else {
          DIP_THROW_RUNTIME( "Unsupported TIFF: unknown PlanarConfiguration value" );
@@ -890,6 +999,42 @@ void ReadTIFFGreyValue(
    }
 }
 
+// Compares the sizes, samples per pixel and data type of the current directory of `tiff` to those in `info`.
+// Returns a description of the first mismatch found, or `nullptr` if they all match.
+char const* CompareTIFFPlane( TiffFile& tiff, FileInformation const& info ) {
+   uint32 temp32;
+   READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGEWIDTH, &temp32 );
+   if( temp32 != info.sizes[ 0 ] ) {
+      return "width of images not consistent";
+   }
+   READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGELENGTH, &temp32 );
+   if( temp32 != info.sizes[ 1 ] ) {
+      return "length of images not consistent";
+   }
+   uint16 photometricInterpretation;
+   if( !TIFFGetField( tiff, TIFFTAG_PHOTOMETRIC, &photometricInterpretation )) {
+      photometricInterpretation = PHOTOMETRIC_MINISBLACK;
+   }
+   DataType dataType;
+   uint16 samplesPerPixel;
+   if(( photometricInterpretation == PHOTOMETRIC_PALETTE ) && !IsLeicaGreyValueTIFF( tiff )) {
+      dataType = DT_UINT16;
+      samplesPerPixel = 3;
+   } else {
+      DIP_STACK_TRACE_THIS( dataType = FindTIFFDataType( tiff ));
+      if( !TIFFGetField( tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel )) {
+         samplesPerPixel = 1;
+      }
+   }
+   if( samplesPerPixel != info.tensorElements ) {
+      return "samples per pixel not consistent";
+   }
+   if( dataType != info.dataType ) {
+      return "data type not consistent";
+   }
+   return nullptr;
+}
+
 void ImageReadTIFFStack(
       Image& image,
       TiffFile& tiff,
@@ -923,35 +1068,10 @@ void ImageReadTIFFStack(
       }
 
       // Test image plane to make sure it matches expectations
-      uint32 temp32;
-      READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGEWIDTH, &temp32 );
-      if( temp32 != data.fileInformation.sizes[ 0 ] ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: width of images not consistent" );
-      }
-      READ_REQUIRED_TIFF_TAG( tiff, TIFFTAG_IMAGELENGTH, &temp32 );
-      if( temp32 != data.fileInformation.sizes[ 1 ] ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: length of images not consistent" );
-      }
-      uint16 photometricInterpretation;
-      if( !TIFFGetField( tiff, TIFFTAG_PHOTOMETRIC, &photometricInterpretation )) {
-         photometricInterpretation = PHOTOMETRIC_MINISBLACK;
-      }
-      DataType dataType;
-      uint16 samplesPerPixel;
-      if( photometricInterpretation == PHOTOMETRIC_PALETTE ) {
-         dataType = DT_UINT16;
-         samplesPerPixel = 3;
-      } else {
-         DIP_STACK_TRACE_THIS( dataType = FindTIFFDataType( tiff ));
-         if( !TIFFGetField( tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel )) {
-            samplesPerPixel = 1;
-         }
-      }
-      if( dataType != image.DataType() ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: data type not consistent" );
-      }
-      if( samplesPerPixel != data.fileInformation.tensorElements ) {
-         DIP_THROW_RUNTIME( "Reading multi-slice TIFF: samples per pixel not consistent" );
+      char const* mismatch;
+      DIP_STACK_TRACE_THIS( mismatch = CompareTIFFPlane( tiff, data.fileInformation ));
+      if( mismatch ) {
+         DIP_THROW_RUNTIME( String( "Reading multi-slice TIFF: " ) + mismatch );
       }
 
       // Read the image data for this plane
@@ -959,26 +1079,15 @@ void ImageReadTIFFStack(
    }
 }
 
-} // namespace
-
-FileInformation ImageReadTIFF(
+// Reads the image in the current directory of `tiff`, or the pages given by `imageNumbers` if it represents
+// more than one page.
+FileInformation ReadTIFFImage(
       Image& out,
-      String const& filename,
-      Range imageNumbers,
+      TiffFile& tiff,
+      Range const& imageNumbers,
       RangeArray const& roi,
       Range const& channels
 ) {
-   // Open TIFF file
-   TiffFile tiff( filename );
-
-   // Go to the right directory
-   dip::uint numberOfImages = TIFFNumberOfDirectories( tiff );
-   DIP_STACK_TRACE_THIS( imageNumbers.Fix( numberOfImages ));
-   uint16 imageNumber = static_cast< uint16 >( imageNumbers.Offset() );
-   if( TIFFSetDirectory( tiff, imageNumber ) == 0 ) {
-      DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
-   }
-
    // Get info
    GetTIFFInfoData data;
    DIP_STACK_TRACE_THIS( data = GetTIFFInfo( tiff ));
@@ -992,19 +1101,6 @@ FileInformation ImageReadTIFF(
       // Read in multiple pages as a 3D image
       DIP_STACK_TRACE_THIS( ImageReadTIFFStack( out, tiff, data, imageNumbers, roiSpec ));
    } else {
-      // Hack by Bernd Rieger to recognize Leica 12 bit TIFFs
-      // These are written as color-mapped images, but they are not
-      if( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) {
-         uint16 bitsPerSample;
-         String artist( 128, ' ' );
-         if(( TIFFGetField( tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample )) &&
-            ( TIFFGetField( tiff, TIFFTAG_ARTIST, &( artist[ 0 ] )))) {
-            if(( artist == "Yves Nicodem" ) || ( artist == "TCS User" )) {
-               data.fileInformation.colorSpace = "";
-               data.photometricInterpretation = PHOTOMETRIC_MINISBLACK;
-            }
-         }
-      }
       if( data.photometricInterpretation == PHOTOMETRIC_PALETTE ) {
          DIP_THROW_IF( !roiSpec.isFullImage, "Reading ROI not supported for colormapped images" );
          DIP_STACK_TRACE_THIS( ReadTIFFColorMap( out, tiff, data ));
@@ -1029,6 +1125,65 @@ FileInformation ImageReadTIFF(
    return data.fileInformation;
 }
 
+// Returns the offsets of the SubIFDs of the current directory of `tiff`
+std::vector< toff_t > GetTIFFSubIFDs( TiffFile& tiff ) {
+   uint16 count = 0;
+   toff_t* offsets = nullptr;
+   if( !TIFFGetField( tiff, TIFFTAG_SUBIFD, &count, &offsets ) || ( offsets == nullptr )) {
+      return {};
+   }
+   return std::vector< toff_t >( offsets, offsets + count );
+}
+
+} // namespace
+
+FileInformation ImageReadTIFF(
+      Image& out,
+      String const& filename,
+      Range imageNumbers,
+      RangeArray const& roi,
+      Range const& channels
+) {
+   // Open TIFF file
+   TiffFile tiff( filename );
+
+   // Go to the right directory
+   dip::uint numberOfImages = TIFFNumberOfDirectories( tiff );
+   DIP_STACK_TRACE_THIS( imageNumbers.Fix( numberOfImages ));
+   uint16 imageNumber = static_cast< uint16 >( imageNumbers.Offset() );
+   if( TIFFSetDirectory( tiff, imageNumber ) == 0 ) {
+      DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+   }
+
+   return ReadTIFFImage( out, tiff, imageNumbers, roi, channels );
+}
+
+FileInformation ImageReadTIFFLevel(
+      Image& out,
+      String const& filename,
+      dip::uint level,
+      RangeArray const& roi,
+      Range const& channels,
+      dip::uint imageNumber
+) {
+   // Open TIFF file
+   TiffFile tiff( filename );
+
+   // Go to the right directory
+   if( TIFFSetDirectory( tiff, static_cast< uint16 >( imageNumber )) == 0 ) {
+      DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+   }
+   if( level > 0 ) {
+      std::vector< toff_t > subIFDs = GetTIFFSubIFDs( tiff );
+      DIP_THROW_IF( level > subIFDs.size(), "The requested pyramid level does not exist" );
+      if( TIFFSetSubDirectory( tiff, subIFDs[ level - 1 ] ) == 0 ) {
+         DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+      }
+   }
+
+   return ReadTIFFImage( out, tiff, Range{ static_cast< dip::sint >( imageNumber ) }, roi, channels );
+}
+
 FileInformation ImageReadTIFF(
       Image& out,
       String const& filename,
@@ -1044,41 +1199,176 @@ FileInformation ImageReadTIFF(
    return ImageReadTIFF( out, filename, imageNumbers, roi, channels );
 }
 
-void ImageReadTIFFSeries(
+FileInformation ImageReadTIFFSeries(
       Image& out,
-      StringArray const& filenames
+      StringArray const& filenames,
+      ProgressCallback const& progress
 ) {
-   DIP_THROW_IF( filenames.size() < 1, E::ARRAY_PARAMETER_EMPTY );
-
-   // Read in first image
-   Image tmp;
-   dip::uint ii = 0;
-   DIP_STACK_TRACE_THIS( ImageReadTIFF( tmp, filenames[ ii ] )); // TODO: Read in first image plane or all image planes?
-
-   // Prepare the output image
-   UnsignedArray sizes = tmp.Sizes();
-   sizes.push_back( filenames.size() );
-   out.ReForge( sizes, tmp.TensorElements(), tmp.DataType() );
-
-   // Iterate over the sub-images through the last dimension
+   DIP_THROW_IF( filenames.empty(), E::ARRAY_PARAMETER_EMPTY );
+   dip::uint nFiles = filenames.size();
+
+   // Forge the output image once, using the header of the first file
+   FileInformation planeInfo;
+   DIP_STACK_TRACE_THIS( planeInfo = ImageReadTIFFInfo( filenames[ 0 ] ));
+   FileInformation info = planeInfo;
+   info.sizes.push_back( nFiles );
+   out.ReForge( info.sizes, info.tensorElements, info.dataType, Option::AcceptDataTypeChange::DO_ALLOW );
+   out.SetColorSpace( info.colorSpace );
+
+   // Each file is read directly into its plane of the output, unless `out` is protected and of a different type
+   bool direct = out.DataType() == info.dataType;
+   std::vector< Image > planes;
+   planes.reserve( nFiles );
    ImageSliceIterator it( out, out.Dimensionality() - 1 );
-
-   // Write the first image into the output
-   it->Copy( tmp );
-   // Make sure we copy over the color space information also
-   if( tmp.IsColor() ) {
-      out.SetColorSpace( tmp.ColorSpace() );
+   do {
+      planes.push_back( *it );
+   } while( ++it );
+
+   // Read the files concurrently. Reading each file is not parallelized when called from within this loop.
+   dip::uint nThreads = std::min( GetNumberOfThreads(), nFiles );
+   std::atomic< bool > failed( false );
+   String errorMessage;
+   dip::uint done = 0;
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      Image tmp;
+      #pragma omp for schedule( dynamic )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( nFiles ); ++ii ) {
+         if( failed ) {
+            continue;
+         }
+         dip::uint index = static_cast< dip::uint >( ii );
+         try {
+            // Check the header before reading, so the plane is not touched if the file doesn't match
+            TiffFile tiff( filenames[ index ] );
+            char const* mismatch = CompareTIFFPlane( tiff, planeInfo );
+            if( mismatch ) {
+               DIP_THROW_RUNTIME( String( "Reading TIFF series: " ) + mismatch );
+            }
+            Image& plane = planes[ index ];
+            if( direct ) {
+               // `tmp` shares the plane's data, the file is read into it directly
+               tmp = plane;
+            }
+            ReadTIFFImage( tmp, tiff, Range{ 0 }, {}, {} );
+            if( tmp.Origin() != plane.Origin() ) {
+               // The file could not be read into the plane in place, copy it over
+               plane.Copy( tmp );
+            }
+         } catch( Error const& e ) {
+            #pragma omp critical( ImageReadTIFFSeries_error )
+            if( errorMessage.empty() ) {
+               errorMessage = filenames[ index ] + ": " + e.Message();
+            }
+            failed = true;
+            continue;
+         }
+         if( progress ) {
+            #pragma omp critical( ImageReadTIFFSeries_progress )
+            {
+               ++done;
+               try {
+                  progress( done, nFiles );
+               } catch( ... ) {
+                  failed = true;
+               }
+            }
+         }
+      }
+   }
+   if( failed ) {
+      DIP_THROW_RUNTIME( errorMessage.empty() ? String( "Reading series interrupted" ) : errorMessage );
    }
+   return info;
+}
 
-   // Read in the rest of the images, and write them into the output
-   while( ++ii, ++it ) {
-      DIP_STACK_TRACE_THIS( ImageReadTIFF( tmp, filenames[ ii ] ));
+FileInformation ImageReadTIFFSeriesInfo( StringArray const& filenames ) {
+   DIP_THROW_IF( filenames.empty(), E::ARRAY_PARAMETER_EMPTY );
+   dip::uint nFiles = filenames.size();
+   std::vector< FileInformation > infos( nFiles );
+   dip::uint nThreads = std::min( GetNumberOfThreads(), nFiles );
+   std::atomic< bool > failed( false );
+   String errorMessage;
+   #pragma omp parallel for schedule( dynamic ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint ii = 0; ii < static_cast< dip::sint >( nFiles ); ++ii ) {
+      if( failed ) {
+         continue;
+      }
+      dip::uint index = static_cast< dip::uint >( ii );
       try {
-         it->Copy( tmp );
-      } catch( Error const& ) {
-         DIP_THROW_RUNTIME( "Images in series do not have consistent sizes" );
+         infos[ index ] = ImageReadTIFFInfo( filenames[ index ] );
+      } catch( Error const& e ) {
+         #pragma omp critical( ImageReadTIFFSeriesInfo_error )
+         if( errorMessage.empty() ) {
+            errorMessage = filenames[ index ] + ": " + e.Message();
+         }
+         failed = true;
+      }
+   }
+   if( failed ) {
+      DIP_THROW_RUNTIME( errorMessage );
+   }
+   FileInformation info = infos[ 0 ];
+   for( dip::uint ii = 1; ii < nFiles; ++ii ) {
+      if( infos[ ii ].sizes != info.sizes ) {
+         DIP_THROW_RUNTIME( filenames[ ii ] + ": Reading TIFF series: sizes of images not consistent" );
+      }
+      if( infos[ ii ].tensorElements != info.tensorElements ) {
+         DIP_THROW_RUNTIME( filenames[ ii ] + ": Reading TIFF series: samples per pixel not consistent" );
+      }
+      if( infos[ ii ].dataType != info.dataType ) {
+         DIP_THROW_RUNTIME( filenames[ ii ] + ": Reading TIFF series: data type not consistent" );
       }
    }
+   info.sizes.push_back( nFiles );
+   return info;
+}
+
+namespace {
+
+class TIFFPlaneSource : public ImagePlaneSource {
+   public:
+      explicit TIFFPlaneSource( String const& filename ) : tiff_( filename ) {
+         GetTIFFInfoData data;
+         DIP_STACK_TRACE_THIS( data = GetTIFFInfo( tiff_ ));
+         information_ = data.fileInformation;
+         information_.sizes.push_back( TIFFNumberOfDirectories( tiff_ ));
+      }
+
+      void ReadPlanes( Image& dest ) override {
+         dip::uint nDims = dest.Dimensionality();
+         RangeArray ranges( nDims );
+         for( dip::uint ii = 0; ii < dest.Size( nDims - 1 ); ++ii ) {
+            if(( next_ > 0 ) && !TIFFReadDirectory( tiff_ )) {
+               DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+            }
+            ranges.back() = Range( static_cast< dip::sint >( ii ));
+            Image plane = dest.At( ranges );
+            plane.Squeeze( nDims - 1 );
+            char const* mismatch;
+            DIP_STACK_TRACE_THIS( mismatch = CompareTIFFPlane( tiff_, information_ ));
+            if( mismatch ) {
+               DIP_THROW_RUNTIME( String( "Reading multi-slice TIFF: " ) + mismatch );
+            }
+            // `tmp` shares the plane's data, it is read into directly unless that is not possible
+            Image tmp = plane;
+            DIP_STACK_TRACE_THIS( ReadTIFFImage( tmp, tiff_, Range( static_cast< dip::sint >( next_ )), {}, {} ));
+            if( tmp.Origin() != plane.Origin() ) {
+               DIP_STACK_TRACE_THIS( plane.Copy( tmp ));
+            }
+            ++next_;
+         }
+      }
+
+   private:
+      TiffFile tiff_;
+      dip::uint next_ = 0;
+};
+
+} // namespace
+
+std::unique_ptr< ImagePlaneSource > OpenTIFFPlaneSource( String const& filename ) {
+   return std::make_unique< TIFFPlaneSource >( filename );
 }
 
 FileInformation ImageReadTIFFInfo(
@@ -1102,6 +1392,21 @@ FileInformation ImageReadTIFFInfo(
    return data.fileInformation;
 }
 
+dip::uint ImageReadTIFFNumberOfLevels(
+      String const& filename,
+      dip::uint imageNumber
+) {
+   // Open TIFF file
+   TiffFile tiff( filename );
+
+   // Go to the right directory
+   if( TIFFSetDirectory( tiff, static_cast< uint16 >( imageNumber )) == 0 ) {
+      DIP_THROW_RUNTIME( TIFF_DIRECTORY_NOT_FOUND );
+   }
+
+   return GetTIFFSubIFDs( tiff ).size() + 1;
+}
+
 bool ImageIsTIFF(
       String const& filename
 ) {
@@ -1120,15 +1425,31 @@ bool ImageIsTIFF(
 #include "diplib.h"
 #include "diplib/file_io.h"
 
+#include "file_io_support.h"
+
 namespace dip {
 
 static const char* NOT_AVAILABLE = "DIPlib was compiled without TIFF support.";
 
-FileInformation ImageReadTIFF( Image&, String const&, Range ) {
+FileInformation ImageReadTIFF( Image&, String const&, Range, RangeArray const&, Range const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+FileInformation ImageReadTIFF(
+      Image&, String const&, Range const&, UnsignedArray const&, UnsignedArray const&, UnsignedArray const&, Range const&
+) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+FileInformation ImageReadTIFFLevel( Image&, String const&, dip::uint, RangeArray const&, Range const&, dip::uint ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+FileInformation ImageReadTIFFSeries( Image&, StringArray const&, ProgressCallback const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
-void ImageReadTIFFSeries( Image&, StringArray const& ) {
+FileInformation ImageReadTIFFSeriesInfo( StringArray const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
@@ -1136,10 +1457,18 @@ FileInformation ImageReadTIFFInfo( String const&, dip::uint ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
+dip::uint ImageReadTIFFNumberOfLevels( String const&, dip::uint ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
 bool ImageIsTIFF( String const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
+std::unique_ptr< ImagePlaneSource > OpenTIFFPlaneSource( String const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
 }
 
 #endif // DIP__HAS_TIFF
@@ -20,11 +20,20 @@
 
 #ifdef DIP__HAS_TIFF
 
+#include <atomic>
+
 #include "diplib.h"
 #include "diplib/file_io.h"
+#include "diplib/multithreading.h"
+
+#include "file_io_support.h"
 
 #include <tiffio.h>
 
+#ifdef DIP__HAS_ZLIB
+#include <zlib.h>
+#endif
+
 namespace dip {
 
 namespace {
@@ -35,15 +44,14 @@ static const char* TIFF_WRITE_TAG = "Error writing tag to TIFF file";
 
 class TiffFile {
    public:
-      explicit TiffFile( String const& filename ) {
-         // Set error and warning handlers, these are library-wide!
-         TIFFSetErrorHandler( nullptr );
-         TIFFSetWarningHandler( nullptr );
+      explicit TiffFile( String const& filename, bool bigTiff = false ) {
+         SetTIFFHandlers();
          // Open the file for writing
+         char const* mode = bigTiff ? "w8" : "w";
          if( FileHasExtension( filename )) {
-            tiff_ = TIFFOpen( filename.c_str(), "w" );
+            tiff_ = TIFFOpen( filename.c_str(), mode );
          } else {
-            tiff_ = TIFFOpen( FileAddExtension( filename, "tif" ).c_str(), "w" );
+            tiff_ = TIFFOpen( FileAddExtension( filename, "tif" ).c_str(), mode );
          }
          if( tiff_ == nullptr ) {
             DIP_THROW_RUNTIME( "Could not open the specified file" );
@@ -81,6 +89,24 @@ static uint16 CompressionTranslate( String const& compression ) {
    }
 }
 
+static uint16 TIFFSampleFormat( DataType dataType ) {
+   switch( dataType ) {
+      case DT_UINT8:
+      case DT_UINT16:
+      case DT_UINT32:
+         return SAMPLEFORMAT_UINT;
+      case DT_SINT8:
+      case DT_SINT16:
+      case DT_SINT32:
+         return SAMPLEFORMAT_INT;
+      case DT_SFLOAT:
+      case DT_DFLOAT:
+         return SAMPLEFORMAT_IEEEFP;
+      default:
+         DIP_THROW( "Data type of image is not compatible with TIFF" );
+   }
+}
+
 void FillBuffer1(
       uint8* dest,
       uint8 const* src,
@@ -204,120 +230,229 @@ void FillBufferMultiChannelN(
    }
 }
 
-void WriteTIFFStrips(
-      Image const& image,
-      TiffFile& tiff
+// Copies `height` rows of `width` pixels of `image`, starting at `src`, into `dest`, packed as in a TIFF file.
+// Consecutive rows in `dest` are `destRowSize` bytes apart, which allows filling a tile that is larger than the
+// image region copied into it.
+void FillChunk(
+      uint8* dest,
+      dip::uint destRowSize,
+      uint8 const* src,
+      dip::uint width,
+      dip::uint height,
+      Image const& image
 ) {
    dip::uint tensorElements = image.TensorElements();
-   dip::uint imageWidth = image.Size( 0 );
-   uint32 imageLength = static_cast< uint32 >( image.Size( 1 ));
    dip::sint tensorStride = image.TensorStride();
    IntegerArray const& strides = image.Strides();
    dip::uint sizeOf = image.DataType().SizeOf();
    bool binary = image.DataType().IsBinary();
+   dip::uint rowSize = binary ? div_ceil< dip::uint >( width, 8 ) : width * tensorElements * sizeOf;
+   dip::uint nCalls = 1;
+   if( rowSize != destRowSize ) {
+      // Rows are not contiguous in `dest`, copy them one at the time
+      nCalls = height;
+      height = 1;
+   }
+   for( dip::uint ii = 0; ii < nCalls; ++ii ) {
+      if( tensorElements == 1 ) {
+         if( binary ) {
+            FillBuffer1( dest, src, width, height, strides );
+         } else if( sizeOf == 1 ) {
+            FillBuffer8( dest, src, width, height, strides );
+         } else {
+            FillBufferN( dest, src, width, height, strides, sizeOf );
+         }
+      } else {
+         if( sizeOf == 1 ) {
+            FillBufferMultiChannel8( dest, src, tensorElements, width, height, tensorStride, strides );
+         } else {
+            FillBufferMultiChannelN( dest, src, tensorElements, width, height, tensorStride, strides, sizeOf );
+         }
+      }
+      dest += destRowSize;
+      src += static_cast< dip::sint >( sizeOf ) * strides[ 1 ];
+   }
+}
 
-   uint32 rowsPerStrip = TIFFDefaultStripSize( tiff, 0 );
-   WRITE_TIFF_TAG( tiff, TIFFTAG_ROWSPERSTRIP, rowsPerStrip );
-
-   // Write it to the file
-   tmsize_t scanline = TIFFScanlineSize( tiff );
+// Writes the pixel data of `image` to `tiff`, as strips if `tileSize` is empty, or as tiles of size `tileSize`
+// otherwise.
+//
+// For deflate compression, if zlib is available, the chunks (strips or tiles) are compressed in parallel, and
+// written in order as raw data. Other compression methods are handled by libtiff, which encodes the chunks
+// one at the time.
+void WriteTIFFData(
+      Image const& image,
+      TiffFile& tiff,
+      uint16 compmode,
+      UnsignedArray const& tileSize
+) {
+   dip::uint imageWidth = image.Size( 0 );
+   dip::uint imageLength = image.Size( 1 );
+   bool binary = image.DataType().IsBinary();
+   bool tiled = !tileSize.empty();
+
+   // Determine the chunk layout
+   dip::uint chunkWidth;
+   dip::uint chunkLength;
+   dip::uint chunkRowSize;
+   if( tiled ) {
+      chunkWidth = tileSize[ 0 ];
+      chunkLength = tileSize[ 1 ];
+      WRITE_TIFF_TAG( tiff, TIFFTAG_TILEWIDTH, static_cast< uint32 >( chunkWidth ));
+      WRITE_TIFF_TAG( tiff, TIFFTAG_TILELENGTH, static_cast< uint32 >( chunkLength ));
+      chunkRowSize = static_cast< dip::uint >( TIFFTileRowSize( tiff ));
+   } else {
+      chunkWidth = imageWidth;
+      uint32 rowsPerStrip = TIFFDefaultStripSize( tiff, 0 );
+      WRITE_TIFF_TAG( tiff, TIFFTAG_ROWSPERSTRIP, rowsPerStrip );
+      chunkLength = rowsPerStrip;
+      chunkRowSize = static_cast< dip::uint >( TIFFScanlineSize( tiff ));
+   }
    if( binary ) {
-      DIP_ASSERT( static_cast< dip::uint >( scanline ) == div_ceil< dip::uint >( image.Size( 0 ), 8 ));
-      DIP_ASSERT( tensorElements == 1 );
+      DIP_ASSERT( chunkRowSize == div_ceil< dip::uint >( chunkWidth, 8 ));
+      DIP_ASSERT( image.IsScalar() );
    } else {
-      DIP_ASSERT( static_cast< dip::uint >( scanline ) == image.Size( 0 ) * tensorElements * sizeOf );
-   }
-   if( image.HasNormalStrides() && !binary ) {
-      // Simple writing
-      tstrip_t strip = 0;
-      uint8* data = static_cast< uint8* >( image.Origin() );
-      for( uint32 row = 0; row < imageLength; row += rowsPerStrip ) {
-         uint32 nrow = row + rowsPerStrip > imageLength ? imageLength - row : rowsPerStrip;
-         if( TIFFWriteEncodedStrip( tiff, strip, data, nrow * scanline ) < 0 ) {
-            DIP_THROW_RUNTIME( "Error writing data" );
-         }
-         data += static_cast< dip::sint >( nrow * sizeOf ) * image.Stride( 1 );
-         ++strip;
+      DIP_ASSERT( chunkRowSize == chunkWidth * image.TensorElements() * image.DataType().SizeOf() );
+   }
+   dip::uint nChunksX = div_ceil( imageWidth, chunkWidth );
+   dip::uint nChunks = nChunksX * div_ceil( imageLength, chunkLength );
+   dip::uint bufferSize = chunkRowSize * chunkLength;
+   // Strips with normal strides can be written directly from the image's data segment
+   bool direct = !tiled && image.HasNormalStrides() && !binary;
+
+   // Returns a pointer to the data for chunk `index`, using `buffer` if the data needs to be copied.
+   // `size` is set to the number of bytes to write.
+   auto prepareChunk = [ & ]( dip::uint index, std::vector< uint8 >& buffer, dip::uint& size ) -> uint8* {
+      dip::uint x = ( index % nChunksX ) * chunkWidth;
+      dip::uint y = ( index / nChunksX ) * chunkLength;
+      dip::uint width = std::min( chunkWidth, imageWidth - x );
+      dip::uint length = std::min( chunkLength, imageLength - y );
+      uint8* src = static_cast< uint8* >( image.Pointer( UnsignedArray{ x, y } ));
+      size = tiled ? bufferSize : chunkRowSize * length; // Tiles always have the full size
+      if( direct ) {
+         return src;
       }
-   } else {
-      // Writing requires an intermediate buffer, filled using strides
-      std::vector< uint8 > buf( static_cast< dip::uint >( TIFFStripSize( tiff )));
-      tstrip_t strip = 0;
-      uint8* data = static_cast< uint8* >( image.Origin() );
-      for( uint32 row = 0; row < imageLength; row += rowsPerStrip ) {
-         uint32 nrow = row + rowsPerStrip > imageLength ? imageLength - row : rowsPerStrip;
-         if( tensorElements == 1 ) {
-            if( binary) {
-               FillBuffer1( buf.data(), data, imageWidth, nrow, strides );
-            } else if( sizeOf == 1 ) {
-               FillBuffer8( buf.data(), data, imageWidth, nrow, strides );
-            } else {
-               FillBufferN( buf.data(), data, imageWidth, nrow, strides, sizeOf );
+      buffer.resize( bufferSize );
+      if(( width < chunkWidth ) || ( length < chunkLength )) {
+         std::fill( buffer.begin(), buffer.end(), uint8( 0 )); // Pad partial tiles with zeros
+      }
+      FillChunk( buffer.data(), chunkRowSize, src, width, length, image );
+      return buffer.data();
+   };
+
+   if( compmode == COMPRESSION_DEFLATE ) {
+#ifdef DIP__HAS_ZLIB
+      dip::uint nThreads = std::min( GetNumberOfThreads(), nChunks );
+      if( nThreads > 1 ) {
+         // Compress a batch of chunks in parallel, then write them in order. Limiting the batch size limits
+         // the amount of compressed data we hold in memory.
+         dip::uint batchSize = std::min( nChunks, nThreads * 8 );
+         std::vector< std::vector< uint8 >> compressed( batchSize );
+         std::atomic< bool > failed( false );
+         for( dip::uint first = 0; first < nChunks; first += batchSize ) {
+            dip::uint last = std::min( first + batchSize, nChunks );
+            #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+            {
+               std::vector< uint8 > buffer;
+               #pragma omp for schedule( dynamic )
+               for( dip::sint ii = static_cast< dip::sint >( first ); ii < static_cast< dip::sint >( last ); ++ii ) {
+                  if( failed ) {
+                     continue;
+                  }
+                  dip::uint size;
+                  uint8 const* data = prepareChunk( static_cast< dip::uint >( ii ), buffer, size );
+                  std::vector< uint8 >& out = compressed[ static_cast< dip::uint >( ii ) - first ];
+                  uLongf outSize = compressBound( static_cast< uLong >( size ));
+                  out.resize( outSize );
+                  if( compress2( out.data(), &outSize, data, static_cast< uLong >( size ), Z_DEFAULT_COMPRESSION ) != Z_OK ) {
+                     failed = true;
+                     continue;
+                  }
+                  out.resize( outSize );
+               }
             }
-         } else {
-            if( sizeOf == 1 ) {
-               FillBufferMultiChannel8( buf.data(), data, tensorElements, imageWidth, nrow, tensorStride, strides );
-            } else {
-               FillBufferMultiChannelN( buf.data(), data, tensorElements, imageWidth, nrow, tensorStride, strides, sizeOf );
+            if( failed ) {
+               DIP_THROW_RUNTIME( "Error compressing data" );
+            }
+            for( dip::uint ii = first; ii < last; ++ii ) {
+               std::vector< uint8 >& out = compressed[ ii - first ];
+               uint32 index = static_cast< uint32 >( ii );
+               tmsize_t outSize = static_cast< tmsize_t >( out.size() );
+               if(( tiled ? TIFFWriteRawTile( tiff, index, out.data(), outSize )
+                          : TIFFWriteRawStrip( tiff, index, out.data(), outSize )) < 0 ) {
+                  DIP_THROW_RUNTIME( "Error writing data" );
+               }
             }
          }
-         if( TIFFWriteEncodedStrip( tiff, strip, buf.data(), nrow * scanline ) < 0 ) {
-            DIP_THROW_RUNTIME( "Error writing data" );
-         }
-         data += static_cast< dip::sint >( nrow * sizeOf ) * image.Stride( 1 );
-         ++strip;
+         return;
       }
+#endif
+      // Otherwise fall through to the serial code below, where libtiff compresses the data
    }
-}
 
-} // namespace
+   std::vector< uint8 > buffer;
+   for( dip::uint ii = 0; ii < nChunks; ++ii ) {
+      dip::uint size;
+      uint8* data = prepareChunk( ii, buffer, size );
+      uint32 index = static_cast< uint32 >( ii );
+      if(( tiled ? TIFFWriteEncodedTile( tiff, index, data, static_cast< tmsize_t >( size ))
+                 : TIFFWriteEncodedStrip( tiff, index, data, static_cast< tmsize_t >( size ))) < 0 ) {
+         DIP_THROW_RUNTIME( "Error writing data" );
+      }
+   }
+}
 
-void ImageWriteTIFF(
-      Image const& image,
-      String const& filename,
-      String const& compression,
-      dip::uint jpegLevel
-) {
+// Checks that `image` can be written to a TIFF file
+void CheckTIFFImage( Image const& image ) {
    DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( image.Dimensionality() != 2, E::DIMENSIONALITY_NOT_SUPPORTED );
    // TODO: Implement writing of 3D images as a stack of 2D images
-
-   // Get image info and quit if we can't write
    DIP_THROW_IF(( image.Size( 0 ) > std::numeric_limits< uint32 >::max() ) ||
                 ( image.Size( 1 ) > std::numeric_limits< uint32 >::max() ), "Image size too large for TIFF file" );
-   uint32 imageWidth = static_cast< uint32 >( image.Size( 0 ));
-   uint32 imageLength = static_cast< uint32 >( image.Size( 1 ));
-   dip::uint sizeOf = image.DataType().SizeOf();
-   uint16 bitsPerSample = 0;
-   uint16 sampleFormat = 0;
    if( image.DataType().IsBinary() ) {
       DIP_THROW_IF( !image.IsScalar(), E::IMAGE_NOT_SCALAR ); // Binary images should not have multiple samples per pixel
    } else {
-      bitsPerSample = static_cast< uint16 >( sizeOf * 8 );
-      switch( image.DataType() ) {
-         case DT_UINT8:
-         case DT_UINT16:
-         case DT_UINT32:
-            sampleFormat = SAMPLEFORMAT_UINT;
-            break;
-         case DT_SINT8:
-         case DT_SINT16:
-         case DT_SINT32:
-            sampleFormat = SAMPLEFORMAT_INT;
-            break;
-         case DT_SFLOAT:
-         case DT_DFLOAT:
-            sampleFormat = SAMPLEFORMAT_IEEEFP;
-            break;
-         default:
-            DIP_THROW( "Data type of image is not compatible with TIFF" );
-            break;
+      TIFFSampleFormat( image.DataType() );
+   }
+}
+
+// Validates the user's tile size, returns an empty array for writing strips
+UnsignedArray TIFFTileSize( UnsignedArray tileSize ) {
+   if( !tileSize.empty() ) {
+      ArrayUseParameter( tileSize, 2 );
+      for( auto& t : tileSize ) {
+         DIP_THROW_IF( t == 0, E::PARAMETER_OUT_OF_RANGE );
+         t = div_ceil< dip::uint >( t, 16 ) * 16; // TIFF requires tile sizes to be a multiple of 16
+         DIP_THROW_IF( t > std::numeric_limits< uint32 >::max(), E::PARAMETER_OUT_OF_RANGE );
       }
    }
-   uint16 compmode = CompressionTranslate( compression );
+   return tileSize;
+}
 
-   // Create the TIFF file and set the tags
-   TiffFile tiff( filename );
+// Size of the uncompressed pixel data of `image` in a TIFF file
+uint64 TIFFDataSize( Image const& image ) {
+   if( image.DataType().IsBinary() ) {
+      return static_cast< uint64 >( div_ceil< dip::uint >( image.Size( 0 ), 8 )) * image.Size( 1 );
+   }
+   return static_cast< uint64 >( image.Size( 0 )) * image.Size( 1 ) * image.TensorElements() * image.DataType().SizeOf();
+}
+
+// Use BigTIFF if `dataSize` bytes of pixel data might not fit in a classic TIFF file, which uses 32-bit offsets.
+// We leave some space for the tags and the strip or tile offset tables.
+bool UseBigTIFF( uint64 dataSize ) {
+   return dataSize > ( uint64( 1 ) << 32 ) - ( uint64( 1 ) << 25 );
+}
+
+// Sets the tags for `image` in the current directory of `tiff`, and writes its pixel data
+void WriteTIFFImage(
+      Image const& image,
+      TiffFile& tiff,
+      uint16 compmode,
+      dip::uint jpegLevel,
+      UnsignedArray const& tileSize
+) {
+   uint32 imageWidth = static_cast< uint32 >( image.Size( 0 ));
+   uint32 imageLength = static_cast< uint32 >( image.Size( 1 ));
 
    if( image.DataType().IsBinary() ) {
       WRITE_TIFF_TAG( tiff, TIFFTAG_PHOTOMETRIC, uint16( PHOTOMETRIC_MINISBLACK ));
@@ -335,8 +470,8 @@ void ImageWriteTIFF(
    WRITE_TIFF_TAG( tiff, TIFFTAG_IMAGELENGTH, imageLength );
 
    if( !image.DataType().IsBinary() ) {
-      WRITE_TIFF_TAG( tiff, TIFFTAG_BITSPERSAMPLE, bitsPerSample );
-      WRITE_TIFF_TAG( tiff, TIFFTAG_SAMPLEFORMAT, sampleFormat );
+      WRITE_TIFF_TAG( tiff, TIFFTAG_BITSPERSAMPLE, static_cast< uint16 >( image.DataType().SizeOf() * 8 ));
+      WRITE_TIFF_TAG( tiff, TIFFTAG_SAMPLEFORMAT, TIFFSampleFormat( image.DataType() ));
       WRITE_TIFF_TAG( tiff, TIFFTAG_SAMPLESPERPIXEL, static_cast< uint16 >( image.TensorElements()));
       if( image.TensorElements() > 1 ) {
          WRITE_TIFF_TAG( tiff, TIFFTAG_PLANARCONFIG, uint16( PLANARCONFIG_CONTIG ));
@@ -347,12 +482,11 @@ void ImageWriteTIFF(
 
    WRITE_TIFF_TAG( tiff, TIFFTAG_COMPRESSION, compmode );
    if( compmode == COMPRESSION_JPEG ) {
-      jpegLevel = clamp< dip::uint >( jpegLevel, 1, 100 );
-      WRITE_TIFF_TAG( tiff, TIFFTAG_JPEGQUALITY, static_cast< int >( jpegLevel ));
+      WRITE_TIFF_TAG( tiff, TIFFTAG_JPEGQUALITY, static_cast< int >( clamp< dip::uint >( jpegLevel, 1, 100 )));
       WRITE_TIFF_TAG( tiff, TIFFTAG_JPEGCOLORMODE, int( JPEGCOLORMODE_RGB ));
    }
 
-   DIP_STACK_TRACE_THIS( WriteTIFFStrips( image, tiff ));
+   WriteTIFFData( image, tiff, compmode, tileSize );
 
    TIFFSetField( tiff, TIFFTAG_SOFTWARE, "DIPlib " DIP_VERSION_STRING );
 
@@ -369,15 +503,165 @@ void ImageWriteTIFF(
    TIFFSetField( tiff, TIFFTAG_RESOLUTIONUNIT, uint16( RESUNIT_CENTIMETER ));
 }
 
+// Halves the size of `in` by averaging blocks of 2x2 pixels. Binary images are reduced with a logical OR.
+Image HalveImage( Image const& in ) {
+   dip::uint width = std::max< dip::uint >( in.Size( 0 ) / 2, 1 );
+   dip::uint length = std::max< dip::uint >( in.Size( 1 ) / 2, 1 );
+   // Returns the view of `in` with one of the four pixels of each 2x2 block. If `in` has a size of 1 along
+   // a dimension, the two pixels along that dimension are the same one.
+   auto block = [ & ]( dip::sint dx, dip::sint dy ) -> Image {
+      dip::sint x = in.Size( 0 ) > 1 ? dx : 0;
+      dip::sint y = in.Size( 1 ) > 1 ? dy : 0;
+      return in.At( Range{ x, x + 2 * static_cast< dip::sint >( width - 1 ), 2 },
+                    Range{ y, y + 2 * static_cast< dip::sint >( length - 1 ), 2 } );
+   };
+   DataType dataType = in.DataType();
+   DataType sumType = DataType::SuggestFloat( dataType );
+   Image out = Add( block( 0, 0 ), block( 1, 0 ), sumType );
+   Add( out, block( 0, 1 ), out, sumType );
+   Add( out, block( 1, 1 ), out, sumType );
+   if( !dataType.IsBinary() ) {
+      if( dataType.IsInteger() ) {
+         Add( out, 2, out, sumType ); // Conversion truncates, this makes it round (for positive values)
+      }
+      MultiplySampleWise( out, 0.25, out, sumType );
+   }
+   out.Convert( dataType );
+   out.SetColorSpace( in.ColorSpace() );
+   PixelSize pixelSize = in.PixelSize();
+   pixelSize.Scale( 2 );
+   out.SetPixelSize( pixelSize );
+   return out;
+}
+
+} // namespace
+
+void ImageWriteTIFF(
+      Image const& image,
+      String const& filename,
+      String const& compression,
+      dip::uint jpegLevel,
+      UnsignedArray const& tileSize
+) {
+   DIP_STACK_TRACE_THIS( CheckTIFFImage( image ));
+   uint16 compmode = CompressionTranslate( compression );
+   UnsignedArray tiles;
+   DIP_STACK_TRACE_THIS( tiles = TIFFTileSize( tileSize ));
+
+   // Create the TIFF file and write the image
+   TiffFile tiff( filename, UseBigTIFF( TIFFDataSize( image )));
+   DIP_STACK_TRACE_THIS( WriteTIFFImage( image, tiff, compmode, jpegLevel, tiles ));
+}
+
+void ImageWriteTIFFPyramid(
+      Image const& image,
+      String const& filename,
+      dip::uint levels,
+      String const& compression,
+      dip::uint jpegLevel,
+      UnsignedArray const& tileSize
+) {
+   DIP_STACK_TRACE_THIS( CheckTIFFImage( image ));
+   DIP_THROW_IF( tileSize.empty(), E::ARRAY_PARAMETER_EMPTY );
+   uint16 compmode = CompressionTranslate( compression );
+   UnsignedArray tiles;
+   DIP_STACK_TRACE_THIS( tiles = TIFFTileSize( tileSize ));
+   if( levels == 0 ) {
+      // Add levels until the image fits in a single tile
+      levels = 1;
+      dip::uint width = image.Size( 0 );
+      dip::uint length = image.Size( 1 );
+      while(( width > tiles[ 0 ] ) || ( length > tiles[ 1 ] )) {
+         width = std::max< dip::uint >( width / 2, 1 );
+         length = std::max< dip::uint >( length / 2, 1 );
+         ++levels;
+      }
+   }
+   DIP_THROW_IF( levels > std::numeric_limits< uint16 >::max(), E::PARAMETER_OUT_OF_RANGE );
+
+   // The reduced-resolution levels together are at most a third of the size of the full-resolution image
+   TiffFile tiff( filename, UseBigTIFF( TIFFDataSize( image ) / 3 * 4 ));
+
+   // The full-resolution image, with a reference to each of the reduced-resolution levels. libtiff writes the
+   // `levels - 1` directories following this one as its SubIFDs, and fills in their offsets.
+   if( levels > 1 ) {
+      std::vector< toff_t > subIFDs( levels - 1, 0 );
+      if( !TIFFSetField( tiff, TIFFTAG_SUBIFD, static_cast< uint16 >( levels - 1 ), subIFDs.data() )) {
+         DIP_THROW_RUNTIME( TIFF_WRITE_TAG );
+      }
+   }
+   DIP_STACK_TRACE_THIS( WriteTIFFImage( image, tiff, compmode, jpegLevel, tiles ));
+   if( !TIFFWriteDirectory( tiff )) {
+      DIP_THROW_RUNTIME( "Error writing data" );
+   }
+
+   // The reduced-resolution levels, each computed from the previous one, so we hold only two levels in memory
+   Image level;
+   for( dip::uint ii = 1; ii < levels; ++ii ) {
+      DIP_STACK_TRACE_THIS( level = HalveImage( ii == 1 ? image : level ));
+      WRITE_TIFF_TAG( tiff, TIFFTAG_SUBFILETYPE, uint32( FILETYPE_REDUCEDIMAGE ));
+      DIP_STACK_TRACE_THIS( WriteTIFFImage( level, tiff, compmode, jpegLevel, tiles ));
+      if( !TIFFWriteDirectory( tiff )) {
+         DIP_THROW_RUNTIME( "Error writing data" );
+      }
+   }
+}
+
+namespace {
+
+class TIFFPlaneSink : public ImagePlaneSink {
+   public:
+      TIFFPlaneSink( String const& filename, bool bigTiff, uint16 compmode )
+            : tiff_( filename, bigTiff ), compmode_( compmode ) {}
+
+      void WritePlanes( Image const& planes ) override {
+         dip::uint nDims = planes.Dimensionality();
+         RangeArray ranges( nDims );
+         for( dip::uint ii = 0; ii < planes.Size( nDims - 1 ); ++ii ) {
+            ranges.back() = Range( static_cast< dip::sint >( ii ));
+            Image plane = planes.At( ranges );
+            plane.Squeeze( nDims - 1 );
+            DIP_STACK_TRACE_THIS( CheckTIFFImage( plane ));
+            DIP_STACK_TRACE_THIS( WriteTIFFImage( plane, tiff_, compmode_, 80, {} ));
+            if( !TIFFWriteDirectory( tiff_ )) {
+               DIP_THROW_RUNTIME( "Error writing data" );
+            }
+         }
+      }
+
+      void Close() override {}
+
+   private:
+      TiffFile tiff_;
+      uint16 compmode_;
+};
+
+} // namespace
+
+std::unique_ptr< ImagePlaneSink > CreateTIFFPlaneSink(
+      String const& filename,
+      Image const& image,
+      String const& compression
+) {
+   DIP_THROW_IF( image.Dimensionality() != 3, E::DIMENSIONALITY_NOT_SUPPORTED );
+   uint16 compmode = CompressionTranslate( compression );
+   uint64 dataSize = TIFFDataSize( image ) * image.Size( 2 );
+   return std::make_unique< TIFFPlaneSink >( filename, UseBigTIFF( dataSize ), compmode );
+}
+
 } // namespace dip
 
 #ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
 #include "doctest.h"
 #include "diplib/testing.h"
 
 DOCTEST_TEST_CASE( "[DIPlib] testing TIFF file reading and writing" ) {
    dip::Image image = dip::ImageReadTIFF( DIP__EXAMPLES_DIR "/fractal1.tiff" );
    image.SetPixelSize( dip::PhysicalQuantityArray{ 6 * dip::Units::Micrometer(), 300 * dip::Units::Nanometer() } );
+   // Compressed tiles and strips, and the files of a series, are read by multiple threads, also on a single core
+   dip::uint nThreads = dip::GetNumberOfThreads();
+   dip::SetNumberOfThreads( 4 );
 
    dip::ImageWriteTIFF( image, "test1.tif" );
    dip::Image result = dip::ImageReadTIFF( "test1" );
@@ -398,6 +682,89 @@ DOCTEST_TEST_CASE( "[DIPlib] testing TIFF file reading and writing" ) {
    dip::ImageWriteTIFF( image, "test2.tif" );
    result = dip::ImageReadTIFF( "test2" );
    DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+
+   // Write tiled, with partial tiles along the image edges
+   dip::ImageWriteTIFF( image, "test3.tif", "deflate", 80, { 48, 32 } );
+   result = dip::ImageReadTIFF( "test3" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   dip::ImageWriteTIFF( image, "test4.tif", "LZW", 80, { 16 } );
+   result = dip::ImageReadTIFF( "test4" );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+
+   // Write a pyramid, and read parts of its levels
+   dip::ImageWriteTIFFPyramid( image, "test5.tif", 0, "deflate", 80, { 64 } );
+   dip::uint levels = dip::ImageReadTIFFNumberOfLevels( "test5" );
+   DOCTEST_CHECK( levels > 1 );
+   result = dip::ImageReadTIFFLevel( "test5", 0 );
+   DOCTEST_CHECK( dip::testing::CompareImages( image, result ));
+   result = dip::ImageReadTIFFLevel( "test5", 0, { dip::Range{ 10, 40 }, dip::Range{ 5, 20 } } );
+   DOCTEST_CHECK( dip::testing::CompareImages( image.At( dip::Range{ 10, 40 }, dip::Range{ 5, 20 } ), result ));
+   // Level 1 is a SubIFD, which the parallel tile decoder must read from the right directory
+   result = dip::ImageReadTIFFLevel( "test5", 1 );
+   DOCTEST_CHECK( result.Size( 0 ) == image.Size( 0 ) / 2 );
+   DOCTEST_CHECK( result.Size( 1 ) == image.Size( 1 ) / 2 );
+   {
+      // The reference 2x reduction: the rounded mean over each 2x2 block of pixels
+      dip::sint width = static_cast< dip::sint >( image.Size( 0 ) / 2 );
+      dip::sint length = static_cast< dip::sint >( image.Size( 1 ) / 2 );
+      auto block = [ & ]( dip::sint dx, dip::sint dy ) {
+         return image.At( dip::Range{ dx, dx + 2 * ( width - 1 ), 2 }, dip::Range{ dy, dy + 2 * ( length - 1 ), 2 } );
+      };
+      dip::Image reference = dip::Add( block( 0, 0 ), block( 1, 0 ), dip::DT_SFLOAT );
+      reference += block( 0, 1 );
+      reference += block( 1, 1 );
+      reference += 2;
+      reference *= 0.25;
+      reference.Convert( image.DataType() );
+      DOCTEST_CHECK( dip::testing::CompareImages( reference, result ));
+   }
+   result = dip::ImageReadTIFFLevel( "test5", levels - 1 );
+   DOCTEST_CHECK( result.Size( 0 ) <= 64 );
+   DOCTEST_CHECK( result.Size( 1 ) <= 64 );
+   DOCTEST_CHECK_THROWS( dip::ImageReadTIFFLevel( "test5", levels ));
+
+   // Read a series of files as a 3D image
+   dip::StringArray filenames;
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      filenames.push_back( "test_series" + std::to_string( ii ) + ".tif" );
+      dip::ImageWriteTIFF( image + dip::uint8( ii ), filenames.back(), "deflate" );
+   }
+   dip::FileInformation info = dip::ImageReadTIFFSeriesInfo( filenames );
+   DOCTEST_CHECK( info.sizes == dip::UnsignedArray{ image.Size( 0 ), image.Size( 1 ), 5 } );
+   dip::uint count = 0;
+   result = dip::ImageReadTIFFSeries( filenames, [ & ]( dip::uint done, dip::uint total ) {
+      DOCTEST_CHECK( done == ++count );
+      DOCTEST_CHECK( total == 5 );
+   } );
+   DOCTEST_CHECK( count == 5 );
+   DOCTEST_REQUIRE( result.Sizes() == info.sizes );
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      dip::Image plane = result.At( dip::Range{}, dip::Range{}, dip::Range( static_cast< dip::sint >( ii )));
+      DOCTEST_CHECK( dip::testing::CompareImages( image + dip::uint8( ii ), plane.Squeeze() ));
+   }
+   // Read into a protected image of a different type, each file is read into a temporary and copied
+   result.Strip();
+   result.SetDataType( dip::DT_SFLOAT );
+   result.Protect();
+   dip::ImageReadTIFFSeries( result, filenames );
+   DOCTEST_CHECK( result.DataType() == dip::DT_SFLOAT );
+   DOCTEST_REQUIRE( result.Sizes() == info.sizes );
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      dip::Image plane = result.At( dip::Range{}, dip::Range{}, dip::Range( static_cast< dip::sint >( ii )));
+      DOCTEST_CHECK( dip::testing::CompareImages( image + dip::uint8( ii ), plane.Squeeze() ));
+   }
+   dip::ImageWriteTIFF( image.At( dip::Range{ 0, 9 }, dip::Range{ 0, 9 } ), "test_series5.tif" );
+   filenames.push_back( "test_series5.tif" ); // has a different size
+   DOCTEST_CHECK_THROWS( dip::ImageReadTIFFSeriesInfo( filenames ));
+   DOCTEST_CHECK_THROWS( dip::ImageReadTIFFSeries( filenames ));
+   dip::SetNumberOfThreads( nThreads );
+
+   for( auto const& name : filenames ) {
+      std::remove( name.c_str() );
+   }
+   for( char const* name : { "test1.tif", "test2.tif", "test3.tif", "test4.tif", "test5.tif" } ) {
+      std::remove( name );
+   }
 }
 
 #endif // DIP__ENABLE_DOCTEST
@@ -407,11 +774,21 @@ DOCTEST_TEST_CASE( "[DIPlib] testing TIFF file reading and writing" ) {
 #include "diplib.h"
 #include "diplib/file_io.h"
 
+#include "file_io_support.h"
+
 namespace dip {
 
 static const char* NOT_AVAILABLE = "DIPlib was compiled without TIFF support.";
 
-void ImageWriteTIFF( Image const&, String const&, String const&, dip::uint ) {
+void ImageWriteTIFF( Image const&, String const&, String const&, dip::uint, UnsignedArray const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+void ImageWriteTIFFPyramid( Image const&, String const&, dip::uint, String const&, dip::uint, UnsignedArray const& ) {
+   DIP_THROW( NOT_AVAILABLE );
+}
+
+std::unique_ptr< ImagePlaneSink > CreateTIFFPlaneSink( String const&, Image const&, String const& ) {
    DIP_THROW( NOT_AVAILABLE );
 }
 
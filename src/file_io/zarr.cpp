@@ -0,0 +1,789 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for the chunked image store, using the Zarr format
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "diplib.h"
+#include "diplib/file_io.h"
+#include "diplib/multithreading.h"
+
+#include "file_io_support.h"
+
+#ifdef DIP__HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _WIN32
+   #include <direct.h>
+#else
+   #include <sys/stat.h>
+#endif
+
+namespace dip {
+
+namespace {
+
+constexpr char const* ZARR_INVALID = "Invalid Zarr array metadata";
+
+// --- A minimal JSON reader, sufficient for the Zarr metadata files ---
+
+String::size_type SkipJSONWhiteSpace( String const& json, String::size_type pos ) {
+   while(( pos < json.size() ) && (( json[ pos ] == ' ' ) || ( json[ pos ] == '\t' ) || ( json[ pos ] == '\r' ) || ( json[ pos ] == '\n' ))) {
+      ++pos;
+   }
+   return pos;
+}
+
+// Returns the position just past the end of the JSON value that starts at `pos`
+String::size_type SkipJSONValue( String const& json, String::size_type pos ) {
+   dip::uint depth = 0;
+   bool inString = false;
+   for( ; pos < json.size(); ++pos ) {
+      char c = json[ pos ];
+      if( inString ) {
+         if( c == '\\' ) {
+            ++pos; // skip the escaped character
+         } else if( c == '"' ) {
+            inString = false;
+            if( depth == 0 ) {
+               return pos + 1;
+            }
+         }
+      } else if( c == '"' ) {
+         inString = true;
+      } else if(( c == '[' ) || ( c == '{' )) {
+         ++depth;
+      } else if(( c == ']' ) || ( c == '}' )) {
+         if( depth == 0 ) {
+            return pos; // end of the enclosing array or object
+         }
+         if( --depth == 0 ) {
+            return pos + 1;
+         }
+      } else if(( depth == 0 ) && (( c == ',' ) || ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\n' ))) {
+         return pos;
+      }
+   }
+   return pos;
+}
+
+// Returns the elements of the JSON array or object `json`, as unparsed strings. For an object, returns keys
+// and values alternately.
+StringArray JSONElements( String const& json ) {
+   StringArray elements;
+   auto pos = SkipJSONWhiteSpace( json, 0 );
+   if(( pos >= json.size() ) || (( json[ pos ] != '[' ) && ( json[ pos ] != '{' ))) {
+      return elements;
+   }
+   pos = SkipJSONWhiteSpace( json, pos + 1 );
+   while(( pos < json.size() ) && ( json[ pos ] != ']' ) && ( json[ pos ] != '}' )) {
+      auto end = SkipJSONValue( json, pos );
+      if( end == pos ) {
+         break; // invalid JSON
+      }
+      elements.push_back( json.substr( pos, end - pos ));
+      pos = SkipJSONWhiteSpace( json, end );
+      if(( pos < json.size() ) && (( json[ pos ] == ',' ) || ( json[ pos ] == ':' ))) {
+         pos = SkipJSONWhiteSpace( json, pos + 1 );
+      }
+   }
+   return elements;
+}
+
+// Returns the contents of the JSON string `json`, or an empty string if it is not a string
+String JSONString( String const& json ) {
+   String out;
+   if(( json.size() < 2 ) || ( json[ 0 ] != '"' )) {
+      return out;
+   }
+   for( dip::uint ii = 1; ii < json.size() - 1; ++ii ) {
+      if(( json[ ii ] == '\\' ) && ( ii + 1 < json.size() - 1 )) {
+         ++ii; // we don't need to support escape codes other than \" and \\ .
+      }
+      out.push_back( json[ ii ] );
+   }
+   return out;
+}
+
+// Returns the unparsed value for `key` in the JSON object `json`, or an empty string if it is not there
+String JSONValue( String const& json, char const* key ) {
+   auto pos = SkipJSONWhiteSpace( json, 0 );
+   if(( pos >= json.size() ) || ( json[ pos ] != '{' )) {
+      return {};
+   }
+   StringArray elements = JSONElements( json );
+   for( dip::uint ii = 0; ii + 1 < elements.size(); ii += 2 ) {
+      if( JSONString( elements[ ii ] ) == key ) {
+         return elements[ ii + 1 ];
+      }
+   }
+   return {};
+}
+
+// Returns a JSON string literal for `value`
+String JSONQuote( String const& value ) {
+   String out = "\"";
+   for( char c : value ) {
+      if(( c == '"' ) || ( c == '\\' )) {
+         out.push_back( '\\' );
+      }
+      out.push_back( c );
+   }
+   out.push_back( '"' );
+   return out;
+}
+
+String ReadTextFile( String const& filename ) {
+   std::ifstream file( filename, std::ios::binary );
+   if( !file ) {
+      return {};
+   }
+   std::ostringstream contents;
+   contents << file.rdbuf();
+   return contents.str();
+}
+
+void WriteTextFile( String const& filename, String const& contents ) {
+   std::ofstream file( filename, std::ios::binary | std::ios::trunc );
+   file.write( contents.data(), static_cast< std::streamsize >( contents.size() ));
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't write Zarr metadata file " + filename );
+   }
+}
+
+void CreateDirectory( String const& directory ) {
+#ifdef _WIN32
+   int result = _mkdir( directory.c_str() );
+#else
+   int result = mkdir( directory.c_str(), 0777 );
+#endif
+   if(( result != 0 ) && ( errno != EEXIST )) {
+      DIP_THROW_RUNTIME( "Couldn't create directory " + directory );
+   }
+}
+
+// --- Chunk compression ---
+
+bool ReadChunkFile( String const& filename, std::vector< uint8 >& data ) {
+   std::ifstream file( filename, std::ios::binary | std::ios::ate );
+   if( !file ) {
+      return false;
+   }
+   data.resize( static_cast< dip::uint >( file.tellg() ));
+   file.seekg( 0 );
+   file.read( reinterpret_cast< char* >( data.data() ), static_cast< std::streamsize >( data.size() ));
+   if( !file ) {
+      DIP_THROW_RUNTIME( "Couldn't read Zarr chunk " + filename );
+   }
+   return true;
+}
+
+// Decompresses `data` into the `length` bytes at `dest`. `compression` is "zlib", "gzip" or empty.
+void DecodeChunk( std::vector< uint8 > const& data, String const& compression, uint8* dest, dip::uint length ) {
+   if( compression.empty() ) {
+      if( data.size() != length ) {
+         DIP_THROW_RUNTIME( "Zarr chunk has the wrong size" );
+      }
+      std::copy( data.begin(), data.end(), dest );
+      return;
+   }
+#ifdef DIP__HAS_ZLIB
+   z_stream stream{};
+   if( inflateInit2( &stream, MAX_WBITS + 32 ) != Z_OK ) { // detects both the zlib and gzip headers
+      DIP_THROW_RUNTIME( "Couldn't initialize zlib" );
+   }
+   stream.next_in = const_cast< uint8* >( data.data() ); // older zlib versions don't declare `next_in` as const
+   stream.avail_in = static_cast< uInt >( data.size() );
+   stream.next_out = dest;
+   stream.avail_out = static_cast< uInt >( length );
+   int result = inflate( &stream, Z_FINISH );
+   bool success = ( result == Z_STREAM_END ) && ( stream.avail_out == 0 );
+   inflateEnd( &stream );
+   if( !success ) {
+      DIP_THROW_RUNTIME( "Zarr chunk is corrupt or has the wrong size" );
+   }
+#else
+   ( void )dest;
+   ( void )length;
+   DIP_THROW_RUNTIME( "Reading compressed Zarr chunks requires zlib, which is not available" );
+#endif
+}
+
+// Compresses the `length` bytes at `src` into `out`. `compression` is "zlib", "gzip" or empty.
+void EncodeChunk( uint8 const* src, dip::uint length, String const& compression, int level, std::vector< uint8 >& out ) {
+   if( compression.empty() ) {
+      out.assign( src, src + length );
+      return;
+   }
+#ifdef DIP__HAS_ZLIB
+   z_stream stream{};
+   int windowBits = compression == "gzip" ? MAX_WBITS + 16 : MAX_WBITS;
+   if( deflateInit2( &stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY ) != Z_OK ) {
+      DIP_THROW_RUNTIME( "Couldn't initialize zlib" );
+   }
+   out.resize( deflateBound( &stream, static_cast< uLong >( length )) + 32 ); // room for the gzip header
+   stream.next_in = const_cast< uint8* >( src );
+   stream.avail_in = static_cast< uInt >( length );
+   stream.next_out = out.data();
+   stream.avail_out = static_cast< uInt >( out.size() );
+   int result = deflate( &stream, Z_FINISH );
+   out.resize( out.size() - stream.avail_out );
+   deflateEnd( &stream );
+   if( result != Z_STREAM_END ) {
+      DIP_THROW_RUNTIME( "Couldn't compress Zarr chunk" );
+   }
+#else
+   ( void )level;
+   ( void )out;
+   DIP_THROW_RUNTIME( "Writing compressed Zarr chunks requires zlib, which is not available" );
+#endif
+}
+
+// Used to create unique names for temporary files
+std::atomic< dip::uint > temporaryFileCounter( 0 );
+
+} // namespace
+
+ImageChunkStore::ImageChunkStore( String const& directory ) : directory_( directory ) {
+   String zarray = ReadTextFile( directory_ + "/.zarray" );
+   if( zarray.empty() ) {
+      DIP_THROW_RUNTIME( "Couldn't open Zarr array " + directory_ );
+   }
+   if( JSONValue( zarray, "zarr_format" ) != "2" ) {
+      DIP_THROW_RUNTIME( "Zarr array is not in version 2 format" );
+   }
+   if( JSONString( JSONValue( zarray, "order" )) != "C" ) {
+      DIP_THROW_RUNTIME( "Zarr arrays with Fortran-order chunks are not supported" );
+   }
+   String filters = JSONValue( zarray, "filters" );
+   if( !filters.empty() && ( filters != "null" ) && !JSONElements( filters ).empty() ) {
+      DIP_THROW_RUNTIME( "Zarr arrays with filters are not supported" );
+   }
+   String compressor = JSONValue( zarray, "compressor" );
+   if( !compressor.empty() && ( compressor != "null" )) {
+      compression_ = JSONString( JSONValue( compressor, "id" ));
+      if(( compression_ != "zlib" ) && ( compression_ != "gzip" )) {
+         DIP_THROW_RUNTIME( "Zarr array with unsupported compressor: " + compression_ );
+      }
+      String level = JSONValue( compressor, "level" );
+      if( !level.empty() ) {
+         compressionLevel_ = std::strtoull( level.c_str(), nullptr, 10 );
+      }
+   }
+   String separator = JSONString( JSONValue( zarray, "dimension_separator" ));
+   if( separator == "/" ) {
+      separator_ = '/';
+   }
+
+   // Data type
+   bool swapBytes;
+   DIP_STACK_TRACE_THIS( information_.dataType = DataTypeFromNumPyTypeString( JSONString( JSONValue( zarray, "dtype" )), swapBytes, "Zarr" ));
+   swapBytes_ = swapBytes;
+   information_.significantBits = information_.dataType.IsBinary() ? 1 : information_.dataType.SizeOf() * 8;
+
+   // Shape and chunks, in C order: we reverse them to get the image dimensions
+   StringArray shape = JSONElements( JSONValue( zarray, "shape" ));
+   StringArray chunks = JSONElements( JSONValue( zarray, "chunks" ));
+   if( shape.empty() || ( shape.size() != chunks.size() )) {
+      DIP_THROW_RUNTIME( ZARR_INVALID );
+   }
+   for( dip::uint ii = shape.size(); ii > 0; ) {
+      --ii;
+      information_.sizes.push_back( std::strtoull( shape[ ii ].c_str(), nullptr, 10 ));
+      chunkSizes_.push_back( std::strtoull( chunks[ ii ].c_str(), nullptr, 10 ));
+      if(( information_.sizes.back() == 0 ) || ( chunkSizes_.back() == 0 )) {
+         DIP_THROW_RUNTIME( ZARR_INVALID );
+      }
+   }
+
+   // Fill value: a number, `null`, a boolean, or one of the strings "NaN", "Infinity" and "-Infinity"
+   String fillValue = JSONValue( zarray, "fill_value" );
+   if( !fillValue.empty() && ( fillValue[ 0 ] == '[' )) {
+      StringArray elements = JSONElements( fillValue ); // complex value
+      fillValue = elements.empty() ? String{} : elements[ 0 ];
+   }
+   if( fillValue == "true" ) {
+      fillValue_ = 1;
+   } else if( !fillValue.empty() && ( fillValue[ 0 ] == '"' )) {
+      fillValue = JSONString( fillValue );
+      fillValue_ = fillValue == "NaN" ? std::nan( "" )
+                                      : ( fillValue[ 0 ] == '-' ? -std::numeric_limits< dfloat >::infinity()
+                                                                : std::numeric_limits< dfloat >::infinity() );
+   } else {
+      fillValue_ = std::strtod( fillValue.c_str(), nullptr ); // 0 for `null` and `false`
+   }
+
+   // Our own attributes: the tensor dimension is the first array dimension, which is the last one in `sizes`
+   information_.name = directory_;
+   information_.fileType = "Zarr";
+   information_.numberOfImages = 1;
+   information_.tensorElements = 1;
+   String attributes = JSONValue( ReadTextFile( directory_ + "/.zattrs" ), "diplib" );
+   String tensorElements = JSONValue( attributes, "tensor_elements" );
+   if( !tensorElements.empty() ) {
+      information_.tensorElements = std::strtoull( tensorElements.c_str(), nullptr, 10 );
+      if(( information_.tensorElements > 1 ) && (( information_.sizes.size() < 2 ) ||
+         ( information_.sizes.back() != information_.tensorElements ) || ( chunkSizes_.back() != information_.tensorElements ))) {
+         DIP_THROW_RUNTIME( ZARR_INVALID );
+      }
+      if( information_.tensorElements > 1 ) {
+         information_.sizes.pop_back();
+         chunkSizes_.pop_back();
+      } else {
+         information_.tensorElements = 1;
+      }
+   }
+   information_.colorSpace = JSONString( JSONValue( attributes, "color_space" ));
+   StringArray pixelSize = JSONElements( JSONValue( attributes, "pixel_size" ));
+   for( dip::uint ii = 0; ii < std::min( pixelSize.size(), information_.sizes.size() ); ++ii ) {
+      dfloat magnitude = std::strtod( JSONValue( pixelSize[ ii ], "magnitude" ).c_str(), nullptr );
+      String units = JSONString( JSONValue( pixelSize[ ii ], "units" ));
+      try {
+         PhysicalQuantity pq{ magnitude, Units{ units }};
+         pq.Normalize();
+         information_.pixelSize.Set( ii, pq );
+      } catch( Error const& ) {
+         // `Units` failed to parse the string
+         information_.pixelSize.Set( ii, magnitude );
+      }
+   }
+
+   numberOfChunks_.resize( information_.sizes.size() );
+   for( dip::uint ii = 0; ii < numberOfChunks_.size(); ++ii ) {
+      numberOfChunks_[ ii ] = div_ceil( information_.sizes[ ii ], chunkSizes_[ ii ] );
+   }
+}
+
+ImageChunkStore::ImageChunkStore(
+      String const& directory,
+      FileInformation const& information,
+      UnsignedArray const& chunkSizes,
+      String const& compression,
+      dip::uint compressionLevel
+) : directory_( directory ), information_( information ), chunkSizes_( chunkSizes ) {
+   dip::uint nDims = information_.sizes.size();
+   DIP_THROW_IF( nDims == 0, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_THROW_IF( information_.sizes.product() == 0, E::INVALID_PARAMETER );
+   DIP_THROW_IF( information_.tensorElements == 0, E::INVALID_PARAMETER );
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( chunkSizes_, nDims, dip::uint( 64 )));
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      DIP_THROW_IF( chunkSizes_[ ii ] == 0, E::INVALID_PARAMETER );
+      chunkSizes_[ ii ] = std::min( chunkSizes_[ ii ], information_.sizes[ ii ] );
+   }
+   if( compression == "zlib" || compression == "gzip" ) {
+#ifndef DIP__HAS_ZLIB
+      DIP_THROW_RUNTIME( "Compressed Zarr chunks require zlib, which is not available" );
+#endif
+      DIP_THROW_IF( compressionLevel > 9, E::PARAMETER_OUT_OF_RANGE );
+      compression_ = compression;
+      compressionLevel_ = compressionLevel;
+   } else if( compression != "none" ) {
+      DIP_THROW_INVALID_FLAG( compression );
+   }
+   String typestr;
+   DIP_STACK_TRACE_THIS( typestr = NumPyTypeString( information_.dataType ));
+   information_.name = directory_;
+   information_.fileType = "Zarr";
+   information_.numberOfImages = 1;
+   information_.significantBits = information_.dataType.IsBinary() ? 1 : information_.dataType.SizeOf() * 8;
+   information_.pixelSize.Resize( nDims );
+   numberOfChunks_.resize( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      numberOfChunks_[ ii ] = div_ceil( information_.sizes[ ii ], chunkSizes_[ ii ] );
+   }
+
+   // The array metadata, with dimensions in C order
+   bool isTensor = information_.tensorElements > 1;
+   auto cOrder = [ & ]( UnsignedArray const& values ) {
+      String out = "[";
+      if( isTensor ) {
+         out += std::to_string( information_.tensorElements ) + ", ";
+      }
+      for( dip::uint ii = nDims; ii > 0; ) {
+         --ii;
+         out += std::to_string( values[ ii ] ) + ( ii > 0 ? ", " : "" );
+      }
+      return out + "]";
+   };
+   std::ostringstream zarray;
+   zarray << "{\n";
+   zarray << "    \"chunks\": " << cOrder( chunkSizes_ ) << ",\n";
+   if( compression_.empty() ) {
+      zarray << "    \"compressor\": null,\n";
+   } else {
+      zarray << "    \"compressor\": {\"id\": " << JSONQuote( compression_ ) << ", \"level\": " << compressionLevel_ << "},\n";
+   }
+   zarray << "    \"dimension_separator\": \".\",\n";
+   zarray << "    \"dtype\": " << JSONQuote( typestr ) << ",\n";
+   zarray << "    \"fill_value\": " << ( information_.dataType.IsBinary() ? "false" : "0" ) << ",\n";
+   zarray << "    \"filters\": null,\n";
+   zarray << "    \"order\": \"C\",\n";
+   zarray << "    \"shape\": " << cOrder( information_.sizes ) << ",\n";
+   zarray << "    \"zarr_format\": 2\n";
+   zarray << "}\n";
+
+   // Our own attributes, with dimensions in DIPlib order
+   std::ostringstream zattrs;
+   zattrs << std::setprecision( 15 );
+   zattrs << "{\n    \"diplib\": {\n";
+   zattrs << "        \"tensor_elements\": " << information_.tensorElements << ",\n";
+   zattrs << "        \"color_space\": " << JSONQuote( information_.colorSpace ) << ",\n";
+   zattrs << "        \"pixel_size\": [";
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      PhysicalQuantity const& pq = information_.pixelSize[ ii ];
+      zattrs << "{\"magnitude\": " << pq.magnitude << ", \"units\": " << JSONQuote( pq.units.String() ) << "}" << ( ii < nDims - 1 ? ", " : "" );
+   }
+   zattrs << "]\n    }\n}\n";
+
+   DIP_STACK_TRACE_THIS( CreateDirectory( directory_ ));
+   DIP_STACK_TRACE_THIS( WriteTextFile( directory_ + "/.zarray", zarray.str() ));
+   DIP_STACK_TRACE_THIS( WriteTextFile( directory_ + "/.zattrs", zattrs.str() ));
+}
+
+RangeArray ImageChunkStore::ChunkRegion( UnsignedArray const& chunk ) const {
+   DIP_THROW_IF( chunk.size() != numberOfChunks_.size(), E::ARRAY_PARAMETER_WRONG_LENGTH );
+   RangeArray region( chunk.size() );
+   for( dip::uint ii = 0; ii < chunk.size(); ++ii ) {
+      DIP_THROW_IF( chunk[ ii ] >= numberOfChunks_[ ii ], E::INDEX_OUT_OF_RANGE );
+      dip::uint start = chunk[ ii ] * chunkSizes_[ ii ];
+      dip::uint stop = std::min( start + chunkSizes_[ ii ], information_.sizes[ ii ] );
+      region[ ii ] = Range{ static_cast< dip::sint >( start ), static_cast< dip::sint >( stop - 1 ) };
+   }
+   return region;
+}
+
+String ImageChunkStore::ChunkFileName( UnsignedArray const& chunk ) const {
+   // The key lists the chunk indices in C order
+   String key = information_.tensorElements > 1 ? "0" : "";
+   for( dip::uint ii = chunk.size(); ii > 0; ) {
+      --ii;
+      if( !key.empty() ) {
+         key.push_back( separator_ );
+      }
+      key += std::to_string( chunk[ ii ] );
+   }
+   return directory_ + "/" + key;
+}
+
+Image ImageChunkStore::NewChunkBuffer() const {
+   // The chunk's samples are in C order, the tensor dimension (if any) is the slowest one
+   UnsignedArray sizes = chunkSizes_;
+   if( information_.tensorElements > 1 ) {
+      sizes.push_back( information_.tensorElements );
+   }
+   Image buffer( sizes, 1, information_.dataType );
+   DIP_ASSERT( buffer.HasNormalStrides() );
+   if( information_.tensorElements > 1 ) {
+      buffer.SpatialToTensor( sizes.size() - 1 );
+   }
+   return buffer;
+}
+
+void ImageChunkStore::ReadChunk( UnsignedArray const& chunk, Image& out ) const {
+   RangeArray region;
+   DIP_STACK_TRACE_THIS( region = ChunkRegion( chunk ));
+   Image buffer = NewChunkBuffer();
+   std::vector< uint8 > data;
+   if( ReadChunkFile( ChunkFileName( chunk ), data )) {
+      dip::uint sizeOf = information_.dataType.SizeOf();
+      dip::uint nSamples = buffer.NumberOfSamples();
+      uint8* dest = static_cast< uint8* >( buffer.Origin() );
+      DIP_STACK_TRACE_THIS( DecodeChunk( data, compression_, dest, nSamples * sizeOf ));
+      if( swapBytes_ ) {
+         // Complex values are swapped per component
+         dip::uint swapSize = information_.dataType.IsComplex() ? sizeOf / 2 : sizeOf;
+         SwapBytes( dest, nSamples * sizeOf / swapSize, swapSize );
+      }
+   } else {
+      // Chunks that were never written contain the fill value
+      buffer.Fill( fillValue_ );
+   }
+   for( dip::uint ii = 0; ii < region.size(); ++ii ) {
+      region[ ii ] = Range{ 0, static_cast< dip::sint >( region[ ii ].Size() ) - 1 };
+   }
+   Image valid = buffer.At( region );
+   valid.SetColorSpace( information_.colorSpace );
+   valid.SetPixelSize( information_.pixelSize );
+   DIP_STACK_TRACE_THIS( out.Copy( valid ));
+}
+
+void ImageChunkStore::WriteChunk( UnsignedArray const& chunk, Image const& data ) const {
+   DIP_THROW_IF( !data.IsForged(), E::IMAGE_NOT_FORGED );
+   RangeArray region;
+   DIP_STACK_TRACE_THIS( region = ChunkRegion( chunk ));
+   UnsignedArray sizes( region.size() );
+   for( dip::uint ii = 0; ii < region.size(); ++ii ) {
+      sizes[ ii ] = region[ ii ].Size();
+      region[ ii ] = Range{ 0, static_cast< dip::sint >( sizes[ ii ] ) - 1 };
+   }
+   DIP_THROW_IF( data.Sizes() != sizes, E::SIZES_DONT_MATCH );
+   DIP_THROW_IF( data.TensorElements() != information_.tensorElements, E::NTENSORELEM_DONT_MATCH );
+   Image buffer = NewChunkBuffer();
+   if( sizes != chunkSizes_ ) {
+      // Chunks at the image edge are padded with the fill value
+      buffer.Fill( fillValue_ );
+   }
+   Image valid = buffer.At( region );
+   DIP_STACK_TRACE_THIS( valid.Copy( data ));
+   std::vector< uint8 > encoded;
+   DIP_STACK_TRACE_THIS( EncodeChunk( static_cast< uint8 const* >( buffer.Origin() ),
+                                      buffer.NumberOfSamples() * information_.dataType.SizeOf(),
+                                      compression_, static_cast< int >( compressionLevel_ ), encoded ));
+
+   // Write to a temporary file and rename it, such that readers never see a partially written chunk
+   String filename = ChunkFileName( chunk );
+   String temporary = filename + "." + std::to_string( std::hash< std::thread::id >()( std::this_thread::get_id() )) +
+                      "." + std::to_string( temporaryFileCounter++ ) + ".tmp";
+   {
+      std::ofstream file( temporary, std::ios::binary | std::ios::trunc );
+      file.write( reinterpret_cast< char const* >( encoded.data() ), static_cast< std::streamsize >( encoded.size() ));
+      if( !file ) {
+         DIP_THROW_RUNTIME( "Couldn't write Zarr chunk " + filename );
+      }
+   }
+   if( std::rename( temporary.c_str(), filename.c_str() ) != 0 ) {
+      // On Windows, `rename` doesn't replace an existing file
+      std::remove( filename.c_str() );
+      if( std::rename( temporary.c_str(), filename.c_str() ) != 0 ) {
+         std::remove( temporary.c_str() );
+         DIP_THROW_RUNTIME( "Couldn't write Zarr chunk " + filename );
+      }
+   }
+}
+
+namespace {
+
+// Calls `function` for each chunk in the box from `first` to `first + n - 1`, in parallel
+void ForEachChunk(
+      UnsignedArray const& first,
+      UnsignedArray const& n,
+      std::function< void( UnsignedArray const& ) > const& function
+) {
+   dip::uint count = n.product();
+   dip::uint nThreads = std::min( GetNumberOfThreads(), count );
+   std::atomic< bool > failed( false );
+   std::exception_ptr error; // the first exception thrown, rethrown after the parallel region
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      UnsignedArray chunk( first.size() );
+      #pragma omp for schedule( dynamic )
+      for( dip::sint ii = 0; ii < static_cast< dip::sint >( count ); ++ii ) {
+         if( failed ) {
+            continue;
+         }
+         dip::uint index = static_cast< dip::uint >( ii );
+         for( dip::uint jj = 0; jj < chunk.size(); ++jj ) {
+            chunk[ jj ] = first[ jj ] + index % n[ jj ];
+            index /= n[ jj ];
+         }
+         // No exception can leave the parallel region, that would terminate the program. This includes
+         // `std::bad_alloc` and I/O failures, not only `dip::Error`.
+         try {
+            function( chunk );
+         } catch( ... ) {
+            #pragma omp critical( ImageChunkStore_error )
+            if( !error ) {
+               error = std::current_exception();
+            }
+            failed = true;
+         }
+      }
+   }
+   if( error ) {
+      std::rethrow_exception( error );
+   }
+}
+
+} // namespace
+
+void ImageChunkStore::Read( Image& out, RangeArray const& c_roi ) const {
+   RangeArray roi = c_roi;
+   dip::uint nDims = information_.sizes.size();
+   if( roi.empty() ) {
+      roi.resize( nDims );
+   }
+   DIP_THROW_IF( roi.size() != nDims, E::ARRAY_PARAMETER_WRONG_LENGTH );
+   UnsignedArray sizes( nDims );
+   UnsignedArray firstChunk( nDims );
+   UnsignedArray nChunks( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      DIP_STACK_TRACE_THIS( roi[ ii ].Fix( information_.sizes[ ii ] ));
+      DIP_THROW_IF(( roi[ ii ].step != 1 ) || ( roi[ ii ].start > roi[ ii ].stop ), "ROI must be a box with increasing indices and a step of 1" );
+      sizes[ ii ] = roi[ ii ].Size();
+      firstChunk[ ii ] = roi[ ii ].Offset() / chunkSizes_[ ii ];
+      nChunks[ ii ] = roi[ ii ].Last() / chunkSizes_[ ii ] - firstChunk[ ii ] + 1;
+   }
+   DIP_STACK_TRACE_THIS( out.ReForge( sizes, information_.tensorElements, information_.dataType, Option::AcceptDataTypeChange::DO_ALLOW ));
+   if( out.TensorElements() == information_.tensorElements ) {
+      out.SetColorSpace( information_.colorSpace );
+   }
+   out.SetPixelSize( information_.pixelSize );
+   ForEachChunk( firstChunk, nChunks, [ & ]( UnsignedArray const& chunk ) {
+      // The part of this chunk that falls within the ROI, in chunk and in `out` coordinates
+      RangeArray region = ChunkRegion( chunk );
+      RangeArray source( nDims );
+      RangeArray destination( nDims );
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         dip::sint start = std::max( region[ ii ].start, roi[ ii ].start );
+         dip::sint stop = std::min( region[ ii ].stop, roi[ ii ].stop );
+         source[ ii ] = Range{ start - region[ ii ].start, stop - region[ ii ].start };
+         destination[ ii ] = Range{ start - roi[ ii ].start, stop - roi[ ii ].start };
+      }
+      Image data;
+      ReadChunk( chunk, data );
+      Image dest = out.At( destination );
+      dest.Copy( data.At( source ));
+   } );
+}
+
+void ImageChunkStore::Write( Image const& image ) const {
+   DIP_THROW_IF( !image.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( image.Sizes() != information_.sizes, E::SIZES_DONT_MATCH );
+   DIP_THROW_IF( image.TensorElements() != information_.tensorElements, E::NTENSORELEM_DONT_MATCH );
+   ForEachChunk( UnsignedArray( numberOfChunks_.size(), 0 ), numberOfChunks_, [ & ]( UnsignedArray const& chunk ) {
+      WriteChunk( chunk, image.At( ChunkRegion( chunk )));
+   } );
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/testing.h"
+#include "diplib/generation.h"
+#include "diplib/statistics.h"
+
+namespace {
+
+// Removes a chunk store written by the test below, `nChunks` is the number of chunks along each dimension
+void RemoveChunkStore( dip::String const& directory, dip::UnsignedArray const& nChunks, bool tensor ) {
+   dip::UnsignedArray chunk( nChunks.size(), 0 );
+   for( dip::uint ii = 0; ii < nChunks.product(); ++ii ) {
+      dip::uint index = ii;
+      dip::String key = tensor ? "0" : ""; // as in `dip::ImageChunkStore::ChunkFileName`
+      for( dip::uint jj = 0; jj < nChunks.size(); ++jj ) {
+         chunk[ jj ] = index % nChunks[ jj ];
+         index /= nChunks[ jj ];
+      }
+      for( dip::uint jj = nChunks.size(); jj > 0; ) {
+         --jj;
+         if( !key.empty() ) {
+            key.push_back( '.' );
+         }
+         key += std::to_string( chunk[ jj ] );
+      }
+      std::remove(( directory + "/" + key ).c_str() );
+   }
+   std::remove(( directory + "/.zarray" ).c_str() );
+   std::remove(( directory + "/.zattrs" ).c_str() );
+#ifdef _WIN32
+   _rmdir( directory.c_str() );
+#else
+   std::remove( directory.c_str() ); // removes empty directories on POSIX systems
+#endif
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE( "[DIPlib] testing the chunked image store" ) {
+   dip::Image image( { 50, 40, 13 }, 1, dip::DT_UINT16 );
+   dip::FillRamp( image, 0, { "corner" } );
+   image += dip::CreateRamp( image.Sizes(), 1, { "corner" } ) * 50;
+   image += dip::CreateRamp( image.Sizes(), 2, { "corner" } ) * 2000;
+   image.SetPixelSize( dip::PhysicalQuantityArray{ 0.5 * dip::Units::Micrometer(), 0.5 * dip::Units::Micrometer(),
+                                                   2.0 * dip::Units::Micrometer() } );
+   dip::FileInformation info;
+   info.sizes = image.Sizes();
+   info.tensorElements = 1;
+   info.dataType = image.DataType();
+   info.pixelSize = image.PixelSize();
+
+   // Write the whole image, read it back, and read an ROI that spans several chunks
+   for( auto compression : { "zlib", "none" } ) {
+      dip::ImageChunkStore store( "test1.zarr", info, { 16, 16, 5 }, compression );
+      DOCTEST_CHECK( store.NumberOfChunks() == dip::UnsignedArray{ 4, 3, 3 } );
+      store.Write( image );
+      dip::ImageChunkStore reader( "test1.zarr" );
+      DOCTEST_CHECK( reader.Information().sizes == image.Sizes() );
+      DOCTEST_CHECK( reader.ChunkSizes() == dip::UnsignedArray{ 16, 16, 5 } );
+      DOCTEST_CHECK( reader.Information().pixelSize == image.PixelSize() );
+      dip::Image result = reader.Read();
+      DOCTEST_CHECK( dip::testing::CompareImages( image, result, dip::Option::CompareImagesMode::FULL ));
+      dip::RangeArray roi{ dip::Range{ 10, 40 }, dip::Range{ 3, 20 }, dip::Range{ 4, 12 } };
+      result = reader.Read( roi );
+      DOCTEST_CHECK( dip::testing::CompareImages( image.At( roi ), result ));
+      // A chunk at the image edge, read into a view of a larger image
+      dip::Image larger( image.Sizes(), 1, dip::DT_UINT16 );
+      larger.Fill( 0 );
+      dip::Image view = larger.At( reader.ChunkRegion( { 3, 2, 2 } ));
+      DOCTEST_CHECK( view.Sizes() == dip::UnsignedArray{ 2, 8, 3 } );
+      reader.ReadChunk( { 3, 2, 2 }, view );
+      DOCTEST_CHECK( dip::testing::CompareImages( image.At( reader.ChunkRegion( { 3, 2, 2 } )), view ));
+   }
+   RemoveChunkStore( "test1.zarr", { 4, 3, 3 }, false );
+
+   // Chunks written independently by many threads, some left unwritten
+   dip::Image color( { 30, 20 }, 3, dip::DT_SFLOAT );
+   dip::Image channel = color[ 0 ];
+   channel.Copy( dip::CreateRamp( color.Sizes(), 0 ));
+   channel = color[ 1 ];
+   channel.Copy( dip::CreateRamp( color.Sizes(), 1 ));
+   channel = color[ 2 ];
+   channel.Fill( 5.0 );
+   color.SetColorSpace( "RGB" );
+   info.sizes = color.Sizes();
+   info.tensorElements = 3;
+   info.dataType = dip::DT_SFLOAT;
+   info.colorSpace = "RGB";
+   info.pixelSize = {};
+   dip::ImageChunkStore store( "test2.zarr", info, { 8 } );
+   #pragma omp parallel for
+   for( dip::sint ii = 0; ii < 4; ++ii ) {
+      for( dip::uint jj = 0; jj < 2; ++jj ) {
+         dip::UnsignedArray chunk{ static_cast< dip::uint >( ii ), jj };
+         store.WriteChunk( chunk, color.At( store.ChunkRegion( chunk )));
+      }
+   }
+   dip::Image result = dip::ImageChunkStore( "test2.zarr" ).Read();
+   DOCTEST_CHECK( result.ColorSpace() == "RGB" );
+   DOCTEST_REQUIRE( result.TensorElements() == 3 );
+   dip::RangeArray written{ dip::Range{}, dip::Range{ 0, 15 } };
+   DOCTEST_CHECK( dip::testing::CompareImages( color.At( written ), result.At( written )));
+   dip::Image unwritten = result.At( dip::Range{}, dip::Range{ 16, -1 } );
+   unwritten.TensorToSpatial();
+   DOCTEST_CHECK( dip::Count( unwritten != 0 ) == 0 ); // fill value
+
+   DOCTEST_CHECK_THROWS( store.WriteChunk( { 0, 0 }, color ));
+   DOCTEST_CHECK_THROWS( store.ChunkRegion( { 4, 0 } ));
+   DOCTEST_CHECK_THROWS( dip::ImageChunkStore( "does_not_exist.zarr" ));
+   RemoveChunkStore( "test2.zarr", store.NumberOfChunks(), true );
+}
+
+#endif // DIP__ENABLE_DOCTEST
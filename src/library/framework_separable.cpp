@@ -227,6 +227,10 @@ void Separable(
       // with this below.
    }
 
+   // In interleaved mode, the line filter sees `nInterleaved` lines at a time, always through buffers
+   bool interleaved = opts.Contains( SeparableOption::InterleavedLines );
+   dip::uint nInterleaved = interleaved ? separableInterleavedLines : 1;
+
    //std::cout << "Starting " << nThreads << " threads\n";
    DIP_STACK_TRACE_THIS( lineFilter.SetNumberOfThreads( nThreads ));
 
@@ -340,8 +344,8 @@ void Separable(
             dip::uint outBorder = opts.Contains( SeparableOption::UseOutputBorder ) ? inBorder : 0;
 
             // Determine if we need to make a temporary buffer for this dimension
-            bool inUseBuffer = ( inImage.DataType() != bufferType ) || !lookUpTable.empty() || ( inBorder > 0 ) || opts.Contains( SeparableOption::UseInputBuffer );
-            bool outUseBuffer = ( outImage.DataType() != bufferType ) || ( outBorder > 0 );
+            bool inUseBuffer = ( inImage.DataType() != bufferType ) || !lookUpTable.empty() || ( inBorder > 0 ) || opts.Contains( SeparableOption::UseInputBuffer ) || interleaved;
+            bool outUseBuffer = ( outImage.DataType() != bufferType ) || ( outBorder > 0 ) || interleaved;
             if( !outUseBuffer && opts.Contains( SeparableOption::UseOutputBuffer )) {
                // We can cheat a little here if UseOutputBuffer is given: if the samples are contiguous, there's no need to actually use the buffer.
                outUseBuffer = !((( outImage.TensorElements() == 1 ) || ( outImage.TensorStride() == 1 ))
@@ -363,7 +367,11 @@ void Separable(
                   inBuffer.tensorLength = lookUpTable.size();
                }
                inBuffer.tensorStride = 1;
-               if( inImage.Stride( processingDim ) == 0 ) {
+               if( interleaved ) {
+                  // Lines are interleaved: pixel `jj` of line `ll` is at `jj * stride + ll * tensorLength`
+                  inBuffer.stride = static_cast< dip::sint >( nInterleaved * inBuffer.tensorLength );
+                  inBufferStorage.resize(( inLength + 2 * inBorder ) * bufferType.SizeOf() * nInterleaved * inBuffer.tensorLength );
+               } else if( inImage.Stride( processingDim ) == 0 ) {
                   // A stride of 0 means all pixels are the same, allocate space for a single pixel
                   inBuffer.stride = 0;
                   inBufferStorage.resize( bufferType.SizeOf() * inBuffer.tensorLength );
@@ -373,7 +381,7 @@ void Separable(
                   inBufferStorage.resize(( inLength + 2 * inBorder ) * bufferType.SizeOf() * inBuffer.tensorLength );
                   //std::cout << "   Using input buffer, size = " << inBufferStorage.size() << std::endl;
                }
-               inBuffer.buffer = inBufferStorage.data() + inBorder * bufferType.SizeOf() * inBuffer.tensorLength;
+               inBuffer.buffer = inBufferStorage.data() + inBorder * bufferType.SizeOf() * nInterleaved * inBuffer.tensorLength;
             } else {
                inBuffer.tensorLength = inImage.TensorElements();
                inBuffer.tensorStride = inImage.TensorStride();
@@ -387,9 +395,9 @@ void Separable(
             outBuffer.tensorLength = outImage.TensorElements();
             if( outUseBuffer ) {
                outBuffer.tensorStride = 1;
-               outBuffer.stride = static_cast< dip::sint >( outBuffer.tensorLength );
-               outBufferStorage.resize(( outLength + 2 * outBorder ) * bufferType.SizeOf() * outBuffer.tensorLength );
-               outBuffer.buffer = outBufferStorage.data() + outBorder * bufferType.SizeOf() * outBuffer.tensorLength;
+               outBuffer.stride = static_cast< dip::sint >( nInterleaved * outBuffer.tensorLength );
+               outBufferStorage.resize(( outLength + 2 * outBorder ) * bufferType.SizeOf() * nInterleaved * outBuffer.tensorLength );
+               outBuffer.buffer = outBufferStorage.data() + outBorder * bufferType.SizeOf() * nInterleaved * outBuffer.tensorLength;
                //std::cout << "   Using output buffer, size = " << outBufferStorage.size() << std::endl;
             } else {
                outBuffer.tensorStride = outImage.TensorStride();
@@ -401,59 +409,123 @@ void Separable(
             // Loop over nLinesPerThread image lines
             GenericJointImageIterator< 2 > it( { inImage, outImage }, processingDim );
             it.SetCoordinates( startCoords[ thread ] );
-            SeparableLineFilterParameters separableLineFilterParams{
-                  inBuffer, outBuffer, processingDim, rep, order.size(), it.Coordinates(), tensorToSpatial, thread
-            }; // Takes inBuffer, outBuffer, it.Coordinates() as references
-            for( dip::uint ii = 0; ( ii < nLinesPerThread ) && it; ++ii, ++it ) {
-               // Get pointers to input and output lines
-               if( inUseBuffer ) {
-                  detail::CopyBuffer(
-                        it.InPointer(),
-                        inImage.DataType(),
-                        inImage.Stride( processingDim ),
-                        inImage.TensorStride(),
-                        inBuffer.buffer,
-                        bufferType,
-                        inBuffer.stride,
-                        inBuffer.tensorStride,
-                        inLength, // if stride == 0, only a single pixel will be copied, because they're all the same
-                        inBuffer.tensorLength,
-                        lookUpTable );
-                  if(( inBorder > 0 ) && ( inBuffer.stride != 0 )) {
-                     detail::ExpandBuffer(
-                           inBuffer.buffer,
+            if( interleaved ) {
+               // Process blocks of up to `nInterleaved` lines
+               UnsignedArray blockPosition;
+               SeparableLineFilterParameters separableLineFilterParams{
+                     inBuffer, outBuffer, processingDim, rep, order.size(), blockPosition, tensorToSpatial, thread
+               }; // Takes inBuffer, outBuffer, blockPosition as references
+               std::vector< void* > outPointers( nInterleaved );
+               dip::uint inSampleSize = bufferType.SizeOf() * inBuffer.tensorLength;
+               dip::uint outSampleSize = bufferType.SizeOf() * outBuffer.tensorLength;
+               void* inBlock = inBuffer.buffer;
+               void* outBlock = outBuffer.buffer;
+               for( dip::uint ii = 0; ( ii < nLinesPerThread ) && it; ) {
+                  blockPosition = it.Coordinates();
+                  dip::uint nLines = 0;
+                  for( ; ( nLines < nInterleaved ) && ( ii < nLinesPerThread ) && it; ++nLines, ++ii, ++it ) {
+                     void* lane = static_cast< uint8* >( inBlock ) + nLines * inSampleSize;
+                     detail::CopyBuffer(
+                           it.InPointer(),
+                           inImage.DataType(),
+                           inImage.Stride( processingDim ),
+                           inImage.TensorStride(),
+                           lane,
                            bufferType,
                            inBuffer.stride,
                            inBuffer.tensorStride,
                            inLength,
                            inBuffer.tensorLength,
-                           inBorder,
-                           inBorder,
-                           boundaryConditions[ processingDim ] );
+                           lookUpTable );
+                     if( inBorder > 0 ) {
+                        detail::ExpandBuffer(
+                              lane,
+                              bufferType,
+                              inBuffer.stride,
+                              inBuffer.tensorStride,
+                              inLength,
+                              inBuffer.tensorLength,
+                              inBorder,
+                              inBorder,
+                              boundaryConditions[ processingDim ] );
+                     }
+                     outPointers[ nLines ] = it.OutPointer();
+                  }
+                  separableLineFilterParams.nLines = nLines;
+
+                  // Filter the block of lines
+                  lineFilter.Filter( separableLineFilterParams );
+
+                  // Copy back the lines from output buffer to the image
+                  for( dip::uint ll = 0; ll < nLines; ++ll ) {
+                     detail::CopyBuffer(
+                           static_cast< uint8* >( outBlock ) + ll * outSampleSize,
+                           bufferType,
+                           outBuffer.stride,
+                           outBuffer.tensorStride,
+                           outPointers[ ll ],
+                           outImage.DataType(),
+                           outImage.Stride( processingDim ),
+                           outImage.TensorStride(),
+                           outLength,
+                           outBuffer.tensorLength );
                   }
-               } else {
-                  inBuffer.buffer = it.InPointer();
-               }
-               if( !outUseBuffer ) {
-                  outBuffer.buffer = it.OutPointer();
                }
+            } else {
+               SeparableLineFilterParameters separableLineFilterParams{
+                     inBuffer, outBuffer, processingDim, rep, order.size(), it.Coordinates(), tensorToSpatial, thread
+               }; // Takes inBuffer, outBuffer, it.Coordinates() as references
+               for( dip::uint ii = 0; ( ii < nLinesPerThread ) && it; ++ii, ++it ) {
+                  // Get pointers to input and output lines
+                  if( inUseBuffer ) {
+                     detail::CopyBuffer(
+                           it.InPointer(),
+                           inImage.DataType(),
+                           inImage.Stride( processingDim ),
+                           inImage.TensorStride(),
+                           inBuffer.buffer,
+                           bufferType,
+                           inBuffer.stride,
+                           inBuffer.tensorStride,
+                           inLength, // if stride == 0, only a single pixel will be copied, because they're all the same
+                           inBuffer.tensorLength,
+                           lookUpTable );
+                     if(( inBorder > 0 ) && ( inBuffer.stride != 0 )) {
+                        detail::ExpandBuffer(
+                              inBuffer.buffer,
+                              bufferType,
+                              inBuffer.stride,
+                              inBuffer.tensorStride,
+                              inLength,
+                              inBuffer.tensorLength,
+                              inBorder,
+                              inBorder,
+                              boundaryConditions[ processingDim ] );
+                     }
+                  } else {
+                     inBuffer.buffer = it.InPointer();
+                  }
+                  if( !outUseBuffer ) {
+                     outBuffer.buffer = it.OutPointer();
+                  }
+
+                  // Filter the line
+                  lineFilter.Filter( separableLineFilterParams );
 
-               // Filter the line
-               lineFilter.Filter( separableLineFilterParams );
-
-               // Copy back the line from output buffer to the image
-               if( outUseBuffer ) {
-                  detail::CopyBuffer(
-                        outBuffer.buffer,
-                        bufferType,
-                        outBuffer.stride,
-                        outBuffer.tensorStride,
-                        it.OutPointer(),
-                        outImage.DataType(),
-                        outImage.Stride( processingDim ),
-                        outImage.TensorStride(),
-                        outLength,
-                        outBuffer.tensorLength );
+                  // Copy back the line from output buffer to the image
+                  if( outUseBuffer ) {
+                     detail::CopyBuffer(
+                           outBuffer.buffer,
+                           bufferType,
+                           outBuffer.stride,
+                           outBuffer.tensorStride,
+                           it.OutPointer(),
+                           outImage.DataType(),
+                           outImage.Stride( processingDim ),
+                           outImage.TensorStride(),
+                           outLength,
+                           outBuffer.tensorLength );
+                  }
                }
             }
          }
@@ -37,6 +37,10 @@ void SetNumberOfThreads( dip::uint nThreads ) {
 }
 
 dip::uint GetNumberOfThreads() {
+   if( omp_in_parallel() ) {
+      // Nested parallel regions are not active, the work must be done in the calling thread
+      return 1;
+   }
    return maxNumberOfThreads;
 }
 
@@ -19,11 +19,16 @@
  */
 
 #include <cstdlib>   // std::malloc, std::free
+#include <atomic>
+#include <cmath>
+#include <exception>
 
 #include "diplib.h"
 #include "diplib/linear.h"
 #include "diplib/transform.h"
 #include "diplib/framework.h"
+#include "diplib/boundary.h"
+#include "diplib/multithreading.h"
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
 
@@ -130,10 +135,21 @@ struct InternOneDimensionalFilter {
 
 using InternOneDimensionalFilterArray = std::vector< InternOneDimensionalFilter >;
 
+// Number of output samples computed at once by `SeparableConvolutionLineFilter`. The accumulator for these should
+// stay in the L1 cache while we iterate over the filter weights.
+constexpr dip::uint convolutionBlockSize = 256;
+
+// The inner loops below iterate over a block of output samples for each filter weight, rather than over the
+// filter weights for each output sample. They read and write contiguous arrays, and have no dependencies
+// between iterations, so that the compiler can vectorize them. Each output sample is computed by adding the
+// same terms in the same order as in the straight-forward implementation.
 template< typename TPI >
 class SeparableConvolutionLineFilter : public Framework::SeparableLineFilter {
    public:
       SeparableConvolutionLineFilter( InternOneDimensionalFilterArray const& filter ) : filter_( filter ) {}
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         buffers_.resize( threads );
+      }
       virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
          TPI* in = static_cast< TPI* >( params.inBuffer.buffer );
          dip::uint length = params.inBuffer.length;
@@ -146,82 +162,85 @@ class SeparableConvolutionLineFilter : public Framework::SeparableLineFilter {
          }
          auto filter = static_cast< FloatType< TPI > const* >( filter_[ procDim ].filter );
          dip::uint dataSize = filter_[ procDim ].dataSize;
-         auto filterEnd = filter + dataSize;
          dip::uint origin = filter_[ procDim ].origin;
+         FilterSymmetry symmetry = filter_[ procDim ].symmetry;
          in -= origin;
-         switch( filter_[ procDim ].symmetry ) {
-            case FilterSymmetry::GENERAL:
-               for( dip::uint ii = 0; ii < length; ++ii ) {
-                  TPI sum = 0;
-                  TPI* in_t = in;
-                  for( auto f = filter; f != filterEnd; ++f, ++in_t ) {
-                     sum += *f * *in_t;
+         if( symmetry != FilterSymmetry::GENERAL ) {
+            in += dataSize - 1; // points at the center of the filter
+         }
+         std::vector< TPI >& buffer = buffers_[ params.thread ];
+         if( outStride != 1 ) {
+            buffer.resize( convolutionBlockSize );
+         }
+         for( dip::uint start = 0; start < length; start += convolutionBlockSize ) {
+            dip::uint n = std::min( convolutionBlockSize, length - start );
+            TPI* sum = outStride == 1 ? out : buffer.data(); // we accumulate directly in `out` if possible
+            switch( symmetry ) {
+               case FilterSymmetry::GENERAL:
+                  FirstTerm( sum, in, filter[ 0 ], n );
+                  for( dip::uint jj = 1; jj < dataSize; ++jj ) {
+                     AddTerm( sum, in + jj, filter[ jj ], n );
                   }
-                  *out = sum;
-                  ++in;
-                  out += outStride;
-               }
-               break;
-            case FilterSymmetry::EVEN: // Always an odd-sized filter
-               in += dataSize - 1;
-               for( dip::uint ii = 0; ii < length; ++ii ) {
-                  TPI sum = *filter * *in;
-                  TPI* in_r = in + 1;
-                  TPI* in_l = in - 1;
-                  for( auto f = filter + 1; f != filterEnd; ++f, --in_l, ++in_r ) {
-                     sum += *f * ( *in_r + *in_l );
+                  break;
+               case FilterSymmetry::EVEN: // Always an odd-sized filter
+                  FirstTerm( sum, in, filter[ 0 ], n );
+                  for( dip::uint jj = 1; jj < dataSize; ++jj ) {
+                     AddSymmetricTerm( sum, in + jj, in - jj, filter[ jj ], n );
                   }
-                  *out = sum;
-                  ++in;
-                  out += outStride;
-               }
-               break;
-            case FilterSymmetry::ODD: // Always an odd-sized filter
-               in += dataSize - 1;
-               for( dip::uint ii = 0; ii < length; ++ii ) {
-                  TPI sum = *filter * *in;
-                  TPI* in_r = in + 1;
-                  TPI* in_l = in - 1;
-                  for( auto f = filter + 1; f != filterEnd; ++f, --in_l, ++in_r ) {
-                     sum += *f * ( *in_r - *in_l );
+                  break;
+               case FilterSymmetry::ODD: // Always an odd-sized filter
+                  FirstTerm( sum, in, filter[ 0 ], n );
+                  for( dip::uint jj = 1; jj < dataSize; ++jj ) {
+                     AddAntiSymmetricTerm( sum, in + jj, in - jj, filter[ jj ], n );
                   }
-                  *out = sum;
-                  ++in;
-                  out += outStride;
-               }
-               break;
-            case FilterSymmetry::D_EVEN: // Always an even-sized filter
-               in += dataSize - 1;
-               for( dip::uint ii = 0; ii < length; ++ii ) {
-                  TPI* in_r = in;
-                  TPI sum = 0;
-                  TPI* in_l = in_r - 1;
-                  for( auto f = filter; f != filterEnd; ++f, --in_l, ++in_r ) {
-                     sum += *f * ( *in_r + *in_l );
+                  break;
+               case FilterSymmetry::D_EVEN: // Always an even-sized filter
+                  std::fill( sum, sum + n, TPI( 0 ));
+                  for( dip::uint jj = 0; jj < dataSize; ++jj ) {
+                     AddSymmetricTerm( sum, in + jj, in - jj - 1, filter[ jj ], n );
                   }
-                  *out = sum;
-                  ++in;
-                  out += outStride;
-               }
-               break;
-            case FilterSymmetry::D_ODD: // Always an even-sized filter
-               in += dataSize - 1;
-               for( dip::uint ii = 0; ii < length; ++ii ) {
-                  TPI* in_r = in;
-                  TPI sum = 0;
-                  TPI* in_l = in_r - 1;
-                  for( auto f = filter; f != filterEnd; ++f, --in_l, ++in_r ) {
-                     sum += *f * ( *in_r - *in_l );
+                  break;
+               case FilterSymmetry::D_ODD: // Always an even-sized filter
+                  std::fill( sum, sum + n, TPI( 0 ));
+                  for( dip::uint jj = 0; jj < dataSize; ++jj ) {
+                     AddAntiSymmetricTerm( sum, in + jj, in - jj - 1, filter[ jj ], n );
                   }
-                  *out = sum;
-                  ++in;
-                  out += outStride;
+                  break;
+            }
+            if( outStride == 1 ) {
+               out += n;
+            } else {
+               for( dip::uint ii = 0; ii < n; ++ii, out += outStride ) {
+                  *out = sum[ ii ];
                }
-               break;
+            }
+            in += n;
          }
       }
    private:
       InternOneDimensionalFilterArray const& filter_;
+      std::vector< std::vector< TPI >> buffers_; // one for each thread
+
+      static void FirstTerm( TPI* sum, TPI const* in, FloatType< TPI > weight, dip::uint n ) {
+         for( dip::uint ii = 0; ii < n; ++ii ) {
+            sum[ ii ] = weight * in[ ii ];
+         }
+      }
+      static void AddTerm( TPI* sum, TPI const* in, FloatType< TPI > weight, dip::uint n ) {
+         for( dip::uint ii = 0; ii < n; ++ii ) {
+            sum[ ii ] += weight * in[ ii ];
+         }
+      }
+      static void AddSymmetricTerm( TPI* sum, TPI const* in_r, TPI const* in_l, FloatType< TPI > weight, dip::uint n ) {
+         for( dip::uint ii = 0; ii < n; ++ii ) {
+            sum[ ii ] += weight * ( in_r[ ii ] + in_l[ ii ] );
+         }
+      }
+      static void AddAntiSymmetricTerm( TPI* sum, TPI const* in_r, TPI const* in_l, FloatType< TPI > weight, dip::uint n ) {
+         for( dip::uint ii = 0; ii < n; ++ii ) {
+            sum[ ii ] += weight * ( in_r[ ii ] - in_l[ ii ] );
+         }
+      }
 };
 
 inline bool IsMeaninglessFilter( InternOneDimensionalFilter const& filter ) {
@@ -379,8 +398,223 @@ class GeneralConvolutionLineFilter : public Framework::FullLineFilter {
       std::vector< dip::sint > offsets_;
 };
 
+// Relative costs used to choose a convolution method, in units of one multiply-add in the direct convolution.
+// The costs are per output pixel.
+constexpr dfloat separableCostPerDimension = 4.0;   // Copying an image line to and from the 1D buffer
+constexpr dfloat fourierCostPerLog2 = 2.5;          // Forward and inverse transform, per sample per log2(size)
+constexpr dfloat fourierCostPerSample = 12.0;       // Spectrum multiplication, tile extraction and copying the result
+constexpr dip::uint minimumBlockSize = 32;          // The smallest tile we consider along a dimension
+constexpr dip::uint maximumTileSize = 1u << 16;     // Number of samples in a tile that fits in the cache
+constexpr dip::uint unfilteredBlockSize = 16;       // Tile size along dimensions where the kernel has size 1
+
+// Returns the number of tile samples computed for each output pixel, along one dimension
+dfloat BlockOverhead( dip::uint N, dip::uint K ) {
+   return static_cast< dfloat >( N ) / static_cast< dfloat >( N - K + 1 );
+}
+
+// Finds the FFT block sizes for the overlap-save convolution, and returns the estimated cost per output pixel
+dfloat OverlapSaveBlockSizes(
+      UnsignedArray const& imageSizes,
+      UnsignedArray const& kernelSizes,
+      UnsignedArray& blockSizes
+) {
+   dip::uint nDims = imageSizes.size();
+   dip::uint nProcess = 0;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if( kernelSizes[ ii ] > 1 ) {
+         ++nProcess;
+      }
+   }
+   // Tiles larger than this don't fit in the cache, making the transform much more expensive
+   dfloat maxSize = nProcess > 0
+                    ? std::pow( static_cast< dfloat >( maximumTileSize ), 1.0 / static_cast< dfloat >( nProcess ))
+                    : static_cast< dfloat >( maximumTileSize );
+   blockSizes.resize( nDims );
+   dfloat overhead = 1.0;
+   dfloat log2Sum = 0.0;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      dip::uint K = kernelSizes[ ii ];
+      if( K == 1 ) {
+         // Not transformed along this dimension
+         blockSizes[ ii ] = std::min( imageSizes[ ii ], unfilteredBlockSize );
+         continue;
+      }
+      // A single tile along this dimension is the largest size that makes sense. We try sizes that are
+      // (approximately) powers of two times the kernel size, up to that size or the cache limit.
+      dip::uint largest = OptimalFourierTransformSize( imageSizes[ ii ] + K - 1 );
+      dip::uint best = 0;
+      dfloat bestCost = 0.0;
+      for( dip::uint size = std::max( 2 * K, minimumBlockSize ); ; size *= 2 ) {
+         dip::uint N = std::min( OptimalFourierTransformSize( size ), largest );
+         if(( best > 0 ) && ( static_cast< dfloat >( N ) > maxSize )) {
+            break;
+         }
+         dfloat cost = BlockOverhead( N, K ) * ( fourierCostPerLog2 * std::log2( static_cast< dfloat >( N )) + fourierCostPerSample / static_cast< dfloat >( nProcess ));
+         if(( best == 0 ) || ( cost < bestCost )) {
+            bestCost = cost;
+            best = N;
+         }
+         if( N == largest ) {
+            break;
+         }
+      }
+      blockSizes[ ii ] = best;
+      overhead *= BlockOverhead( best, K );
+      log2Sum += std::log2( static_cast< dfloat >( best ));
+   }
+   return overhead * ( fourierCostPerLog2 * log2Sum + fourierCostPerSample );
+}
+
+// Computes the convolution through the Framework::Full, for a filter that has already been mirrored
+void DirectConvolution(
+      Image const& in,
+      Image& out,
+      Kernel const& filter,
+      BoundaryConditionArray const& bc
+) {
+   DataType dtype = DataType::SuggestFlex( in.DataType() );
+   std::unique_ptr< Framework::FullLineFilter > lineFilter;
+   DIP_OVL_NEW_FLEX( lineFilter, GeneralConvolutionLineFilter, (), dtype );
+   Framework::Full( in, out, dtype, dtype, dtype, 1, bc, filter, *lineFilter, Framework::FullOption::AsScalarImage );
+}
+
 } // namespace
 
+void OverlapSaveConvolution(
+      Image const& in,
+      Image const& c_filter,
+      Image& out,
+      StringArray const& boundaryCondition,
+      UnsignedArray blockSizes
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !c_filter.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !c_filter.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( c_filter.DataType().IsBinary(), E::DATA_TYPE_NOT_SUPPORTED );
+   dip::uint nDims = in.Dimensionality();
+   DIP_THROW_IF( nDims < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+   Image filter = c_filter.QuickCopy();
+   DIP_THROW_IF( filter.Dimensionality() > nDims, E::DIMENSIONALITIES_DONT_MATCH );
+   filter.ExpandDimensionality( nDims );
+   UnsignedArray const& kernelSizes = filter.Sizes();
+   UnsignedArray sizes = in.Sizes();
+   BoundaryConditionArray bc;
+   DIP_START_STACK_TRACE
+      bc = StringArrayToBoundaryConditionArray( boundaryCondition );
+      if( blockSizes.empty() ) {
+         OverlapSaveBlockSizes( sizes, kernelSizes, blockSizes );
+      } else {
+         ArrayUseParameter( blockSizes, nDims );
+      }
+   DIP_END_STACK_TRACE
+   BooleanArray process( nDims, false );
+   UnsignedArray filterSizes( nDims, 1 );    // Size of the padded filter
+   UnsignedArray step( nDims );              // Number of output pixels computed by each tile
+   UnsignedArray border( nDims );            // Boundary extension, the origin of the filter
+   UnsignedArray nTiles( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      DIP_THROW_IF( blockSizes[ ii ] < kernelSizes[ ii ], E::PARAMETER_OUT_OF_RANGE );
+      process[ ii ] = kernelSizes[ ii ] > 1;
+      if( process[ ii ] ) {
+         filterSizes[ ii ] = blockSizes[ ii ];
+      }
+      step[ ii ] = blockSizes[ ii ] - kernelSizes[ ii ] + 1;
+      border[ ii ] = kernelSizes[ ii ] / 2;
+      nTiles[ ii ] = div_ceil( sizes[ ii ], step[ ii ] );
+   }
+
+   DIP_START_STACK_TRACE
+      // The output pixels [s, s + step) are computed from the input pixels [s - K + 1 + border, s + step + border),
+      // with `border = K / 2`. In the extended image, these start at `s + 2 * border + 1 - K`.
+      Image extended;
+      ExtendImage( in, extended, border, bc );
+      UnsignedArray const& extendedSizes = extended.Sizes();
+
+      // The kernel spectrum is computed once and shared by all tiles
+      Image filterFT = filter.Pad( filterSizes );
+      FourierTransform( filterFT, filterFT, {}, process );
+      bool real = in.DataType().IsReal() && filter.DataType().IsReal();
+      // The output is complex if either `in` or `filter` is complex
+      DataType dtype = DataType::SuggestFlex( in.DataType() );
+      if( !real ) {
+         dtype = DataType::SuggestComplex( dtype );
+      }
+      StringSet inverseOptions{ S::INVERSE };
+      if( real ) {
+         inverseOptions.insert( S::REAL );
+      }
+
+      // `extended` is a copy, so it doesn't matter if `out` shares data with `in`
+      out.ReForge( sizes, in.TensorElements(), dtype, Option::AcceptDataTypeChange::DO_ALLOW );
+      out.CopyNonDataProperties( extended );
+
+      // Process the tiles concurrently, each one is independent of the others
+      dip::uint nBlocks = nTiles.product();
+      dip::uint nThreads = std::min( GetNumberOfThreads(), nBlocks );
+      std::atomic< bool > failed( false );
+      std::exception_ptr error; // the first exception thrown, rethrown after the parallel region
+      #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+      {
+         Image tile;
+         Image tileFT;
+         RangeArray inRange( nDims );     // The part of `extended` transformed
+         RangeArray tileRange( nDims );   // Where that data goes in the tile, if it's smaller than a tile
+         RangeArray outRange( nDims );    // The part of `out` computed by the tile
+         RangeArray validRange( nDims );  // Where in the result to find those output pixels
+         #pragma omp for schedule( dynamic )
+         for( dip::sint jj = 0; jj < static_cast< dip::sint >( nBlocks ); ++jj ) {
+            if( failed ) {
+               continue;
+            }
+            try {
+               dip::uint index = static_cast< dip::uint >( jj );
+               bool partial = false;
+               for( dip::uint ii = 0; ii < nDims; ++ii ) {
+                  dip::uint start = ( index % nTiles[ ii ] ) * step[ ii ];
+                  index /= nTiles[ ii ];
+                  dip::uint length = std::min( step[ ii ], sizes[ ii ] - start );
+                  dip::uint first = start + 2 * border[ ii ] + 1 - kernelSizes[ ii ];
+                  dip::uint available = std::min( blockSizes[ ii ], extendedSizes[ ii ] - first );
+                  partial |= available < blockSizes[ ii ];
+                  inRange[ ii ] = Range{ static_cast< dip::sint >( first ), static_cast< dip::sint >( first + available - 1 ) };
+                  tileRange[ ii ] = Range{ 0, static_cast< dip::sint >( available - 1 ) };
+                  outRange[ ii ] = Range{ static_cast< dip::sint >( start ), static_cast< dip::sint >( start + length - 1 ) };
+                  dip::uint left = kernelSizes[ ii ] - 1 - border[ ii ];
+                  validRange[ ii ] = Range{ static_cast< dip::sint >( left ), static_cast< dip::sint >( left + length - 1 ) };
+               }
+               if( partial ) {
+                  // The last tile along some dimension: the pixels past the end of `extended` only affect
+                  // output pixels we don't use, but must be finite
+                  tile.ReForge( blockSizes, in.TensorElements(), dtype );
+                  tile.Fill( 0 );
+                  tile.At( tileRange ).Copy( extended.At( inRange ));
+                  FourierTransform( tile, tileFT, {}, process );
+               } else {
+                  FourierTransform( extended.At( inRange ), tileFT, {}, process );
+               }
+               MultiplySampleWise( tileFT, filterFT, tileFT, tileFT.DataType() );
+               FourierTransform( tileFT, tileFT, inverseOptions, process );
+               Image result = tileFT.At( validRange );
+               if( real && result.DataType().IsComplex() ) {
+                  result = result.Real();
+               }
+               out.At( outRange ).Copy( result );
+            } catch( ... ) {
+               // Includes `std::bad_alloc` from the tile buffers, no exception can leave the parallel region
+               #pragma omp critical( OverlapSaveConvolution_error )
+               if( !error ) {
+                  error = std::current_exception();
+               }
+               failed = true;
+            }
+         }
+      }
+      if( error ) {
+         std::rethrow_exception( error );
+      }
+   DIP_END_STACK_TRACE
+}
+
 void GeneralConvolution(
       Image const& in,
       Image const& c_filter,
@@ -398,14 +632,42 @@ void GeneralConvolution(
          return;
       }
       BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
-      DataType dtype = DataType::SuggestFlex( in.DataType() );
-      std::unique_ptr< Framework::FullLineFilter > lineFilter;
-      DIP_OVL_NEW_FLEX( lineFilter, GeneralConvolutionLineFilter, (), dtype );
-      Framework::Full( in, out, dtype, dtype, dtype, 1, bc, filter, *lineFilter, Framework::FullOption::AsScalarImage );
+      dip::uint nDims = in.Dimensionality();
+      DIP_THROW_IF( c_filter.Dimensionality() > nDims, E::DIMENSIONALITIES_DONT_MATCH );
+      // Estimate the cost per output pixel of each of the three methods. The direct method skips
+      // non-finite filter weights, the other two methods can only be used if there are none.
+      dip::uint nWeights = filter.NumberOfPixels( nDims );
+      dfloat directCost = static_cast< dfloat >( nWeights );
+      if(( nWeights == c_filter.NumberOfPixels() ) && c_filter.DataType().IsReal() ) {
+         UnsignedArray kernelSizes = c_filter.Sizes();
+         kernelSizes.resize( nDims, 1 );
+         dip::uint nFiltered = 0;
+         dfloat separableCost = 0.0;
+         for( auto sz : kernelSizes ) {
+            if( sz > 1 ) {
+               ++nFiltered;
+               separableCost += static_cast< dfloat >( sz ) + separableCostPerDimension;
+            }
+         }
+         UnsignedArray blockSizes;
+         dfloat fourierCost = OverlapSaveBlockSizes( in.Sizes(), kernelSizes, blockSizes );
+         if(( nFiltered > 1 ) && ( separableCost < directCost ) && ( separableCost <= fourierCost )) {
+            OneDimensionalFilterArray filterArray = SeparateFilter( c_filter );
+            if( !filterArray.empty() ) {
+               filterArray.resize( nDims ); // the dimensions that the filter doesn't have are not processed
+               SeparableConvolution( in, out, filterArray, boundaryCondition );
+               return;
+            }
+         }
+         if( fourierCost < directCost ) {
+            OverlapSaveConvolution( in, c_filter, out, boundaryCondition, blockSizes );
+            return;
+         }
+      }
+      DirectConvolution( in, out, filter, bc );
    DIP_END_STACK_TRACE
 }
 
-
 } // namespace dip
 
 
@@ -414,6 +676,7 @@ void GeneralConvolution(
 #include "diplib/statistics.h"
 #include "diplib/generation.h"
 #include "diplib/iterators.h"
+#include "diplib/math.h"
 
 DOCTEST_TEST_CASE("[DIPlib] testing the separable convolution") {
    dip::dfloat meanval = 9563.0;
@@ -501,4 +764,68 @@ DOCTEST_TEST_CASE("[DIPlib] testing the separable convolution") {
    DOCTEST_CHECK( dip::Mean( out1 - out2 ).As< dip::dfloat >() / meanval == doctest::Approx( 0.0 ));
 }
 
+DOCTEST_TEST_CASE("[DIPlib] testing the overlap-save convolution") {
+   dip::Image img{ dip::UnsignedArray{ 83, 61 }, 1, dip::DT_SFLOAT };
+   dip::Random random( 0 );
+   img.Fill( 100.0 );
+   dip::GaussianNoise( img, img, random, 20.0 );
+   // An even-sized, non-separable filter
+   dip::Image filter{ dip::UnsignedArray{ 8, 5 }, 1, dip::DT_DFLOAT };
+   filter.Fill( 0.0 );
+   dip::UniformNoise( filter, filter, random, -1.0, 1.0 );
+   dip::Image out1;
+   dip::Image out2;
+   for( auto const& bc : { "mirror", "asym mirror", "periodic", "add zeros", "zero order" } ) {
+      dip::GeneralConvolution( img, filter, out1, { bc } ); // filter is small enough to use the direct method
+      DOCTEST_CHECK( out1.DataType() == dip::DT_SFLOAT );
+      dip::OverlapSaveConvolution( img, filter, out2, { bc }, { 16, 12 } );
+      DOCTEST_CHECK( out2.DataType() == dip::DT_SFLOAT );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, out2 ) < 1e-3 );
+   }
+   // Default block sizes, a single tile covering the whole image
+   dip::OverlapSaveConvolution( img, filter, out2, { "zero order" } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, out2 ) < 1e-3 );
+   // Larger filter; a non-finite weight forces the direct method, and is equivalent to a zero weight
+   filter = dip::Image{ dip::UnsignedArray{ 15, 14 }, 1, dip::DT_DFLOAT };
+   filter.Fill( 0.0 );
+   dip::UniformNoise( filter, filter, random, -1.0, 1.0 );
+   filter.At( 0, 0 ) = 0.0;
+   dip::OverlapSaveConvolution( img, filter, out1, { "mirror" } );
+   filter.At( 0, 0 ) = std::nan( "" );
+   dip::GeneralConvolution( img, filter, out2, { "mirror" } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, out2 ) < 1e-2 );
+   // A 2D filter applied to a 3D image, in place, with different block sizes
+   dip::Image img3{ dip::UnsignedArray{ 20, 15, 7 }, 1, dip::DT_SFLOAT };
+   img3.Fill( 100.0 );
+   dip::GaussianNoise( img3, img3, random, 20.0 );
+   filter.At( 0, 0 ) = 0.0;
+   dip::GeneralConvolution( img3, filter, out1, { "periodic" } );
+   dip::OverlapSaveConvolution( img3, filter, img3, { "periodic" }, { 32, 20, 4 } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, img3 ) < 1e-3 );
+   // A separable filter is applied through SeparableConvolution
+   filter = dip::Image{ dip::UnsignedArray{ 25, 25 }, 1, dip::DT_DFLOAT };
+   dip::FillRadiusCoordinate( filter );
+   filter = dip::Exp( -filter * filter / 50.0 );
+   dip::GeneralConvolution( img, filter, out1, { "mirror" } );
+   dip::OverlapSaveConvolution( img, filter, out2, { "mirror" } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, out2 ) < 1e-2 );
+   // A complex filter applied to a real image gives a complex output, the real and imaginary parts of the filter
+   // each contribute to the corresponding part of the output
+   dip::Image realPart{ dip::UnsignedArray{ 7, 6 }, 1, dip::DT_DFLOAT };
+   realPart.Fill( 0.0 );
+   dip::UniformNoise( realPart, realPart, random, -1.0, 1.0 );
+   dip::Image imagPart = realPart.Similar();
+   imagPart.Fill( 0.0 );
+   dip::UniformNoise( imagPart, imagPart, random, -1.0, 1.0 );
+   filter = dip::Image{ realPart.Sizes(), 1, dip::DT_DCOMPLEX };
+   filter.Real().Copy( realPart );
+   filter.Imaginary().Copy( imagPart );
+   dip::OverlapSaveConvolution( img, filter, out2, { "mirror" }, { 16, 12 } );
+   DOCTEST_CHECK( out2.DataType() == dip::DT_SCOMPLEX );
+   dip::GeneralConvolution( img, realPart, out1, { "mirror" } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, out2.Real() ) < 1e-3 );
+   dip::GeneralConvolution( img, imagPart, out1, { "mirror" } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out1, out2.Imaginary() ) < 1e-3 );
+}
+
 #endif // DIP__ENABLE_DOCTEST
@@ -21,12 +21,34 @@
 #include "diplib.h"
 #include "diplib/linear.h"
 #include "diplib/math.h"
+#include "diplib/framework.h"
+#include "diplib/overload.h"
 #include "diplib/generic_iterators.h"
 
 namespace dip {
 
 namespace {
 
+// The box method is preferred over the IIR method only when it can avoid floating-point buffers: it is
+// less precise, and otherwise not faster.
+bool GaussBoxIsFixedPoint(
+      Image const& in,
+      Image const& out,
+      FloatArray const& sigmas,
+      UnsignedArray const& derivativeOrder
+) {
+   if( derivativeOrder.any() ) {
+      return false;
+   }
+   for( auto s : sigmas ) {
+      if(( s > 0.0 ) && ( s < 2.0 )) {
+         return false; // poorly approximated
+      }
+   }
+   return out.IsProtected() && ( out.DataType() == in.DataType() )
+          && (( in.DataType() == DT_UINT8 ) || ( in.DataType() == DT_UINT16 ));
+}
+
 void GaussDispatch(
       Image const& in,
       Image& out,
@@ -36,7 +58,7 @@ void GaussDispatch(
       dfloat truncation
 ) {
    // If any( sigmas < 0.8 ) || any( derivativeOrder > 3 )  ==>  FT
-   // Else if any( sigmas > 10 )  ==>  IIR
+   // Else if any( sigmas > 10 )  ==>  box if it can compute in fixed point, else IIR
    // Else ==>  FIR
    for( dip::uint ii = 0; ii < derivativeOrder.size(); ++ii ) { // We can't fold this loop in with the next one, the two arrays might be of different size
       if( derivativeOrder[ ii ] > 3 ) {
@@ -52,7 +74,11 @@ void GaussDispatch(
    }
    for( dip::uint ii = 0; ii < sigmas.size(); ++ii ) {
       if( sigmas[ ii ] > 10 ) {
-         GaussIIR( in, out, sigmas, derivativeOrder, boundaryCondition, {}, S::DISCRETE_TIME_FIT, truncation );
+         if( GaussBoxIsFixedPoint( in, out, sigmas, derivativeOrder )) {
+            GaussBox( in, out, sigmas, 4, boundaryCondition );
+         } else {
+            GaussIIR( in, out, sigmas, derivativeOrder, boundaryCondition, {}, S::DISCRETE_TIME_FIT, truncation );
+         }
          return;
       }
    }
@@ -81,6 +107,9 @@ void Gauss(
       DIP_STACK_TRACE_THIS( GaussFT( in, out, sigmas, derivativeOrder, truncation )); // ignores boundaryCondition
    } else if( ( method == "IIR" ) || ( method == "iir" ) ) {
       DIP_STACK_TRACE_THIS( GaussIIR( in, out, sigmas, derivativeOrder, boundaryCondition, {}, S::DISCRETE_TIME_FIT, truncation ));
+   } else if( ( method == "box" ) || ( method == "BOX" ) ) {
+      DIP_THROW_IF( derivativeOrder.any(), "The box method cannot compute derivatives" );
+      DIP_STACK_TRACE_THIS( GaussBox( in, out, sigmas, 4, boundaryCondition ));
    } else {
       DIP_THROW( "Unknown Gauss filter method" );
    }
@@ -122,6 +151,167 @@ void Derivative(
 
 namespace {
 
+// The state shared by the nodes of the derivative bank's tree of 1D passes
+struct DerivativeBankData {
+   std::vector< UnsignedArray > const& orders;
+   std::vector< Image >& outputs;
+   UnsignedArray dims;                 // the dimensions to filter, in the order they are processed
+   FloatArray const& sigmas;
+   StringArray const& boundaryCondition;
+   dfloat truncation;
+   bool iir;
+   std::vector< Image > temporaries;   // one intermediate image for each level of the tree
+};
+
+// Applies the 1D Gaussian derivative filter of order `order` along dimension `dim`
+void DerivativeBankPass( DerivativeBankData const& data, Image const& in, Image& out, dip::uint dim, dip::uint order ) {
+   FloatArray sigmas( in.Dimensionality(), 0.0 ); // dimensions with a zero sigma are not processed
+   sigmas[ dim ] = data.sigmas[ dim ];
+   UnsignedArray derivativeOrder( in.Dimensionality(), 0 );
+   derivativeOrder[ dim ] = order;
+   if( data.iir ) {
+      GaussIIR( in, out, sigmas, derivativeOrder, data.boundaryCondition, {}, S::DISCRETE_TIME_FIT, data.truncation );
+   } else {
+      GaussFIR( in, out, sigmas, derivativeOrder, data.boundaryCondition, data.truncation );
+   }
+}
+
+// Computes the outputs `indices`, which all have the same derivative orders along the first `level` dimensions in
+// `data.dims`. `in` is the input image filtered along those dimensions. Outputs are grouped by their derivative
+// order along the next dimension; each group shares one 1D pass.
+void DerivativeBankNode( DerivativeBankData& data, Image const& in, dip::uint level, std::vector< dip::uint > const& indices ) {
+   dip::uint dim = data.dims[ level ];
+   bool leaf = level + 1 == data.dims.size();
+   std::vector< bool > assigned( indices.size(), false );
+   for( dip::uint ii = 0; ii < indices.size(); ++ii ) {
+      if( assigned[ ii ] ) {
+         continue;
+      }
+      dip::uint order = data.orders[ indices[ ii ]][ dim ];
+      std::vector< dip::uint > group;
+      for( dip::uint jj = ii; jj < indices.size(); ++jj ) {
+         if( !assigned[ jj ] && ( data.orders[ indices[ jj ]][ dim ] == order )) {
+            group.push_back( indices[ jj ] );
+            assigned[ jj ] = true;
+         }
+      }
+      if( leaf ) {
+         Image& dest = data.outputs[ group[ 0 ]];
+         DerivativeBankPass( data, in, dest, dim, order );
+         for( dip::uint jj = 1; jj < group.size(); ++jj ) {
+            data.outputs[ group[ jj ]].Copy( dest ); // the same derivative was requested more than once
+         }
+      } else {
+         Image& tmp = data.temporaries[ level ];
+         DerivativeBankPass( data, in, tmp, dim, order );
+         DerivativeBankNode( data, tmp, level + 1, group );
+      }
+   }
+}
+
+} // namespace
+
+void DerivativeBank(
+      Image const& c_in,
+      Image& out,
+      std::vector< UnsignedArray > const& derivativeOrders,
+      FloatArray sigmas,
+      String const& method,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) {
+   DIP_THROW_IF( !c_in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !c_in.IsScalar(), E::IMAGE_NOT_SCALAR );
+   dip::uint nDims = c_in.Dimensionality();
+   dip::uint nOut = derivativeOrders.size();
+   DIP_THROW_IF( nDims < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_THROW_IF( nOut < 1, E::ARRAY_PARAMETER_EMPTY );
+   dip::uint maxOrder = 0;
+   for( auto const& order : derivativeOrders ) {
+      DIP_THROW_IF( order.size() != nDims, E::ARRAY_PARAMETER_WRONG_LENGTH );
+      for( auto o : order ) {
+         maxOrder = std::max( maxOrder, o );
+      }
+   }
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( sigmas, nDims, 1.0 ));
+
+   // Which Gaussian implementation to use, following the logic of `GaussDispatch`. Only the separable FIR and IIR
+   // implementations can share passes; for other methods we compute each derivative independently.
+   bool iir = false;
+   bool shared = false;
+   if(( method == S::BEST ) || ( method == "gauss" )) {
+      shared = maxOrder <= 3;
+      for( auto s : sigmas ) {
+         if(( s < 0.8 ) && ( s > 0.0 )) {
+            shared = false;
+         }
+         if( s > 10 ) {
+            iir = true;
+         }
+      }
+   } else if(( method == "gaussFIR" ) || ( method == "gaussfir" )) {
+      shared = true;
+   } else if(( method == "gaussIIR" ) || ( method == "gaussiir" )) {
+      shared = true;
+      iir = true;
+   }
+
+   Image in = c_in.QuickCopy();
+   PixelSize pxsz = c_in.PixelSize();
+   if( in.Aliases( out )) {
+      out.Strip();
+   }
+   out.ReForge( in.Sizes(), nOut, DataType::SuggestFlex( in.DataType() ));
+   std::vector< Image > outputs;
+   for( dip::uint ii = 0; ii < nOut; ++ii ) {
+      outputs.push_back( out[ ii ] );
+   }
+   if( !shared ) {
+      for( dip::uint ii = 0; ii < nOut; ++ii ) {
+         DIP_STACK_TRACE_THIS( Derivative( in, outputs[ ii ], derivativeOrders[ ii ], sigmas, method, boundaryCondition, truncation ));
+      }
+      out.SetPixelSize( pxsz );
+      return;
+   }
+
+   // The dimensions to filter. Dimensions along which the outputs have fewer distinct derivative orders are
+   // processed first, such that the tree of 1D passes branches as late as possible.
+   DerivativeBankData data{ derivativeOrders, outputs, {}, sigmas, boundaryCondition, truncation, iir, {} };
+   UnsignedArray branches;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if(( sigmas[ ii ] > 0.0 ) && ( in.Size( ii ) > 1 )) {
+         std::vector< bool > seen( maxOrder + 1, false );
+         dip::uint count = 0;
+         for( auto const& order : derivativeOrders ) {
+            if( !seen[ order[ ii ]] ) {
+               seen[ order[ ii ]] = true;
+               ++count;
+            }
+         }
+         data.dims.push_back( ii );
+         branches.push_back( count );
+      }
+   }
+   if( data.dims.empty() ) {
+      // Nothing to filter
+      for( auto& output : outputs ) {
+         output.Copy( in );
+      }
+      out.SetPixelSize( pxsz );
+      return;
+   }
+   data.dims = data.dims.permute( branches.sorted_indices() );
+   data.temporaries.resize( data.dims.size() - 1 );
+   std::vector< dip::uint > indices( nOut );
+   for( dip::uint ii = 0; ii < nOut; ++ii ) {
+      indices[ ii ] = ii;
+   }
+   DIP_STACK_TRACE_THIS( DerivativeBankNode( data, in, 0, indices ));
+   out.SetPixelSize( pxsz );
+}
+
+namespace {
+
 UnsignedArray FindGradientDimensions(
       UnsignedArray const& sizes,
       FloatArray& sigmas, // adjusted to nDims
@@ -141,6 +331,26 @@ UnsignedArray FindGradientDimensions(
    return dims;
 }
 
+// Adds the derivative orders for the elements of the Hessian matrix over dimensions `dims`, in the order they are
+// stored in a symmetric matrix tensor image
+void AddHessianOrders( std::vector< UnsignedArray >& orders, UnsignedArray const& dims, dip::uint nDims ) {
+   UnsignedArray order( nDims, 0 );
+   for( dip::uint ii = 0; ii < dims.size(); ++ii ) { // Symmetric matrix stores diagonal elements first
+      order[ dims[ ii ]] = 2;
+      orders.push_back( order );
+      order[ dims[ ii ]] = 0;
+   }
+   for( dip::uint jj = 1; jj < dims.size(); ++jj ) { // Elements above diagonal stored column-wise
+      for( dip::uint ii = 0; ii < jj; ++ii ) {
+         order[ dims[ ii ]] = 1;
+         order[ dims[ jj ]] = 1;
+         orders.push_back( order );
+         order[ dims[ ii ]] = 0;
+         order[ dims[ jj ]] = 0;
+      }
+   }
+}
+
 } // namespace
 
 void Gradient(
@@ -163,15 +373,11 @@ void Gradient(
    if( in.Aliases( out )) {
       out.Strip();
    }
-   out.ReForge( in.Sizes(), nDims, DataType::SuggestFlex( in.DataType() ));
-   UnsignedArray order( in.Dimensionality(), 0 );
-   auto it = ImageTensorIterator( out );
+   std::vector< UnsignedArray > orders( nDims, UnsignedArray( in.Dimensionality(), 0 ));
    for( dip::uint ii = 0; ii < nDims; ++ii ) {
-      order[ dims[ ii ]] = 1;
-      DIP_STACK_TRACE_THIS( Derivative( in, *it, order, sigmas, method, boundaryCondition, truncation ));
-      order[ dims[ ii ]] = 0;
-      ++it;
+      orders[ ii ][ dims[ ii ]] = 1;
    }
+   DIP_STACK_TRACE_THIS( DerivativeBank( in, out, orders, sigmas, method, boundaryCondition, truncation ));
    out.SetPixelSize( pxsz );
 }
 
@@ -351,27 +557,10 @@ void Hessian (
    if( in.Aliases( out )) {
       out.Strip();
    }
-   Tensor tensor( Tensor::Shape::SYMMETRIC_MATRIX, nDims, nDims );
-   out.ReForge( in.Sizes(), tensor.Elements(), DataType::SuggestFlex( in.DataType() ));
-   out.ReshapeTensor( tensor );
-   UnsignedArray order( in.Dimensionality(), 0 );
-   auto it = ImageTensorIterator( out );
-   for( dip::uint ii = 0; ii < nDims; ++ii ) { // Symmetric matrix stores diagonal elements first
-      order[ dims[ ii ]] = 2;
-      DIP_STACK_TRACE_THIS( Derivative( in, *it, order, sigmas, method, boundaryCondition, truncation ));
-      order[ dims[ ii ]] = 0;
-      ++it;
-   }
-   for( dip::uint jj = 1; jj < nDims; ++jj ) { // Elements above diagonal stored column-wise
-      for( dip::uint ii = 0; ii < jj; ++ii ) {
-         order[ dims[ ii ]] = 1;
-         order[ dims[ jj ]] = 1;
-         DIP_STACK_TRACE_THIS( Derivative( in, *it, order, sigmas, method, boundaryCondition, truncation ));
-         order[ dims[ ii ]] = 0;
-         order[ dims[ jj ]] = 0;
-         ++it;
-      }
-   }
+   std::vector< UnsignedArray > orders;
+   AddHessianOrders( orders, dims, in.Dimensionality() );
+   DIP_STACK_TRACE_THIS( DerivativeBank( in, out, orders, sigmas, method, boundaryCondition, truncation ));
+   out.ReshapeTensor( Tensor( Tensor::Shape::SYMMETRIC_MATRIX, nDims, nDims ));
    out.SetPixelSize( pxsz );
 }
 
@@ -437,18 +626,27 @@ void DggFamily(
    DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
    DIP_THROW_IF( !in.IsScalar(), E::IMAGE_NOT_SCALAR );
 
-   Image g, H;
-   DIP_STACK_TRACE_THIS( Gradient( in, g, sigmas, method, boundaryCondition, process, truncation ));
-   DIP_STACK_TRACE_THIS( Hessian( in, H, sigmas, method, boundaryCondition, process, truncation ));
-   DIP_ASSERT( g.TensorElements() == H.TensorRows());
+   // The gradient and the Hessian are computed together, such that they share the smoothing passes
+   FloatArray ss = sigmas;
+   UnsignedArray dims;
+   DIP_STACK_TRACE_THIS( dims = FindGradientDimensions( in.Sizes(), ss, process ));
+   dip::uint nDims = dims.size();
+   DIP_THROW_IF( nDims < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+   std::vector< UnsignedArray > orders( nDims, UnsignedArray( in.Dimensionality(), 0 ));
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      orders[ ii ][ dims[ ii ]] = 1;
+   }
+   AddHessianOrders( orders, dims, in.Dimensionality() );
+   Image derivatives;
+   DIP_STACK_TRACE_THIS( DerivativeBank( in, derivatives, orders, ss, method, boundaryCondition, truncation ));
+   Image g = derivatives[ Range( 0, static_cast< dip::sint >( nDims ) - 1 ) ];
+   Image H = derivatives[ Range( static_cast< dip::sint >( nDims ), -1 ) ];
+   H.ReshapeTensor( Tensor( Tensor::Shape::SYMMETRIC_MATRIX, nDims, nDims ));
 
    // The easy way to compute this:
    //    out = Transpose( g ) * H * g;
    //    out /= Transpose( g ) * g;
    // But that duplicates some computations, so we write it out by hand.
-   // Note that computing the elements of the gradient and Hessian as they are needed, instead of
-   // computing them all upfront, would reduce temporary memory usage. But it's too attractive to
-   // re-use those functions here.
 
    // 1. The first diagonal element, to initialize `out` and `gradSum`.
    Image gradSum = MultiplySampleWise( g[ 0 ], g[ 0 ] );
@@ -521,6 +719,124 @@ void LaplaceMinusDgg(
    DIP_STACK_TRACE_THIS( DggFamily( in, out, sigmas, method, boundaryCondition, process, truncation, DggFamilyVersion::LaplaceMinusDgg ));
 }
 
+namespace {
+
+// Writes `in * mask` and `mask` as the real and imaginary components of a complex image. The two channels of the
+// normalized convolution can then be filtered together, in one pass over the image, because the Gaussian kernels
+// are real-valued.
+template< typename TPF >
+class WeightedValueLineFilter : public Framework::ScanLineFilter {
+   public:
+      virtual dip::uint GetNumberOfOperations( dip::uint, dip::uint, dip::uint ) override { return 2; }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         TPF const* in = static_cast< TPF const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint const inStride = params.inBuffer[ 0 ].stride;
+         TPF const* mask = static_cast< TPF const* >( params.inBuffer[ 1 ].buffer );
+         dip::sint const maskStride = params.inBuffer[ 1 ].stride;
+         std::complex< TPF >* out = static_cast< std::complex< TPF >* >( params.outBuffer[ 0 ].buffer );
+         dip::sint const outStride = params.outBuffer[ 0 ].stride;
+         for( dip::uint kk = 0; kk < params.bufferLength; ++kk ) {
+            *out = { *in * *mask, *mask };
+            in += inStride;
+            mask += maskStride;
+            out += outStride;
+         }
+      }
+};
+
+// Computes the normalized convolution from the filtered weighted values and weights, stored as a complex image by
+// `WeightedValueLineFilter`. If there is a second input, it is the derivative of the weighted values and weights,
+// and the normalized differential convolution is computed instead. Where the filtered weights are zero, the output
+// is zero, as with `dip::SafeDivide`.
+template< typename TPF >
+class NormalizedDivisionLineFilter : public Framework::ScanLineFilter {
+   public:
+      virtual dip::uint GetNumberOfOperations( dip::uint nInput, dip::uint, dip::uint ) override { return 4 * nInput; }
+      virtual void Filter( Framework::ScanLineFilterParameters const& params ) override {
+         std::complex< TPF > const* smooth = static_cast< std::complex< TPF > const* >( params.inBuffer[ 0 ].buffer );
+         dip::sint const smoothStride = params.inBuffer[ 0 ].stride;
+         TPF* out = static_cast< TPF* >( params.outBuffer[ 0 ].buffer );
+         dip::sint const outStride = params.outBuffer[ 0 ].stride;
+         dip::uint const bufferLength = params.bufferLength;
+         if( params.inBuffer.size() == 1 ) {
+            for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
+               TPF weight = smooth->imag();
+               *out = weight == 0 ? TPF( 0 ) : smooth->real() / weight;
+               smooth += smoothStride;
+               out += outStride;
+            }
+         } else {
+            std::complex< TPF > const* derivative = static_cast< std::complex< TPF > const* >( params.inBuffer[ 1 ].buffer );
+            dip::sint const derivativeStride = params.inBuffer[ 1 ].stride;
+            for( dip::uint kk = 0; kk < bufferLength; ++kk ) {
+               TPF weight = smooth->imag();
+               *out = weight == 0 ? TPF( 0 ) : ( derivative->real() - smooth->real() / weight * derivative->imag() ) / weight;
+               smooth += smoothStride;
+               derivative += derivativeStride;
+               out += outStride;
+            }
+         }
+      }
+};
+
+// The normalized convolution can be computed with the fused two-channel filtering
+bool UseFusedNormalizedConvolution( Image const& in ) {
+   return in.IsScalar() && !in.DataType().IsComplex();
+}
+
+// Returns the complex image with `in * mask` and `mask` as its components
+Image WeightedValues( Image const& in, Image const& mask, DataType floatType ) {
+   std::unique_ptr< Framework::ScanLineFilter > lineFilter;
+   DIP_OVL_NEW_FLOAT( lineFilter, WeightedValueLineFilter, (), floatType );
+   DataType complexType = DataType::SuggestComplex( floatType );
+   Image weighted;
+   ImageRefArray outar{ weighted };
+   Framework::Scan( { in, mask }, outar, { floatType, floatType }, { complexType }, { complexType }, { 1 }, *lineFilter );
+   return weighted;
+}
+
+// Computes `out` from the filtered complex images, see `NormalizedDivisionLineFilter`
+void NormalizedDivision( ImageConstRefArray const& filtered, Image& out, DataType floatType ) {
+   std::unique_ptr< Framework::ScanLineFilter > lineFilter;
+   DIP_OVL_NEW_FLOAT( lineFilter, NormalizedDivisionLineFilter, (), floatType );
+   DataType complexType = DataType::SuggestComplex( floatType );
+   DataTypeArray inBufferTypes( filtered.size(), complexType );
+   ImageRefArray outar{ out };
+   Framework::Scan( filtered, outar, inBufferTypes, { floatType }, { floatType }, { 1 }, *lineFilter );
+}
+
+} // namespace
+
+void NormalizedConvolution(
+      Image const& in,
+      Image const& mask,
+      Image& out,
+      FloatArray const& sigmas,
+      String const& method,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) {
+   DIP_THROW_IF( !in.IsForged() || !mask.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !mask.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( mask.DataType().IsComplex(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( mask.Sizes() != in.Sizes(), E::SIZES_DONT_MATCH );
+   DataType dt = DataType::SuggestFlex( in.DataType() );
+   if( UseFusedNormalizedConvolution( in )) {
+      // One complex image holds both channels, it is filtered in place
+      DIP_START_STACK_TRACE
+         Image weighted = WeightedValues( in, mask, dt );
+         Gauss( weighted, weighted, sigmas, { 0 }, method, boundaryCondition, truncation );
+         NormalizedDivision( { weighted }, out, dt );
+      DIP_END_STACK_TRACE
+      return;
+   }
+   Image denominator;
+   DIP_STACK_TRACE_THIS( Gauss( mask, denominator, sigmas, { 0 }, method, boundaryCondition, truncation ));
+   DIP_STACK_TRACE_THIS( MultiplySampleWise( in, mask, out, dt ));
+   DIP_STACK_TRACE_THIS( Gauss( out, out, sigmas, { 0 }, method, boundaryCondition, truncation ));
+   DIP_STACK_TRACE_THIS( SafeDivide( out, denominator, out, dt ));
+}
+
 void NormalizedDifferentialConvolution(
       Image const& in,
       Image const& mask,
@@ -535,12 +851,31 @@ void NormalizedDifferentialConvolution(
    DIP_THROW_IF( !mask.IsScalar(), E::IMAGE_NOT_SCALAR );
    DIP_THROW_IF( mask.DataType().IsComplex(), E::DATA_TYPE_NOT_SUPPORTED );
    DIP_THROW_IF( mask.Sizes() != in.Sizes(), E::SIZES_DONT_MATCH );
+   DIP_THROW_IF( dimension >= in.Dimensionality(), E::ILLEGAL_DIMENSION );
    DataType dt = DataType::SuggestFlex( in.DataType());
 
    // We compute here:
    //    out = SafeDivide( Derivative( a * m ), Gauss( m )) - SafeDivide( Gauss( a * m ), Gauss( m )) * SafeDivide( Derivative( m ), Gauss( m ))
    //        = SafeDivide( Derivative( a * m ) - SafeDivide( Gauss( a * m ), Gauss( m )) * Derivative( m ), Gauss( m ))
 
+   UnsignedArray derivativeOrder( in.Dimensionality(), 0 );
+   derivativeOrder[ dimension ] = 1;
+   if( UseFusedNormalizedConvolution( in )) {
+      // `a * m` and `m` are filtered together as one complex image, and the smoothing and the derivative share
+      // the passes along all other dimensions
+      DIP_START_STACK_TRACE
+         Image weighted = WeightedValues( in, mask, dt );
+         Image filtered;
+         DerivativeBank( weighted, filtered, { UnsignedArray( in.Dimensionality(), 0 ), derivativeOrder }, sigmas,
+                         method, boundaryCondition, truncation );
+         weighted.Strip();
+         Image smooth = filtered[ 0 ];
+         Image derivative = filtered[ 1 ];
+         NormalizedDivision( { smooth, derivative }, out, dt );
+      DIP_END_STACK_TRACE
+      return;
+   }
+
    Image denominator;
    DIP_STACK_TRACE_THIS( Gauss( mask, denominator, sigmas, { 0 }, method, boundaryCondition, truncation ));
    Image weighted;
@@ -550,8 +885,6 @@ void NormalizedDifferentialConvolution(
    DIP_STACK_TRACE_THIS( Gauss( weighted, NC, sigmas, { 0 }, method, boundaryCondition, truncation ));
    SafeDivide( NC, denominator, NC, dt ); // NC.DataType() == dt
    // out = SafeDivide( Derivative( a * m ) - NC * Derivative( m ), Gauss( m ));
-   UnsignedArray derivativeOrder( in.Dimensionality(), 0 );
-   derivativeOrder[ dimension ] = 1;
    Image tmp;
    DIP_STACK_TRACE_THIS( Derivative( mask, tmp, derivativeOrder, sigmas, method, boundaryCondition, truncation ));
    DIP_STACK_TRACE_THIS( Derivative( weighted, out, derivativeOrder, sigmas, method, boundaryCondition, truncation ));
@@ -561,6 +894,76 @@ void NormalizedDifferentialConvolution(
    DIP_STACK_TRACE_THIS( Subtract( out, NC, out, dt ));
    NC.Strip();
    DIP_STACK_TRACE_THIS( SafeDivide( out, denominator, out, dt ));
-};
+}
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/random.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the derivative bank") {
+   dip::Image img{ dip::UnsignedArray{ 40, 30, 20 }, 1, dip::DT_SFLOAT };
+   img.Fill( 50.0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random, 100.0 );
+   std::vector< dip::UnsignedArray > orders{ { 2, 0, 0 }, { 1, 1, 0 }, { 0, 0, 1 }, { 0, 0, 0 }, { 2, 0, 0 }, { 0, 1, 2 } };
+   for( auto method : { "gaussfir", "gaussiir" } ) {
+      dip::Image bank = dip::DerivativeBank( img, orders, { 1.5, 2.0, 1.0 }, method );
+      DOCTEST_REQUIRE( bank.TensorElements() == orders.size() );
+      for( dip::uint ii = 0; ii < orders.size(); ++ii ) {
+         dip::Image ref = dip::Derivative( img, orders[ ii ], { 1.5, 2.0, 1.0 }, method );
+         DOCTEST_CHECK( dip::testing::CompareImages( bank[ ii ], ref, 1e-4 ));
+      }
+   }
+   // Hessian and Dgg are computed through the bank
+   dip::Image H = dip::Hessian( img, { 2.0 } );
+   DOCTEST_CHECK( H.TensorShape() == dip::Tensor::Shape::SYMMETRIC_MATRIX );
+   DOCTEST_CHECK( dip::testing::CompareImages( H[ dip::UnsignedArray{ 0, 2 } ], dip::Derivative( img, { 1, 0, 1 }, { 2.0 } ), 1e-4 ));
+   DOCTEST_CHECK( dip::testing::CompareImages( H[ dip::UnsignedArray{ 1, 1 } ], dip::Derivative( img, { 0, 2, 0 }, { 2.0 } ), 1e-4 ));
+   // A singleton dimension is not processed
+   img = img.At( dip::Range{}, dip::Range{}, dip::Range{ 3 } );
+   dip::Image g = dip::Gradient( img, { 1.0 } );
+   DOCTEST_REQUIRE( g.TensorElements() == 2 );
+   DOCTEST_CHECK( dip::testing::CompareImages( g[ 1 ], dip::Derivative( img, { 0, 1, 0 }, { 1.0 } ), 1e-4 ));
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the normalized convolution") {
+   // Double precision, such that rounding errors don't obscure the comparisons near missing data
+   dip::Image img{ dip::UnsignedArray{ 50, 40 }, 1, dip::DT_DFLOAT };
+   img.Fill( 50.0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random, 100.0 );
+   dip::Image mask{ img.Sizes(), 1, dip::DT_DFLOAT };
+   mask.Fill( 0 );
+   dip::UniformNoise( mask, mask, random, 0.0, 1.0 );
+   mask.At( dip::Range{ 10, 20 }, dip::Range{} ) = 0; // a region with missing data
+   dip::FloatArray sigmas{ 2.0, 1.5 };
+   dip::StringArray bc{ dip::S::ADD_ZEROS };
+   for( auto method : { "best", "gaussfir", "gaussiir", "gaussft" } ) {
+      // The fused computation matches the separate filtering of the weighted values and the weights
+      dip::Image denominator = dip::Gauss( mask, sigmas, { 0 }, method, bc );
+      dip::Image expected = dip::SafeDivide( dip::Gauss( img * mask, sigmas, { 0 }, method, bc ), denominator );
+      dip::Image out = dip::NormalizedConvolution( img, mask, sigmas, method );
+      DOCTEST_CHECK( out.DataType() == dip::DT_DFLOAT );
+      DOCTEST_CHECK( dip::testing::CompareImages( out, expected, 1e-8 ));
+      for( dip::uint dim = 0; dim < 2; ++dim ) {
+         dip::UnsignedArray order{ 0, 0 };
+         order[ dim ] = 1;
+         dip::Image derivative = dip::SafeDivide( dip::Derivative( img * mask, order, sigmas, method, bc ), denominator )
+                                 - expected * dip::SafeDivide( dip::Derivative( mask, order, sigmas, method, bc ), denominator );
+         out = dip::NormalizedDifferentialConvolution( img, mask, dim, sigmas, method );
+         DOCTEST_CHECK( dip::testing::CompareImages( out, derivative, 1e-6 ));
+      }
+   }
+   // A mask of ones gives the Gaussian filter, away from the image edge
+   mask.Fill( 1 );
+   dip::Image out = dip::NormalizedConvolution( img, mask, sigmas, "best", { dip::S::PERIODIC } );
+   DOCTEST_CHECK( dip::testing::CompareImages( out, dip::Gauss( img, sigmas, { 0 }, "best", { dip::S::PERIODIC } ), 1e-8 ));
+   DOCTEST_CHECK( dip::NormalizedConvolution( dip::Convert( img, dip::DT_UINT8 ), mask ).DataType() == dip::DT_SFLOAT );
+   DOCTEST_CHECK_THROWS( dip::NormalizedDifferentialConvolution( img, mask, 2 ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
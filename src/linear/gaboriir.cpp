@@ -1,6 +1,7 @@
 /*
  * DIPlib 3.0
- * This file contains definitions of functions that implement the IIR Gabor filter.
+ * This file contains definitions of functions that implement the IIR Gabor filter and the recursive
+ * oriented Gaussian filter.
  *
  * (c)2018, Erik Schuitema, Cris Luengo.
  * Based on original DIPlib code: (c)1995-2014, Delft University of Technology.
@@ -21,6 +22,7 @@
 
 #include "diplib.h"
 #include "diplib/linear.h"
+#include "diplib/math.h"
 #include "diplib/framework.h"
 
 namespace dip {
@@ -122,6 +124,115 @@ dip__GaborIIRParams dip__FillGaborIIRParams(
    return params;
 }
 
+// Computes the recursive filter along `nLanes` interleaved image lines at once. `in` and `out` point to the
+// first sample of the expanded lines, `stride` is the distance between pixels. The inner loops over `ll` are
+// independent and vectorize, the outer loops over `ii` carry the recursion.
+template< dip::uint N >
+void GaborIIRLanes(
+      dcomplex const* in,
+      dcomplex* out,
+      dip::sint stride,
+      dip::uint length,
+      dip::uint nLanes,
+      dip__GaborIIRParams const& fParams,
+      dcomplex* p1 // buffer of size length * stride
+) {
+   if( N > 0 ) {
+      nLanes = N; // Compile-time constant lets the compiler unroll and vectorize the inner loops
+   }
+   dip::uint S = static_cast< dip::uint >( stride );
+   dcomplex const* p0 = in;
+   dcomplex* p2 = out;
+
+   auto const& a1 = fParams.a1;
+   auto const& a2 = fParams.a2;
+   auto const& b1 = fParams.b1;
+   auto const& b2 = fParams.b2;
+   dcomplex c = fParams.cc;
+
+   auto const& orderMA = fParams.iir_order_num;
+   auto const& orderAR = fParams.iir_order_den;
+   dip::uint order1 = std::max( orderAR[ 0 ], orderMA[ 0 ] );
+   dip::uint order2 = std::max( orderAR[ 3 ], orderMA[ 3 ] );
+   bool copy_forward = ( orderMA[ 0 ] == 0 ) && ( a1[ 0 ] == 1.0 );
+   bool copy_backward = ( orderMA[ 3 ] == 0 ) && ( a2[ 0 ] == 1.0 );
+
+   // Recursive forward scan
+   for( dip::uint ii = 0; ii < order1; ii++ ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         p1[ ii * S + ll ] = p0[ ii * S + ll ];
+      }
+   }
+   for( dip::uint ii = order1; ii < length; ii++ ) {
+      dcomplex* dest = p1 + ii * S;
+      if( !copy_forward ) {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = 0.0;
+         }
+         for( dip::uint jj = orderMA[ 1 ]; jj <= orderMA[ 2 ]; jj++ ) {
+            dcomplex const* src = p0 + ( ii - jj ) * S;
+            for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+               dest[ ll ] += dcomplex(( a1[ jj ].real() * src[ ll ].real() ) - ( a1[ jj ].imag() * src[ ll ].imag() ),
+                                      ( a1[ jj ].real() * src[ ll ].imag() ) - ( a1[ jj ].imag() * src[ ll ].real() ));
+            }
+         }
+      } else {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = p0[ ii * S + ll ];
+         }
+      }
+      for( dip::uint jj = orderAR[ 1 ]; jj <= orderAR[ 2 ]; jj++ ) {
+         dcomplex const* src = dest - jj * S;
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] -= dcomplex(( b1[ jj ].real() * src[ ll ].real() ) - ( b1[ jj ].imag() * src[ ll ].imag() ),
+                                   ( b1[ jj ].real() * src[ ll ].imag() ) + ( b1[ jj ].imag() * src[ ll ].real() ));
+         }
+      }
+   }
+
+   // Backward scan
+   for( dip::uint ii = length - order2; ii < length; ii++ ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         p2[ ii * S + ll ] = p1[ ii * S + ll ];
+      }
+   }
+   for( dip::uint ii = length - order2; ii-- > 0; ) {
+      dcomplex* dest = p2 + ii * S;
+      if( !copy_backward ) {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = 0.0;
+         }
+         for( dip::uint jj = orderMA[ 4 ]; jj <= orderMA[ 5 ]; jj++ ) {
+            dcomplex const* src = p1 + ( ii + jj ) * S;
+            for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+               dest[ ll ] += dcomplex(( a2[ jj ].real() * src[ ll ].real() ) - ( a2[ jj ].imag() * src[ ll ].imag() ),
+                                      ( a2[ jj ].real() * src[ ll ].imag() ) - ( a2[ jj ].imag() * src[ ll ].real() ));
+            }
+         }
+      } else {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = p1[ ii * S + ll ];
+         }
+      }
+      for( dip::uint jj = orderAR[ 4 ]; jj <= orderAR[ 5 ]; jj++ ) {
+         dcomplex const* src = dest + jj * S;
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] -= dcomplex(( b2[ jj ].real() * src[ ll ].real() ) - ( b2[ jj ].imag() * src[ ll ].imag() ),
+                                   ( b2[ jj ].real() * src[ ll ].imag() ) + ( b2[ jj ].imag() * src[ ll ].real() ));
+         }
+      }
+   }
+
+   // Normalization
+   for( dip::uint ii = 0; ii < length; ii++ ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         dcomplex& v = p2[ ii * S + ll ];
+         v.real( c.real() * v.real() );
+         v.imag( c.real() * v.imag() );
+      }
+   }
+}
+
 // Gabor IIR separable line filter
 class GaborIIRLineFilter : public Framework::SeparableLineFilter
 {
@@ -130,92 +241,33 @@ public:
    virtual void SetNumberOfThreads( dip::uint threads ) override {
       buffers_.resize( threads );
    }
-   virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint, dip::uint /*procDim*/ ) override {
-      // TODO: figure out how filter parameters affect amount of computation
-      //dip__GaborIIRParams const& fParams = filterParams_[ procDim ];
-      return lineLength * 40;
+   virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint border, dip::uint procDim ) override {
+      // Each output sample takes one complex multiply-add per MA and AR term, in the forward and in the backward pass
+      dip__GaborIIRParams const& fParams = filterParams_[ procDim ];
+      auto const& orderMA = fParams.iir_order_num;
+      auto const& orderAR = fParams.iir_order_den;
+      dip::uint terms = ( orderMA[ 2 ] - orderMA[ 1 ] + 1 ) + ( orderAR[ 2 ] - orderAR[ 1 ] + 1 )
+                      + ( orderMA[ 5 ] - orderMA[ 4 ] + 1 ) + ( orderAR[ 5 ] - orderAR[ 4 ] + 1 );
+      return ( lineLength + 2 * border ) * 8 * terms;
    }
    virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
       dcomplex* in = static_cast< dcomplex* >(params.inBuffer.buffer);
       dcomplex* out = static_cast< dcomplex* >(params.outBuffer.buffer);
-      DIP_ASSERT( params.inBuffer.stride == 1 );
-      DIP_ASSERT( params.outBuffer.stride == 1 );
+      dip::sint stride = params.inBuffer.stride;
+      DIP_ASSERT( stride >= static_cast< dip::sint >( params.nLines ));
+      DIP_ASSERT( params.outBuffer.stride == stride );
       dip__GaborIIRParams const& fParams = filterParams_[ params.dimension ];
       DIP_ASSERT( fParams.border == params.inBuffer.border );
 
-      in -= fParams.border;
-      out -= fParams.border;
+      in -= static_cast< dip::sint >( fParams.border ) * stride;
+      out -= static_cast< dip::sint >( fParams.border ) * stride;
       dip::uint length = params.inBuffer.length + fParams.border * 2;
-      buffers_[ params.thread ].resize( length ); // won't do anything if buffer is already of correct size.
+      buffers_[ params.thread ].resize( length * static_cast< dip::uint >( stride )); // won't do anything if buffer is already of correct size.
       dcomplex* p1 = buffers_[ params.thread ].data();
-
-      auto const& a1 = fParams.a1;
-      auto const& a2 = fParams.a2;
-      auto const& b1 = fParams.b1;
-      auto const& b2 = fParams.b2;
-      dcomplex c = fParams.cc;
-
-      auto const& orderMA = fParams.iir_order_num;
-      auto const& orderAR = fParams.iir_order_den;
-      dip::uint order1 = std::max( orderAR[ 0 ], orderMA[ 0 ] );
-      dip::uint order2 = std::max( orderAR[ 3 ], orderMA[ 3 ] );
-      bool copy_forward = false;
-      bool copy_backward = false;
-      if(( orderMA[ 0 ] == 0 ) && ( a1[ 0 ] == 1.0 )) {
-         copy_forward = true;
-      }
-      if(( orderMA[ 3 ] == 0 ) && ( a2[ 0 ] == 1.0 )) {
-         copy_backward = true;
-      }
-
-      // Recursive forward scan
-      dcomplex* p0 = in;
-      for( dip::uint ii = 0; ii < order1; ii++ ) {
-         p1[ ii ] = p0[ ii ];
-      }
-      for( dip::uint ii = order1; ii < length; ii++ ) {
-         if( !copy_forward ) {
-            p1[ ii ] = 0.0;
-            for( dip::uint jj = orderMA[ 1 ]; jj <= orderMA[ 2 ]; jj++ ) {
-               p1[ ii ] += dcomplex(( a1[ jj ].real() * p0[ ii - jj ].real() ) - ( a1[ jj ].imag() * p0[ ii - jj ].imag() ),
-                                    ( a1[ jj ].real() * p0[ ii - jj ].imag() ) - ( a1[ jj ].imag() * p0[ ii - jj ].real() ));
-            }
-         } else {
-            p1[ ii ] = p0[ ii ];
-         }
-
-         for(dip::uint jj = orderAR[ 1 ]; jj <= orderAR[ 2 ]; jj++ ) {
-            p1[ ii ] -= dcomplex(( b1[ jj ].real() * p1[ ii - jj ].real() ) - ( b1[ jj ].imag() * p1[ ii - jj ].imag() ),
-                                 ( b1[ jj ].real() * p1[ ii - jj ].imag() ) + ( b1[ jj ].imag() * p1[ ii - jj ].real() ));
-         }
-      }
-
-      // Backward scan
-      dcomplex* p2 = out;
-      for( dip::uint ii = length - order2; ii < length; ii++ ) {
-         p2[ ii ] = p1[ ii ];
-      }
-      for( dip::uint ii = length - order2; ii-- > 0; ) {
-         if( !copy_backward ) {
-            p2[ ii ] = 0.0;
-            for( dip::uint jj = orderMA[ 4 ]; jj <= orderMA[ 5 ]; jj++ ) {
-               p2[ ii ] += dcomplex(( a2[ jj ].real() * p1[ ii + jj ].real() ) - ( a2[ jj ].imag() * p1[ ii + jj ].imag() ),
-                                    ( a2[ jj ].real() * p1[ ii + jj ].imag() ) - ( a2[ jj ].imag() * p1[ ii + jj ].real() ));
-            }
-         } else {
-            p2[ ii ] = p1[ ii ];
-         }
-
-         for( dip::uint jj = orderAR[ 4 ]; jj <= orderAR[ 5 ]; jj++ ) {
-            p2[ ii ] -= dcomplex(( b2[ jj ].real() * p2[ ii + jj ].real() ) - ( b2[ jj ].imag() * p2[ ii + jj ].imag() ),
-                                 ( b2[ jj ].real() * p2[ ii + jj ].imag() ) + ( b2[ jj ].imag() * p2[ ii + jj ].real() ));
-         }
-      }
-
-      // Normalization
-      for(dip::uint ii = 0; ii < length; ii++ ) {
-         p2[ ii ].real( c.real() * p2[ ii ].real() );
-         p2[ ii ].imag( c.real() * p2[ ii ].imag() );
+      if( params.nLines == Framework::separableInterleavedLines ) {
+         GaborIIRLanes< Framework::separableInterleavedLines >( in, out, stride, length, params.nLines, fParams, p1 );
+      } else {
+         GaborIIRLanes< 0 >( in, out, stride, length, params.nLines, fParams, p1 );
       }
    }
 private:
@@ -223,6 +275,103 @@ private:
    std::vector< std::vector< dcomplex >> buffers_; // one for each thread
 };
 
+// Applies the filters in `filterParams` along the dimensions in `process`
+void ApplyGaborIIR(
+      Image const& in,
+      Image& out,
+      DataType outType,
+      std::vector< dip__GaborIIRParams > const& filterParams,
+      BooleanArray const& process,
+      BoundaryConditionArray const& bc
+) {
+   UnsignedArray border( process.size(), 0 );
+   for( dip::uint ii = 0; ii < process.size(); ++ii ) {
+      if( process[ ii ] ) {
+         border[ ii ] = filterParams[ ii ].border;
+      }
+   }
+   GaborIIRLineFilter lineFilter( filterParams );
+   Framework::Separable(
+      in,
+      out,
+      DT_DCOMPLEX,
+      outType,
+      process,
+      border,
+      bc,
+      lineFilter,
+      Framework::SeparableOption::AsScalarImage
+      + Framework::SeparableOption::UseOutputBorder
+      + Framework::SeparableOption::InterleavedLines // processes several image lines at once
+   );
+}
+
+// Writes `out[ x ] = in( x + position )`, with linear interpolation, for `x` in [0, `length`). `in` has `inLength`
+// samples, reads outside it are clamped to its ends. Both lines are contiguous.
+void ShiftLine( dfloat const* in, dip::sint inLength, dfloat* out, dip::sint length, dfloat position ) {
+   dfloat integer = std::floor( position );
+   dip::sint offset = static_cast< dip::sint >( integer );
+   dfloat right = position - integer;
+   dfloat left = 1.0 - right;
+   // Within [`begin`, `end`), both `x + offset` and `x + offset + 1` are inside `in`
+   dip::sint begin = clamp( -offset, dip::sint( 0 ), length );
+   dip::sint end = clamp( inLength - 1 - offset, begin, length );
+   for( dip::sint x = 0; x < begin; ++x ) {
+      out[ x ] = in[ clamp( x + offset + ( right > 0.5 ? 1 : 0 ), dip::sint( 0 ), inLength - 1 ) ];
+   }
+   dfloat const* src = in + offset;
+   for( dip::sint x = begin; x < end; ++x ) {
+      out[ x ] = left * src[ x ] + right * src[ x + 1 ];
+   }
+   for( dip::sint x = end; x < length; ++x ) {
+      out[ x ] = in[ clamp( x + offset + ( right > 0.5 ? 1 : 0 ), dip::sint( 0 ), inLength - 1 ) ];
+   }
+}
+
+// Applies the recursive Gaussian with `sigma` along sheared lines of `in`, a 2D image of type `DT_DFLOAT` with
+// contiguous rows: each step along dimension 1 is a step of `shift` pixels along dimension 0, with `|shift| <= 1`.
+// The rows of `in` are first shifted so that these lines become columns, which are filtered with `dip::GaussIIR`,
+// and then shifted back. Keeping the linear interpolation out of the recursion keeps the filter stable. `out`
+// receives the window of the result that starts at `(axisBorder, lineBorder)`, it must be forged.
+void ShearedGaussIIR(
+      Image const& in,
+      Image& out,
+      dfloat shift,
+      dfloat sigma,
+      dfloat truncation,
+      dip::uint axisBorder,
+      dip::uint lineBorder
+) {
+   DIP_ASSERT( in.Stride( 0 ) == 1 );
+   DIP_ASSERT( out.Stride( 0 ) == 1 );
+   dip::sint inWidth = static_cast< dip::sint >( in.Size( 0 ));
+   dip::uint nRows = in.Size( 1 );
+   // Row `ii` is shifted by `( ii - center ) * shift`, the sheared image needs `padding` extra columns on each side
+   dfloat center = static_cast< dfloat >( nRows - 1 ) / 2.0;
+   dip::sint padding = static_cast< dip::sint >( std::ceil( std::abs( shift ) * center ));
+   dip::sint shearedWidth = inWidth + 2 * padding;
+   Image sheared( { static_cast< dip::uint >( shearedWidth ), nRows }, 1, DT_DFLOAT );
+   dfloat const* inOrigin = static_cast< dfloat const* >( in.Origin() );
+   dfloat* shearedOrigin = static_cast< dfloat* >( sheared.Origin() );
+   for( dip::uint ii = 0; ii < nRows; ++ii ) {
+      dfloat t = ( static_cast< dfloat >( ii ) - center ) * shift;
+      ShiftLine( inOrigin + static_cast< dip::sint >( ii ) * in.Stride( 1 ), inWidth,
+                 shearedOrigin + static_cast< dip::sint >( ii ) * sheared.Stride( 1 ), shearedWidth,
+                 t - static_cast< dfloat >( padding ));
+   }
+   GaussIIR( sheared, sheared, { 0.0, sigma }, { 0, 0 }, {}, {}, S::DISCRETE_TIME_FIT, truncation );
+   shearedOrigin = static_cast< dfloat* >( sheared.Origin() ); // in case `GaussIIR` reallocated it
+   dip::sint outWidth = static_cast< dip::sint >( out.Size( 0 ));
+   dfloat* outOrigin = static_cast< dfloat* >( out.Origin() );
+   for( dip::uint ii = 0; ii < out.Size( 1 ); ++ii ) {
+      dip::uint row = ii + lineBorder;
+      dfloat t = ( static_cast< dfloat >( row ) - center ) * shift;
+      ShiftLine( shearedOrigin + static_cast< dip::sint >( row ) * sheared.Stride( 1 ), shearedWidth,
+                 outOrigin + static_cast< dip::sint >( ii ) * out.Stride( 1 ), outWidth,
+                 static_cast< dfloat >( axisBorder + static_cast< dip::uint >( padding )) - t );
+   }
+}
+
 } // namespace
 
 void GaborIIR(
@@ -285,10 +434,460 @@ void GaborIIR(
          lineFilter,
          Framework::SeparableOption::AsScalarImage
          + Framework::SeparableOption::UseOutputBorder
-         + Framework::SeparableOption::UseInputBuffer // ensures that there's no strides
-         + Framework::SeparableOption::UseOutputBuffer // ensures that there's no strides
+         + Framework::SeparableOption::InterleavedLines // processes several image lines at once
       );
    DIP_END_STACK_TRACE
 }
 
+void GaborIIRBank(
+   Image const& c_in,
+   Image& out,
+   std::vector< FloatArray > const& sigmas,
+   std::vector< FloatArray > const& frequencies,
+   String const& outputMode,
+   StringArray const& boundaryCondition,
+   BooleanArray const& c_process,
+   dfloat truncation
+) {
+   DIP_THROW_IF( !c_in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !c_in.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !c_in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   dip::uint nFilters = frequencies.size();
+   DIP_THROW_IF( nFilters == 0, E::INVALID_PARAMETER );
+   DIP_THROW_IF(( sigmas.size() != 1 ) && ( sigmas.size() != nFilters ), E::ARRAY_SIZES_DONT_MATCH );
+   bool magnitude;
+   if( outputMode == "magnitude" ) {
+      magnitude = true;
+   } else if( outputMode == "complex" ) {
+      magnitude = false;
+   } else {
+      DIP_THROW_INVALID_FLAG( outputMode );
+   }
+   dip::uint nDims = c_in.Dimensionality();
+   BooleanArray process = c_process;
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( process, nDims, true ));
+   if( truncation <= 0.0 ) {
+      truncation = 3;   // Default truncation
+   }
+
+   // Sigmas for each filter
+   std::vector< FloatArray > filterSigmas( nFilters );
+   for( dip::uint ii = 0; ii < nFilters; ++ii ) {
+      DIP_THROW_IF( frequencies[ ii ].size() != nDims, E::ARRAY_PARAMETER_WRONG_LENGTH );
+      filterSigmas[ ii ] = sigmas[ sigmas.size() == 1 ? 0 : ii ];
+      DIP_THROW_IF( filterSigmas[ ii ].empty(), E::INVALID_PARAMETER );
+      DIP_STACK_TRACE_THIS( ArrayUseParameter( filterSigmas[ ii ], nDims, 1.0 ));
+   }
+
+   DIP_START_STACK_TRACE
+      Image in = c_in.QuickCopy();
+      PixelSize pixelSize = c_in.PixelSize();
+      if( out.Aliases( in )) {
+         out.Strip(); // we write to `out` before we're done reading `in`
+      }
+      DataType complexType = DataType::SuggestComplex( in.DataType() );
+      DataType outType = magnitude ? DataType::SuggestFloat( in.DataType() ) : complexType;
+      if( out.IsProtected() || ( out.IsForged() && ( out.Sizes() == in.Sizes() )
+                                 && ( out.TensorElements() == nFilters ) && ( out.DataType() == outType ))) {
+         out.ReForge( in.Sizes(), nFilters, outType, Option::AcceptDataTypeChange::DO_ALLOW );
+      } else {
+         // Store each filter response as a contiguous plane. With the usual interleaved tensor elements, writing the
+         // response of one filter would touch all the memory of `out`.
+         out.Strip();
+         out.SetSizes( in.Sizes() );
+         out.SetTensorSizes( nFilters );
+         out.SetDataType( outType );
+         out.SetStrides( Image::ComputeStrides( in.Sizes(), 1 ));
+         out.SetTensorStride( static_cast< dip::sint >( in.NumberOfPixels() ));
+         out.Forge();
+      }
+      BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
+
+      Image intermediate; // the result of the first pass, reused for all filters
+      Image response; // the complex response of one filter in magnitude mode, reused for all filters
+      std::vector< bool > done( nFilters, false );
+      for( dip::uint ii = 0; ii < nFilters; ++ii ) {
+         if( done[ ii ] ) {
+            continue;
+         }
+         // The filters with the same sigmas as filter `ii`
+         FloatArray const& groupSigmas = filterSigmas[ ii ];
+         std::vector< dip::uint > group;
+         for( dip::uint kk = ii; kk < nFilters; ++kk ) {
+            if( !done[ kk ] && ( filterSigmas[ kk ] == groupSigmas )) {
+               group.push_back( kk );
+               done[ kk ] = true;
+            }
+         }
+         BooleanArray groupProcess = process;
+         dip::uint nProcess = 0;
+         for( dip::uint dd = 0; dd < nDims; ++dd ) {
+            if( groupProcess[ dd ] && ( groupSigmas[ dd ] > 0.0 ) && ( in.Size( dd ) > 1 )) {
+               ++nProcess;
+            } else {
+               groupProcess[ dd ] = false;
+            }
+         }
+         if( nProcess == 0 ) {
+            for( dip::uint kk : group ) {
+               Image dest = out[ kk ];
+               dest.Protect();
+               if( magnitude ) {
+                  Abs( in, dest );
+               } else {
+                  dest.Copy( in );
+               }
+            }
+            continue;
+         }
+
+         // The input is real-valued, so filtering along the first dimension with frequency `-f` yields the complex
+         // conjugate of filtering with `f`. Filters with equal or opposite frequencies along the first dimension
+         // share that first pass. We start with the dimension along which the filters have the fewest distinct
+         // frequencies, and among those, the one with the largest stride, which is the most expensive to process.
+         dip::uint firstDim = nDims;
+         dip::uint fewest = 0;
+         for( dip::uint dd = 0; dd < nDims; ++dd ) {
+            if( !groupProcess[ dd ] ) {
+               continue;
+            }
+            std::vector< dfloat > distinct;
+            for( dip::uint kk : group ) {
+               dfloat f = std::abs( frequencies[ kk ][ dd ] );
+               if( std::find( distinct.begin(), distinct.end(), f ) == distinct.end() ) {
+                  distinct.push_back( f );
+               }
+            }
+            if(( firstDim == nDims ) || ( distinct.size() < fewest ) ||
+               (( distinct.size() == fewest ) && ( std::abs( in.Stride( dd )) > std::abs( in.Stride( firstDim ))))) {
+               firstDim = dd;
+               fewest = distinct.size();
+            }
+         }
+         BooleanArray firstProcess( nDims, false );
+         firstProcess[ firstDim ] = true;
+         BooleanArray restProcess = groupProcess;
+         restProcess[ firstDim ] = false;
+
+         std::vector< dip__GaborIIRParams > filterParams( nDims );
+         std::vector< bool > computed( group.size(), false );
+         for( dip::uint jj = 0; jj < group.size(); ++jj ) {
+            if( computed[ jj ] ) {
+               continue;
+            }
+            dfloat firstFrequency = frequencies[ group[ jj ]][ firstDim ];
+            std::vector< dip::uint > shared;
+            std::vector< bool > conjugate;
+            for( dip::uint kk = jj; kk < group.size(); ++kk ) {
+               dfloat f = frequencies[ group[ kk ]][ firstDim ];
+               if( !computed[ kk ] && (( f == firstFrequency ) || ( f == -firstFrequency ))) {
+                  shared.push_back( group[ kk ] );
+                  conjugate.push_back( f != firstFrequency );
+                  computed[ kk ] = true;
+               }
+            }
+            filterParams[ firstDim ] = dip__FillGaborIIRParams( groupSigmas[ firstDim ], firstFrequency, truncation );
+            if( nProcess == 1 ) {
+               // The first pass is the only one, copy its result to the filters that share it
+               Image dest0 = out[ shared[ 0 ]];
+               dest0.Protect();
+               ApplyGaborIIR( in, dest0, complexType, filterParams, firstProcess, bc );
+               for( dip::uint kk = 1; kk < shared.size(); ++kk ) {
+                  Image dest = out[ shared[ kk ]];
+                  dest.Protect();
+                  if( conjugate[ kk ] && !magnitude ) {
+                     Conjugate( dest0, dest );
+                  } else {
+                     dest.Copy( dest0 );
+                  }
+               }
+            } else {
+               ApplyGaborIIR( in, intermediate, DT_DCOMPLEX, filterParams, firstProcess, bc );
+               for( dip::uint kk = 0; kk < shared.size(); ++kk ) {
+                  // Filtering the conjugate with frequency `f` is the conjugate of filtering with `-f`
+                  for( dip::uint dd = 0; dd < nDims; ++dd ) {
+                     if( restProcess[ dd ] ) {
+                        dfloat f = frequencies[ shared[ kk ]][ dd ];
+                        filterParams[ dd ] = dip__FillGaborIIRParams( groupSigmas[ dd ], conjugate[ kk ] ? -f : f, truncation );
+                     }
+                  }
+                  Image dest = out[ shared[ kk ]];
+                  dest.Protect();
+                  if( magnitude ) {
+                     // Converting the complex line buffers to `dest` would compute `std::abs` for each sample, which
+                     // is much slower than taking the square root of the square modulus of the whole image.
+                     ApplyGaborIIR( intermediate, response, complexType, filterParams, restProcess, bc );
+                     SquareModulus( response, dest );
+                     Sqrt( dest, dest );
+                  } else {
+                     ApplyGaborIIR( intermediate, dest, complexType, filterParams, restProcess, bc );
+                     if( conjugate[ kk ] ) {
+                        Conjugate( dest, dest );
+                     }
+                  }
+               }
+            }
+         }
+      }
+      out.SetPixelSize( pixelSize );
+   DIP_END_STACK_TRACE
+}
+
+void OrientedGaussBank(
+   Image const& c_in,
+   Image& out,
+   std::vector< FloatArray > const& sigmas,
+   FloatArray const& orientations,
+   StringArray const& boundaryCondition,
+   dfloat truncation
+) {
+   DIP_THROW_IF( !c_in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !c_in.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !c_in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( c_in.Dimensionality() != 2, E::DIMENSIONALITY_NOT_SUPPORTED );
+   dip::uint nFilters = orientations.size();
+   DIP_THROW_IF( nFilters == 0, E::INVALID_PARAMETER );
+   DIP_THROW_IF(( sigmas.size() != 1 ) && ( sigmas.size() != nFilters ), E::ARRAY_SIZES_DONT_MATCH );
+   for( auto const& s : sigmas ) {
+      DIP_THROW_IF( s.size() != 2, E::ARRAY_PARAMETER_WRONG_LENGTH );
+      DIP_THROW_IF(( s[ 0 ] < 0.0 ) || ( s[ 1 ] < 0.0 ), E::PARAMETER_OUT_OF_RANGE );
+   }
+   DIP_THROW_IF( boundaryCondition.size() > 2, E::ARRAY_PARAMETER_WRONG_LENGTH );
+   if( truncation <= 0.0 ) {
+      truncation = 3;   // Default truncation
+   }
+
+   // The covariance matrix of each filter is split into a Gaussian along one image axis, followed by a Gaussian
+   // along a sheared line that steps one pixel along the other axis and `shift` pixels along the first one. The
+   // sheared line steps along the axis with the largest variance, so that `|shift| <= 1`. `swap` is true if that
+   // is the x-axis.
+   struct Decomposition {
+      bool swap;
+      dfloat axisVariance;
+      dfloat lineVariance;
+      dfloat shift;
+   };
+   std::vector< Decomposition > decompositions( nFilters );
+   for( dip::uint ii = 0; ii < nFilters; ++ii ) {
+      FloatArray const& s = sigmas[ sigmas.size() == 1 ? 0 : ii ];
+      // Orientations `x` and `pi - x` have the same diagonal covariance elements and opposite off-diagonal ones,
+      // we compute them from the same angle so that they are exactly equal and share the axis pass.
+      dfloat angle = std::fmod( orientations[ ii ], pi );
+      if( angle < 0 ) {
+         angle += pi;
+      }
+      dfloat sign = 1.0;
+      if( angle > pi / 2 ) {
+         angle = pi - angle;
+         sign = -1.0;
+      }
+      dfloat cosine = std::cos( angle );
+      dfloat sine = std::sin( angle );
+      dfloat su2 = s[ 0 ] * s[ 0 ];
+      dfloat sv2 = s[ 1 ] * s[ 1 ];
+      dfloat xx = su2 * cosine * cosine + sv2 * sine * sine;
+      dfloat yy = su2 * sine * sine + sv2 * cosine * cosine;
+      dfloat xy = sign * ( su2 - sv2 ) * cosine * sine;
+      Decomposition& d = decompositions[ ii ];
+      d.swap = xx > yy;
+      if( d.swap ) {
+         std::swap( xx, yy );
+      }
+      if( yy > 0.0 ) {
+         d.shift = xy / yy;
+         d.axisVariance = std::max( xx - xy * d.shift, 0.0 );
+      } else {
+         d.shift = 0.0;
+         d.axisVariance = 0.0;
+      }
+      d.lineVariance = yy;
+   }
+
+   DIP_START_STACK_TRACE
+      Image in = c_in.QuickCopy();
+      PixelSize pixelSize = c_in.PixelSize();
+      if( out.Aliases( in )) {
+         out.Strip(); // we write to `out` before we're done reading `in`
+      }
+      DataType outType = DataType::SuggestFloat( in.DataType() );
+      if( out.IsProtected() || ( out.IsForged() && ( out.Sizes() == in.Sizes() )
+                                 && ( out.TensorElements() == nFilters ) && ( out.DataType() == outType ))) {
+         out.ReForge( in.Sizes(), nFilters, outType, Option::AcceptDataTypeChange::DO_ALLOW );
+      } else {
+         // Store each filter response as a contiguous plane, as in `dip::GaborIIRBank`
+         out.Strip();
+         out.SetSizes( in.Sizes() );
+         out.SetTensorSizes( nFilters );
+         out.SetDataType( outType );
+         out.SetStrides( Image::ComputeStrides( in.Sizes(), 1 ));
+         out.SetTensorStride( static_cast< dip::sint >( in.NumberOfPixels() ));
+         out.Forge();
+      }
+
+      std::vector< bool > done( nFilters, false );
+      for( dip::uint ii = 0; ii < nFilters; ++ii ) {
+         if( done[ ii ] ) {
+            continue;
+         }
+         // The filters that share the axis pass and the line sigma with filter `ii`
+         Decomposition const& d = decompositions[ ii ];
+         std::vector< dip::uint > group;
+         std::vector< dfloat > shifts;
+         for( dip::uint kk = ii; kk < nFilters; ++kk ) {
+            Decomposition const& dk = decompositions[ kk ];
+            if( !done[ kk ] && ( dk.swap == d.swap ) && ( dk.axisVariance == d.axisVariance )
+                && ( dk.lineVariance == d.lineVariance )) {
+               group.push_back( kk );
+               shifts.push_back( dk.shift );
+               done[ kk ] = true;
+            }
+         }
+         // We process the image with the sheared lines stepping along dimension 1
+         Image input = in.QuickCopy();
+         StringArray groupBC = boundaryCondition;
+         if( d.swap ) {
+            input.SwapDimensions( 0, 1 );
+            if( groupBC.size() == 2 ) {
+               std::swap( groupBC[ 0 ], groupBC[ 1 ] );
+            }
+         }
+         Image smoothed( input.Sizes(), 1, DT_DFLOAT );
+         smoothed.Protect();
+         Gauss( input, smoothed, { std::sqrt( d.axisVariance ), 0.0 }, { 0, 0 }, S::BEST, groupBC, truncation );
+         if( d.lineVariance == 0.0 ) {
+            for( dip::uint kk : group ) {
+               Image dest = out[ kk ];
+               if( d.swap ) {
+                  dest.SwapDimensions( 0, 1 );
+               }
+               dest.Protect();
+               dest.Copy( smoothed );
+            }
+            continue;
+         }
+         dfloat lineSigma = std::sqrt( d.lineVariance );
+         // Along dimension 1 we need the border of the recursive filter. Along dimension 0, the sheared lines
+         // through the image move `|shift|` pixels per row, plus one pixel for the interpolation.
+         dfloat maxShift = 0.0;
+         for( dfloat shift : shifts ) {
+            maxShift = std::max( maxShift, std::abs( shift ));
+         }
+         dip::uint lineBorder = static_cast< dip::uint >( std::ceil( lineSigma * truncation )) + 1;
+         dip::uint axisBorder = static_cast< dip::uint >( std::ceil( maxShift * static_cast< dfloat >( lineBorder ))) + 2;
+         Image extended;
+         ExtendImage( smoothed, extended, { axisBorder, lineBorder }, StringArrayToBoundaryConditionArray( groupBC ));
+         Image result = smoothed; // reuse the memory for the result, `smoothed` has the right sizes and strides
+         for( dip::uint kk = 0; kk < group.size(); ++kk ) {
+            ShearedGaussIIR( extended, result, shifts[ kk ], lineSigma, truncation, axisBorder, lineBorder );
+            Image dest = out[ group[ kk ]];
+            if( d.swap ) {
+               dest.SwapDimensions( 0, 1 );
+            }
+            dest.Protect();
+            dest.Copy( result );
+         }
+      }
+      out.SetPixelSize( pixelSize );
+   DIP_END_STACK_TRACE
+}
+
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/statistics.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the IIR Gabor filter bank") {
+   dip::Image img{ dip::UnsignedArray{ 61, 37 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random, 100.0 );
+   dip::FloatArray sigmas{ 2.0, 5.0 };
+   dip::FloatArray frequencies{ 0.2, 0.08 };
+   dip::uint nOrientations = 10;
+   dip::Image bank = dip::Gabor2DBank( img, sigmas, frequencies, nOrientations, "complex", { "mirror" } );
+   DOCTEST_REQUIRE( bank.TensorElements() == 20 );
+   DOCTEST_CHECK( bank.DataType() == dip::DT_SCOMPLEX );
+   dip::Image magnitude = dip::Gabor2DBank( img, sigmas, frequencies, nOrientations, "magnitude", { "mirror" } );
+   DOCTEST_REQUIRE( magnitude.TensorElements() == 20 );
+   DOCTEST_CHECK( magnitude.DataType() == dip::DT_SFLOAT );
+   for( dip::uint ii = 0; ii < sigmas.size(); ++ii ) {
+      for( dip::uint jj = 0; jj < nOrientations; ++jj ) {
+         dip::dfloat direction = static_cast< dip::dfloat >( jj ) * dip::pi / static_cast< dip::dfloat >( nOrientations );
+         dip::Image expected = dip::Gabor2D( img, { sigmas[ ii ], sigmas[ ii ] }, frequencies[ ii ], direction, { "mirror" } );
+         dip::uint index = ii * nOrientations + jj;
+         // The bank processes dimensions in a different order, its directions differ in the last bit, and it computes
+         // the magnitude in double precision
+         DOCTEST_CHECK( dip::testing::CompareImages( bank[ index ], expected, 1e-3 ));
+         DOCTEST_CHECK( dip::testing::CompareImages( magnitude[ index ], dip::Modulus( expected ), 1e-3 ));
+      }
+   }
+   // Explicit filters, mixing sigmas, with one dimension not filtered, and opposite frequencies
+   std::vector< dip::FloatArray > bankSigmas{{ 3.0, 0.0 }, { 1.5, 2.0 }, { 3.0, 0.0 }, { 3.0, 0.0 }, { 1.5, 2.0 }};
+   std::vector< dip::FloatArray > bankFrequencies{{ 0.1, 0.0 }, { 0.0, 0.3 }, { 0.15, 0.2 }, { -0.1, 0.0 }, { -0.0, -0.3 }};
+   bank = dip::GaborIIRBank( img, bankSigmas, bankFrequencies );
+   DOCTEST_REQUIRE( bank.TensorElements() == 5 );
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      DOCTEST_CHECK( dip::testing::CompareImages( bank[ ii ], dip::GaborIIR( img, bankSigmas[ ii ], bankFrequencies[ ii ] ), 1e-3 ));
+   }
+   DOCTEST_CHECK_THROWS( dip::GaborIIRBank( img, bankSigmas, bankFrequencies, "phase" ));
+   DOCTEST_CHECK_THROWS( dip::GaborIIRBank( img, { { 1.0 }, { 2.0 } }, bankFrequencies ));
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the oriented Gaussian filter bank") {
+   // The impulse response has the expected covariance matrix
+   dip::Image impulse{ dip::UnsignedArray{ 121, 121 }, 1, dip::DT_SFLOAT };
+   impulse.Fill( 0 );
+   impulse.At( 60, 60 ) = 1;
+   dip::FloatArray sigmas{ 8.0, 2.0 };
+   dip::FloatArray orientations{ 0.0, dip::pi / 8, dip::pi / 4, dip::pi / 2, 7 * dip::pi / 8, 9 * dip::pi / 8 };
+   dip::Image bank = dip::OrientedGaussBank( impulse, { sigmas }, orientations, {}, 4 );
+   DOCTEST_REQUIRE( bank.TensorElements() == orientations.size() );
+   DOCTEST_CHECK( bank.DataType() == dip::DT_SFLOAT );
+   for( dip::uint ii = 0; ii < orientations.size(); ++ii ) {
+      dip::dfloat sum = 0, xx = 0, yy = 0, xy = 0;
+      for( dip::sint y = 0; y < 121; ++y ) {
+         for( dip::sint x = 0; x < 121; ++x ) {
+            dip::dfloat v = bank[ ii ].At( static_cast< dip::uint >( x ), static_cast< dip::uint >( y )).As< dip::dfloat >();
+            sum += v;
+            xx += v * static_cast< dip::dfloat >(( x - 60 ) * ( x - 60 ));
+            yy += v * static_cast< dip::dfloat >(( y - 60 ) * ( y - 60 ));
+            xy += v * static_cast< dip::dfloat >(( x - 60 ) * ( y - 60 ));
+         }
+      }
+      dip::dfloat c = std::cos( orientations[ ii ] );
+      dip::dfloat s = std::sin( orientations[ ii ] );
+      DOCTEST_CHECK( sum == doctest::Approx( 1.0 ).epsilon( 1e-4 ));
+      // The interpolation adds at most 0.5 to the variance across the sheared lines
+      DOCTEST_CHECK( std::abs( xx - ( 64 * c * c + 4 * s * s )) < 0.5 );
+      DOCTEST_CHECK( std::abs( yy - ( 64 * s * s + 4 * c * c )) < 0.5 );
+      DOCTEST_CHECK( std::abs( xy - 60 * c * s ) < 0.5 );
+   }
+   // Orientations `x` and `x + pi` are the same filter
+   DOCTEST_CHECK( dip::testing::CompareImages( bank[ 1 ], bank[ 5 ], 1e-6 ));
+
+   // Axis-aligned filters match `dip::Gauss`, and the bank matches separate calls
+   dip::Image img{ dip::UnsignedArray{ 91, 73 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random, 100.0 );
+   img = dip::Gauss( img, { 1.0 } );
+   bank = dip::OrientedGaussBank( img, { { 5.0, 2.0 }, { 5.0, 2.0 }, { 3.0, 3.0 } }, { 0.0, dip::pi / 2, 1.0 } );
+   // The recursive filters differ from the FIR ones by up to about 2% of the signal amplitude. The noise, and thus
+   // the amplitude, depends on the number of threads used to generate it
+   dip::Image expected = dip::Gauss( img, { 5.0, 2.0 }, { 0 }, "fir" );
+   DOCTEST_CHECK( dip::testing::CompareImages( bank[ 0 ], expected, 0.03 * dip::MaximumAbs( expected ).As< dip::dfloat >() ));
+   expected = dip::Gauss( img, { 2.0, 5.0 }, { 0 }, "fir" );
+   DOCTEST_CHECK( dip::testing::CompareImages( bank[ 1 ], expected, 0.03 * dip::MaximumAbs( expected ).As< dip::dfloat >() ));
+   DOCTEST_CHECK( dip::testing::CompareImages( bank[ 2 ], dip::OrientedGauss( img, { 3.0, 3.0 }, 1.0 )));
+   expected = dip::Gauss( img, { 3.0, 3.0 }, { 0 }, "fir" );
+   DOCTEST_CHECK( dip::testing::CompareImages( bank[ 2 ], expected, 0.03 * dip::MaximumAbs( expected ).As< dip::dfloat >() ));
+
+   DOCTEST_CHECK_THROWS( dip::OrientedGaussBank( img, { { 1.0 } }, { 0.0 } ));
+   DOCTEST_CHECK_THROWS( dip::OrientedGaussBank( img, { { 1.0, 2.0 }, { 1.0, 2.0 } }, { 0.0 } ));
+   DOCTEST_CHECK_THROWS( dip::OrientedGauss( dip::Image{ dip::UnsignedArray{ 10, 10, 10 }, 1, dip::DT_SFLOAT }, { 2.0, 1.0 }, 0.0 ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
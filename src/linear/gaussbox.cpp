@@ -0,0 +1,349 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions of functions that implement the Gaussian filter by iterated extended box filters.
+ *
+ * (c)2017, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diplib.h"
+#include "diplib/linear.h"
+#include "diplib/framework.h"
+
+namespace dip {
+
+namespace {
+
+// An extended box filter: a box of `2 * radius + 1` samples with weight `weight`, and one sample at each end
+// with weight `endWeight`. The fractional end samples let the variance take any value.
+struct ExtendedBox {
+   dip::uint radius = 0;
+   dfloat weight = 1;
+   dfloat endWeight = 0;
+};
+
+// Computes the extended box filter that, applied `iterations` times, has a variance of `sigma^2`.
+// See: P. Gwosdek, S. Grewenig, A. Bruhn, J. Weickert, Theoretical foundations of Gaussian convolution
+// by extended box filtering, in: Scale Space and Variational Methods in Computer Vision, LNCS 6667:447-458, 2012.
+ExtendedBox MakeExtendedBox( dfloat sigma, dip::uint iterations ) {
+   dfloat variance = sigma * sigma / static_cast< dfloat >( iterations );
+   // The largest box whose variance, r(r+1)/3, is not larger than the requested variance
+   dfloat r = std::floor(( std::sqrt( 12.0 * variance + 1.0 ) - 1.0 ) / 2.0 );
+   // The weight of the end samples, relative to the other samples, that adds the missing variance; it is in [0,1)
+   dfloat alpha = ( 2.0 * r + 1.0 ) * ( r * ( r + 1.0 ) / 3.0 - variance ) / ( 2.0 * ( variance - ( r + 1.0 ) * ( r + 1.0 )));
+   dfloat total = 2.0 * r + 1.0 + 2.0 * alpha;
+   ExtendedBox box;
+   box.radius = static_cast< dip::uint >( r );
+   box.weight = 1.0 / total;
+   box.endWeight = alpha / total;
+   return box;
+}
+
+// Applies the extended box filter to `nLanes` interleaved lines of `n` samples in `in`, writing the
+// `n - 2 * ( radius + 1 )` samples for which the filter fits within the input to `out`. Consecutive samples
+// of a line are `stride` apart, in both `in` and `out`.
+template< dip::uint N, typename TPA >
+void ExtendedBoxLanes( TPA const* in, TPA* out, dip::uint stride, dip::uint n, dip::uint nLanes, ExtendedBox const& box ) {
+   if( N > 0 ) {
+      nLanes = N; // Compile-time constant lets the compiler unroll and vectorize the inner loops
+   }
+   dip::uint S = stride;
+   dip::uint outLength = n - 2 * ( box.radius + 1 );
+   std::array< TPA, Framework::separableInterleavedLines > sum;
+   sum.fill( TPA( 0 ));
+   for( dip::uint ii = 1; ii <= 2 * box.radius + 1; ++ii ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         sum[ ll ] += in[ ii * S + ll ];
+      }
+   }
+   TPA const* left = in;                            // the end sample at the left
+   TPA const* right = in + ( 2 * box.radius + 2 ) * S; // the end sample at the right
+   for( dip::uint ii = 0; ii < outLength; ++ii ) {
+      TPA* dest = out + ii * S;
+      TPA const* l0 = left + ii * S;
+      TPA const* l1 = l0 + S;
+      TPA const* r0 = right + ii * S;
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         dest[ ll ] = sum[ ll ] * box.weight + ( l0[ ll ] + r0[ ll ] ) * box.endWeight;
+         sum[ ll ] += r0[ ll ] - l1[ ll ];
+      }
+   }
+}
+
+// Like `ExtendedBoxLanes`, in fixed-point arithmetic. `weight` and `endWeight` are the weights scaled by 2^32.
+template< dip::uint N >
+void FixedPointExtendedBoxLanes(
+      uint32 const* in,
+      uint32* out,
+      dip::uint stride,
+      dip::uint n,
+      dip::uint nLanes,
+      dip::uint radius,
+      std::uint64_t weight,
+      std::uint64_t endWeight
+) {
+   if( N > 0 ) {
+      nLanes = N;
+   }
+   dip::uint S = stride;
+   dip::uint outLength = n - 2 * ( radius + 1 );
+   std::array< std::uint64_t, Framework::separableInterleavedLines > sum;
+   sum.fill( 0 );
+   for( dip::uint ii = 1; ii <= 2 * radius + 1; ++ii ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         sum[ ll ] += in[ ii * S + ll ];
+      }
+   }
+   constexpr std::uint64_t half = std::uint64_t( 1 ) << 31;
+   uint32 const* left = in;
+   uint32 const* right = in + ( 2 * radius + 2 ) * S;
+   for( dip::uint ii = 0; ii < outLength; ++ii ) {
+      uint32* dest = out + ii * S;
+      uint32 const* l0 = left + ii * S;
+      uint32 const* l1 = l0 + S;
+      uint32 const* r0 = right + ii * S;
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         std::uint64_t ends = static_cast< std::uint64_t >( l0[ ll ] ) + static_cast< std::uint64_t >( r0[ ll ] );
+         dest[ ll ] = static_cast< uint32 >(( sum[ ll ] * weight + ends * endWeight + half ) >> 32 );
+         sum[ ll ] += r0[ ll ];
+         sum[ ll ] -= l1[ ll ];
+      }
+   }
+}
+
+// The buffers are of type `TPA`, either `dfloat` or `dcomplex`
+template< typename TPA >
+class GaussBoxLineFilter : public Framework::SeparableLineFilter {
+   public:
+      GaussBoxLineFilter( std::vector< ExtendedBox > const& boxes, dip::uint iterations ) :
+            boxes_( boxes ), iterations_( iterations ) {}
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         buffers_.resize( threads );
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint border, dip::uint ) override {
+         return ( lineLength + 2 * border ) * iterations_ * 5;
+      }
+      virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
+         TPA const* in = static_cast< TPA const* >( params.inBuffer.buffer );
+         TPA* out = static_cast< TPA* >( params.outBuffer.buffer );
+         dip::uint stride = static_cast< dip::uint >( params.inBuffer.stride );
+         DIP_ASSERT( stride >= params.nLines );
+         DIP_ASSERT( params.outBuffer.stride == params.inBuffer.stride );
+         ExtendedBox const& box = boxes_[ params.dimension ];
+         dip::uint border = params.inBuffer.border;
+         DIP_ASSERT( border == iterations_ * ( box.radius + 1 ));
+         in -= border * stride;
+         dip::uint n = params.inBuffer.length + 2 * border;
+         std::vector< TPA >& buffer = buffers_[ params.thread ];
+         buffer.resize( 2 * n * stride ); // won't do anything if buffer is already of correct size.
+         TPA* work[ 2 ] = { buffer.data(), buffer.data() + n * stride };
+         // The first iteration reads from the input buffer, the last one writes to the output buffer
+         for( dip::uint jj = 0; jj < iterations_; ++jj ) {
+            TPA* dest = jj + 1 == iterations_ ? out : work[ jj % 2 ];
+            if( params.nLines == Framework::separableInterleavedLines ) {
+               ExtendedBoxLanes< Framework::separableInterleavedLines >( in, dest, stride, n, params.nLines, box );
+            } else {
+               ExtendedBoxLanes< 0 >( in, dest, stride, n, params.nLines, box );
+            }
+            in = dest;
+            n -= 2 * ( box.radius + 1 );
+         }
+      }
+   private:
+      std::vector< ExtendedBox > const& boxes_; // one for each dimension
+      dip::uint iterations_;
+      std::vector< std::vector< TPA >> buffers_; // one for each thread
+};
+
+// For 8-bit and 16-bit unsigned integer images: the buffers are of the image's type, and the filter uses
+// fixed-point arithmetic with `fractionBits` fractional bits.
+template< typename TPI >
+class FixedPointGaussBoxLineFilter : public Framework::SeparableLineFilter {
+   public:
+      static constexpr dip::uint fractionBits = 8;
+      static_assert( std::numeric_limits< TPI >::digits + fractionBits <= 24, "Sums can overflow" );
+      FixedPointGaussBoxLineFilter( std::vector< ExtendedBox > const& boxes, dip::uint iterations ) :
+            boxes_( boxes ), iterations_( iterations ) {
+         weights_.resize( boxes.size() );
+         endWeights_.resize( boxes.size() );
+         for( dip::uint ii = 0; ii < boxes.size(); ++ii ) {
+            weights_[ ii ] = static_cast< std::uint64_t >( std::round( boxes[ ii ].weight * 4294967296.0 )); // 2^32
+            endWeights_[ ii ] = static_cast< std::uint64_t >( std::round( boxes[ ii ].endWeight * 4294967296.0 ));
+         }
+      }
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         buffers_.resize( threads );
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint border, dip::uint ) override {
+         return ( lineLength + 2 * border ) * iterations_ * 5;
+      }
+      virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
+         TPI const* in = static_cast< TPI const* >( params.inBuffer.buffer );
+         TPI* out = static_cast< TPI* >( params.outBuffer.buffer );
+         dip::uint stride = static_cast< dip::uint >( params.inBuffer.stride );
+         DIP_ASSERT( stride >= params.nLines );
+         DIP_ASSERT( params.outBuffer.stride == params.inBuffer.stride );
+         dip::uint radius = boxes_[ params.dimension ].radius;
+         std::uint64_t weight = weights_[ params.dimension ];
+         std::uint64_t endWeight = endWeights_[ params.dimension ];
+         dip::uint border = params.inBuffer.border;
+         DIP_ASSERT( border == iterations_ * ( radius + 1 ));
+         in -= border * stride;
+         dip::uint n = params.inBuffer.length + 2 * border;
+         std::vector< uint32 >& buffer = buffers_[ params.thread ];
+         buffer.resize( 2 * n * stride ); // won't do anything if buffer is already of correct size.
+         uint32* src = buffer.data();
+         uint32* dest = src + n * stride;
+         for( dip::uint ii = 0; ii < n * stride; ++ii ) {
+            src[ ii ] = static_cast< uint32 >( in[ ii ] ) << fractionBits;
+         }
+         for( dip::uint jj = 0; jj < iterations_; ++jj ) {
+            if( params.nLines == Framework::separableInterleavedLines ) {
+               FixedPointExtendedBoxLanes< Framework::separableInterleavedLines >( src, dest, stride, n, params.nLines, radius, weight, endWeight );
+            } else {
+               FixedPointExtendedBoxLanes< 0 >( src, dest, stride, n, params.nLines, radius, weight, endWeight );
+            }
+            n -= 2 * ( radius + 1 );
+            std::swap( src, dest );
+         }
+         DIP_ASSERT( n == params.inBuffer.length );
+         constexpr uint32 half = uint32( 1 ) << ( fractionBits - 1 );
+         constexpr uint32 max = std::numeric_limits< TPI >::max();
+         for( dip::uint ii = 0; ii < n * stride; ++ii ) {
+            out[ ii ] = static_cast< TPI >( std::min(( src[ ii ] + half ) >> fractionBits, max ));
+         }
+      }
+   private:
+      std::vector< ExtendedBox > const& boxes_; // one for each dimension
+      dip::uint iterations_;
+      std::vector< std::uint64_t > weights_;    // one for each dimension
+      std::vector< std::uint64_t > endWeights_; // one for each dimension
+      std::vector< std::vector< uint32 >> buffers_; // one for each thread
+};
+
+} // namespace
+
+void GaussBox(
+      Image const& in,
+      Image& out,
+      FloatArray sigmas,
+      dip::uint iterations,
+      StringArray const& boundaryCondition
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( iterations == 0, E::INVALID_PARAMETER );
+   dip::uint nDims = in.Dimensionality();
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( sigmas, nDims, 1.0 ));
+   std::vector< ExtendedBox > boxes( nDims );
+   BooleanArray process( nDims, false );
+   UnsignedArray border( nDims, 0 );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      if(( sigmas[ ii ] > 0.0 ) && ( in.Size( ii ) > 1 )) {
+         boxes[ ii ] = MakeExtendedBox( sigmas[ ii ], iterations );
+         process[ ii ] = true;
+         border[ ii ] = iterations * ( boxes[ ii ].radius + 1 ); // each iteration needs `radius + 1` more samples
+      }
+   }
+   DIP_START_STACK_TRACE
+      BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
+      DataType inType = in.DataType();
+      bool fixedPoint = out.IsProtected() && ( out.DataType() == inType ) && (( inType == DT_UINT8 ) || ( inType == DT_UINT16 ));
+      DataType bufferType;
+      DataType outType;
+      std::unique_ptr< Framework::SeparableLineFilter > lineFilter;
+      if( fixedPoint ) {
+         bufferType = inType;
+         outType = inType;
+         if( inType == DT_UINT8 ) {
+            lineFilter.reset( new FixedPointGaussBoxLineFilter< uint8 >( boxes, iterations ));
+         } else {
+            lineFilter.reset( new FixedPointGaussBoxLineFilter< uint16 >( boxes, iterations ));
+         }
+      } else if( inType.IsComplex() ) {
+         bufferType = DT_DCOMPLEX;
+         outType = DataType::SuggestFlex( inType );
+         lineFilter.reset( new GaussBoxLineFilter< dcomplex >( boxes, iterations ));
+      } else {
+         bufferType = DT_DFLOAT;
+         outType = DataType::SuggestFlex( inType );
+         lineFilter.reset( new GaussBoxLineFilter< dfloat >( boxes, iterations ));
+      }
+      Framework::Separable(
+            in,
+            out,
+            bufferType,
+            outType,
+            process,
+            border,
+            bc,
+            *lineFilter,
+            Framework::SeparableOption::AsScalarImage
+            + Framework::SeparableOption::InterleavedLines // processes several image lines at once
+      );
+   DIP_END_STACK_TRACE
+}
+
+} // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/math.h"
+#include "diplib/statistics.h"
+#include "diplib/generation.h"
+#include "diplib/testing.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the box Gaussian filter") {
+   // The impulse response has the requested variance, and matches the Gaussian within the documented bounds
+   dip::Image img{ dip::UnsignedArray{ 256 }, 1, dip::DT_DFLOAT };
+   img.Fill( 0.0 );
+   img.At( 128 ) = 1.0;
+   dip::Image gauss;
+   for( dip::dfloat sigma : { 2.0, 5.3, 12.0 } ) {
+      gauss = dip::GaussFIR( img, { sigma }, { 0 }, {}, 8.0 ); // a normalized sampled Gaussian
+      for( dip::uint iterations = 3; iterations <= 5; ++iterations ) {
+         dip::Image box = dip::GaussBox( img, { sigma }, iterations );
+         DOCTEST_CHECK( dip::Sum( box ).As< dip::dfloat >() == doctest::Approx( 1.0 ));
+         dip::dfloat variance = 0;
+         for( dip::uint ii = 0; ii < 256; ++ii ) {
+            dip::dfloat x = static_cast< dip::dfloat >( ii ) - 128.0;
+            variance += x * x * box.At( ii ).As< dip::dfloat >();
+         }
+         DOCTEST_CHECK( variance == doctest::Approx( sigma * sigma ));
+         dip::dfloat bound = iterations == 3 ? 0.055 : ( iterations == 4 ? 0.04 : 0.031 );
+         DOCTEST_CHECK( dip::Sum( dip::Abs( box - gauss )).As< dip::dfloat >() < bound );
+      }
+   }
+
+   // The fixed-point path for 8-bit images matches the floating-point path within rounding
+   dip::Image img8{ dip::UnsignedArray{ 71, 43 }, 1, dip::DT_UINT8 };
+   img8.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img8, img8, random, 0.0, 255.0 );
+   dip::Image expected = dip::GaussBox( img8, { 4.0, 2.5 }, 4, { "mirror" } );
+   DOCTEST_CHECK( expected.DataType() == dip::DT_SFLOAT );
+   dip::Image out8{ img8.Sizes(), 1, dip::DT_UINT8 };
+   out8.Protect();
+   dip::GaussBox( img8, out8, { 4.0, 2.5 }, 4, { "mirror" } );
+   DOCTEST_CHECK( out8.DataType() == dip::DT_UINT8 );
+   // One rounding to integer after each dimension
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( out8, expected ) <= 1.0 );
+
+   // `dip::Gauss` selects the box method for large sigmas if it can use fixed-point arithmetic
+   dip::Gauss( img8, out8, { 12.0 }, { 0 }, "best", { "mirror" } );
+   DOCTEST_CHECK( dip::testing::CompareImages( out8, dip::GaussBox( img8, { 12.0 }, 4, { "mirror" } ), 1.0 ));
+   DOCTEST_CHECK( dip::testing::CompareImages( dip::Gauss( img8, { 3.0 }, { 0 }, "box" ), dip::GaussBox( img8, { 3.0 } )));
+   DOCTEST_CHECK_THROWS( dip::Gauss( img8, { 3.0 }, { 1 }, "box" ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -441,278 +441,239 @@ dip__GaussIIRParams dip__FillGaussIIRParams(
    return params;
 }
 
-class GaussIIRLineFilter : public Framework::SeparableLineFilter {
-   public:
-      GaussIIRLineFilter( std::vector< dip__GaussIIRParams > const& filterParams ) : filterParams_( filterParams ) {}
-      virtual void SetNumberOfThreads( dip::uint threads ) override {
-         buffers_.resize( threads );
+// Computes the recursive filter along `nLanes` interleaved image lines at once. `in` and `out` point to the
+// first sample of the expanded lines (i.e. the first border pixel), `stride` is the distance between pixels.
+// The recursion state of each line is kept in its own SIMD lane: the inner loops over `ll` are independent
+// and vectorize, whereas the outer loops over `ii` carry the recursion.
+//
+// The special-cased starting conditions of the original implementation (derivative filters and the
+// copy-through MA part) are expressed as a starting value `r` for each line, which is written to the first
+// `start` output samples and also used as the (virtual) history before the first sample. This yields
+// exactly the same results as the unrolled recursions of the single-line implementation.
+template< dip::uint N >
+void GaussIIRLanes(
+      dfloat const* in,
+      dfloat* out,
+      dip::sint stride,
+      dip::uint length,
+      dip::uint nLanes,
+      dip__GaussIIRParams const& fParams,
+      dfloat* p1, // buffer of size ( length + 2 * MAX_IIR_ORDER ) * stride, p1 points at the start of it
+      dfloat* p2  // same
+) {
+   if( N > 0 ) {
+      nLanes = N; // Compile-time constant lets the compiler unroll and vectorize the inner loops
+   }
+   dip::uint S = static_cast< dip::uint >( stride );
+   p1 += MAX_IIR_ORDER * S;
+   p2 += MAX_IIR_ORDER * S;
+   dfloat const* p0 = in;
+
+   auto const& a1 = fParams.a1;
+   auto const& a2 = fParams.a2;
+   auto const& b1 = fParams.b1;
+   auto const& b2 = fParams.b2;
+   dfloat c = fParams.cc;
+
+   auto const& orderMA = fParams.iir_order_num;
+   auto const& orderAR = fParams.iir_order_den;
+   dip::uint order1 = std::max( orderAR[ 0 ], orderMA[ 0 ] );
+   dip::uint order2 = std::max( orderAR[ 3 ], orderMA[ 3 ] );
+   bool copy_forward = ( orderMA[ 0 ] == 0 ) && ( a1[ 0 ] == 1.0 );
+   bool copy_backward = ( orderMA[ 3 ] == 0 ) && ( a2[ 0 ] == 1.0 );
+   dfloat norm1 = 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] + b1[ 4 ] + b1[ 5 ];
+   dfloat norm2 = 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] + b2[ 4 ] + b2[ 5 ];
+   std::array< dfloat, Framework::separableInterleavedLines > r;
+
+   // Starting values for the recursive forward scan
+   dip::uint start;
+   if( copy_forward && ( order1 >= 3 ) && ( order1 <= 5 )) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         r[ ll ] = p0[ ll ] / norm1;
       }
-      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint, dip::uint /*procDim*/ ) override {
-         // TODO: figure out how filter parameters affect amount of computation
-         //dip__GaussIIRParams const& fParams = filterParams_[ procDim ];
-         return lineLength * 40;
+      start = 0;
+   } else if(( order1 == 4 ) && ( a1[ 0 ] == 0.5 ) && ( a1[ 1 ] == 0.0 ) && ( a1[ 2 ] == -0.5 ) && ( a1[ 3 ] == 0.0 )) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         r[ ll ] = ( p0[ S + ll ] - p0[ ll ] ) / norm1;
       }
-      virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
-         dfloat* in = static_cast< dfloat* >( params.inBuffer.buffer );
-         dfloat* out = static_cast< dfloat* >( params.outBuffer.buffer );
-         DIP_ASSERT( params.inBuffer.stride == 1 );
-         DIP_ASSERT( params.outBuffer.stride == 1 );
-         dip__GaussIIRParams const& fParams = filterParams_[ params.dimension ];
-         DIP_ASSERT( fParams.border == params.inBuffer.border );
-
-         in -= fParams.border;
-         out -= fParams.border;
-         dip::uint length = params.inBuffer.length + fParams.border * 2;
-         buffers_[ params.thread ].resize( length ); // won't do anything if buffer is already of correct size.
-         dfloat* p1 = buffers_[ params.thread ].data();
-
-         auto const& a1 = fParams.a1;
-         auto const& a2 = fParams.a2;
-         auto const& b1 = fParams.b1;
-         auto const& b2 = fParams.b2;
-         dfloat c = ( fParams.cc );
+      start = 2;
+   } else if(( order1 == 5 ) && ( a1[ 0 ] == 1.0 ) && ( a1[ 1 ] == -1.0 ) && ( a1[ 2 ] == 0.0 ) && ( a1[ 3 ] == 0.0 )) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         r[ ll ] = ( p0[ S + ll ] - p0[ ll ] ) / norm1;
+      }
+      start = 1;
+   } else {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         dfloat val = 0.0;
+         for( dip::uint jj = orderMA[ 1 ]; jj <= orderMA[ 2 ]; ++jj ) {
+            val += ( a1[ jj ] * p0[ ( orderMA[ 2 ] - jj ) * S + ll ] );
+         }
+         r[ ll ] = val / norm1;
+      }
+      start = order1;
+   }
+   for( dip::uint ii = 1; ii <= MAX_IIR_ORDER; ++ii ) {
+      dfloat* history = p1 - ii * S;
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         history[ ll ] = r[ ll ];
+      }
+   }
+   for( dip::uint ii = 0; ii < start; ++ii ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         p1[ ii * S + ll ] = r[ ll ];
+      }
+   }
 
-         auto const& orderMA = fParams.iir_order_num;
-         auto const& orderAR = fParams.iir_order_den;
-         dip::uint order1 = std::max( orderAR[ 0 ], orderMA[ 0 ] );
-         dip::uint order2 = std::max( orderAR[ 3 ], orderMA[ 3 ] );
-         bool copy_forward = false;
-         bool copy_backward = false;
-         if( ( orderMA[ 0 ] == 0 ) && ( a1[ 0 ] == 1.0 ) ) {
-            copy_forward = true;
+   // Recursive forward scan
+   for( dip::uint ii = start; ii < length; ++ii ) {
+      dfloat* dest = p1 + ii * S;
+      if( copy_forward ) {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = p0[ ii * S + ll ];
          }
-         if( ( orderMA[ 3 ] == 0 ) && ( a2[ 0 ] == 1.0 ) ) {
-            copy_backward = true;
+      } else {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = 0.0;
          }
-
-         // Recursive forward scan
-         dfloat* p0 = in;
-         dip::uint ii = 0;
-         dfloat r1, r2, r3, r4, r5;
-         switch( order1 ) {
-            case 3:
-               if( copy_forward ) {
-                  r1 = r2 = r3 = p0[ 0 ] / ( 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] );
-                  for( ; ii < length - 3; ii += 3 ) {
-                     r3 = p1[ ii ] = p0[ ii ] - b1[ 1 ] * r1 - b1[ 2 ] * r2 - b1[ 3 ] * r3;
-                     r2 = p1[ ii + 1 ] = p0[ ii + 1 ] - b1[ 1 ] * r3 - b1[ 2 ] * r1 - b1[ 3 ] * r2;
-                     r1 = p1[ ii + 2 ] = p0[ ii + 2 ] - b1[ 1 ] * r2 - b1[ 2 ] * r3 - b1[ 3 ] * r1;
-                  }
-               }
-               break;
-
-            case 4:
-               if( copy_forward ) {
-                  r1 = r2 = r3 = r4 = p0[ 0 ] / ( 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] + b1[ 4 ] );
-                  for( ; ii < length - 4; ii += 4 ) {
-                     r4 = p1[ ii ] = p0[ ii ]
-                                     - b1[ 1 ] * r1 - b1[ 2 ] * r2 - b1[ 3 ] * r3 - b1[ 4 ] * r4;
-                     r3 = p1[ ii + 1 ] = p0[ ii + 1 ]
-                                         - b1[ 1 ] * r4 - b1[ 2 ] * r1 - b1[ 3 ] * r2 - b1[ 4 ] * r3;
-                     r2 = p1[ ii + 2 ] = p0[ ii + 2 ]
-                                         - b1[ 1 ] * r3 - b1[ 2 ] * r4 - b1[ 3 ] * r1 - b1[ 4 ] * r2;
-                     r1 = p1[ ii + 3 ] = p0[ ii + 3 ]
-                                         - b1[ 1 ] * r2 - b1[ 2 ] * r3 - b1[ 3 ] * r4 - b1[ 4 ] * r1;
-                  }
-               } else if( a1[ 0 ] == 0.5 && a1[ 1 ] == 0.0 && a1[ 2 ] == -0.5 && a1[ 3 ] == 0.0 ) {
-                  r1 = r2 = r3 = r4 = ( p0[ 1 ] - p0[ 0 ] ) /
-                                      ( 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] + b1[ 4 ] );
-                  for( ii = 0; ii < 2; ++ii ) {
-                     p1[ ii ] = r1;
-                  }
-                  for( ; ii < length - 4; ii += 4 ) {
-                     r4 = p1[ ii ] = 0.5 * ( p0[ ii ] - p0[ ii - 2 ] )
-                                     - b1[ 1 ] * r1 - b1[ 2 ] * r2 - b1[ 3 ] * r3 - b1[ 4 ] * r4;
-                     r3 = p1[ ii + 1 ] = 0.5 * ( p0[ ii + 1 ] - p0[ ii - 1 ] )
-                                         - b1[ 1 ] * r4 - b1[ 2 ] * r1 - b1[ 3 ] * r2 - b1[ 4 ] * r3;
-                     r2 = p1[ ii + 2 ] = 0.5 * ( p0[ ii + 2 ] - p0[ ii ] )
-                                         - b1[ 1 ] * r3 - b1[ 2 ] * r4 - b1[ 3 ] * r1 - b1[ 4 ] * r2;
-                     r1 = p1[ ii + 3 ] = 0.5 * ( p0[ ii + 3 ] - p0[ ii + 1 ] )
-                                         - b1[ 1 ] * r2 - b1[ 2 ] * r3 - b1[ 3 ] * r4 - b1[ 4 ] * r1;
-                  }
-               }
-               break;
-
-            case 5:
-               if( copy_forward ) {
-                  r1 = r2 = r3 = r4 = r5 = p0[ 0 ] /
-                                           ( 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] + b1[ 4 ] + b1[ 5 ] );
-                  for( ; ii < length - 5; ii += 5 ) {
-                     r5 = p1[ ii ] = p0[ ii ]
-                                     - b1[ 1 ] * r1 - b1[ 2 ] * r2 - b1[ 3 ] * r3 - b1[ 4 ] * r4 - b1[ 5 ] * r5;
-                     r4 = p1[ ii + 1 ] = p0[ ii + 1 ]
-                                         - b1[ 1 ] * r5 - b1[ 2 ] * r1 - b1[ 3 ] * r2 - b1[ 4 ] * r3 - b1[ 5 ] * r4;
-                     r3 = p1[ ii + 2 ] = p0[ ii + 2 ]
-                                         - b1[ 1 ] * r4 - b1[ 2 ] * r5 - b1[ 3 ] * r1 - b1[ 4 ] * r2 - b1[ 5 ] * r3;
-                     r2 = p1[ ii + 3 ] = p0[ ii + 3 ]
-                                         - b1[ 1 ] * r3 - b1[ 2 ] * r4 - b1[ 3 ] * r5 - b1[ 4 ] * r1 - b1[ 5 ] * r2;
-                     r1 = p1[ ii + 4 ] = p0[ ii + 4 ]
-                                         - b1[ 1 ] * r2 - b1[ 2 ] * r3 - b1[ 3 ] * r4 - b1[ 4 ] * r5 - b1[ 5 ] * r1;
-                  }
-               } else if( a1[ 0 ] == 1.0 && a1[ 1 ] == -1.0 && a1[ 2 ] == 0.0 && a1[ 3 ] == 0.0 ) {
-                  r1 = r2 = r3 = r4 = r5 = ( p0[ 1 ] - p0[ 0 ] ) /
-                                           ( 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] + b1[ 4 ] + b1[ 5 ] );
-                  p1[ ii++ ] = r1;
-                  for( ; ii < length - 5; ii += 5 ) {
-                     r5 = p1[ ii ] = p0[ ii ] - p0[ ii - 1 ]
-                                     - b1[ 1 ] * r1 - b1[ 2 ] * r2 - b1[ 3 ] * r3 - b1[ 4 ] * r4 - b1[ 5 ] * r5;
-                     r4 = p1[ ii + 1 ] = p0[ ii + 1 ] - p0[ ii ]
-                                         - b1[ 1 ] * r5 - b1[ 2 ] * r1 - b1[ 3 ] * r2 - b1[ 4 ] * r3 - b1[ 5 ] * r4;
-                     r3 = p1[ ii + 2 ] = p0[ ii + 2 ] - p0[ ii + 1 ]
-                                         - b1[ 1 ] * r4 - b1[ 2 ] * r5 - b1[ 3 ] * r1 - b1[ 4 ] * r2 - b1[ 5 ] * r3;
-                     r2 = p1[ ii + 3 ] = p0[ ii + 3 ] - p0[ ii + 2 ]
-                                         - b1[ 1 ] * r3 - b1[ 2 ] * r4 - b1[ 3 ] * r5 - b1[ 4 ] * r1 - b1[ 5 ] * r2;
-                     r1 = p1[ ii + 4 ] = p0[ ii + 4 ] - p0[ ii + 3 ]
-                                         - b1[ 1 ] * r2 - b1[ 2 ] * r3 - b1[ 3 ] * r4 - b1[ 4 ] * r5 - b1[ 5 ] * r1;
-                  }
-               }
-               break;
-
-            default:
-               break;
+         for( dip::uint jj = orderMA[ 1 ]; jj <= orderMA[ 2 ]; ++jj ) {
+            dfloat const* src = p0 + ( ii - jj ) * S;
+            for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+               dest[ ll ] += a1[ jj ] * src[ ll ];
+            }
          }
+      }
+      for( dip::uint jj = orderAR[ 1 ]; jj <= orderAR[ 2 ]; ++jj ) {
+         dfloat const* src = dest - jj * S; // can point into the history before the first sample
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] -= b1[ jj ] * src[ ll ];
+         }
+      }
+   }
 
-         // Compute the first order1 values for arbitrary coefficients a & b
+   // Starting values for the recursive backward scan
+   dfloat const* last = p1 + ( length - 1 ) * S;
+   if( copy_backward && ( order2 >= 3 ) && ( order2 <= 5 )) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         r[ ll ] = c * last[ ll ] / norm2;
+      }
+      start = 0;
+   } else if(( order2 == 4 ) && ( a2[ 0 ] == 0.0 ) && ( a2[ 1 ] == 1.0 ) && ( a2[ 2 ] == 0.0 ) && ( a2[ 3 ] == 0.0 )) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         r[ ll ] = c * last[ ll ] / norm2;
+      }
+      start = 1;
+   } else if(( order2 == 5 ) && ( a2[ 0 ] == -1.0 ) && ( a2[ 1 ] == 1.0 ) && ( a2[ 2 ] == 0.0 ) && ( a2[ 3 ] == 0.0 )) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         r[ ll ] = c * ( -( last - S )[ ll ] + last[ ll ] ) / norm2;
+      }
+      start = 1;
+   } else {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
          dfloat val = 0.0;
-         for( dip::uint jj = orderMA[ 1 ]; jj <= orderMA[ 2 ]; ++jj ) {
-            val += ( a1[ jj ] * p0[ orderMA[ 2 ] - jj ] );
+         for( dip::uint jj = orderMA[ 4 ]; jj <= orderMA[ 5 ]; ++jj ) {
+            val += ( a2[ jj ] * ( last - ( orderMA[ 5 ] - jj ) * S )[ ll ] );
+         }
+         r[ ll ] = c * ( val / norm2 );
+      }
+      start = order2;
+   }
+   for( dip::uint ii = 0; ii < MAX_IIR_ORDER; ++ii ) {
+      dfloat* history = p2 + ( length + ii ) * S;
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         history[ ll ] = r[ ll ];
+      }
+   }
+   for( dip::uint ii = length - start; ii < length; ++ii ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         p2[ ii * S + ll ] = r[ ll ];
+      }
+   }
+
+   // Recursive backward scan
+   for( dip::uint ii = length - start; ii-- > 0; ) {
+      dfloat* dest = p2 + ii * S;
+      if( copy_backward ) {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = c * p1[ ii * S + ll ];
          }
-         r1 = val / ( 1.0 + b1[ 1 ] + b1[ 2 ] + b1[ 3 ] + b1[ 4 ] + b1[ 5 ] );
-         for( ; ii < order1; ++ii ) {
-            p1[ ii ] = r1;
+      } else {
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = 0.0;
          }
-         for( ; ii < length; ++ii ) {
-            if( !copy_forward ) {
-               val = 0.0;
-               for( dip::uint jj = orderMA[ 1 ]; jj <= orderMA[ 2 ]; ++jj ) {
-                  val += ( a1[ jj ] * p0[ ii - jj ] );
-               }
-            } else {
-               val = p0[ ii ];
-            }
-            for( dip::uint jj = orderAR[ 1 ]; jj <= orderAR[ 2 ]; ++jj ) {
-               val -= ( b1[ jj ] * p1[ ii - jj ] );
+         for( dip::uint jj = orderMA[ 4 ]; jj <= orderMA[ 5 ]; ++jj ) {
+            dfloat const* src = p1 + ( ii + jj ) * S;
+            for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+               dest[ ll ] += a2[ jj ] * src[ ll ];
             }
-            p1[ ii ] = val;
          }
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] = c * dest[ ll ];
+         }
+      }
+      for( dip::uint jj = orderAR[ 4 ]; jj <= orderAR[ 5 ]; ++jj ) {
+         dfloat const* src = dest + jj * S; // can point into the history after the last sample
+         for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+            dest[ ll ] -= b2[ jj ] * src[ ll ];
+         }
+      }
+   }
 
-         // Iterative & recursive backward scan
-         dfloat* p2 = out;
-         ii = length - 1;
-         switch( order2 ) {
-            case 3:
-               if( copy_backward ) {
-                  r1 = r2 = r3 = c * p1[ length - 1 ] / ( 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] );
-                  for( ; ii >= 3; ii -= 3 ) {
-                     r3 = p2[ ii ] = c * p1[ ii ] - b2[ 1 ] * r1 - b2[ 2 ] * r2 - b2[ 3 ] * r3;
-                     r2 = p2[ ii - 1 ] = c * p1[ ii - 1 ] - b2[ 1 ] * r3 - b2[ 2 ] * r1 - b2[ 3 ] * r2;
-                     r1 = p2[ ii - 2 ] = c * p1[ ii - 2 ] - b2[ 1 ] * r2 - b2[ 2 ] * r3 - b2[ 3 ] * r1;
-                  }
-               }
-               break;
-
-            case 4:
-               if( copy_backward ) {
-                  r1 = r2 = r3 = r4 = c * p1[ length - 1 ] /
-                                      ( 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] + b2[ 4 ] );
-                  for( ; ii >= 4; ii -= 4 ) {
-                     r4 = p2[ ii ] = c * p1[ ii ]
-                                     - b2[ 1 ] * r1 - b2[ 2 ] * r2 - b2[ 3 ] * r3 - b2[ 4 ] * r4;
-                     r3 = p2[ ii - 1 ] = c * p1[ ii - 1 ]
-                                         - b2[ 1 ] * r4 - b2[ 2 ] * r1 - b2[ 3 ] * r2 - b2[ 4 ] * r3;
-                     r2 = p2[ ii - 2 ] = c * p1[ ii - 2 ]
-                                         - b2[ 1 ] * r3 - b2[ 2 ] * r4 - b2[ 3 ] * r1 - b2[ 4 ] * r2;
-                     r1 = p2[ ii - 3 ] = c * p1[ ii - 3 ]
-                                         - b2[ 1 ] * r2 - b2[ 2 ] * r3 - b2[ 3 ] * r4 - b2[ 4 ] * r1;
-                  }
-               } else if( a2[ 0 ] == 0.0 && a2[ 1 ] == 1.0 && a2[ 2 ] == 0.0 && a2[ 3 ] == 0.0 ) {
-                  r1 = r2 = r3 = r4 = c * p1[ length - 1 ] /
-                                      ( 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] + b2[ 4 ] );
-                  p2[ ii ] = r1;
-                  ii -= 1;
-                  for( ; ii >= 4; ii -= 4 ) {
-                     r4 = p2[ ii ] = c * p1[ ii + 1 ]
-                                     - b2[ 1 ] * r1 - b2[ 2 ] * r2 - b2[ 3 ] * r3 - b2[ 4 ] * r4;
-                     r3 = p2[ ii - 1 ] = c * p1[ ii ]
-                                         - b2[ 1 ] * r4 - b2[ 2 ] * r1 - b2[ 3 ] * r2 - b2[ 4 ] * r3;
-                     r2 = p2[ ii - 2 ] = c * p1[ ii - 1 ]
-                                         - b2[ 1 ] * r3 - b2[ 2 ] * r4 - b2[ 3 ] * r1 - b2[ 4 ] * r2;
-                     r1 = p2[ ii - 3 ] = c * p1[ ii - 2 ]
-                                         - b2[ 1 ] * r2 - b2[ 2 ] * r3 - b2[ 3 ] * r4 - b2[ 4 ] * r1;
-                  }
-               }
-               break;
-
-            case 5:
-               if( copy_backward ) {
-                  r1 = r2 = r3 = r4 = r5 = c * p1[ length - 1 ] /
-                                           ( 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] + b2[ 4 ] + b2[ 5 ] );
-                  for( ; ii >= 5; ii -= 5 ) {
-                     r5 = p2[ ii ] = c * p1[ ii ]
-                                     - b2[ 1 ] * r1 - b2[ 2 ] * r2 - b2[ 3 ] * r3 - b2[ 4 ] * r4 - b2[ 5 ] * r5;
-                     r4 = p2[ ii - 1 ] = c * p1[ ii - 1 ]
-                                         - b2[ 1 ] * r5 - b2[ 2 ] * r1 - b2[ 3 ] * r2 - b2[ 4 ] * r3 - b2[ 5 ] * r4;
-                     r3 = p2[ ii - 2 ] = c * p1[ ii - 2 ]
-                                         - b2[ 1 ] * r4 - b2[ 2 ] * r5 - b2[ 3 ] * r1 - b2[ 4 ] * r2 - b2[ 5 ] * r3;
-                     r2 = p2[ ii - 3 ] = c * p1[ ii - 3 ]
-                                         - b2[ 1 ] * r3 - b2[ 2 ] * r4 - b2[ 3 ] * r5 - b2[ 4 ] * r1 - b2[ 5 ] * r2;
-                     r1 = p2[ ii - 4 ] = c * p1[ ii - 4 ]
-                                         - b2[ 1 ] * r2 - b2[ 2 ] * r3 - b2[ 3 ] * r4 - b2[ 4 ] * r5 - b2[ 5 ] * r1;
-                  }
-               } else if( a2[ 0 ] == -1.0 && a2[ 1 ] == 1.0 && a2[ 2 ] == 0.0 && a2[ 3 ] == 0.0 ) {
-                  r1 = r2 = r3 = r4 = r5 = c * ( -p1[ length - 2 ] + p1[ length - 1 ] ) /
-                                           ( 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] + b2[ 4 ] + b2[ 5 ] );
-                  p2[ ii ] = r1;
-                  ii -= 1;
-                  for( ; ii >= 5; ii -= 5 ) {
-                     r5 = p2[ ii ] = c * ( -p1[ ii ] + p1[ ii + 1 ] )
-                                     - b2[ 1 ] * r1 - b2[ 2 ] * r2 - b2[ 3 ] * r3 - b2[ 4 ] * r4 - b2[ 5 ] * r5;
-                     r4 = p2[ ii - 1 ] = c * ( -p1[ ii - 1 ] + p1[ ii ] )
-                                         - b2[ 1 ] * r5 - b2[ 2 ] * r1 - b2[ 3 ] * r2 - b2[ 4 ] * r3 - b2[ 5 ] * r4;
-                     r3 = p2[ ii - 2 ] = c * ( -p1[ ii - 2 ] + p1[ ii - 1 ] )
-                                         - b2[ 1 ] * r4 - b2[ 2 ] * r5 - b2[ 3 ] * r1 - b2[ 4 ] * r2 - b2[ 5 ] * r3;
-                     r2 = p2[ ii - 3 ] = c * ( -p1[ ii - 3 ] + p1[ ii - 2 ] )
-                                         - b2[ 1 ] * r3 - b2[ 2 ] * r4 - b2[ 3 ] * r5 - b2[ 4 ] * r1 - b2[ 5 ] * r2;
-                     r1 = p2[ ii - 4 ] = c * ( -p1[ ii - 4 ] + p1[ ii - 3 ] )
-                                         - b2[ 1 ] * r2 - b2[ 2 ] * r3 - b2[ 3 ] * r4 - b2[ 4 ] * r5 - b2[ 5 ] * r1;
-                  }
-               }
-               break;
+   // Copy result to output buffer
+   for( dip::uint ii = 0; ii < length; ++ii ) {
+      for( dip::uint ll = 0; ll < nLanes; ++ll ) {
+         out[ ii * S + ll ] = p2[ ii * S + ll ];
+      }
+   }
+}
 
-            default:
-               break;
-         }
+class GaussIIRLineFilter : public Framework::SeparableLineFilter {
+   public:
+      GaussIIRLineFilter( std::vector< dip__GaussIIRParams > const& filterParams, bool complex ) :
+            filterParams_( filterParams ), complex_( complex ) {}
+      virtual void SetNumberOfThreads( dip::uint threads ) override {
+         buffers_.resize( threads );
+      }
+      virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint border, dip::uint procDim ) override {
+         // Each output sample takes one multiply-add per MA and AR term, in the forward and in the backward pass
+         dip__GaussIIRParams const& fParams = filterParams_[ procDim ];
+         auto const& orderMA = fParams.iir_order_num;
+         auto const& orderAR = fParams.iir_order_den;
+         dip::uint terms = ( orderMA[ 2 ] - orderMA[ 1 ] + 1 ) + ( orderAR[ 2 ] - orderAR[ 1 ] + 1 )
+                         + ( orderMA[ 5 ] - orderMA[ 4 ] + 1 ) + ( orderAR[ 5 ] - orderAR[ 4 ] + 1 );
+         return ( lineLength + 2 * border ) * 2 * terms * ( complex_ ? 2 : 1 );
+      }
+      virtual void Filter( Framework::SeparableLineFilterParameters const& params ) override {
+         // A complex buffer holds the interleaved lines as twice as many real-valued lanes: the filter is real,
+         // so the real and imaginary parts are filtered independently
+         dip::uint samples = complex_ ? 2 : 1;
+         dfloat* in = static_cast< dfloat* >( params.inBuffer.buffer );
+         dfloat* out = static_cast< dfloat* >( params.outBuffer.buffer );
+         dip::sint stride = params.inBuffer.stride * static_cast< dip::sint >( samples );
+         dip::uint nLanes = params.nLines * samples;
+         DIP_ASSERT( stride >= static_cast< dip::sint >( nLanes ));
+         DIP_ASSERT( params.outBuffer.stride == params.inBuffer.stride );
+         dip__GaussIIRParams const& fParams = filterParams_[ params.dimension ];
+         DIP_ASSERT( fParams.border == params.inBuffer.border );
 
-         // Compute the first order2 values for arbitrary coefficients a & b
-         val = 0.0;
-         for( dip::uint jj = orderMA[ 4 ]; jj <= orderMA[ 5 ]; ++jj ) {
-            val += ( a2[ jj ] * p1[ length - 1 - orderMA[ 5 ] + jj ] );
-         }
-         r1 = val / ( 1.0 + b2[ 1 ] + b2[ 2 ] + b2[ 3 ] + b2[ 4 ] + b2[ 5 ] );
-         for( ; ii > length - 1 - order2; --ii ) {
-            p2[ ii ] = c * r1;
-         }
-         ++ii;
-         while( ii > 0 ) {
-            --ii;
-            if( !copy_backward ) {
-               val = 0.0;
-               for( dip::uint jj = orderMA[ 4 ]; jj <= orderMA[ 5 ]; ++jj ) {
-                  val += ( a2[ jj ] * p1[ ii + jj ] );
-               }
-               val = c * val;
+         in -= static_cast< dip::sint >( fParams.border ) * stride;
+         out -= static_cast< dip::sint >( fParams.border ) * stride;
+         dip::uint length = params.inBuffer.length + fParams.border * 2;
+         dip::uint bufferSize = ( length + 2 * MAX_IIR_ORDER ) * static_cast< dip::uint >( stride );
+         buffers_[ params.thread ].resize( 2 * bufferSize ); // won't do anything if buffer is already of correct size.
+         dfloat* p1 = buffers_[ params.thread ].data();
+         dfloat* p2 = p1 + bufferSize;
+         for( dip::uint first = 0; first < nLanes; first += Framework::separableInterleavedLines ) {
+            dip::uint n = std::min( nLanes - first, Framework::separableInterleavedLines );
+            if( n == Framework::separableInterleavedLines ) {
+               GaussIIRLanes< Framework::separableInterleavedLines >( in + first, out + first, stride, length, n, fParams, p1 + first, p2 + first );
             } else {
-               val = c * p1[ ii ];
-            }
-
-            for( dip::uint jj = orderAR[ 4 ]; jj <= orderAR[ 5 ]; ++jj ) {
-               val -= ( b2[ jj ] * p2[ ii + jj ] );
+               GaussIIRLanes< 0 >( in + first, out + first, stride, length, n, fParams, p1 + first, p2 + first );
             }
-            p2[ ii ] = val;
          }
       }
    private:
       std::vector< dip__GaussIIRParams > const& filterParams_; // one of each dimension
+      bool complex_;
       std::vector< std::vector< dfloat >> buffers_; // one for each thread
 };
 
@@ -775,11 +736,12 @@ void GaussIIR(
       // handle boundary condition array (checks are made in Framework::Separable, no need to repeat them here)
       BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
       // Get callback function
-      GaussIIRLineFilter lineFilter( filterParams );
+      bool complex = in.DataType().IsComplex();
+      GaussIIRLineFilter lineFilter( filterParams, complex );
       Framework::Separable(
             in,
             out,
-            DT_DFLOAT,
+            complex ? DT_DCOMPLEX : DT_DFLOAT,
             DataType::SuggestFlex( in.DataType() ),
             process,
             border,
@@ -787,8 +749,7 @@ void GaussIIR(
             lineFilter,
             Framework::SeparableOption::AsScalarImage
             + Framework::SeparableOption::UseOutputBorder
-            + Framework::SeparableOption::UseInputBuffer // ensures that there's no strides
-            + Framework::SeparableOption::UseOutputBuffer // ensures that there's no strides
+            + Framework::SeparableOption::InterleavedLines // processes several image lines at once
       );
    DIP_END_STACK_TRACE
 }
@@ -872,4 +833,37 @@ DOCTEST_TEST_CASE("[DIPlib] testing the IIR Gaussian filter") {
    DOCTEST_CHECK( r1.At( 128 ).As< dip::dfloat >() == doctest::Approx( 6.0 ));
 }
 
+DOCTEST_TEST_CASE("[DIPlib] testing the IIR Gaussian filter on interleaved image lines") {
+   // 21 image lines along dimension 1: two full blocks of interleaved lines and a partial one
+   dip::Image img{ dip::UnsignedArray{ 21, 50 }, 1, dip::DT_DFLOAT };
+   dip::ImageIterator< dip::dfloat > it( img );
+   for( dip::uint ii = 0; it; ++it, ++ii ) {
+      *it = static_cast< dip::dfloat >(( ii * 7919 ) % 101 );
+   }
+   for( dip::uint order = 0; order < 3; ++order ) {
+      dip::Image result = dip::GaussIIR( img, { 0.0, 3.0 }, { 0, order } );
+      for( dip::uint ii = 0; ii < img.Size( 0 ); ii += 5 ) {
+         dip::Image line = img.At( dip::Range( static_cast< dip::sint >( ii )), dip::Range{} );
+         line.Squeeze();
+         dip::Image expected = dip::GaussIIR( line, { 3.0 }, { order } );
+         dip::Image actual = result.At( dip::Range( static_cast< dip::sint >( ii )), dip::Range{} );
+         actual.Squeeze();
+         DOCTEST_CHECK( dip::testing::CompareImages( actual, expected ));
+      }
+   }
+   // The real and imaginary components of a complex image are filtered as two real images
+   dip::Image cimg{ img.Sizes(), 1, dip::DT_DCOMPLEX };
+   dip::Image component = cimg.Real();
+   component.Copy( img );
+   component = cimg.Imaginary();
+   component.Copy( img );
+   component *= -0.5;
+   dip::Image result = dip::GaussIIR( cimg, { 2.0, 3.0 }, { 0, 1 } );
+   DOCTEST_CHECK( result.DataType() == dip::DT_DCOMPLEX );
+   dip::Image expected = dip::GaussIIR( img, { 2.0, 3.0 }, { 0, 1 } );
+   DOCTEST_CHECK( dip::testing::CompareImages( result.Real(), expected ));
+   expected *= -0.5;
+   DOCTEST_CHECK( dip::testing::CompareImages( result.Imaginary(), expected ));
+}
+
 #endif // DIP__ENABLE_DOCTEST
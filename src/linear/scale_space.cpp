@@ -0,0 +1,225 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for the Gaussian scale space.
+ *
+ * (c)2017, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diplib.h"
+#include "diplib/linear.h"
+#include "diplib/geometry.h"
+
+namespace dip {
+
+GaussianScaleSpace::GaussianScaleSpace(
+      Image const& in,
+      FloatArray const& scales,
+      bool downsample,
+      dfloat inputScale,
+      dip::uint memoryBudget,
+      String const& method,
+      StringArray const& boundaryCondition,
+      dfloat truncation
+) : input_( in.QuickCopy() ), scales_( scales ), inputScale_( inputScale ), memoryBudget_( memoryBudget ),
+    method_( method ), boundaryCondition_( boundaryCondition ), truncation_( truncation ) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( scales.empty(), E::ARRAY_PARAMETER_EMPTY );
+   DIP_THROW_IF( inputScale < 0.0, E::PARAMETER_OUT_OF_RANGE );
+   dfloat previous = inputScale;
+   for( auto s : scales ) {
+      DIP_THROW_IF( s <= previous, "Scales must be increasing, and larger than the input scale" );
+      previous = s;
+   }
+   dip::uint nLevels = scales.size();
+   factors_.resize( nLevels, 1 );
+   if( downsample ) {
+      for( dip::uint ii = 0; ii < nLevels; ++ii ) {
+         // The largest power of two not larger than the scale
+         while( static_cast< dfloat >( factors_[ ii ] * 2 ) <= scales[ ii ] ) {
+            factors_[ ii ] *= 2;
+         }
+      }
+   }
+   levels_.resize( nLevels );
+   lastUse_.resize( nLevels, 0 );
+}
+
+Image GaussianScaleSpace::Level( dip::uint level ) {
+   DIP_THROW_IF( level >= levels_.size(), E::INDEX_OUT_OF_RANGE );
+   if( !levels_[ level ].IsForged() ) {
+      Image parent = Parent( level );
+      Image smoothed;
+      DIP_STACK_TRACE_THIS( Gauss( parent, smoothed, { IncrementalSigma( level ) }, { 0 }, method_, boundaryCondition_, truncation_ ));
+      Keep( level, ToLevelSampling( smoothed, level ));
+      if( !levels_[ level ].IsForged() ) {
+         // It doesn't fit in the memory budget
+         return ToLevelSampling( smoothed, level );
+      }
+   }
+   lastUse_[ level ] = ++clock_;
+   return levels_[ level ];
+}
+
+Image GaussianScaleSpace::Derivative( dip::uint level, UnsignedArray const& derivativeOrder ) {
+   DIP_THROW_IF( level >= levels_.size(), E::INDEX_OUT_OF_RANGE );
+   Image parent = Parent( level );
+   Image out;
+   DIP_STACK_TRACE_THIS( dip::Derivative( parent, out, derivativeOrder, { IncrementalSigma( level ) }, method_, boundaryCondition_, truncation_ ));
+   out = ToLevelSampling( out, level );
+   dip::uint parentFactor = level == 0 ? 1 : factors_[ level - 1 ];
+   if( parentFactor > 1 ) {
+      // The derivative along a dimension is with respect to the parent's pixel coordinates
+      dip::uint nDims = out.Dimensionality();
+      UnsignedArray order = derivativeOrder;
+      DIP_STACK_TRACE_THIS( ArrayUseParameter( order, nDims, dip::uint( 0 )));
+      dip::uint totalOrder = 0;
+      for( dip::uint ii = 0; ii < nDims; ++ii ) {
+         totalOrder += out.Size( ii ) > 1 ? order[ ii ] : 0;
+      }
+      out /= std::pow( static_cast< dfloat >( parentFactor ), static_cast< dfloat >( totalOrder ));
+   }
+   return out;
+}
+
+Image GaussianScaleSpace::Gradient( dip::uint level ) {
+   DIP_THROW_IF( level >= levels_.size(), E::INDEX_OUT_OF_RANGE );
+   Image parent = Parent( level );
+   Image out;
+   DIP_STACK_TRACE_THIS( dip::Gradient( parent, out, { IncrementalSigma( level ) }, method_, boundaryCondition_, {}, truncation_ ));
+   out = ToLevelSampling( out, level );
+   dip::uint parentFactor = level == 0 ? 1 : factors_[ level - 1 ];
+   if( parentFactor > 1 ) {
+      out /= static_cast< dfloat >( parentFactor );
+   }
+   return out;
+}
+
+Image GaussianScaleSpace::Hessian( dip::uint level ) {
+   DIP_THROW_IF( level >= levels_.size(), E::INDEX_OUT_OF_RANGE );
+   Image parent = Parent( level );
+   Image out;
+   DIP_STACK_TRACE_THIS( dip::Hessian( parent, out, { IncrementalSigma( level ) }, method_, boundaryCondition_, {}, truncation_ ));
+   out = ToLevelSampling( out, level );
+   dip::uint parentFactor = level == 0 ? 1 : factors_[ level - 1 ];
+   if( parentFactor > 1 ) {
+      out /= static_cast< dfloat >( parentFactor * parentFactor );
+   }
+   return out;
+}
+
+Image GaussianScaleSpace::Parent( dip::uint level ) {
+   return level == 0 ? input_ : Level( level - 1 );
+}
+
+dfloat GaussianScaleSpace::IncrementalSigma( dip::uint level ) const {
+   dfloat previous = level == 0 ? inputScale_ : scales_[ level - 1 ];
+   dip::uint parentFactor = level == 0 ? 1 : factors_[ level - 1 ];
+   return std::sqrt( scales_[ level ] * scales_[ level ] - previous * previous ) / static_cast< dfloat >( parentFactor );
+}
+
+Image GaussianScaleSpace::ToLevelSampling( Image const& img, dip::uint level ) const {
+   dip::uint parentFactor = level == 0 ? 1 : factors_[ level - 1 ];
+   dip::uint step = factors_[ level ] / parentFactor;
+   if( step == 1 ) {
+      return img;
+   }
+   UnsignedArray sample( img.Dimensionality(), step );
+   for( dip::uint ii = 0; ii < sample.size(); ++ii ) {
+      if( img.Size( ii ) == 1 ) {
+         sample[ ii ] = 1;
+      }
+   }
+   return Subsampling( img, sample );
+}
+
+void GaussianScaleSpace::Keep( dip::uint level, Image const& img ) {
+   dip::uint bytes = img.NumberOfSamples() * img.DataType().SizeOf();
+   if( memoryBudget_ > 0 ) {
+      // Discard the least recently used levels until the new one fits
+      while( memoryUsage_ + bytes > memoryBudget_ ) {
+         dip::uint oldest = levels_.size();
+         for( dip::uint ii = 0; ii < levels_.size(); ++ii ) {
+            if( levels_[ ii ].IsForged() && (( oldest == levels_.size() ) || ( lastUse_[ ii ] < lastUse_[ oldest ] ))) {
+               oldest = ii;
+            }
+         }
+         if( oldest == levels_.size() ) {
+            return; // nothing left to discard, and it still doesn't fit
+         }
+         memoryUsage_ -= levels_[ oldest ].NumberOfSamples() * levels_[ oldest ].DataType().SizeOf();
+         levels_[ oldest ] = Image();
+      }
+   }
+   levels_[ level ] = img;
+   memoryUsage_ += bytes;
+}
+
+} // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/statistics.h"
+#include "diplib/generation.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the Gaussian scale space") {
+   dip::Image img{ dip::UnsignedArray{ 128, 96 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::GaussianNoise( img, img, random, 100.0 );
+   img = dip::Gauss( img, { 1.0 }, { 0 }, dip::S::BEST, { dip::S::PERIODIC } ); // the input has a scale of 1
+   dip::FloatArray scales{ 1.5, 2.2, 3.3, 5.0 };
+   dip::StringArray bc{ dip::S::PERIODIC };
+
+   // Each level matches smoothing the input directly
+   dip::GaussianScaleSpace scaleSpace( img, scales, false, 1.0, 0, dip::S::BEST, bc );
+   DOCTEST_REQUIRE( scaleSpace.NumberOfLevels() == 4 );
+   for( dip::uint ii = 0; ii < scales.size(); ++ii ) {
+      dip::dfloat sigma = std::sqrt( scales[ ii ] * scales[ ii ] - 1.0 );
+      dip::Image expected = dip::Gauss( img, { sigma }, { 0 }, dip::S::BEST, bc );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( scaleSpace.Level( ii ), expected ) < 0.05 );
+      expected = dip::Derivative( img, { 1, 0 }, { sigma }, dip::S::BEST, bc );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( scaleSpace.Derivative( ii, { 1, 0 } ), expected ) < 0.01 );
+   }
+   DOCTEST_CHECK( scaleSpace.MemoryUsage() == 4 * 128 * 96 * sizeof( dip::sfloat ));
+
+   // With downsampling, levels are subsampled versions, and derivatives are with respect to input pixels
+   dip::GaussianScaleSpace pyramid( img, scales, true, 1.0, 0, dip::S::BEST, bc );
+   DOCTEST_CHECK( pyramid.SubsamplingFactor( 0 ) == 1 );
+   DOCTEST_CHECK( pyramid.SubsamplingFactor( 1 ) == 2 );
+   DOCTEST_CHECK( pyramid.SubsamplingFactor( 2 ) == 2 );
+   DOCTEST_CHECK( pyramid.SubsamplingFactor( 3 ) == 4 );
+   dip::Image level = pyramid.Level( 3 );
+   DOCTEST_REQUIRE( level.Sizes() == dip::UnsignedArray{ 32, 24 } );
+   dip::dfloat sigma = std::sqrt( scales[ 3 ] * scales[ 3 ] - 1.0 );
+   dip::Image expected = dip::Subsampling( dip::Gauss( img, { sigma }, { 0 }, dip::S::BEST, bc ), { 4, 4 } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( level, expected ) < 0.05 );
+   expected = dip::Subsampling( dip::Hessian( img, { sigma }, dip::S::BEST, bc ), { 4, 4 } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( pyramid.Hessian( 3 ), expected ) < 0.01 );
+
+   // A memory budget that fits only two levels
+   dip::uint levelBytes = 128 * 96 * sizeof( dip::sfloat );
+   dip::GaussianScaleSpace budgeted( img, scales, false, 1.0, 2 * levelBytes, dip::S::BEST, bc );
+   for( dip::uint ii = 0; ii < scales.size(); ++ii ) {
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( budgeted.Level( ii ), scaleSpace.Level( ii )) == 0.0 );
+      DOCTEST_CHECK( budgeted.MemoryUsage() <= 2 * levelBytes );
+   }
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( budgeted.Level( 0 ), scaleSpace.Level( 0 )) == 0.0 );
+
+   DOCTEST_CHECK_THROWS( dip::GaussianScaleSpace( img, { 2.0, 1.5 } ));
+   DOCTEST_CHECK_THROWS( dip::GaussianScaleSpace( img, { 1.0 }, false, 1.0 ));
+   DOCTEST_CHECK_THROWS( scaleSpace.Level( 4 ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
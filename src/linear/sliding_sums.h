@@ -0,0 +1,115 @@
+/*
+ * DIPlib 3.0
+ * This file contains support for computing sums over a sliding neighborhood of arbitrary shape.
+ *
+ * (c)2017, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SLIDING_SUMS_H_INCLUDED
+#define SLIDING_SUMS_H_INCLUDED
+
+#include "diplib.h"
+#include "diplib/pixel_table.h"
+
+namespace dip {
+
+// Updates sums over a neighborhood of arbitrary shape as it slides along the processing dimension.
+// Only the first pixel of each run leaves the neighborhood, and only the pixel just past the end of each run
+// enters it, so the cost of an update is proportional to the number of runs in the pixel table.
+//
+// The changes to the sums are computed for a block of consecutive positions at once, looping over the runs
+// in the outer loop and over the positions in the inner loop. The inner loop has no dependencies between
+// iterations, and reads consecutive pixels when the stride is 1, so the compiler can vectorize it. The
+// caller then adds the changes one after the other to obtain the sums.
+class SlidingRunSums {
+   public:
+      // Number of positions to process at once; the caller's buffers for the changes must have this size.
+      static constexpr dip::uint blockSize = 256;
+
+      // Prepares the offsets for the given pixel table. `stride` is the stride along the processing dimension
+      // of the image the pixel table was prepared for.
+      void Prepare( PixelTableOffsets const& pixelTable, dip::sint stride ) {
+         auto const& runs = pixelTable.Runs();
+         leaving_.resize( runs.size() );
+         entering_.resize( runs.size() );
+         for( dip::uint ii = 0; ii < runs.size(); ++ii ) {
+            leaving_[ ii ] = runs[ ii ].offset;
+            entering_[ ii ] = runs[ ii ].offset + static_cast< dip::sint >( runs[ ii ].length ) * stride;
+         }
+      }
+
+      // Computes `delta[ kk ]`, the change in the sum of the pixel values when the neighborhood moves from
+      // `in + kk * stride` to the next pixel, for `kk` in [0,`n`). `n` must not be larger than `blockSize`.
+      template< typename TPI, typename TPS >
+      void SumDeltas( TPI const* in, dip::sint stride, dip::uint n, TPS* delta ) const {
+         DIP_ASSERT( n <= blockSize );
+         for( dip::uint kk = 0; kk < n; ++kk ) {
+            delta[ kk ] = 0;
+         }
+         for( dip::uint rr = 0; rr < leaving_.size(); ++rr ) {
+            TPI const* enter = in + entering_[ rr ];
+            TPI const* leave = in + leaving_[ rr ];
+            if( stride == 1 ) {
+               for( dip::uint kk = 0; kk < n; ++kk ) {
+                  delta[ kk ] += static_cast< TPS >( enter[ kk ] ) - static_cast< TPS >( leave[ kk ] );
+               }
+            } else {
+               for( dip::uint kk = 0; kk < n; ++kk ) {
+                  dip::sint offset = static_cast< dip::sint >( kk ) * stride;
+                  delta[ kk ] += static_cast< TPS >( enter[ offset ] ) - static_cast< TPS >( leave[ offset ] );
+               }
+            }
+         }
+      }
+
+      // Like `SumDeltas`, but also computes `squareDelta[ kk ]`, the change in the sum of the squared pixel values.
+      template< typename TPI >
+      void SumAndSquareSumDeltas( TPI const* in, dip::sint stride, dip::uint n, dfloat* delta, dfloat* squareDelta ) const {
+         DIP_ASSERT( n <= blockSize );
+         for( dip::uint kk = 0; kk < n; ++kk ) {
+            delta[ kk ] = 0;
+            squareDelta[ kk ] = 0;
+         }
+         for( dip::uint rr = 0; rr < leaving_.size(); ++rr ) {
+            TPI const* enter = in + entering_[ rr ];
+            TPI const* leave = in + leaving_[ rr ];
+            // a^2 - b^2 = ( a - b ) * ( a + b )
+            if( stride == 1 ) {
+               for( dip::uint kk = 0; kk < n; ++kk ) {
+                  dfloat a = static_cast< dfloat >( enter[ kk ] );
+                  dfloat b = static_cast< dfloat >( leave[ kk ] );
+                  delta[ kk ] += a - b;
+                  squareDelta[ kk ] += ( a - b ) * ( a + b );
+               }
+            } else {
+               for( dip::uint kk = 0; kk < n; ++kk ) {
+                  dip::sint offset = static_cast< dip::sint >( kk ) * stride;
+                  dfloat a = static_cast< dfloat >( enter[ offset ] );
+                  dfloat b = static_cast< dfloat >( leave[ offset ] );
+                  delta[ kk ] += a - b;
+                  squareDelta[ kk ] += ( a - b ) * ( a + b );
+               }
+            }
+         }
+      }
+
+   private:
+      std::vector< dip::sint > leaving_;  // offset to the first pixel of each run
+      std::vector< dip::sint > entering_; // offset to the pixel just past the end of each run
+};
+
+} // namespace dip
+
+#endif // SLIDING_SUMS_H_INCLUDED
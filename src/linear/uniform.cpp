@@ -23,6 +23,7 @@
 #include "diplib/framework.h"
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
+#include "sliding_sums.h"
 
 namespace dip {
 
@@ -94,6 +95,9 @@ void RectangularUniform(
 template< typename TPI >
 class PixelTableUniformLineFilter : public Framework::FullLineFilter {
    public:
+      virtual void SetNumberOfThreads( dip::uint, PixelTableOffsets const& pixelTable ) override {
+         sums_.Prepare( pixelTable, pixelTable.Stride() );
+      }
       virtual void Filter( Framework::FullLineFilterParameters const& params ) override {
          TPI* in = static_cast< TPI* >( params.inBuffer.buffer );
          dip::sint inStride = params.inBuffer.stride;
@@ -101,6 +105,7 @@ class PixelTableUniformLineFilter : public Framework::FullLineFilter {
          dip::sint outStride = params.outBuffer.stride;
          dip::uint length = params.bufferLength;
          PixelTableOffsets const& pixelTable = params.pixelTable;
+         DIP_ASSERT( inStride == pixelTable.Stride() );
          TPI sum = 0; // Sum of values within the filter
          for( auto offset : pixelTable ) {
             sum += in[ offset ];
@@ -109,20 +114,24 @@ class PixelTableUniformLineFilter : public Framework::FullLineFilter {
          *out = sum * norm;
          //in += inStride; // we don't increment `in` here, so that we don't have to subtract one index inside the loop
          //out += outStride; // we don't increment `out` here, we increment it in the loop before the assignment, it saves one addition! :)
-         for( dip::uint ii = 1; ii < length; ++ii ) {
-            for( auto run : pixelTable.Runs() ) {
-               sum -= in[ run.offset ];
-               sum += in[ run.offset + static_cast< dip::sint >( run.length ) * inStride ];
+         std::array< TPI, SlidingRunSums::blockSize > delta;
+         for( dip::uint ii = 1; ii < length; ii += SlidingRunSums::blockSize ) {
+            dip::uint n = std::min( SlidingRunSums::blockSize, length - ii );
+            sums_.SumDeltas( in, inStride, n, delta.data() );
+            for( dip::uint kk = 0; kk < n; ++kk ) {
+               sum += delta[ kk ];
+               out += outStride;
+               *out = sum * norm;
             }
-            in += inStride;
-            out += outStride;
-            *out = sum * norm;
+            in += static_cast< dip::sint >( n ) * inStride;
          }
       }
       virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint, dip::uint nRuns ) override {
-         return lineLength * nRuns * 4    // number of adds
+         return lineLength * nRuns * 2    // number of adds
                 + lineLength * nRuns;     // iterating over pixel table runs
       }
+   private:
+      SlidingRunSums sums_;
 };
 
 void PixelTableUniform(
@@ -162,3 +171,26 @@ void Uniform(
 
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/statistics.h"
+#include "diplib/generation.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the uniform filter with arbitrary kernels") {
+   dip::Image img{ dip::UnsignedArray{ 64, 41 }, 1, dip::DT_DFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 0.0, 100.0 );
+   for( auto shape : { dip::Kernel::ShapeCode::ELLIPTIC, dip::Kernel::ShapeCode::DIAMOND } ) {
+      dip::Kernel kernel( shape, { 11, 7 } );
+      dip::Image weights = kernel.PixelTable( 2, 0 ).AsImage();
+      weights.Convert( dip::DT_DFLOAT );
+      weights /= dip::Sum( weights );
+      dip::Image result = dip::Uniform( img, kernel, { "mirror" } );
+      dip::Image expected = dip::GeneralConvolution( img, weights, { "mirror" } );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( result, expected ) < 1e-10 );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -0,0 +1,381 @@
+/*
+ * DIPlib 3.0
+ * This file contains the definition of the summed-area table.
+ *
+ * (c)2017, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diplib.h"
+#include "diplib/statistics.h"
+#include "diplib/math.h"
+#include "diplib/multithreading.h"
+
+namespace dip {
+
+namespace {
+
+// The 2^n corners of a box, as offsets into the table relative to the box's first pixel, and the sign with which
+// the table value at each corner contributes to the sum over the box (inclusion-exclusion). Bit `ii` of the
+// corner index selects the far side of the box along dimension `ii`.
+struct BoxCorners {
+   std::vector< dip::sint > offsets;
+   std::vector< dfloat > signs;
+
+   BoxCorners( UnsignedArray const& sizes, IntegerArray const& strides ) {
+      dip::uint nDims = sizes.size();
+      dip::uint nCorners = dip::uint( 1 ) << nDims;
+      offsets.resize( nCorners );
+      signs.resize( nCorners );
+      for( dip::uint cc = 0; cc < nCorners; ++cc ) {
+         dip::sint offset = 0;
+         dip::uint nNear = 0;
+         for( dip::uint ii = 0; ii < nDims; ++ii ) {
+            if( cc & ( dip::uint( 1 ) << ii )) {
+               offset += static_cast< dip::sint >( sizes[ ii ] ) * strides[ ii ];
+            } else {
+               ++nNear;
+            }
+         }
+         offsets[ cc ] = offset;
+         signs[ cc ] = ( nNear & 1 ) ? -1.0 : 1.0;
+      }
+   }
+};
+
+// Returns the sum over the box with corners `corners`, with the box's first pixel at `table`
+dfloat CornerSum( dfloat const* table, BoxCorners const& corners ) {
+   dfloat sum = 0;
+   for( dip::uint cc = 0; cc < corners.offsets.size(); ++cc ) {
+      sum += corners.signs[ cc ] * table[ corners.offsets[ cc ]];
+   }
+   return sum;
+}
+
+// Returns the variance given the sum and sum of squares of `n` values
+dfloat BoxVariance( dfloat sum, dfloat squareSum, dfloat n ) {
+   if( n <= 1 ) {
+      return 0;
+   }
+   // Rounding errors can make this slightly negative
+   return std::max(( squareSum - sum * sum / n ) / ( n - 1 ), 0.0 );
+}
+
+enum class BoxStatistic { SUM, MEAN, VARIANCE };
+
+} // namespace
+
+SummedAreaTable::SummedAreaTable( Image const& in, bool squares ) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !in.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( in.Dimensionality() < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_START_STACK_TRACE
+      sizes_ = in.Sizes();
+      shift_ = dip::Mean( in ).As< dfloat >();
+      UnsignedArray tableSizes = sizes_;
+      RangeArray inside( sizes_.size() );
+      for( dip::uint ii = 0; ii < sizes_.size(); ++ii ) {
+         ++tableSizes[ ii ];
+         inside[ ii ] = Range{ 1, -1 };
+      }
+      // The first pixel along each dimension stays 0, the cumulative sum then makes pixel `p` the sum over
+      // all input pixels with smaller coordinates
+      sums_.ReForge( tableSizes, 1, DT_DFLOAT );
+      sums_.Fill( 0 );
+      Image values = sums_.At( inside );
+      values.Copy( in );
+      values -= shift_;
+      if( squares ) {
+         squares_.ReForge( tableSizes, 1, DT_DFLOAT );
+         squares_.Fill( 0 );
+         Image squareValues = squares_.At( inside );
+         Square( values, squareValues );
+         CumulativeSum( squares_, {}, squares_ );
+      }
+      CumulativeSum( sums_, {}, sums_ );
+   DIP_END_STACK_TRACE
+}
+
+namespace {
+
+void ValidateBox( SummedAreaTable::Box const& box, UnsignedArray const& sizes ) {
+   DIP_THROW_IF(( box.origin.size() != sizes.size() ) || ( box.sizes.size() != sizes.size() ), E::ARRAY_PARAMETER_WRONG_LENGTH );
+   for( dip::uint ii = 0; ii < sizes.size(); ++ii ) {
+      DIP_THROW_IF( box.sizes[ ii ] == 0, E::INVALID_PARAMETER );
+      DIP_THROW_IF( box.origin[ ii ] + box.sizes[ ii ] > sizes[ ii ], E::INDEX_OUT_OF_RANGE );
+   }
+}
+
+dfloat const* BoxOrigin( Image const& table, UnsignedArray const& origin ) {
+   return static_cast< dfloat const* >( table.Pointer( origin ));
+}
+
+// Computes `statistic` for each of `boxes`, which have already been validated
+std::vector< dfloat > BoxStatistics(
+      Image const& sums,
+      Image const& squares,
+      dfloat shift,
+      std::vector< SummedAreaTable::Box > const& boxes,
+      BoxStatistic statistic
+) {
+   std::vector< dfloat > result( boxes.size() );
+   dip::uint nCorners = dip::uint( 1 ) << sums.Dimensionality();
+   dip::uint nThreads = boxes.size() * nCorners < threadingThreshold ? 1 : std::min( GetNumberOfThreads(), boxes.size() );
+   #pragma omp parallel for schedule( dynamic, 64 ) num_threads( static_cast< int >( nThreads ))
+   for( dip::sint jj = 0; jj < static_cast< dip::sint >( boxes.size() ); ++jj ) {
+      SummedAreaTable::Box const& box = boxes[ static_cast< dip::uint >( jj ) ];
+      BoxCorners corners( box.sizes, sums.Strides() );
+      dfloat n = static_cast< dfloat >( box.sizes.product() );
+      dfloat sum = CornerSum( BoxOrigin( sums, box.origin ), corners );
+      dfloat value;
+      switch( statistic ) {
+         case BoxStatistic::SUM:
+            value = sum + n * shift;
+            break;
+         case BoxStatistic::MEAN:
+            value = sum / n + shift;
+            break;
+         default: // case BoxStatistic::VARIANCE:
+            value = BoxVariance( sum, CornerSum( BoxOrigin( squares, box.origin ), corners ), n );
+            break;
+      }
+      result[ static_cast< dip::uint >( jj ) ] = value;
+   }
+   return result;
+}
+
+// Computes `statistic` for a box of size `boxSizes` at every position within the image
+void BoxStatisticImage(
+      Image const& sums,
+      Image const& squares,
+      dfloat shift,
+      UnsignedArray const& sizes,
+      UnsignedArray boxSizes,
+      Image& out,
+      BoxStatistic statistic
+) {
+   dip::uint nDims = sizes.size();
+   ArrayUseParameter( boxSizes, nDims, dip::uint( 1 ));
+   UnsignedArray outSizes = sizes;
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      DIP_THROW_IF(( boxSizes[ ii ] == 0 ) || ( boxSizes[ ii ] > sizes[ ii ] ), E::INVALID_PARAMETER );
+      outSizes[ ii ] = sizes[ ii ] - boxSizes[ ii ] + 1;
+   }
+   out.ReForge( outSizes, 1, DT_DFLOAT, Option::AcceptDataTypeChange::DO_ALLOW );
+   // If `out` is protected and of a different type, we compute into a temporary image
+   Image result = out.DataType() == DT_DFLOAT ? out : Image( outSizes, 1, DT_DFLOAT );
+
+   BoxCorners corners( boxSizes, sums.Strides() );
+   dfloat n = static_cast< dfloat >( boxSizes.product() );
+   dip::uint lineLength = outSizes[ 0 ];
+   dip::uint nLines = outSizes.product() / lineLength;
+   IntegerArray const& tableStrides = sums.Strides();
+   IntegerArray const& outStrides = result.Strides();
+   dip::sint outStride = outStrides[ 0 ];
+   dip::uint nThreads = outSizes.product() * corners.offsets.size() < threadingThreshold
+                        ? 1 : std::min( GetNumberOfThreads(), nLines );
+   #pragma omp parallel num_threads( static_cast< int >( nThreads ))
+   {
+      std::vector< dfloat > sumBuffer( lineLength );
+      std::vector< dfloat > squareBuffer( statistic == BoxStatistic::VARIANCE ? lineLength : 0 );
+      #pragma omp for schedule( dynamic )
+      for( dip::sint jj = 0; jj < static_cast< dip::sint >( nLines ); ++jj ) {
+         // Find the start of the line in the table and in the output
+         dip::uint index = static_cast< dip::uint >( jj );
+         dip::sint tableOffset = 0;
+         dip::sint outOffset = 0;
+         for( dip::uint ii = 1; ii < nDims; ++ii ) {
+            dip::sint coord = static_cast< dip::sint >( index % outSizes[ ii ] );
+            index /= outSizes[ ii ];
+            tableOffset += coord * tableStrides[ ii ];
+            outOffset += coord * outStrides[ ii ];
+         }
+         // Accumulate the corners one at the time. The tables have normal strides, so the inner loop reads
+         // consecutive values and can be vectorized.
+         dfloat const* sumLine = static_cast< dfloat const* >( sums.Origin() ) + tableOffset;
+         std::fill( sumBuffer.begin(), sumBuffer.end(), 0.0 );
+         for( dip::uint cc = 0; cc < corners.offsets.size(); ++cc ) {
+            dfloat const* corner = sumLine + corners.offsets[ cc ];
+            dfloat sign = corners.signs[ cc ];
+            for( dip::uint kk = 0; kk < lineLength; ++kk ) {
+               sumBuffer[ kk ] += sign * corner[ kk ];
+            }
+         }
+         if( statistic == BoxStatistic::VARIANCE ) {
+            dfloat const* squareLine = static_cast< dfloat const* >( squares.Origin() ) + tableOffset;
+            std::fill( squareBuffer.begin(), squareBuffer.end(), 0.0 );
+            for( dip::uint cc = 0; cc < corners.offsets.size(); ++cc ) {
+               dfloat const* corner = squareLine + corners.offsets[ cc ];
+               dfloat sign = corners.signs[ cc ];
+               for( dip::uint kk = 0; kk < lineLength; ++kk ) {
+                  squareBuffer[ kk ] += sign * corner[ kk ];
+               }
+            }
+         }
+         dfloat* outLine = static_cast< dfloat* >( result.Origin() ) + outOffset;
+         switch( statistic ) {
+            case BoxStatistic::SUM:
+               for( dip::uint kk = 0; kk < lineLength; ++kk, outLine += outStride ) {
+                  *outLine = sumBuffer[ kk ] + n * shift;
+               }
+               break;
+            case BoxStatistic::MEAN:
+               for( dip::uint kk = 0; kk < lineLength; ++kk, outLine += outStride ) {
+                  *outLine = sumBuffer[ kk ] / n + shift;
+               }
+               break;
+            case BoxStatistic::VARIANCE:
+               for( dip::uint kk = 0; kk < lineLength; ++kk, outLine += outStride ) {
+                  *outLine = BoxVariance( sumBuffer[ kk ], squareBuffer[ kk ], n );
+               }
+               break;
+         }
+      }
+   }
+   if( !out.IsIdenticalView( result )) {
+      out.Copy( result );
+   }
+}
+
+} // namespace
+
+dfloat SummedAreaTable::Sum( Box const& box ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_STACK_TRACE_THIS( ValidateBox( box, sizes_ ));
+   BoxCorners corners( box.sizes, sums_.Strides() );
+   return CornerSum( BoxOrigin( sums_, box.origin ), corners ) + static_cast< dfloat >( box.sizes.product() ) * shift_;
+}
+
+dfloat SummedAreaTable::Mean( Box const& box ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_STACK_TRACE_THIS( ValidateBox( box, sizes_ ));
+   BoxCorners corners( box.sizes, sums_.Strides() );
+   return CornerSum( BoxOrigin( sums_, box.origin ), corners ) / static_cast< dfloat >( box.sizes.product() ) + shift_;
+}
+
+dfloat SummedAreaTable::Variance( Box const& box ) const {
+   DIP_THROW_IF( !HasSquares(), "The summed-area table was computed without squares" );
+   DIP_STACK_TRACE_THIS( ValidateBox( box, sizes_ ));
+   BoxCorners corners( box.sizes, sums_.Strides() );
+   return BoxVariance( CornerSum( BoxOrigin( sums_, box.origin ), corners ),
+                       CornerSum( BoxOrigin( squares_, box.origin ), corners ),
+                       static_cast< dfloat >( box.sizes.product() ));
+}
+
+std::vector< dfloat > SummedAreaTable::Sums( std::vector< Box > const& boxes ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_START_STACK_TRACE
+      for( auto const& box : boxes ) {
+         ValidateBox( box, sizes_ );
+      }
+      return BoxStatistics( sums_, squares_, shift_, boxes, BoxStatistic::SUM );
+   DIP_END_STACK_TRACE
+}
+
+std::vector< dfloat > SummedAreaTable::Means( std::vector< Box > const& boxes ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_START_STACK_TRACE
+      for( auto const& box : boxes ) {
+         ValidateBox( box, sizes_ );
+      }
+      return BoxStatistics( sums_, squares_, shift_, boxes, BoxStatistic::MEAN );
+   DIP_END_STACK_TRACE
+}
+
+std::vector< dfloat > SummedAreaTable::Variances( std::vector< Box > const& boxes ) const {
+   DIP_THROW_IF( !HasSquares(), "The summed-area table was computed without squares" );
+   DIP_START_STACK_TRACE
+      for( auto const& box : boxes ) {
+         ValidateBox( box, sizes_ );
+      }
+      return BoxStatistics( sums_, squares_, shift_, boxes, BoxStatistic::VARIANCE );
+   DIP_END_STACK_TRACE
+}
+
+void SummedAreaTable::BoxSums( UnsignedArray boxSizes, Image& out ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_STACK_TRACE_THIS( BoxStatisticImage( sums_, squares_, shift_, sizes_, std::move( boxSizes ), out, BoxStatistic::SUM ));
+}
+
+void SummedAreaTable::BoxMeans( UnsignedArray boxSizes, Image& out ) const {
+   DIP_THROW_IF( !IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_STACK_TRACE_THIS( BoxStatisticImage( sums_, squares_, shift_, sizes_, std::move( boxSizes ), out, BoxStatistic::MEAN ));
+}
+
+void SummedAreaTable::BoxVariances( UnsignedArray boxSizes, Image& out ) const {
+   DIP_THROW_IF( !HasSquares(), "The summed-area table was computed without squares" );
+   DIP_STACK_TRACE_THIS( BoxStatisticImage( sums_, squares_, shift_, sizes_, std::move( boxSizes ), out, BoxStatistic::VARIANCE ));
+}
+
+} // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/linear.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the summed-area table") {
+   dip::Image img{ dip::UnsignedArray{ 37, 23, 11 }, 1, dip::DT_SFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 1000.0, 1100.0 );
+   dip::SummedAreaTable table( img );
+   DOCTEST_REQUIRE( table.IsForged() );
+   DOCTEST_CHECK( table.Sizes() == img.Sizes() );
+   DOCTEST_CHECK( table.Table().Sizes() == dip::UnsignedArray{ 38, 24, 12 } );
+
+   // Individual boxes, compared to the statistics over a view
+   dip::SummedAreaTable::Box box{ { 3, 5, 2 }, { 20, 1, 7 }};
+   dip::Image view = img.At( dip::Range{ 3, 22 }, dip::Range{ 5, 5 }, dip::Range{ 2, 8 } );
+   DOCTEST_CHECK( table.Sum( box ) == doctest::Approx( dip::Sum( view ).As< dip::dfloat >() ));
+   DOCTEST_CHECK( table.Mean( box ) == doctest::Approx( dip::Mean( view ).As< dip::dfloat >() ));
+   DOCTEST_CHECK( table.Variance( box ) == doctest::Approx( dip::SampleStatistics( view ).Variance() ));
+   dip::SummedAreaTable::Box all{ { 0, 0, 0 }, img.Sizes() };
+   DOCTEST_CHECK( table.Sum( all ) == doctest::Approx( dip::Sum( img ).As< dip::dfloat >() ));
+   DOCTEST_CHECK( table.Variance( { { 4, 4, 4 }, { 1, 1, 1 }} ) == 0.0 );
+
+   // Lists of boxes give the same results
+   std::vector< dip::SummedAreaTable::Box > boxes{ box, all, { { 36, 0, 10 }, { 1, 23, 1 }}};
+   auto sums = table.Sums( boxes );
+   auto variances = table.Variances( boxes );
+   DOCTEST_REQUIRE( sums.size() == 3 );
+   DOCTEST_REQUIRE( variances.size() == 3 );
+   for( dip::uint ii = 0; ii < boxes.size(); ++ii ) {
+      DOCTEST_CHECK( sums[ ii ] == table.Sum( boxes[ ii ] ));
+      DOCTEST_CHECK( variances[ ii ] == table.Variance( boxes[ ii ] ));
+   }
+
+   // Box statistics at every position, compared to the uniform filter
+   dip::Image means;
+   table.BoxMeans( { 5, 3, 3 }, means );
+   DOCTEST_CHECK( means.Sizes() == dip::UnsignedArray{ 33, 21, 9 } );
+   dip::Image expected = dip::Uniform( dip::Convert( img, dip::DT_DFLOAT ), dip::Kernel( dip::Kernel::ShapeCode::RECTANGULAR, { 5, 3, 3 } ));
+   expected = expected.At( dip::Range{ 2, 34 }, dip::Range{ 1, 21 }, dip::Range{ 1, 9 } );
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( means, expected ) < 1e-8 );
+   dip::Image variances2;
+   table.BoxVariances( { 5, 3, 3 }, variances2 );
+   DOCTEST_CHECK( dip::Mean( variances2 ).As< dip::dfloat >() == doctest::Approx( 100.0 * 100.0 / 12.0 ).epsilon( 0.05 ));
+   DOCTEST_CHECK( variances2.At( 7, 4, 2 ).As< dip::dfloat >() == doctest::Approx( table.Variance( { { 7, 4, 2 }, { 5, 3, 3 }} )));
+
+   // Errors
+   DOCTEST_CHECK_THROWS( table.Sum( { { 36, 0, 0 }, { 2, 1, 1 }} ));
+   DOCTEST_CHECK_THROWS( table.Sum( { { 0, 0 }, { 1, 1 }} ));
+   DOCTEST_CHECK_THROWS( table.BoxSums( { 38, 1, 1 }, means ));
+   dip::SummedAreaTable noSquares( img, false );
+   DOCTEST_CHECK( !noSquares.HasSquares() );
+   DOCTEST_CHECK_THROWS( noSquares.Variance( box ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
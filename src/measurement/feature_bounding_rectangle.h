@@ -0,0 +1,73 @@
+/*
+ * DIPlib 3.0
+ * This file defines the "MinAreaRectangle" and "MinPerimeterRectangle" measurement features
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+namespace dip {
+namespace Feature {
+
+
+// The two bounding rectangles are computed together by the rotating calipers, they differ only in which one is output.
+class FeatureBoundingRectangle : public ConvexHullBased {
+   public:
+      enum class Criterion { MIN_AREA, MIN_PERIMETER };
+
+      explicit FeatureBoundingRectangle( Criterion criterion ) :
+            ConvexHullBased( criterion == Criterion::MIN_AREA
+                             ? Information{ "MinAreaRectangle", "Minimum-area bounding rectangle (2D)", false }
+                             : Information{ "MinPerimeterRectangle", "Minimum-perimeter bounding rectangle (2D)", false } ),
+            criterion_( criterion ) {};
+
+      virtual ValueInformationArray Initialize( Image const& label, Image const&, dip::uint ) override {
+         ValueInformationArray out( 3 );
+         PhysicalQuantity pq = label.PixelSize( 0 );
+         if( label.IsIsotropic() && pq.IsPhysical() ) {
+            scale_ = pq.magnitude;
+            out[ 0 ].units = pq.units;
+            out[ 1 ].units = pq.units;
+         } else {
+            scale_ = 1;
+            out[ 0 ].units = Units::Pixel();
+            out[ 1 ].units = Units::Pixel();
+         }
+         out[ 2 ].units = Units::Radian();
+         out[ 0 ].name = "Length";
+         out[ 1 ].name = "Width";
+         out[ 2 ].name = "Angle";
+         return out;
+      }
+
+      virtual bool UsesRotatingCalipers() const override { return true; }
+
+      virtual void Measure( ConvexHull const& convexHull, Measurement::ValueIterator output ) override {
+         CaliperValues const& calipers = convexHull.RotatingCalipers();
+         OrientedRectangle const& rect = criterion_ == Criterion::MIN_AREA ? calipers.minAreaRectangle
+                                                                          : calipers.minPerimeterRectangle;
+         output[ 0 ] = rect.length * scale_;
+         output[ 1 ] = rect.width * scale_;
+         output[ 2 ] = rect.angle;
+      }
+
+   private:
+      Criterion criterion_;
+      dfloat scale_;
+};
+
+
+} // namespace feature
+} // namespace dip
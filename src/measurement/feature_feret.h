@@ -51,8 +51,10 @@ class FeatureFeret : public ConvexHullBased {
          return out;
       }
 
+      virtual bool UsesRotatingCalipers() const override { return true; }
+
       virtual void Measure( ConvexHull const& convexHull, Measurement::ValueIterator output ) override {
-         FeretValues feret = convexHull.Feret();
+         FeretValues const& feret = convexHull.RotatingCalipers().feret;
          output[ 0 ] = feret.maxDiameter * scale_;
          output[ 1 ] = feret.minDiameter * scale_;
          output[ 2 ] = feret.maxPerpendicular * scale_;
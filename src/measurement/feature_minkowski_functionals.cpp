@@ -0,0 +1,362 @@
+/*
+ * DIPlib 3.0
+ * This file contains definitions for the function that computes the 3D Minkowski functionals.
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+
+#include "diplib.h"
+#include "diplib/overload.h"
+#include "diplib/multithreading.h"
+#include "feature_minkowski_functionals.h"
+
+namespace dip {
+
+namespace {
+
+// A lattice vector, also used to represent the vertices of the 2x2x2 cube
+using Vector3 = std::array< dip::sint, 3 >;
+
+// The 13 directions connecting pairs of vertices in the 2x2x2 cube
+constexpr std::array< Vector3, 13 > directions = {{
+      {{ 1,  0,  0 }}, {{ 0,  1,  0 }}, {{ 0,  0,  1 }},
+      {{ 1,  1,  0 }}, {{ 1, -1,  0 }}, {{ 1,  0,  1 }},
+      {{ 1,  0, -1 }}, {{ 0,  1,  1 }}, {{ 0,  1, -1 }},
+      {{ 1,  1,  1 }}, {{ 1,  1, -1 }}, {{ 1, -1,  1 }},
+      {{ 1, -1, -1 }}
+}};
+
+// The fraction of the unit sphere closest to each of the directions above (counting both a direction
+// and its opposite), from Legland et al. (2007). These weights add up to 1.
+constexpr std::array< dfloat, 4 > directionWeights = {{
+      0,                         // not used
+      2.0 * 0.04577789120476,    // axis directions
+      2.0 * 0.03698062787608,    // face diagonals
+      2.0 * 0.03519563978232     // body diagonals
+}};
+
+dip::sint Dot( Vector3 const& a, Vector3 const& b ) {
+   return a[ 0 ] * b[ 0 ] + a[ 1 ] * b[ 1 ] + a[ 2 ] * b[ 2 ];
+}
+
+// Number of non-zero components of `v`, which identifies the direction class (axis, face diagonal, body diagonal)
+dip::uint DirectionClass( Vector3 const& v ) {
+   return static_cast< dip::uint >(( v[ 0 ] != 0 ) + ( v[ 1 ] != 0 ) + ( v[ 2 ] != 0 ));
+}
+
+Vector3 CubeVertex( dip::uint index ) {
+   return {{ static_cast< dip::sint >( index & 1u ), static_cast< dip::sint >(( index >> 1u ) & 1u ), static_cast< dip::sint >(( index >> 2u ) & 1u ) }};
+}
+
+// Number of set vertices in the cube
+dfloat CountVertices( dip::uint config ) {
+   dip::uint n = 0;
+   for( dip::uint ii = 0; ii < 8; ++ii ) {
+      n += ( config >> ii ) & 1u;
+   }
+   return static_cast< dfloat >( n );
+}
+
+bool IsSet( dip::uint config, Vector3 const& p ) {
+   return ( config >> static_cast< dip::uint >( p[ 0 ] + 2 * p[ 1 ] + 4 * p[ 2 ] )) & 1u;
+}
+
+bool IsInCube( Vector3 const& p ) {
+   return ( p[ 0 ] == 0 || p[ 0 ] == 1 ) && ( p[ 1 ] == 0 || p[ 1 ] == 1 ) && ( p[ 2 ] == 0 || p[ 2 ] == 1 );
+}
+
+// Number of pairs of vertices (p, p+v) within the cube for which `set(p) + set(p+v)` equals `count`, divided
+// by the number of cubes each such pair belongs to.
+dfloat CountPairs( dip::uint config, Vector3 const& v, dip::uint count ) {
+   dip::uint n = 0;
+   for( dip::uint ii = 0; ii < 8; ++ii ) {
+      Vector3 p = CubeVertex( ii );
+      Vector3 q = {{ p[ 0 ] + v[ 0 ], p[ 1 ] + v[ 1 ], p[ 2 ] + v[ 2 ] }};
+      if( IsInCube( q ) && ( static_cast< dip::uint >( IsSet( config, p )) + static_cast< dip::uint >( IsSet( config, q )) == count )) {
+         ++n;
+      }
+   }
+   // A pair along an axis is shared by 4 cubes, along a face diagonal by 2, and along a body diagonal by 1.
+   return static_cast< dfloat >( n ) / static_cast< dfloat >( 1u << ( 3 - DirectionClass( v )));
+}
+
+// Euler number of the cubical complex formed by the set vertices of the cube (6-connected foreground), each
+// cell weighted by the inverse of the number of cubes it belongs to.
+dfloat EulerNumber6( dip::uint config ) {
+   dfloat vertices = CountVertices( config );
+   dfloat edges = 0;
+   dfloat faces = 0;
+   for( dip::uint ii = 0; ii < 3; ++ii ) {
+      edges += CountPairs( config, directions[ ii ], 2 );
+      // The two faces orthogonal to axis `ii`
+      dip::uint mask = 0;
+      for( dip::uint jj = 0; jj < 8; ++jj ) {
+         if( CubeVertex( jj )[ ii ] == 0 ) {
+            mask |= 1u << jj;
+         }
+      }
+      faces += static_cast< dfloat >((( config & mask ) == mask ) + (( config & ~mask & 0xFFu ) == ( ~mask & 0xFFu ))) / 2.0;
+   }
+   dfloat cubes = config == 0xFFu ? 1.0 : 0.0;
+   return vertices / 8.0 - edges + faces - cubes;
+}
+
+// Integral over all planes orthogonal to `normal` of the Euler number of the intersection of the plane with
+// the complex formed by the set vertices of the cube (4-connected foreground within the planes).
+dfloat PlaneEulerIntegral6( dip::uint config, Vector3 const& normal ) {
+   dfloat vertices = CountVertices( config );
+   // Edges within the plane are those lattice directions that are orthogonal to the normal and not
+   // diagonals of the cells of the plane lattice.
+   dip::sint normalLength2 = Dot( normal, normal );
+   dfloat edges = 0;
+   for( auto const& v : directions ) {
+      if(( Dot( v, normal ) == 0 ) && ( Dot( v, v ) <= normalLength2 )) {
+         edges += CountPairs( config, v, 2 );
+      }
+   }
+   // Cells within the plane are the sets of 3 or 4 cube vertices that lie in the same plane.
+   dfloat faces = 0;
+   for( dip::sint k = -3; k <= 3; ++k ) {
+      dip::uint n = 0;
+      bool all = true;
+      Vector3 minP = {{ 1, 1, 1 }};
+      Vector3 maxP = {{ 0, 0, 0 }};
+      for( dip::uint ii = 0; ii < 8; ++ii ) {
+         Vector3 p = CubeVertex( ii );
+         if( Dot( p, normal ) == k ) {
+            ++n;
+            all &= IsSet( config, p );
+            for( dip::uint jj = 0; jj < 3; ++jj ) {
+               minP[ jj ] = std::min( minP[ jj ], p[ jj ] );
+               maxP[ jj ] = std::max( maxP[ jj ], p[ jj ] );
+            }
+         }
+      }
+      if(( n >= 3 ) && all ) {
+         // A cell that is flat along one of the axes is shared by two cubes.
+         dip::uint flat = 0;
+         for( dip::uint jj = 0; jj < 3; ++jj ) {
+            flat += minP[ jj ] == maxP[ jj ];
+         }
+         faces += 1.0 / static_cast< dfloat >( 1u << flat );
+      }
+   }
+   // The planes are separated by 1/|normal|.
+   return ( vertices / 8.0 - edges + faces ) / std::sqrt( static_cast< dfloat >( normalLength2 ));
+}
+
+using MinkowskiLUT = std::array< MinkowskiValues, 256 >;
+
+// Computes the contribution of each of the 256 configurations of the 2x2x2 cube to each of the
+// Minkowski functionals. The surface area is computed using the Crofton formula: the number of intersections
+// of lines in each of the 13 directions with the object boundary. The mean breadth is computed as the
+// integral of the Euler number of the intersections of the object with planes orthogonal to each of
+// the 13 directions. The Euler number of the 26-connected foreground is computed as the Euler number of the
+// 6-connected background; the same duality, in 2D, is used for the mean breadth.
+MinkowskiLUT ComputeLUT() {
+   MinkowskiLUT lut;
+   for( dip::uint config = 0; config < 256; ++config ) {
+      dip::uint complement = ~config & 0xFFu;
+      lut[ config ].volume = CountVertices( config ) / 8.0;
+      for( auto const& v : directions ) {
+         dfloat weight = directionWeights[ DirectionClass( v ) ];
+         dfloat length = std::sqrt( static_cast< dfloat >( Dot( v, v )));
+         lut[ config ].surfaceArea += 2.0 * weight * CountPairs( config, v, 1 ) / length;
+         lut[ config ].meanBreadth -= weight * PlaneEulerIntegral6( complement, v );
+      }
+      lut[ config ].eulerNumber = EulerNumber6( complement );
+   }
+   return lut;
+}
+
+MinkowskiLUT const& GetLUT() {
+   static MinkowskiLUT const lut = ComputeLUT();
+   return lut;
+}
+
+template< typename TPI >
+void dip__MinkowskiFunctionals(
+      Image const& label,
+      ObjectIdToIndexMap const& objectIndex,
+      std::vector< std::vector< MinkowskiValues >>& accumulators // one for each thread
+) {
+   MinkowskiLUT const& lut = GetLUT();
+   TPI const* origin = static_cast< TPI const* >( label.Origin() );
+   dip::sint nx = static_cast< dip::sint >( label.Size( 0 ));
+   dip::sint ny = static_cast< dip::sint >( label.Size( 1 ));
+   dip::sint nz = static_cast< dip::sint >( label.Size( 2 ));
+   dip::sint sx = label.Stride( 0 );
+   dip::sint sy = label.Stride( 1 );
+   dip::sint sz = label.Stride( 2 );
+   // We visit all 2x2x2 cubes that contain at least one image voxel, the image is considered surrounded by
+   // background. Each thread processes a set of cube planes.
+   #pragma omp parallel num_threads( static_cast< int >( accumulators.size() ))
+   {
+      std::vector< MinkowskiValues >& values = accumulators[ static_cast< dip::uint >( omp_get_thread_num() ) ];
+      // If new objectID is equal to previous one, we don't need to look it up again
+      TPI objectID = 0;
+      MinkowskiValues* data = nullptr;
+      auto lookUp = [ & ]( TPI id ) {
+         if( id != objectID ) {
+            objectID = id;
+            auto it = objectIndex.find( id );
+            data = it == objectIndex.end() ? nullptr : &( values[ it->second ] );
+         }
+         return data;
+      };
+      #pragma omp for schedule( dynamic )
+      for( dip::sint zz = -1; zz < nz; ++zz ) {
+         for( dip::sint yy = -1; yy < ny; ++yy ) {
+            // The four image lines that pass through the cubes on this row, indexed by `dy + 2 * dz`
+            std::array< TPI const*, 4 > lines{};
+            for( dip::sint dz = 0; dz < 2; ++dz ) {
+               for( dip::sint dy = 0; dy < 2; ++dy ) {
+                  if(( yy + dy >= 0 ) && ( yy + dy < ny ) && ( zz + dz >= 0 ) && ( zz + dz < nz )) {
+                     lines[ static_cast< dip::uint >( dy + 2 * dz ) ] = origin + ( yy + dy ) * sy + ( zz + dz ) * sz;
+                  }
+               }
+            }
+            // The cube vertices are indexed by `dx + 2 * dy + 4 * dz`; we shift the cube along the row
+            std::array< TPI, 8 > cube{};
+            for( dip::sint xx = -1; xx < nx; ++xx ) {
+               for( dip::uint ii = 0; ii < 4; ++ii ) {
+                  cube[ 2 * ii ] = cube[ 2 * ii + 1 ];
+                  cube[ 2 * ii + 1 ] = ( lines[ ii ] && ( xx + 1 < nx )) ? lines[ ii ][ ( xx + 1 ) * sx ] : TPI( 0 );
+               }
+               if( std::all_of( cube.begin() + 1, cube.end(), [ & ]( TPI v ) { return v == cube[ 0 ]; } )) {
+                  // Cube is completely inside an object or the background; this is the most common case
+                  if( cube[ 0 ] > 0 ) {
+                     MinkowskiValues* ptr = lookUp( cube[ 0 ] );
+                     if( ptr ) {
+                        *ptr += lut[ 0xFF ];
+                     }
+                  }
+                  continue;
+               }
+               for( dip::uint ii = 0; ii < 8; ++ii ) {
+                  TPI id = cube[ ii ];
+                  if(( id == 0 ) || ( std::find( cube.begin(), cube.begin() + static_cast< dip::sint >( ii ), id ) != cube.begin() + static_cast< dip::sint >( ii ))) {
+                     continue; // background, or an object we've already processed for this cube
+                  }
+                  MinkowskiValues* ptr = lookUp( id );
+                  if( ptr ) {
+                     dip::uint config = 0;
+                     for( dip::uint jj = ii; jj < 8; ++jj ) {
+                        config |= static_cast< dip::uint >( cube[ jj ] == id ) << jj;
+                     }
+                     *ptr += lut[ config ];
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+} // namespace
+
+std::vector< MinkowskiValues > MinkowskiFunctionals(
+      Image const& label,
+      UnsignedArray const& objectIDs
+) {
+   if( objectIDs.empty() ) {
+      return {};
+   }
+
+   // Check image properties
+   DIP_STACK_TRACE_THIS( label.CheckProperties( 3, 1, dip::DataType::Class_UInt, Option::ThrowException::DO_THROW ));
+
+   // Create lookup table for objectIDs
+   ObjectIdToIndexMap objectIndex;
+   for( dip::uint ii = 0; ii < objectIDs.size(); ++ii ) {
+      objectIndex.emplace( objectIDs[ ii ], ii );
+   }
+
+   // Each thread accumulates into its own array
+   dip::uint nThreads = std::min( GetNumberOfThreads(), label.Size( 2 ) + 1 );
+   if( label.NumberOfPixels() * 20 < threadingThreshold ) {
+      nThreads = 1;
+   }
+   std::vector< std::vector< MinkowskiValues >> accumulators( nThreads, std::vector< MinkowskiValues >( objectIDs.size() ));
+
+   DIP_OVL_CALL_UINT( dip__MinkowskiFunctionals, ( label, objectIndex, accumulators ), label.DataType() );
+
+   for( dip::uint ii = 1; ii < nThreads; ++ii ) {
+      for( dip::uint jj = 0; jj < objectIDs.size(); ++jj ) {
+         accumulators[ 0 ][ jj ] += accumulators[ ii ][ jj ];
+      }
+   }
+   return accumulators[ 0 ];
+}
+
+} // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing the Minkowski functionals" ) {
+   dip::Image label( { 40, 35, 30 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   // Object 1: a single voxel touching the image edge
+   label.At( 0, 0, 0 ) = 1;
+   // Object 2: a box with a cavity
+   label.At( dip::Range{ 2, 9 }, dip::Range{ 2, 9 }, dip::Range{ 2, 9 } ) = 2;
+   label.At( dip::Range{ 5, 6 }, dip::Range{ 5, 6 }, dip::Range{ 5, 6 } ) = 0;
+   // Object 3: a ring, touching object 2
+   label.At( dip::Range{ 10, 14 }, dip::Range{ 2, 6 }, dip::Range{ 2, 3 } ) = 3;
+   label.At( dip::Range{ 11, 13 }, dip::Range{ 3, 5 }, dip::Range{ 2, 3 } ) = 0;
+   // Object 4: a ball
+   dip::sint radius = 10;
+   dip::uint ballSize = 0;
+   for( dip::sint z = -radius; z <= radius; ++z ) {
+      for( dip::sint y = -radius; y <= radius; ++y ) {
+         for( dip::sint x = -radius; x <= radius; ++x ) {
+            if( x * x + y * y + z * z <= radius * radius ) {
+               label.At( static_cast< dip::uint >( x + 27 ), static_cast< dip::uint >( y + 20 ), static_cast< dip::uint >( z + 15 )) = 4;
+               ++ballSize;
+            }
+         }
+      }
+   }
+   auto res = dip::MinkowskiFunctionals( label, { 1, 2, 3, 4 } );
+   DOCTEST_REQUIRE( res.size() == 4 );
+   DOCTEST_CHECK( res[ 0 ].volume == 1 );
+   DOCTEST_CHECK( res[ 0 ].eulerNumber == 1 );
+   DOCTEST_CHECK( res[ 0 ].surfaceArea > 0 );
+   DOCTEST_CHECK( res[ 0 ].meanBreadth > 0 );
+   DOCTEST_CHECK( res[ 1 ].volume == 8 * 8 * 8 - 2 * 2 * 2 );
+   DOCTEST_CHECK( res[ 1 ].eulerNumber == 2 );
+   DOCTEST_CHECK( res[ 2 ].volume == 5 * 5 * 2 - 3 * 3 * 2 );
+   DOCTEST_CHECK( res[ 2 ].eulerNumber == 0 );
+   DOCTEST_CHECK( res[ 3 ].volume == static_cast< dip::dfloat >( ballSize ) );
+   DOCTEST_CHECK( res[ 3 ].eulerNumber == 1 );
+   dip::dfloat r = std::cbrt( static_cast< dip::dfloat >( ballSize ) * 3.0 / 4.0 / dip::pi );
+   DOCTEST_CHECK( res[ 3 ].surfaceArea == doctest::Approx( 4.0 * dip::pi * r * r ).epsilon( 0.03 ));
+   DOCTEST_CHECK( res[ 3 ].meanBreadth == doctest::Approx( 2.0 * r ).epsilon( 0.03 ));
+
+   // Neighboring objects do not affect the measurement
+   dip::Image box( label.Sizes(), 1, dip::DT_UINT8 );
+   box.Fill( 0 );
+   box.At( dip::Range{ 2, 9 }, dip::Range{ 2, 9 }, dip::Range{ 2, 9 } ) = 2;
+   box.At( dip::Range{ 5, 6 }, dip::Range{ 5, 6 }, dip::Range{ 5, 6 } ) = 0;
+   auto boxRes = dip::MinkowskiFunctionals( box, { 2 } );
+   DOCTEST_CHECK( res[ 1 ].surfaceArea == doctest::Approx( boxRes[ 0 ].surfaceArea ));
+   DOCTEST_CHECK( res[ 1 ].meanBreadth == doctest::Approx( boxRes[ 0 ].meanBreadth ));
+}
+
+#endif // DIP__ENABLE_DOCTEST
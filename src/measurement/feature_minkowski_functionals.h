@@ -0,0 +1,98 @@
+/*
+ * DIPlib 3.0
+ * This file defines the "MinkowskiFunctionals" measurement feature
+ *
+ * (c)2018, Cris Luengo.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diplib.h"
+#include "diplib/measurement.h"
+
+namespace dip {
+
+
+// The four Minkowski functionals (intrinsic volumes) of a 3D object.
+struct MinkowskiValues {
+   dfloat volume = 0;
+   dfloat surfaceArea = 0;
+   dfloat meanBreadth = 0;
+   dfloat eulerNumber = 0;
+
+   MinkowskiValues& operator+=( MinkowskiValues const& other ) {
+      volume += other.volume;
+      surfaceArea += other.surfaceArea;
+      meanBreadth += other.meanBreadth;
+      eulerNumber += other.eulerNumber;
+      return *this;
+   }
+};
+
+// Computes the Minkowski functionals for all objects in `objectIDs`, in a single pass over the
+// 2x2x2 neighborhoods of `label`. The output has objects in the same order as `objectIDs`.
+std::vector< MinkowskiValues > MinkowskiFunctionals(
+      Image const& label,
+      UnsignedArray const& objectIDs
+);
+
+
+namespace Feature {
+
+
+class FeatureMinkowskiFunctionals : public ImageBased {
+   public:
+      FeatureMinkowskiFunctionals() : ImageBased( { "MinkowskiFunctionals", "volume, surface area, mean breadth and Euler number of object (3D)", false } ) {};
+
+      virtual ValueInformationArray Initialize( Image const& label, Image const&, dip::uint ) override {
+         DIP_THROW_IF( label.Dimensionality() != 3, E::DIMENSIONALITY_NOT_SUPPORTED );
+         ValueInformationArray out( 4 );
+         PhysicalQuantity pq = label.PixelSize( 0 );
+         if( label.IsIsotropic() && pq.IsPhysical() ) {
+            scale_ = pq.magnitude;
+            out[ 0 ].units = ( pq * pq * pq ).units;
+            out[ 1 ].units = ( pq * pq ).units;
+            out[ 2 ].units = pq.units;
+         } else {
+            scale_ = 1;
+            out[ 0 ].units = Units::CubicPixel();
+            out[ 1 ].units = Units::SquarePixel();
+            out[ 2 ].units = Units::Pixel();
+         }
+         out[ 0 ].name = "Volume";
+         out[ 1 ].name = "SurfaceArea";
+         out[ 2 ].name = "MeanBreadth";
+         out[ 3 ].name = "EulerNumber";
+         return out;
+      }
+
+      virtual void Measure( Image const& label, Image const&, Measurement::IteratorFeature& output ) override {
+         std::vector< MinkowskiValues > res = MinkowskiFunctionals( label, output.Objects() );
+         // Note that `res` has objects sorted in the same way as `output`.
+         auto dst = output.FirstObject();
+         auto src = res.begin();
+         do {
+            dst[ 0 ] = src->volume * scale_ * scale_ * scale_;
+            dst[ 1 ] = src->surfaceArea * scale_ * scale_;
+            dst[ 2 ] = src->meanBreadth * scale_;
+            dst[ 3 ] = src->eulerNumber;
+         } while( ++src, ++dst );
+      }
+
+   private:
+      dfloat scale_;
+};
+
+
+} // namespace feature
+} // namespace dip
@@ -21,130 +21,222 @@
 #include "diplib.h"
 #include "diplib/chain_code.h"
 #include "diplib/accumulators.h"
+#include "diplib/multithreading.h"
 
 namespace dip {
 
-// An operator that increments the iterator but treating the container as a circular one
-template< typename Iterator, typename Container >
-static inline Iterator Next( Iterator it, Container const& con ) {
-   ++it;
-   if( it == con.end() ) {
-      it = con.begin();
+namespace {
+
+// Returns an angle in the range [0,pi), the orientation of a line.
+inline dfloat LineOrientation( dfloat angle ) {
+   angle = std::fmod( angle, pi );
+   if( angle < 0 ) {
+      angle += pi;
    }
-   return it;
+   return angle;
 }
 
-FeretValues ConvexHull::Feret() const {
-
-   FeretValues feret;
+inline OrientedRectangle MakeOrientedRectangle( dfloat alongEdge, dfloat acrossEdge, dfloat edgeAngle ) {
+   OrientedRectangle rect;
+   if( alongEdge >= acrossEdge ) {
+      rect.length = alongEdge;
+      rect.width = acrossEdge;
+      rect.angle = LineOrientation( edgeAngle );
+   } else {
+      rect.length = acrossEdge;
+      rect.width = alongEdge;
+      rect.angle = LineOrientation( edgeAngle + pi / 2.0 );
+   }
+   return rect;
+}
 
-   auto const& vertices = Vertices();
+// The rotating calipers algorithm over a convex polygon of `n` vertices, with coordinates `x[ ii ]` and `y[ ii ]`.
+// The polygon can have either orientation.
+//
+// For each edge (p,p+1) we keep track of three vertices: `q`, the vertex farthest from the edge; `kMax`, the
+// vertex with the largest projection onto the edge; and `kMin`, the vertex with the smallest projection onto
+// the edge. As the edge rotates, these three vertices move monotonically in the same direction, so we only
+// need to advance them while the projection keeps increasing (or decreasing). They are initialized by a full
+// scan over the vertices for the first edge.
+CaliperValues RotatingCalipersKernel( dfloat const* x, dfloat const* y, dip::uint n ) {
+   CaliperValues out;
+   auto X = [ & ]( dip::uint ii ) { return x[ ii ]; };
+   auto Y = [ & ]( dip::uint ii ) { return y[ ii ]; };
+   auto Next = [ & ]( dip::uint ii ) { return ii + 1 == n ? 0 : ii + 1; };
 
-   if( vertices.size() < 3 ) {
-      // Nothing to do, give some meaningful values
-      if( vertices.size() == 2 ) {
-         feret.maxDiameter = Distance( vertices[ 0 ], vertices[ 1 ] );
-         feret.minDiameter = 1;
-         feret.maxPerpendicular = feret.maxDiameter;
-      } else if (vertices.size() == 1 ) {
-         feret.maxDiameter = 1;
-         feret.minDiameter = 1;
-         feret.maxPerpendicular = 1;
+   if( n < 3 ) {
+      // Nothing to do, give some meaningful values (same as in ConvexHull::Feret())
+      if( n == 2 ) {
+         dfloat d = std::hypot( X( 1 ) - X( 0 ), Y( 1 ) - Y( 0 ));
+         out.feret.maxDiameter = d;
+         out.feret.minDiameter = 1;
+         out.feret.maxPerpendicular = d;
+         dfloat angle = std::atan2( Y( 1 ) - Y( 0 ), X( 1 ) - X( 0 ));
+         out.minAreaRectangle = MakeOrientedRectangle( d, 1, angle );
+      } else if( n == 1 ) {
+         out.feret.maxDiameter = 1;
+         out.feret.minDiameter = 1;
+         out.feret.maxPerpendicular = 1;
+         out.minAreaRectangle = MakeOrientedRectangle( 1, 1, 0 );
       }
-      return feret;
+      out.minPerimeterRectangle = out.minAreaRectangle;
+      return out;
    }
 
-   /* Algorithm by Preparata and Shamos (1985) to obtain list of anti-podal pairs
-    *    (from http://cgm.cs.mcgill.ca/~orm/rotcal.html)
-    *
-    * begin
-    *   p0:=pn;
-    *   q:=NEXT[p];
-    *   while (Area(p,NEXT[p],NEXT[q]) > Area(p,NEXT[p],q)) do
-    *     q:=NEXT[q];
-    *     q0:=q;                                                <= WRONG INDENTING!!!
-    *     while (q != p0) do                                    <= TYPO! (p != p0)
-    *       begin
-    *         p:=NEXT[p];
-    *         Print(p,q);
-    *         while (Area(p,NEXT[p],NEXT[q]) > Area(p,NEXT[p],q) do
-    *           begin
-    *             q:=NEXT[q];
-    *             if ((p,q) != (q0,p0)) then Print(p,q)
-    *             else return                                   <= NEVER SEEMS TO HAPPEN?
-    *           end;
-    *         if (Area(p,NEXT[p],NEXT[q]) = Area(p,NEXT[p],q)) then
-    *           if ((p,q) != (q0,p0)) then Print(p,NEXT[q])
-    *           else Print(NEXT[p],q)                           <= NEVER SEEMS TO HAPPEN?
-    *       end
-    * end.
-    */
-   auto first = vertices.begin();
-   auto p = first;
-   auto q = p + 1;
-   while( ParallelogramSignedArea( *p, *Next( p, vertices ), *Next( q, vertices )) >
-          ParallelogramSignedArea( *p, *Next( p, vertices ), *q ) ) {
-      q = Next( q, vertices );
-   }
+   dip::uint q = 0;
+   dip::uint kMax = 0;
+   dip::uint kMin = 0;
+   bool initialized = false;
+   dfloat maxDiameterSquare = 0.0;
+   out.feret.minDiameter = std::numeric_limits< dfloat >::max();
+   dfloat minArea = std::numeric_limits< dfloat >::max();
+   dfloat minPerimeter = std::numeric_limits< dfloat >::max();
+   auto UpdateMaxDiameter = [ & ]( dip::uint a, dip::uint b ) {
+      dfloat dx = X( b ) - X( a );
+      dfloat dy = Y( b ) - Y( a );
+      dfloat d2 = dx * dx + dy * dy;
+      if( d2 > maxDiameterSquare ) {
+         maxDiameterSquare = d2;
+         out.feret.maxAngle = std::atan2( dy, dx );
+      }
+   };
 
-   //auto q0 = q;
-   auto p0 = vertices.end() - 1;
-   feret.minDiameter = std::numeric_limits< dfloat >::max();
-   while( p != p0 ) {
-      ++p;
-      // (p,q) is an antipodal pair
-      dfloat d = Distance( *p, *q );
-      if( d > feret.maxDiameter ) {
-         feret.maxDiameter = d;
-         feret.maxAngle = Angle( *p, *q );
+   for( dip::uint p = 0; p < n; ++p ) {
+      dip::uint p1 = Next( p );
+      dfloat ex = X( p1 ) - X( p );
+      dfloat ey = Y( p1 ) - Y( p );
+      dfloat len = std::hypot( ex, ey );
+      if( len == 0.0 ) {
+         continue; // Repeated vertex, skip the edge
       }
-      while( ParallelogramSignedArea( *p, *Next( p, vertices ), *Next( q, vertices )) >
-             ParallelogramSignedArea( *p, *Next( p, vertices ), *q ) ) {
-         // (p,q+1) is an antipodal pair
-         d = TriangleHeight( *q, *Next( q, vertices ), *p );
-         if( d < feret.minDiameter ) {
-            feret.minDiameter = d;
-            feret.minAngle = Angle( *q, *Next( q, vertices ) );
+      ex /= len;
+      ey /= len;
+      // Distance of vertex k to the line through the edge, and projection of vertex k onto the edge
+      auto Height = [ & ]( dip::uint k ) { return std::abs( ex * ( Y( k ) - Y( p )) - ey * ( X( k ) - X( p ))); };
+      auto Projection = [ & ]( dip::uint k ) { return ex * X( k ) + ey * Y( k ); };
+      if( !initialized ) {
+         dfloat hMax = Height( 0 );
+         dfloat prMax = Projection( 0 );
+         dfloat prMin = prMax;
+         for( dip::uint k = 1; k < n; ++k ) {
+            dfloat h = Height( k );
+            if( h > hMax ) {
+               hMax = h;
+               q = k;
+            }
+            dfloat pr = Projection( k );
+            if( pr > prMax ) {
+               prMax = pr;
+               kMax = k;
+            }
+            if( pr < prMin ) {
+               prMin = pr;
+               kMin = k;
+            }
          }
-         q = Next( q, vertices );
-         d = Distance( *p, *q );
-         if( d > feret.maxDiameter ) {
-            feret.maxDiameter = d;
-            feret.maxAngle = Angle( *p, *q );
+         initialized = true;
+      } else {
+         while( Height( Next( q )) > Height( q )) {
+            q = Next( q );
          }
-      }
-      if( ParallelogramSignedArea( *p, *Next( p, vertices ), *Next( q, vertices ) ) ==
-          ParallelogramSignedArea( *p, *Next( p, vertices ), *q ) ) {
-         // (p,q+1) is an antipodal pair also, but we don't advance q
-         d = TriangleHeight( *q, *Next( q, vertices ), *p );
-         if( d < feret.minDiameter ) {
-            feret.minDiameter = d;
-            feret.minAngle = Angle( *q, *Next( q, vertices ) );
+         while( Projection( Next( kMax )) > Projection( kMax )) {
+            kMax = Next( kMax );
          }
-         d = Distance( *p, *Next( q, vertices ) );
-         if( d > feret.maxDiameter ) {
-            feret.maxDiameter = d;
-            feret.maxAngle = Angle( *p, *Next( q, vertices ) );
+         while( Projection( Next( kMin )) < Projection( kMin )) {
+            kMin = Next( kMin );
          }
       }
+      // (p,q) and (p+1,q) are antipodal pairs; if the edge (q,q+1) is parallel to (p,p+1), so is (p,q+1) and (p+1,q+1)
+      UpdateMaxDiameter( p, q );
+      UpdateMaxDiameter( p1, q );
+      dip::uint q1 = Next( q );
+      dfloat width = Height( q );
+      if( Height( q1 ) == width ) {
+         UpdateMaxDiameter( p, q1 );
+         UpdateMaxDiameter( p1, q1 );
+      }
+      // The rectangle with one side along this edge
+      dfloat length = Projection( kMax ) - Projection( kMin );
+      dfloat edgeAngle = std::atan2( ey, ex );
+      if( width < out.feret.minDiameter ) {
+         out.feret.minDiameter = width;
+         out.feret.minAngle = edgeAngle;
+         out.feret.maxPerpendicular = length;
+      }
+      dfloat area = width * length;
+      if( area < minArea ) {
+         minArea = area;
+         out.minAreaRectangle = MakeOrientedRectangle( length, width, edgeAngle );
+      }
+      dfloat perimeter = width + length;
+      if( perimeter < minPerimeter ) {
+         minPerimeter = perimeter;
+         out.minPerimeterRectangle = MakeOrientedRectangle( length, width, edgeAngle );
+      }
    }
+   out.feret.maxDiameter = std::sqrt( maxDiameterSquare );
+   // We want to give the minimum diameter angle correctly
+   out.feret.minAngle = out.feret.minAngle + pi / 2.0;
+   return out;
+}
+
+} // namespace
 
-   // Get the diameter perpendicular to feret.minDiameter
-   dfloat cos = std::cos( feret.minAngle );
-   dfloat sin = std::sin( feret.minAngle );
-   dfloat pmin = std::numeric_limits< dfloat >::max();
-   dfloat pmax = std::numeric_limits< dfloat >::lowest();
-   for( auto const& v : vertices ) {
-      dfloat d = v.x * cos + v.y * sin;
-      pmin = std::min( pmin, d );
-      pmax = std::max( pmax, d );
+FeretValues ConvexHull::Feret() const {
+   return RotatingCalipers().feret;
+}
+
+CaliperValues const& ConvexHull::RotatingCalipers() const {
+   if( !hasCalipers_ ) {
+      auto const& vertices = Vertices();
+      dip::uint n = vertices.size();
+      if( n > 0 ) {
+         std::vector< dfloat > x( n );
+         std::vector< dfloat > y( n );
+         for( dip::uint ii = 0; ii < n; ++ii ) {
+            x[ ii ] = vertices[ ii ].x;
+            y[ ii ] = vertices[ ii ].y;
+         }
+         calipers_ = RotatingCalipersKernel( x.data(), y.data(), n );
+      }
+      hasCalipers_ = true;
    }
-   feret.maxPerpendicular = pmax - pmin;
+   return calipers_;
+}
 
-   // We want to give the minimum diameter angle correctly
-   feret.minAngle = feret.minAngle + pi / 2.0;
+std::vector< CaliperValues > ConvexHullBatch::RotatingCalipers() const {
+   dip::uint nHulls = Size();
+   std::vector< CaliperValues > out( nHulls );
+   // Each vertex is visited a few times, with ~10 operations for each visit.
+   dip::uint nThreads = x_.size() * 50 > threadingThreshold ? GetNumberOfThreads() : 1;
+   dip::sint nHullsSigned = static_cast< dip::sint >( nHulls );
+   #pragma omp parallel for num_threads( static_cast< int >( nThreads )) schedule( dynamic, 64 )
+   for( dip::sint ii = 0; ii < nHullsSigned; ++ii ) {
+      dip::uint index = static_cast< dip::uint >( ii );
+      dip::uint offset = offsets_[ index ];
+      dip::uint n = offsets_[ index + 1 ] - offset;
+      if( n > 0 ) {
+         out[ index ] = RotatingCalipersKernel( x_.data() + offset, y_.data() + offset, n );
+      }
+   }
+   return out;
+}
 
-   return feret;
+void ComputeRotatingCalipers( std::vector< ConvexHull >& convexHulls ) {
+   dip::uint nVertices = 0;
+   for( auto const& hull : convexHulls ) {
+      nVertices += hull.Vertices().size();
+   }
+   ConvexHullBatch batch;
+   batch.Reserve( convexHulls.size(), nVertices );
+   for( auto const& hull : convexHulls ) {
+      batch.Add( hull );
+   }
+   std::vector< CaliperValues > values = batch.RotatingCalipers();
+   for( dip::uint ii = 0; ii < convexHulls.size(); ++ii ) {
+      convexHulls[ ii ].calipers_ = values[ ii ];
+      convexHulls[ ii ].hasCalipers_ = true;
+   }
 }
 
 
@@ -194,4 +286,42 @@ DOCTEST_TEST_CASE("[DIPlib] testing chain code polygons") {
    DOCTEST_CHECK( h.IsClockWise() );
 }
 
+DOCTEST_TEST_CASE("[DIPlib] testing rotating calipers") {
+   dip::ChainCode cc;
+   cc.codes = { 0, 6, 4, 2 }; // A chain code that is a little square.
+   dip::ConvexHull h = cc.Polygon().ConvexHull();
+   auto f = h.Feret();
+   auto c = h.RotatingCalipers();
+   DOCTEST_CHECK( c.feret.maxDiameter == doctest::Approx( f.maxDiameter ));
+   DOCTEST_CHECK( c.feret.minDiameter == doctest::Approx( f.minDiameter ));
+   DOCTEST_CHECK( c.feret.maxPerpendicular == doctest::Approx( f.maxPerpendicular ));
+
+   // A 4x2 rectangle rotated by 30 degrees, with an extra vertex cut off one corner
+   dip::dfloat cos = std::cos( dip::pi / 6 );
+   dip::dfloat sin = std::sin( dip::pi / 6 );
+   auto rot = [ & ]( dip::dfloat x, dip::dfloat y ) { return dip::VertexFloat{ 10 + x * cos - y * sin, 5 + x * sin + y * cos }; };
+   dip::Polygon p;
+   p.vertices = { rot( 0, 0 ), rot( 0, 2 ), rot( 3.9, 2 ), rot( 4, 1.9 ), rot( 4, 0 ) };
+   h = p.ConvexHull();
+   c = h.RotatingCalipers();
+   f = h.Feret();
+   DOCTEST_CHECK( c.feret.maxDiameter == doctest::Approx( f.maxDiameter ));
+   DOCTEST_CHECK( c.feret.minDiameter == doctest::Approx( 2 ));
+   DOCTEST_CHECK( c.feret.maxPerpendicular == doctest::Approx( 4 ));
+   DOCTEST_CHECK( c.minAreaRectangle.length == doctest::Approx( 4 ));
+   DOCTEST_CHECK( c.minAreaRectangle.width == doctest::Approx( 2 ));
+   DOCTEST_CHECK( c.minAreaRectangle.angle == doctest::Approx( dip::pi / 6 ));
+   DOCTEST_CHECK( c.minPerimeterRectangle.Perimeter() == doctest::Approx( 12 ));
+
+   dip::ConvexHullBatch batch;
+   batch.Add( cc.Polygon().ConvexHull() );
+   batch.Add( h );
+   batch.Add( dip::ConvexHull{} );
+   auto values = batch.RotatingCalipers();
+   DOCTEST_REQUIRE( values.size() == 3 );
+   DOCTEST_CHECK( values[ 1 ].feret.maxDiameter == c.feret.maxDiameter );
+   DOCTEST_CHECK( values[ 1 ].minAreaRectangle.Area() == c.minAreaRectangle.Area() );
+   DOCTEST_CHECK( values[ 2 ].feret.maxDiameter == 0.0 );
+}
+
 #endif // DIP__ENABLE_DOCTEST
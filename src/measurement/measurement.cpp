@@ -175,6 +175,196 @@ void WriteCSV(
    file.close(); // Not really necessary, but we're used to it...
 }
 
+namespace {
+
+constexpr char columnarMagic[ 8 ] = { 'D', 'I', 'P', 'M', 'S', 'R', '\0', '\1' };
+constexpr std::uint64_t columnarByteOrderMark = 0x0102030405060708u;
+constexpr dip::uint columnarAlignment = 64;
+
+void WriteUInt64( std::ostream& file, std::uint64_t value ) {
+   file.write( reinterpret_cast< char const* >( &value ), sizeof( value ));
+}
+
+void WriteString( std::ostream& file, String const& string ) {
+   WriteUInt64( file, string.size() );
+   file.write( string.data(), static_cast< std::streamsize >( string.size() ));
+}
+
+std::uint64_t ReadUInt64( std::istream& file ) {
+   std::uint64_t value = 0;
+   file.read( reinterpret_cast< char* >( &value ), sizeof( value ));
+   DIP_THROW_IF( !file, "Error reading columnar measurement file" );
+   return value;
+}
+
+// The number of bytes in `file` after the current read position, `fileSize` is the size of the file
+dip::uint RemainingBytes( std::istream& file, dip::uint fileSize ) {
+   auto pos = file.tellg();
+   DIP_THROW_IF( !file || ( pos < 0 ) || ( static_cast< dip::uint >( pos ) > fileSize ), "Error reading columnar measurement file" );
+   return fileSize - static_cast< dip::uint >( pos );
+}
+
+String ReadString( std::istream& file, dip::uint fileSize ) {
+   std::uint64_t length = ReadUInt64( file );
+   DIP_THROW_IF( length > RemainingBytes( file, fileSize ), "Columnar measurement file is corrupt" );
+   String string( length, '\0' );
+   file.read( &string[ 0 ], static_cast< std::streamsize >( length ));
+   DIP_THROW_IF( !file, "Error reading columnar measurement file" );
+   return string;
+}
+
+} // namespace
+
+void WriteColumnar(
+      Measurement const& msr,
+      String const& filename
+) {
+   DIP_THROW_IF( !msr.IsForged(), E::MEASUREMENT_NOT_FORGED );
+   std::ofstream file( filename, std::ios_base::trunc | std::ios_base::binary );
+   DIP_THROW_IF( !file.is_open(), "Could not open file for writing" );
+   dip::uint nObjects = msr.NumberOfObjects();
+   dip::uint nValues = msr.NumberOfValues();
+   // Header
+   file.write( columnarMagic, sizeof( columnarMagic ));
+   WriteUInt64( file, columnarByteOrderMark );
+   WriteUInt64( file, nObjects );
+   WriteUInt64( file, msr.NumberOfFeatures() );
+   WriteUInt64( file, nValues );
+   auto offsetPos = file.tellp();
+   WriteUInt64( file, 0 ); // We'll fill in the data offset later
+   // Feature table
+   for( auto const& feature : msr.Features() ) {
+      WriteString( file, feature.name );
+      WriteUInt64( file, feature.numberValues );
+   }
+   for( auto const& value : msr.Values() ) {
+      WriteString( file, value.name );
+      WriteString( file, value.units.String() );
+   }
+   // Padding
+   dip::uint offset = static_cast< dip::uint >( file.tellp() );
+   dip::uint padding = ( columnarAlignment - offset % columnarAlignment ) % columnarAlignment;
+   for( dip::uint ii = 0; ii < padding; ++ii ) {
+      file.put( '\0' );
+   }
+   offset += padding;
+   // Object IDs
+   std::vector< std::uint64_t > ids( msr.Objects().begin(), msr.Objects().end() );
+   file.write( reinterpret_cast< char const* >( ids.data() ), static_cast< std::streamsize >( nObjects * sizeof( std::uint64_t )));
+   // Columns: we gather each column into a buffer, so that we write contiguous blocks to the file
+   std::vector< Measurement::ValueType > buffer( nObjects );
+   Measurement::ValueIterator data = msr.Data();
+   dip::sint stride = msr.Stride();
+   for( dip::uint ii = 0; ii < nValues; ++ii ) {
+      Measurement::ValueIterator src = data + ii;
+      for( auto& v : buffer ) {
+         v = *src;
+         src += stride;
+      }
+      file.write( reinterpret_cast< char const* >( buffer.data() ), static_cast< std::streamsize >( nObjects * sizeof( Measurement::ValueType )));
+   }
+   // Fill in data offset
+   file.seekp( offsetPos );
+   WriteUInt64( file, offset );
+   DIP_THROW_IF( !file, "Error writing columnar measurement file" );
+   file.close();
+}
+
+Measurement ReadColumnar(
+      String const& filename,
+      StringArray const& features
+) {
+   std::ifstream file( filename, std::ios_base::binary );
+   DIP_THROW_IF( !file.is_open(), "Could not open file for reading" );
+   // All sizes read from the file are checked against the file size before we allocate memory for them
+   file.seekg( 0, std::ios_base::end );
+   auto end = file.tellg();
+   DIP_THROW_IF( !file || ( end < 0 ), "Error reading columnar measurement file" );
+   dip::uint fileSize = static_cast< dip::uint >( end );
+   file.seekg( 0 );
+   // Header
+   char magic[ sizeof( columnarMagic ) ];
+   file.read( magic, sizeof( magic ));
+   DIP_THROW_IF( !file || !std::equal( magic, magic + sizeof( magic ), columnarMagic ), "File is not a columnar measurement file" );
+   DIP_THROW_IF( ReadUInt64( file ) != columnarByteOrderMark, "Columnar measurement file has a different byte order" );
+   dip::uint nObjects = ReadUInt64( file );
+   dip::uint nFeatures = ReadUInt64( file );
+   dip::uint nValues = ReadUInt64( file );
+   dip::uint offset = ReadUInt64( file );
+   // Each feature takes at least 16 bytes in the feature table, and each value 32 bytes. The object IDs and the
+   // columns take `nObjects * 8` bytes each, after `offset`.
+   dip::uint remaining = RemainingBytes( file, fileSize );
+   DIP_THROW_IF(( nFeatures > remaining / 16 ) || ( nValues > remaining / 32 ) || ( nFeatures > nValues ),
+                "Columnar measurement file is corrupt" );
+   DIP_THROW_IF(( offset > fileSize ) || ( nObjects > ( fileSize - offset ) / sizeof( std::uint64_t ) / ( nValues + 1 )),
+                "Columnar measurement file is truncated" );
+   // Feature table
+   std::vector< Measurement::FeatureInformation > featureInfo;
+   featureInfo.reserve( nFeatures );
+   dip::uint column = 0;
+   for( dip::uint ii = 0; ii < nFeatures; ++ii ) {
+      String name = ReadString( file, fileSize );
+      dip::uint n = ReadUInt64( file );
+      DIP_THROW_IF( n > nValues - column, "Columnar measurement file is corrupt" );
+      featureInfo.emplace_back( std::move( name ), column, n );
+      column += n;
+   }
+   DIP_THROW_IF( column != nValues, "Columnar measurement file is corrupt" );
+   Feature::ValueInformationArray values( nValues );
+   for( auto& value : values ) {
+      value.name = ReadString( file, fileSize );
+      value.units = Units( ReadString( file, fileSize ));
+   }
+   DIP_THROW_IF( offset < fileSize - RemainingBytes( file, fileSize ), "Columnar measurement file is corrupt" );
+   // Select features
+   Measurement msr;
+   std::vector< dip::uint > columns; // the columns in the file that we read, in the order they appear in `msr`
+   auto addFeature = [ & ]( Measurement::FeatureInformation const& f ) {
+      auto b = values.begin() + static_cast< dip::sint >( f.startColumn );
+      msr.AddFeature( f.name, Feature::ValueInformationArray( b, b + static_cast< dip::sint >( f.numberValues )));
+      for( dip::uint jj = 0; jj < f.numberValues; ++jj ) {
+         columns.push_back( f.startColumn + jj );
+      }
+   };
+   if( features.empty() ) {
+      for( auto const& f : featureInfo ) {
+         addFeature( f );
+      }
+   } else {
+      for( auto const& name : features ) {
+         auto it = std::find_if( featureInfo.begin(), featureInfo.end(),
+                                 [ & ]( Measurement::FeatureInformation const& f ) { return f.name == name; } );
+         DIP_THROW_IF( it == featureInfo.end(), "Feature not present: " + name );
+         addFeature( *it );
+      }
+   }
+   // Object IDs
+   file.seekg( static_cast< std::streamoff >( offset ));
+   std::vector< std::uint64_t > ids( nObjects );
+   file.read( reinterpret_cast< char* >( ids.data() ), static_cast< std::streamsize >( nObjects * sizeof( std::uint64_t )));
+   DIP_THROW_IF( !file, "Error reading columnar measurement file" );
+   UnsignedArray objectIDs( nObjects );
+   std::copy( ids.begin(), ids.end(), objectIDs.begin() );
+   msr.AddObjectIDs( objectIDs );
+   msr.Forge();
+   // Columns
+   std::vector< Measurement::ValueType > buffer( nObjects );
+   Measurement::ValueIterator data = msr.Data();
+   dip::sint stride = msr.Stride();
+   for( dip::uint ii = 0; ii < columns.size(); ++ii ) {
+      dip::uint pos = offset + ( columns[ ii ] + 1 ) * nObjects * sizeof( Measurement::ValueType );
+      file.seekg( static_cast< std::streamoff >( pos ));
+      file.read( reinterpret_cast< char* >( buffer.data() ), static_cast< std::streamsize >( nObjects * sizeof( Measurement::ValueType )));
+      DIP_THROW_IF( !file, "Error reading columnar measurement file" );
+      Measurement::ValueIterator dest = data + ii;
+      for( auto v : buffer ) {
+         *dest = v;
+         dest += stride;
+      }
+   }
+   return msr;
+}
+
 Measurement operator+( Measurement const& lhs, Measurement const& rhs ) {
    DIP_THROW_IF( !lhs.IsForged() || !rhs.IsForged(), E::MEASUREMENT_NOT_FORGED );
    constexpr dip::uint NOT_THERE = std::numeric_limits< dip::uint >::max();
@@ -383,6 +573,8 @@ StatisticsAccumulator SampleStatistics( Measurement::IteratorFeature const& feat
 
 
 #ifdef DIP__ENABLE_DOCTEST
+#include <cstdio>
+#include <cstring>
 #include "doctest.h"
 
 DOCTEST_TEST_CASE( "[DIPlib] testing dip::Measurement" ) {
@@ -569,6 +761,58 @@ DOCTEST_TEST_CASE( "[DIPlib] testing dip::Measurement" ) {
    DOCTEST_CHECK( objIt[ "Feature3" ][ 1 ] == ( 23 - 15 ) * 5 + 103 );
    DOCTEST_CHECK( objIt[ "Feature3" ][ 2 ] == ( 23 - 15 ) * 5 + 104 );
 
+   // Check writing and reading columnar files
+
+   dip::WriteColumnar( res, "test_msr.dipmsr" );
+   auto res2 = dip::ReadColumnar( "test_msr.dipmsr" );
+   DOCTEST_REQUIRE( res2.IsForged() );
+   DOCTEST_CHECK( res2.NumberOfObjects() == 15 );
+   DOCTEST_CHECK( res2.NumberOfFeatures() == 3 );
+   DOCTEST_CHECK( res2.NumberOfValues() == 6 );
+   DOCTEST_CHECK( res2.Values()[ 3 ].name == "Foo" );
+   DOCTEST_CHECK( res2.Values()[ 3 ].units == dip::Units::SquareMeter() );
+   objIt = res2[ 18 ];
+   DOCTEST_CHECK( objIt[ "Feature1" ][ 1 ] == ( 18 - 10 ) * 3 + 1 );
+   DOCTEST_CHECK( objIt[ "Feature3" ][ 2 ] == ( 18 - 15 ) * 5 + 104 );
+   objIt = res2[ 13 ];
+   DOCTEST_CHECK( std::isnan( objIt[ "Feature3" ][ 0 ] ));
+
+   res2 = dip::ReadColumnar( "test_msr.dipmsr", { "Feature3" } );
+   DOCTEST_CHECK( res2.NumberOfObjects() == 15 );
+   DOCTEST_CHECK( res2.NumberOfFeatures() == 1 );
+   DOCTEST_CHECK( res2.NumberOfValues() == 3 );
+   DOCTEST_CHECK( res2[ 23 ][ "Feature3" ][ 1 ] == ( 23 - 15 ) * 5 + 103 );
+
+   // Corrupt files must throw, not allocate whatever size the file claims
+   std::string contents;
+   {
+      std::ifstream file( "test_msr.dipmsr", std::ios_base::binary );
+      contents.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+   }
+   auto writeCorrupt = [ & ]( std::string const& data ) {
+      std::ofstream file( "test_msr_corrupt.dipmsr", std::ios_base::trunc | std::ios_base::binary );
+      file.write( data.data(), static_cast< std::streamsize >( data.size() ));
+   };
+   auto setUInt64 = [ & ]( dip::uint pos, std::uint64_t value ) {
+      std::string data = contents;
+      std::memcpy( &data[ pos ], &value, sizeof( value ));
+      return data;
+   };
+   writeCorrupt( contents.substr( 0, contents.size() - 8 )); // truncated
+   DOCTEST_CHECK_THROWS( dip::ReadColumnar( "test_msr_corrupt.dipmsr" ));
+   writeCorrupt( setUInt64( 16, std::uint64_t( 1 ) << 60 )); // number of objects
+   DOCTEST_CHECK_THROWS( dip::ReadColumnar( "test_msr_corrupt.dipmsr" ));
+   writeCorrupt( setUInt64( 24, std::uint64_t( 1 ) << 60 )); // number of features
+   DOCTEST_CHECK_THROWS( dip::ReadColumnar( "test_msr_corrupt.dipmsr" ));
+   writeCorrupt( setUInt64( 32, std::uint64_t( 1 ) << 60 )); // number of values
+   DOCTEST_CHECK_THROWS( dip::ReadColumnar( "test_msr_corrupt.dipmsr" ));
+   writeCorrupt( setUInt64( 40, std::uint64_t( 1 ) << 60 )); // data offset
+   DOCTEST_CHECK_THROWS( dip::ReadColumnar( "test_msr_corrupt.dipmsr" ));
+   writeCorrupt( setUInt64( 48, std::uint64_t( 1 ) << 60 )); // length of the first feature name
+   DOCTEST_CHECK_THROWS( dip::ReadColumnar( "test_msr_corrupt.dipmsr" ));
+
+   std::remove( "test_msr.dipmsr" );
+   std::remove( "test_msr_corrupt.dipmsr" );
 }
 
 #endif // DIP__ENABLE_DOCTEST
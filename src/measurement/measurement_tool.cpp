@@ -34,7 +34,9 @@
 #include "feature_cartesian_box.h"
 #include "feature_perimeter.h"
 #include "feature_surface_area.h"
+#include "feature_minkowski_functionals.h"
 #include "feature_feret.h"
+#include "feature_bounding_rectangle.h"
 #include "feature_convex_area.h"
 #include "feature_convex_perimeter.h"
 // Shape
@@ -83,7 +85,10 @@ MeasurementTool::MeasurementTool() {
    Register( new Feature::FeatureCartesianBox );
    Register( new Feature::FeaturePerimeter );
    Register( new Feature::FeatureSurfaceArea );
+   Register( new Feature::FeatureMinkowskiFunctionals );
    Register( new Feature::FeatureFeret );
+   Register( new Feature::FeatureBoundingRectangle( Feature::FeatureBoundingRectangle::Criterion::MIN_AREA ));
+   Register( new Feature::FeatureBoundingRectangle( Feature::FeatureBoundingRectangle::Criterion::MIN_PERIMETER ));
    Register( new Feature::FeatureSolidArea );
    Register( new Feature::FeatureConvexArea );
    Register( new Feature::FeatureConvexPerimeter );
@@ -149,52 +154,94 @@ class MeasureLineFilter : public Framework::ScanLineFilter {
             );
          }
 
+         UnsignedArray position = params.position;
+         if( !origin.empty() ) {
+            position += origin;
+         }
          for( auto const& feature : features ) {
             // NOTE! params.dimension here works as long as params.tensorToSpatial is false.
             // As is now, MeasurementTool::Measure only works with scalar images, so we don't need to test here.
-            feature->ScanLine( label, grey, params.position, params.dimension, objectIndices );
+            feature->ScanLine( label, grey, position, params.dimension, objectIndices );
          }
       }
-      MeasureLineFilter( LineBasedFeatureArray const& features, ObjectIdToIndexMap const& objectIndices ) :
-            features( features ), objectIndices( objectIndices ) {}
+      MeasureLineFilter( LineBasedFeatureArray const& features, ObjectIdToIndexMap const& objectIndices, UnsignedArray const& origin ) :
+            features( features ), objectIndices( objectIndices ), origin( origin ) {}
    private:
       LineBasedFeatureArray const& features;
       ObjectIdToIndexMap const& objectIndices;
+      UnsignedArray const& origin; // added to the coordinates, for when we're measuring a slab of a larger image
 };
 
-} // namespace
-
-Measurement MeasurementTool::Measure(
-      Image const& label,
-      Image const& grey,
-      StringArray features, // copy
-      UnsignedArray const& objectIDs,
-      dip::uint connectivity
-) const {
-
-   // Check input
+void CheckInputImages( Image const& label, Image const& grey ) {
    DIP_THROW_IF( !label.IsScalar(), E::IMAGE_NOT_SCALAR );
    DIP_THROW_IF( !label.DataType().IsUInt(), E::DATA_TYPE_NOT_SUPPORTED );
    if( grey.IsForged() ) {
       DIP_THROW_IF( !grey.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
       DIP_STACK_TRACE_THIS( grey.CompareProperties( label, Option::CmpProp::Sizes ));
    }
+}
 
-   Measurement measurement;
-
-   // Fill out the object IDs
-   if( objectIDs.empty() ) {
-      measurement.AddObjectIDs( GetObjectLabels( label, Image{}, S::EXCLUDE ));
-   } else {
-      measurement.AddObjectIDs( objectIDs );
+// Calls dip::Feature::LineBased::ScanLine() for each image line
+void ScanLineBased(
+      Image const& label,
+      Image const& grey,
+      LineBasedFeatureArray const& lineBasedFeatures,
+      ObjectIdToIndexMap const& objectIndices,
+      UnsignedArray const& origin
+) {
+   // Create arrays for Scan framework
+   ImageConstRefArray inar{ label };
+   DataTypeArray inBufT{ DT_UINT32 };
+   if( grey.IsForged() ) {
+      inar.emplace_back( grey );
+      inBufT.push_back( DT_DFLOAT );
    }
-   if( measurement.NumberOfObjects() == 0 ) {
-      // There's no objects to be measured. We're done.
-      // TODO: throw?
-      return measurement;
+   ImageRefArray outar{};
+
+   // Do the scan, which calls dip::Feature::LineBased::ScanLine()
+   MeasureLineFilter functor{ lineBasedFeatures, objectIndices, origin };
+   Framework::Scan( inar, outar, inBufT, {}, {}, {}, functor,
+         Framework::ScanOption::NoMultiThreading + Framework::ScanOption::NeedCoordinates );
+}
+
+// Calls dip::Feature::LineBased::Finish() for each object
+void FinishLineBased(
+      LineBasedFeatureArray const& lineBasedFeatures,
+      Measurement& measurement
+) {
+   for( auto const& feature : lineBasedFeatures ) {
+      Measurement::IteratorFeature column = measurement[ feature->information.name ];
+      Measurement::IteratorFeature::Iterator it = column.FirstObject();
+      do {
+         feature->Finish( it.ObjectIndex(), it.data() );
+      } while( ++it );
    }
+}
 
-   // Parse the features array and prepare measurements
+// Calls dip::Feature::Composite::Compose() for each object
+void ComposeFeatures(
+      FeatureArray const& featureArray,
+      Measurement& measurement
+) {
+   Measurement::IteratorObject row = measurement.FirstObject(); // these two arrays are ordered the same way
+   do {
+      for( auto const& feature : featureArray ) {
+         if( feature->type == Feature::Type::COMPOSITE ) {
+            auto cell = row[ feature->information.name ];
+            dynamic_cast< Feature::Composite* >( feature )->Compose( row, cell.data() );
+         }
+      }
+   } while( ++row );
+}
+
+} // namespace
+
+FeatureArray MeasurementTool::PrepareFeatures(
+      StringArray& features,
+      Image const& label,
+      Image const& grey,
+      Measurement& measurement
+) const {
    DIP_THROW_IF( features.empty(), "No features given" );
    FeatureArray featureArray;
    featureArray.reserve( features.size() );
@@ -220,6 +267,36 @@ Measurement MeasurementTool::Measure(
       }
       ++ii;
    }
+   return featureArray;
+}
+
+Measurement MeasurementTool::Measure(
+      Image const& label,
+      Image const& grey,
+      StringArray features, // copy
+      UnsignedArray const& objectIDs,
+      dip::uint connectivity
+) const {
+
+   // Check input
+   CheckInputImages( label, grey );
+
+   Measurement measurement;
+
+   // Fill out the object IDs
+   if( objectIDs.empty() ) {
+      measurement.AddObjectIDs( GetObjectLabels( label, Image{}, S::EXCLUDE ));
+   } else {
+      measurement.AddObjectIDs( objectIDs );
+   }
+   if( measurement.NumberOfObjects() == 0 ) {
+      // There's no objects to be measured. We're done.
+      // TODO: throw?
+      return measurement;
+   }
+
+   // Parse the features array and prepare measurements
+   FeatureArray featureArray = PrepareFeatures( features, label, grey, measurement );
 
    // Allocate memory for all features and objects
    measurement.Forge();
@@ -231,6 +308,7 @@ Measurement MeasurementTool::Measure(
    bool doChaincodeBased = false;
    bool doPolygonBased = false;
    bool doConvHullBased = false;
+   bool doRotatingCalipers = false;
    bool doComposite = false;
    for( auto const& feature : featureArray ) {
       switch( feature->type ) {
@@ -249,6 +327,9 @@ Measurement MeasurementTool::Measure(
             break;
          case Feature::Type::CONVEXHULL_BASED:
             doConvHullBased = true;
+            if( dynamic_cast< Feature::ConvexHullBased* >( feature )->UsesRotatingCalipers() ) {
+               doRotatingCalipers = true;
+            }
             break;
          case Feature::Type::COMPOSITE:
             doComposite = true;
@@ -259,28 +340,8 @@ Measurement MeasurementTool::Measure(
    // Let the line based functions do their work
    if( doLineBased ) {
 
-      // Create arrays for Scan framework
-      ImageConstRefArray inar{ label };
-      DataTypeArray inBufT{ DT_UINT32 };
-      if( grey.IsForged() ) {
-         inar.emplace_back( grey );
-         inBufT.push_back( DT_DFLOAT );
-      }
-      ImageRefArray outar{};
-
-      // Do the scan, which calls dip::Feature::LineBased::ScanLine()
-      MeasureLineFilter functor{ lineBasedFeatures, measurement.ObjectIndices() };
-      Framework::Scan( inar, outar, inBufT, {}, {}, {}, functor,
-            Framework::ScanOption::NoMultiThreading + Framework::ScanOption::NeedCoordinates );
-
-      // Call dip::Feature::LineBased::Finish()
-      for( auto const& feature : lineBasedFeatures ) {
-         Measurement::IteratorFeature column = measurement[ feature->information.name ];
-         Measurement::IteratorFeature::Iterator it = column.FirstObject();
-         do {
-            feature->Finish( it.ObjectIndex(), it.data() );
-         } while( ++it );
-      }
+      ScanLineBased( label, grey, lineBasedFeatures, measurement.ObjectIndices(), {} );
+      FinishLineBased( lineBasedFeatures, measurement );
    }
 
    // Let the image based functions do their work
@@ -296,17 +357,31 @@ Measurement MeasurementTool::Measure(
    // Let the chaincode based functions do their work
    if( doChaincodeBased || doPolygonBased || doConvHullBased ) {
       ChainCodeArray chainCodeArray = GetImageChainCodes( label, measurement.Objects(), connectivity );
+      // The convex hulls are computed first, so that the rotating calipers can be computed for all objects at once.
+      // The results are stored in the convex hulls, and shared by all features that use them.
+      std::vector< ConvexHull > convexHulls;
+      if( doRotatingCalipers ) {
+         convexHulls.reserve( chainCodeArray.size() );
+         for( auto const& chainCode : chainCodeArray ) {
+            convexHulls.push_back( chainCode.ConvexHull() );
+         }
+         ComputeRotatingCalipers( convexHulls );
+      }
       auto itCC = chainCodeArray.begin();
       auto itObj = measurement.FirstObject(); // these two arrays are ordered the same way
+      dip::uint index = 0;
       do {
          Polygon polygon;
          ConvexHull convexHull;
-         if( doPolygonBased || doConvHullBased ) {
+         if( doPolygonBased || ( doConvHullBased && !doRotatingCalipers )) {
             polygon = itCC->Polygon();
          }
-         if( doConvHullBased ) {
+         if( doRotatingCalipers ) {
+            convexHull = std::move( convexHulls[ index ] );
+         } else if( doConvHullBased ) {
             convexHull = polygon.ConvexHull();
          }
+         ++index;
          for( auto const& feature : featureArray ) {
             if( feature->type == Feature::Type::CHAINCODE_BASED ) {
                auto cell = itObj[ feature->information.name ];
@@ -324,15 +399,7 @@ Measurement MeasurementTool::Measure(
 
    // Let the composite functions do their work
    if( doComposite ) {
-      Measurement::IteratorObject row = measurement.FirstObject(); // these two arrays are ordered the same way
-      do {
-         for( auto const& feature : featureArray ) {
-            if( feature->type == Feature::Type::COMPOSITE ) {
-               auto cell = row[ feature->information.name ];
-               dynamic_cast< Feature::Composite* >( feature )->Compose( row, cell.data() );
-            }
-         }
-      } while( ++row );
+      ComposeFeatures( featureArray, measurement );
    }
 
    // Clean up
@@ -343,4 +410,271 @@ Measurement MeasurementTool::Measure(
    return measurement;
 }
 
+MeasurementTool::IncrementalMeasurement::IncrementalMeasurement( IncrementalMeasurement&& other ) noexcept :
+      tool_( other.tool_ ),
+      featureNames_( std::move( other.featureNames_ )),
+      objectIDs_( std::move( other.objectIDs_ )),
+      measurement_( std::move( other.measurement_ )),
+      featureArray_( std::move( other.featureArray_ )),
+      lineBasedFeatures_( std::move( other.lineBasedFeatures_ )),
+      nDims_( other.nDims_ ),
+      hasGrey_( other.hasGrey_ ),
+      finished_( other.finished_ ) {
+   // The moved-from object no longer owns the features' state
+   other.featureArray_.clear();
+   other.lineBasedFeatures_.clear();
+   other.finished_ = true;
+}
+
+MeasurementTool::IncrementalMeasurement& MeasurementTool::IncrementalMeasurement::operator=( IncrementalMeasurement&& other ) noexcept {
+   if( this != &other ) {
+      Release();
+      tool_ = other.tool_;
+      featureNames_ = std::move( other.featureNames_ );
+      objectIDs_ = std::move( other.objectIDs_ );
+      measurement_ = std::move( other.measurement_ );
+      featureArray_ = std::move( other.featureArray_ );
+      lineBasedFeatures_ = std::move( other.lineBasedFeatures_ );
+      nDims_ = other.nDims_;
+      hasGrey_ = other.hasGrey_;
+      finished_ = other.finished_;
+      other.featureArray_.clear();
+      other.lineBasedFeatures_.clear();
+      other.finished_ = true;
+   }
+   return *this;
+}
+
+MeasurementTool::IncrementalMeasurement::~IncrementalMeasurement() {
+   Release();
+}
+
+void MeasurementTool::IncrementalMeasurement::Release() noexcept {
+   if( !finished_ ) {
+      for( auto const& feature : featureArray_ ) {
+         try {
+            feature->Cleanup();
+         } catch( ... ) {} // never throw from a destructor
+      }
+      featureArray_.clear();
+      lineBasedFeatures_.clear();
+      finished_ = true;
+   }
+}
+
+void MeasurementTool::IncrementalMeasurement::Scan(
+      Image const& label,
+      Image const& grey,
+      UnsignedArray const& origin
+) {
+   DIP_THROW_IF( finished_, "Incremental measurement already finished" );
+   DIP_THROW_IF( !label.IsForged(), E::IMAGE_NOT_FORGED );
+   CheckInputImages( label, grey );
+   DIP_THROW_IF( origin.size() != label.Dimensionality(), E::ARRAY_PARAMETER_WRONG_LENGTH );
+
+   if( !measurement_.IsForged() ) {
+      // First slab: prepare the measurement
+      nDims_ = label.Dimensionality();
+      hasGrey_ = grey.IsForged();
+      measurement_.AddObjectIDs( objectIDs_ );
+      DIP_STACK_TRACE_THIS( featureArray_ = tool_->PrepareFeatures( featureNames_, label, grey, measurement_ ));
+      for( auto const& feature : featureArray_ ) {
+         switch( feature->type ) {
+            case Feature::Type::LINE_BASED:
+               lineBasedFeatures_.emplace_back( dynamic_cast< Feature::LineBased* >( feature ));
+               break;
+            case Feature::Type::COMPOSITE:
+               break;
+            default:
+               Release();
+               DIP_THROW( "Feature cannot be measured incrementally: " + feature->information.name );
+         }
+      }
+      measurement_.Forge();
+   } else {
+      DIP_THROW_IF( label.Dimensionality() != nDims_, E::DIMENSIONALITIES_DONT_MATCH );
+      DIP_THROW_IF( grey.IsForged() != hasGrey_, "Grey-value image must be given for all slabs or for none" );
+   }
+
+   if( !lineBasedFeatures_.empty() ) {
+      ScanLineBased( label, grey, lineBasedFeatures_, measurement_.ObjectIndices(), origin );
+   }
+}
+
+Measurement MeasurementTool::IncrementalMeasurement::Finish() {
+   DIP_THROW_IF( finished_, "Incremental measurement already finished" );
+   DIP_THROW_IF( !measurement_.IsForged(), "No image slabs were measured" );
+   FinishLineBased( lineBasedFeatures_, measurement_ );
+   ComposeFeatures( featureArray_, measurement_ );
+   Release();
+   return std::move( measurement_ );
+}
+
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/generation.h"
+#include "diplib/random.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing dip::MeasurementTool::MeasureIncremental" ) {
+   dip::Image label( { 20, 15, 12 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   label.At( dip::Range{ 2, 8 }, dip::Range{ 3, 10 }, dip::Range{ 1, 10 } ) = 1;
+   label.At( dip::Range{ 10, 18 }, dip::Range{ 1, 5 }, dip::Range{ 4, 6 } ) = 2;
+   label.At( dip::Range{ 12, 15 }, dip::Range{ 8, 14 }, dip::Range{ 7, 11 } ) = 3;
+   dip::Image grey( label.Sizes(), 1, dip::DT_SFLOAT );
+   grey.Fill( 0 );
+   dip::Random random( 0 );
+   grey = dip::UniformNoise( grey, random );
+
+   dip::MeasurementTool tool;
+   dip::StringArray features{ "Size", "Center", "Mean", "Inertia", "Maximum" };
+   dip::UnsignedArray objectIDs{ 1, 2, 3 };
+   dip::Measurement reference = tool.Measure( label, grey, features, objectIDs );
+
+   auto incremental = tool.MeasureIncremental( features, objectIDs );
+   for( dip::uint z = 0; z < 12; z += 5 ) {
+      dip::sint last = static_cast< dip::sint >( std::min< dip::uint >( z + 5, 12 )) - 1;
+      dip::Range zRange{ static_cast< dip::sint >( z ), last };
+      dip::Image labelSlab = label.At( dip::Range{}, dip::Range{}, zRange );
+      dip::Image greySlab = grey.At( dip::Range{}, dip::Range{}, zRange );
+      incremental.Scan( labelSlab, greySlab, { 0, 0, z } );
+   }
+   dip::Measurement result = incremental.Finish();
+
+   DOCTEST_REQUIRE( result.NumberOfObjects() == reference.NumberOfObjects() );
+   DOCTEST_REQUIRE( result.NumberOfValues() == reference.NumberOfValues() );
+   for( dip::uint ii = 0; ii < result.NumberOfObjects() * result.NumberOfValues(); ++ii ) {
+      DOCTEST_CHECK( result.Data()[ ii ] == doctest::Approx( reference.Data()[ ii ] ));
+   }
+
+   incremental = tool.MeasureIncremental( { "Perimeter" }, objectIDs );
+   DOCTEST_CHECK_THROWS( incremental.Scan( label, {}, { 0, 0, 0 } ));
+
+   // Moving transfers the state, destroying an unfinished object releases the tool
+   {
+      auto partial = tool.MeasureIncremental( features, objectIDs );
+      partial.Scan( label.At( dip::Range{}, dip::Range{}, dip::Range{ 0, 4 } ),
+                    grey.At( dip::Range{}, dip::Range{}, dip::Range{ 0, 4 } ), { 0, 0, 0 } );
+      auto moved = std::move( partial );
+      DOCTEST_CHECK_THROWS( partial.Finish() );
+      moved.Scan( label.At( dip::Range{}, dip::Range{}, dip::Range{ 5, -1 } ),
+                  grey.At( dip::Range{}, dip::Range{}, dip::Range{ 5, -1 } ), { 0, 0, 5 } );
+   }
+   result = tool.Measure( label, grey, features, objectIDs );
+   for( dip::uint ii = 0; ii < result.NumberOfObjects() * result.NumberOfValues(); ++ii ) {
+      DOCTEST_CHECK( result.Data()[ ii ] == doctest::Approx( reference.Data()[ ii ] ));
+   }
+}
+
+namespace {
+
+// The algorithm used by `dip::ConvexHull::Feret` before it was replaced by the rotating calipers
+// (Preparata and Shamos' enumeration of antipodal pairs), used as the reference in the test below.
+dip::FeretValues ReferenceFeret( dip::ConvexHull const& convexHull ) {
+   auto const& vertices = convexHull.Vertices();
+   auto Next = [ & ]( std::vector< dip::VertexFloat >::const_iterator it ) {
+      ++it;
+      return it == vertices.end() ? vertices.begin() : it;
+   };
+   dip::FeretValues feret;
+   auto p = vertices.begin();
+   auto q = p + 1;
+   while( dip::ParallelogramSignedArea( *p, *Next( p ), *Next( q )) > dip::ParallelogramSignedArea( *p, *Next( p ), *q )) {
+      q = Next( q );
+   }
+   auto p0 = vertices.end() - 1;
+   feret.minDiameter = std::numeric_limits< dip::dfloat >::max();
+   auto UpdateMax = [ & ]( dip::VertexFloat const& a, dip::VertexFloat const& b ) {
+      dip::dfloat d = dip::Distance( a, b );
+      if( d > feret.maxDiameter ) {
+         feret.maxDiameter = d;
+         feret.maxAngle = dip::Angle( a, b );
+      }
+   };
+   auto UpdateMin = [ & ]( dip::VertexFloat const& a, dip::VertexFloat const& b, dip::VertexFloat const& c ) {
+      dip::dfloat d = dip::TriangleHeight( a, b, c );
+      if( d < feret.minDiameter ) {
+         feret.minDiameter = d;
+         feret.minAngle = dip::Angle( a, b );
+      }
+   };
+   while( p != p0 ) {
+      ++p;
+      UpdateMax( *p, *q );
+      while( dip::ParallelogramSignedArea( *p, *Next( p ), *Next( q )) > dip::ParallelogramSignedArea( *p, *Next( p ), *q )) {
+         UpdateMin( *q, *Next( q ), *p );
+         q = Next( q );
+         UpdateMax( *p, *q );
+      }
+      if( dip::ParallelogramSignedArea( *p, *Next( p ), *Next( q )) == dip::ParallelogramSignedArea( *p, *Next( p ), *q )) {
+         UpdateMin( *q, *Next( q ), *p );
+         UpdateMax( *p, *Next( q ));
+      }
+   }
+   dip::dfloat cos = std::cos( feret.minAngle );
+   dip::dfloat sin = std::sin( feret.minAngle );
+   dip::dfloat pmin = std::numeric_limits< dip::dfloat >::max();
+   dip::dfloat pmax = std::numeric_limits< dip::dfloat >::lowest();
+   for( auto const& v : vertices ) {
+      dip::dfloat d = v.x * cos + v.y * sin;
+      pmin = std::min( pmin, d );
+      pmax = std::max( pmax, d );
+   }
+   feret.maxPerpendicular = pmax - pmin;
+   return feret;
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE( "[DIPlib] testing the rotating-calipers-based features" ) {
+   // A 4x4 grid of randomly rotated and scaled triangles and quadrilaterals, labeled 1 to 16
+   dip::Image label( { 200, 200 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformRandomGenerator generator( random );
+   for( dip::uint ii = 0; ii < 16; ++ii ) {
+      dip::dfloat cx = 25.0 + 50.0 * static_cast< dip::dfloat >( ii % 4 );
+      dip::dfloat cy = 25.0 + 50.0 * static_cast< dip::dfloat >( ii / 4 );
+      dip::dfloat angle = generator( 0, dip::pi );
+      dip::dfloat cos = std::cos( angle );
+      dip::dfloat sin = std::sin( angle );
+      dip::Polygon polygon;
+      dip::uint nVertices = ii % 2 == 0 ? 3 : 4;
+      for( dip::uint jj = 0; jj < nVertices; ++jj ) {
+         dip::dfloat phi = 2.0 * dip::pi * static_cast< dip::dfloat >( jj ) / static_cast< dip::dfloat >( nVertices );
+         dip::dfloat x = generator( 8, 22 ) * std::cos( phi );
+         dip::dfloat y = generator( 4, 12 ) * std::sin( phi );
+         polygon.vertices.push_back( { cx + x * cos - y * sin, cy + x * sin + y * cos } );
+      }
+      dip::DrawPolygon2D( label, polygon, { ii + 1 } );
+   }
+
+   dip::MeasurementTool tool;
+   dip::Measurement msr = tool.Measure( label, {}, { "Feret", "MinAreaRectangle", "MinPerimeterRectangle" } );
+   DOCTEST_REQUIRE( msr.NumberOfObjects() == 16 );
+   dip::ChainCodeArray chainCodes = dip::GetImageChainCodes( label, msr.Objects() );
+   auto itCC = chainCodes.begin();
+   auto itObj = msr.FirstObject();
+   do {
+      dip::ConvexHull hull = itCC->ConvexHull();
+      dip::FeretValues reference = ReferenceFeret( hull );
+      auto feret = itObj[ "Feret" ];
+      DOCTEST_CHECK( feret[ 0 ] == doctest::Approx( reference.maxDiameter ));
+      DOCTEST_CHECK( feret[ 1 ] == doctest::Approx( reference.minDiameter ));
+      DOCTEST_CHECK( feret[ 2 ] == doctest::Approx( reference.maxPerpendicular ));
+      dip::CaliperValues const& calipers = hull.RotatingCalipers();
+      auto minArea = itObj[ "MinAreaRectangle" ];
+      DOCTEST_CHECK( minArea[ 0 ] == calipers.minAreaRectangle.length );
+      DOCTEST_CHECK( minArea[ 1 ] == calipers.minAreaRectangle.width );
+      DOCTEST_CHECK( minArea[ 2 ] == calipers.minAreaRectangle.angle );
+      auto minPerimeter = itObj[ "MinPerimeterRectangle" ];
+      DOCTEST_CHECK( minPerimeter[ 0 ] == calipers.minPerimeterRectangle.length );
+      DOCTEST_CHECK( minPerimeter[ 1 ] == calipers.minPerimeterRectangle.width );
+      DOCTEST_CHECK( minPerimeter[ 2 ] == calipers.minPerimeterRectangle.angle );
+   } while( ++itCC, ++itObj );
+}
+
+#endif // DIP__ENABLE_DOCTEST
@@ -1,6 +1,6 @@
 /*
  * DIPlib 3.0
- * This file contains the definition for the dip::MeasurementToObject function.
+ * This file contains the definitions for the dip::ObjectToMeasurement functions.
  *
  * (c)2016-2017, Cris Luengo.
  * Based on original DIPlib code: (c)1995-2014, Delft University of Technology.
@@ -19,6 +19,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 
 #include "diplib.h"
 #include "diplib/measurement.h"
@@ -26,26 +27,35 @@
 
 namespace dip {
 
-void ObjectToMeasurement(
-      Image const& label,
-      Image& out,
-      Measurement::IteratorFeature const& featureValues
-) {
-   DIP_THROW_IF( !label.IsScalar(), E::IMAGE_NOT_SCALAR );
-   DIP_THROW_IF( !label.DataType().IsUInt(), E::DATA_TYPE_NOT_SUPPORTED );
-   UnsignedArray const& objects = featureValues.Objects();
-   dip::uint maxObject = *std::max_element( objects.begin(), objects.end() );
-   dip::uint nElements = featureValues.NumberOfValues();
+namespace {
+
+// Paints `out` by mapping each label through `lutIm`, which has one row per object ID. Labels that are not in the
+// table (larger than the largest object ID) are painted with 0, as is the background.
+void PaintObjects( Image const& label, Image& out, Image const& lutIm, DataType defaultType ) {
    bool protect = out.IsProtected();
    if( !protect ) {
-      // If the user didn't protect the output image, we set it to SFLOAT, which is the default output type
-      out.ReForge( label.Sizes(), nElements, DT_SFLOAT );
+      // If the user didn't protect the output image, we set it to the default output type
+      out.ReForge( label.Sizes(), lutIm.TensorElements(), defaultType );
       out.Protect();
    }
-   Image lutIm( { maxObject + 1 }, nElements, DT_DFLOAT );
+   LookupTable lut( lutIm );
+   lut.SetOutOfBoundsValue( 0.0 );
+   lut.Apply( label, out );
+   out.Protect( protect );
+}
+
+// Creates an empty table for the objects in `measurement`, with `nValues` values per object
+Image CreateObjectTable( UnsignedArray const& objects, dip::uint nValues ) {
+   dip::uint maxObject = objects.empty() ? 0 : *std::max_element( objects.begin(), objects.end() );
+   Image lutIm( { maxObject + 1 }, nValues, DT_DFLOAT );
    lutIm.Fill( 0.0 );
    DIP_ASSERT( lutIm.TensorStride() == 1 );
-   dfloat* data = static_cast< dfloat* >( lutIm.Origin() );
+   return lutIm;
+}
+
+// Copies the values of the objects in `featureValues` into `lutIm`, starting at tensor element `firstElement`
+void FillObjectTable( Image& lutIm, Measurement::IteratorFeature const& featureValues, dip::uint firstElement ) {
+   dfloat* data = static_cast< dfloat* >( lutIm.Origin() ) + firstElement;
    dip::sint stride = lutIm.Stride( 0 );
    auto it = featureValues.FirstObject();
    while( it ) {
@@ -53,9 +63,156 @@ void ObjectToMeasurement(
       std::copy( it.begin(), it.end(), dest );
       ++it;
    }
-   LookupTable lut( lutIm );
-   lut.Apply( label, out );
-   out.Protect( protect );
+}
+
+} // namespace
+
+void ObjectToMeasurement(
+      Image const& label,
+      Image& out,
+      Measurement::IteratorFeature const& featureValues
+) {
+   DIP_THROW_IF( !label.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !label.DataType().IsUInt(), E::DATA_TYPE_NOT_SUPPORTED );
+   Image lutIm = CreateObjectTable( featureValues.Objects(), featureValues.NumberOfValues() );
+   FillObjectTable( lutIm, featureValues, 0 );
+   PaintObjects( label, out, lutIm, DT_SFLOAT );
+}
+
+void ObjectToMeasurement(
+      Image const& label,
+      Image& out,
+      Measurement const& measurement,
+      StringArray const& features,
+      String const& scaling
+) {
+   DIP_THROW_IF( !label.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !label.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !label.DataType().IsUInt(), E::DATA_TYPE_NOT_SUPPORTED );
+   DIP_THROW_IF( !measurement.IsForged(), E::MEASUREMENT_NOT_FORGED );
+   bool normalize = BooleanFromString( scaling, S::NORMALIZE, S::DONT_NORMALIZE );
+   DataType outType = normalize ? DT_UINT16 : DT_SFLOAT;
+   if( out.IsProtected() ) {
+      outType = out.DataType();
+      DIP_THROW_IF( normalize && ( !outType.IsUnsigned() || ( outType.SizeOf() > 4 )), E::DATA_TYPE_NOT_SUPPORTED );
+   }
+
+   // Collect the requested features
+   std::vector< Measurement::IteratorFeature > columns;
+   dip::uint nValues = 0;
+   if( features.empty() ) {
+      for( auto const& feature : measurement.Features() ) {
+         columns.push_back( measurement[ feature.name ] );
+         nValues += feature.numberValues;
+      }
+   } else {
+      for( auto const& name : features ) {
+         columns.push_back( measurement[ name ] );
+         nValues += columns.back().NumberOfValues();
+      }
+   }
+   DIP_THROW_IF( nValues == 0, "No feature values to paint" );
+
+   // Fill in the table, one row per object ID, with all selected feature values
+   Image lutIm = CreateObjectTable( measurement.Objects(), nValues );
+   dip::uint element = 0;
+   for( auto const& column : columns ) {
+      FillObjectTable( lutIm, column, element );
+      element += column.NumberOfValues();
+   }
+
+   if( normalize ) {
+      // Each value is linearly mapped to the range [1, max], where max is the largest value representable in the
+      // output data type, such that the background (0) is distinct from all objects. Non-finite values don't take
+      // part in the range, and are mapped to 0.
+      dfloat maxValue = std::pow( 2.0, static_cast< dfloat >( 8 * outType.SizeOf() )) - 1.0;
+      UnsignedArray const& objects = measurement.Objects();
+      dfloat* data = static_cast< dfloat* >( lutIm.Origin() );
+      dip::sint stride = lutIm.Stride( 0 );
+      for( dip::uint ii = 0; ii < nValues; ++ii ) {
+         dfloat minVal = std::numeric_limits< dfloat >::max();
+         dfloat maxVal = std::numeric_limits< dfloat >::lowest();
+         for( auto id : objects ) {
+            dfloat v = data[ static_cast< dip::sint >( id ) * stride + static_cast< dip::sint >( ii ) ];
+            if( std::isfinite( v )) {
+               minVal = std::min( minVal, v );
+               maxVal = std::max( maxVal, v );
+            }
+         }
+         // `maxVal - minVal` can overflow for extreme values, in which case all objects map to 1
+         dfloat range = maxVal - minVal;
+         dfloat scale = ( maxVal > minVal ) && std::isfinite( range ) ? ( maxValue - 1.0 ) / range : 0.0;
+         for( auto id : objects ) {
+            dfloat& v = data[ static_cast< dip::sint >( id ) * stride + static_cast< dip::sint >( ii ) ];
+            v = std::isfinite( v ) ? 1.0 + std::round(( v - minVal ) * scale ) : 0.0;
+         }
+      }
+      lutIm.Convert( outType );
+   }
+
+   PaintObjects( label, out, lutIm, outType );
 }
 
 } // namespace dip
+
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+
+DOCTEST_TEST_CASE( "[DIPlib] testing dip::ObjectToMeasurement" ) {
+   dip::Image label( { 10, 8 }, 1, dip::DT_UINT8 );
+   label.Fill( 0 );
+   label.At( dip::Range{ 1, 3 }, dip::Range{ 1, 3 } ) = 1;
+   label.At( dip::Range{ 5, 8 }, dip::Range{ 2, 6 } ) = 3;
+   label.At( 9, 7 ) = 4; // not measured
+   dip::MeasurementTool tool;
+   dip::Measurement msr = tool.Measure( label, {}, { "Size", "Center" }, { 1, 3 } );
+
+   dip::Image single = dip::ObjectToMeasurement( label, msr[ "Size" ] );
+   DOCTEST_CHECK( single.At( 2, 2 ) == 9 );
+   DOCTEST_CHECK( single.At( 6, 4 ) == 20 );
+   DOCTEST_CHECK( single.At( 0, 0 ) == 0 );
+   DOCTEST_CHECK( single.At( 9, 7 ) == 0 );
+
+   dip::Image multi = dip::ObjectToMeasurement( label, msr );
+   DOCTEST_REQUIRE( multi.TensorElements() == 3 );
+   DOCTEST_CHECK( multi.DataType() == dip::DT_SFLOAT );
+   DOCTEST_CHECK( multi.At( 2, 2 )[ 0 ] == 9 );
+   DOCTEST_CHECK( multi.At( 2, 2 )[ 1 ] == 2 );
+   DOCTEST_CHECK( multi.At( 2, 2 )[ 2 ] == 2 );
+   DOCTEST_CHECK( multi.At( 6, 4 )[ 0 ] == 20 );
+   DOCTEST_CHECK( multi.At( 6, 4 )[ 1 ] == 6.5 );
+   DOCTEST_CHECK( multi.At( 6, 4 )[ 2 ] == 4 );
+   DOCTEST_CHECK( multi.At( 9, 7 )[ 0 ] == 0 );
+   DOCTEST_CHECK( multi.At( 9, 7 )[ 1 ] == 0 );
+   DOCTEST_CHECK( multi.At( 9, 7 )[ 2 ] == 0 );
+
+   dip::Image quantized = dip::ObjectToMeasurement( label, msr, { "Center" }, dip::S::NORMALIZE );
+   DOCTEST_REQUIRE( quantized.TensorElements() == 2 );
+   DOCTEST_CHECK( quantized.DataType() == dip::DT_UINT16 );
+   DOCTEST_CHECK( quantized.At( 2, 2 )[ 0 ] == 1 );
+   DOCTEST_CHECK( quantized.At( 2, 2 )[ 1 ] == 1 );
+   DOCTEST_CHECK( quantized.At( 6, 4 )[ 0 ] == 65535 );
+   DOCTEST_CHECK( quantized.At( 6, 4 )[ 1 ] == 65535 );
+   DOCTEST_CHECK( quantized.At( 0, 0 )[ 0 ] == 0 );
+   DOCTEST_CHECK( quantized.At( 0, 0 )[ 1 ] == 0 );
+
+   // Non-finite values don't affect the range of the others, and are painted as 0
+   label.At( dip::Range{ 5, 8 }, dip::Range{ 0, 0 } ) = 2;
+   label.At( dip::Range{ 0, 3 }, dip::Range{ 6, 7 } ) = 5;
+   msr = tool.Measure( label, {}, { "Size" }, { 1, 2, 3, 5 } );
+   msr[ "Size" ][ 2 ][ 0 ] = std::numeric_limits< dip::dfloat >::quiet_NaN();
+   msr[ "Size" ][ 5 ][ 0 ] = std::numeric_limits< dip::dfloat >::infinity();
+   quantized = dip::ObjectToMeasurement( label, msr, {}, dip::S::NORMALIZE );
+   DOCTEST_CHECK( quantized.At( 2, 2 ) == 1 );
+   DOCTEST_CHECK( quantized.At( 6, 4 ) == 65535 );
+   DOCTEST_CHECK( quantized.At( 6, 0 ) == 0 );
+   DOCTEST_CHECK( quantized.At( 1, 7 ) == 0 );
+   msr[ "Size" ][ 1 ][ 0 ] = -std::numeric_limits< dip::dfloat >::infinity();
+   msr[ "Size" ][ 3 ][ 0 ] = std::numeric_limits< dip::dfloat >::quiet_NaN();
+   quantized = dip::ObjectToMeasurement( label, msr, {}, dip::S::NORMALIZE );
+   DOCTEST_CHECK( quantized.At( 2, 2 ) == 0 );
+   DOCTEST_CHECK( quantized.At( 6, 4 ) == 0 );
+}
+
+#endif // DIP__ENABLE_DOCTEST
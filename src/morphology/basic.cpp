@@ -877,6 +877,8 @@ void BasicMorphology(
 #include "doctest.h"
 #include "diplib/statistics.h"
 #include "diplib/iterators.h"
+#include "diplib/generation.h"
+#include "diplib/testing.h"
 
 DOCTEST_TEST_CASE("[DIPlib] testing the basic morphological filters") {
    dip::Image in( { 64, 41 }, 1, dip::DT_UINT8 );
@@ -976,6 +978,47 @@ DOCTEST_TEST_CASE("[DIPlib] testing the basic morphological filters") {
    DOCTEST_CHECK( dip::Count( out ) == 1 );
    DOCTEST_CHECK( out.At( 32, 20 ) == pval );
 
+   // Grey-value SE morphology -- asymmetric weights along a run of the pixel table
+   seImg = dip::Image( { 5, 1 }, 1, dip::DT_SFLOAT );
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      seImg.At( ii, 0 ) = -static_cast< dip::sint >( ii );
+   }
+   se = seImg;
+   dip::detail::BasicMorphology( in, out, se, {}, dip::detail::BasicMorphologyOperation::DILATION );
+   DOCTEST_CHECK( dip::Count( out ) == 5 );
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      DOCTEST_CHECK( out.At( 34 - ii, 20 ) == pval - ii ); // the SE is mirrored for the dilation
+   }
+   se.Mirror();
+   dip::detail::BasicMorphology( in, out, se, {}, dip::detail::BasicMorphologyOperation::DILATION );
+   for( dip::uint ii = 0; ii < 5; ++ii ) {
+      DOCTEST_CHECK( out.At( 30 + ii, 20 ) == pval - ii );
+   }
+   {
+      // A closing is extensive and idempotent, an opening anti-extensive and idempotent; neither holds if the
+      // second step of these operations does not use exactly the mirrored SE
+      dip::Image noise( { 64, 41 }, 1, dip::DT_SFLOAT );
+      noise.Fill( 0 );
+      dip::Random random( 0 );
+      dip::UniformNoise( noise, noise, random, -100, 100 );
+      noise.Convert( dip::DT_SINT16 ); // integer values, so that the comparisons below are exact
+      se = seImg;
+      dip::Image closed;
+      dip::detail::BasicMorphology( noise, closed, se, {}, dip::detail::BasicMorphologyOperation::CLOSING );
+      DOCTEST_CHECK( dip::Count( closed < noise ) == 0 );
+      DOCTEST_CHECK( dip::Count( closed > noise ) > 0 );
+      dip::Image closed2;
+      dip::detail::BasicMorphology( closed, closed2, se, {}, dip::detail::BasicMorphologyOperation::CLOSING );
+      DOCTEST_CHECK( dip::testing::CompareImages( closed, closed2 ));
+      dip::Image opened;
+      dip::detail::BasicMorphology( noise, opened, se, {}, dip::detail::BasicMorphologyOperation::OPENING );
+      DOCTEST_CHECK( dip::Count( opened > noise ) == 0 );
+      DOCTEST_CHECK( dip::Count( opened < noise ) > 0 );
+      dip::Image opened2;
+      dip::detail::BasicMorphology( opened, opened2, se, {}, dip::detail::BasicMorphologyOperation::OPENING );
+      DOCTEST_CHECK( dip::testing::CompareImages( opened, opened2 ));
+   }
+
    // Line morphology
    se = {{ 10, 4 }, "discrete line" };
    dip::detail::BasicMorphology( in, out, se, {}, dip::detail::BasicMorphologyOperation::DILATION );
@@ -23,7 +23,9 @@
 #include "diplib/framework.h"
 #include "diplib/pixel_table.h"
 #include "diplib/overload.h"
-#include "diplib/accumulators.h"
+#include "diplib/boundary.h"
+#include "diplib/statistics.h"
+#include "../linear/sliding_sums.h"
 
 namespace dip {
 
@@ -32,9 +34,12 @@ namespace {
 template< typename TPI >
 class VarianceLineFilter : public Framework::FullLineFilter {
    public:
+      virtual void SetNumberOfThreads( dip::uint, PixelTableOffsets const& pixelTable ) override {
+         sums_.Prepare( pixelTable, pixelTable.Stride() );
+      }
       virtual dip::uint GetNumberOfOperations( dip::uint lineLength, dip::uint, dip::uint nKernelPixels, dip::uint nRuns ) override {
          return 5 * nKernelPixels + lineLength * (
-               nRuns * 2      // number of multiply-adds
+               nRuns * 4      // number of multiply-adds
                + nRuns );     // iterating over pixel table runs
       }
       virtual void Filter( Framework::FullLineFilterParameters const& params ) override {
@@ -44,25 +49,67 @@ class VarianceLineFilter : public Framework::FullLineFilter {
          dip::sint outStride = params.outBuffer.stride;
          dip::uint length = params.bufferLength;
          PixelTableOffsets const& pixelTable = params.pixelTable;
-         FastVarianceAccumulator acc;
+         DIP_ASSERT( inStride == pixelTable.Stride() );
+         // Sum and sum of squares of values within the filter, as in `dip::FastVarianceAccumulator`
+         dfloat sum = 0;
+         dfloat squareSum = 0;
          for( auto offset : pixelTable ) {
-            acc.Push( in[ offset ] );
+            dfloat x = static_cast< dfloat >( in[ offset ] );
+            sum += x;
+            squareSum += x * x;
          }
-         *out = static_cast< TPI >( acc.Variance() );
+         dfloat n = static_cast< dfloat >( pixelTable.NumberOfPixels() );
+         dfloat norm = n > 1 ? 1 / ( n - 1 ) : 0.0;
+         *out = static_cast< TPI >(( squareSum - ( sum * sum ) / n ) * norm );
          //in += inStride; // we don't increment `in` here, so that we don't have to subtract one index inside the loop
          //out += outStride; // we don't increment `out` here, we increment it in the loop before the assignment, it saves one addition! :)
-         for( dip::uint ii = 1; ii < length; ++ii ) {
-            for( auto run : pixelTable.Runs() ) {
-               acc.Pop( in[ run.offset ] );
-               acc.Push( in[ run.offset + static_cast< dip::sint >( run.length ) * inStride ] );
+         std::array< dfloat, SlidingRunSums::blockSize > delta;
+         std::array< dfloat, SlidingRunSums::blockSize > squareDelta;
+         for( dip::uint ii = 1; ii < length; ii += SlidingRunSums::blockSize ) {
+            dip::uint nBlock = std::min( SlidingRunSums::blockSize, length - ii );
+            sums_.SumAndSquareSumDeltas( in, inStride, nBlock, delta.data(), squareDelta.data() );
+            for( dip::uint kk = 0; kk < nBlock; ++kk ) {
+               sum += delta[ kk ];
+               squareSum += squareDelta[ kk ];
+               out += outStride;
+               *out = static_cast< TPI >(( squareSum - ( sum * sum ) / n ) * norm );
             }
-            in += inStride;
-            out += outStride;
-            *out = static_cast< TPI >( acc.Variance() );
+            in += static_cast< dip::sint >( nBlock ) * inStride;
          }
       }
+   private:
+      SlidingRunSums sums_;
 };
 
+void RectangularVarianceFilter(
+      Image const& in,
+      Image& out,
+      UnsignedArray const& sizes,
+      BoundaryConditionArray const& bc,
+      DataType dtype
+) {
+   // The window around pixel `x` is [ x - sizes/2, x - sizes/2 + sizes ), see `dip::PixelTable`. In the image
+   // extended by `sizes/2`, the box that starts at `x` is thus the window for input pixel `x`.
+   dip::uint nDims = in.Dimensionality();
+   UnsignedArray border( nDims );
+   RangeArray crop( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      border[ ii ] = sizes[ ii ] / 2;
+      crop[ ii ] = Range{ 0, static_cast< dip::sint >( in.Size( ii )) - 1 };
+   }
+   Image extended;
+   ExtendImage( in, extended, border, bc );
+   SummedAreaTable table( extended );
+   extended.Strip();
+   Image variance;
+   table.BoxVariances( sizes, variance );
+   variance = variance.At( crop );
+   PixelSize pixelSize = in.PixelSize();
+   out.ReForge( in.Sizes(), 1, dtype, Option::AcceptDataTypeChange::DO_ALLOW );
+   out.Copy( variance );
+   out.SetPixelSize( pixelSize );
+}
+
 } // namespace
 
 void VarianceFilter(
@@ -76,6 +123,11 @@ void VarianceFilter(
    DIP_START_STACK_TRACE
       BoundaryConditionArray bc = StringArrayToBoundaryConditionArray( boundaryCondition );
       DataType dtype = DataType::SuggestFlex( in.DataType() );
+      if( kernel.IsRectangular() && !kernel.Shift().any() && !kernel.IsMirrored() && in.IsScalar() && in.DataType().IsReal() ) {
+         // A summed-area table gives the variance in a rectangle at a cost independent of its size
+         RectangularVarianceFilter( in, out, kernel.Sizes( in.Dimensionality() ), bc, dtype );
+         return;
+      }
       std::unique_ptr< Framework::FullLineFilter > lineFilter;
       DIP_OVL_NEW_FLOAT( lineFilter, VarianceLineFilter, (), dtype );
       Framework::Full( in, out, dtype, dtype, dtype, 1, bc, kernel, *lineFilter, Framework::FullOption::AsScalarImage );
@@ -83,3 +135,45 @@ void VarianceFilter(
 }
 
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/linear.h"
+#include "diplib/statistics.h"
+#include "diplib/generation.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the variance filter") {
+   dip::Image img{ dip::UnsignedArray{ 64, 41 }, 1, dip::DT_DFLOAT };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 0.0, 100.0 );
+   dip::Kernel kernel( dip::Kernel::ShapeCode::ELLIPTIC, { 11, 7 } );
+   dip::Image weights = kernel.PixelTable( 2, 0 ).AsImage();
+   weights.Convert( dip::DT_DFLOAT );
+   dip::dfloat n = dip::Sum( weights ).As< dip::dfloat >();
+   weights /= n;
+   dip::Image result = dip::VarianceFilter( img, kernel, { "mirror" } );
+   dip::Image mean = dip::GeneralConvolution( img, weights, { "mirror" } );
+   dip::Image meanSquare = dip::GeneralConvolution( img * img, weights, { "mirror" } );
+   dip::Image expected = ( meanSquare - mean * mean ) * ( n / ( n - 1 ));
+   DOCTEST_CHECK( dip::MaximumAbsoluteError( result, expected ) < 1e-6 );
+}
+
+DOCTEST_TEST_CASE("[DIPlib] testing the variance filter with rectangular kernels") {
+   dip::Image img{ dip::UnsignedArray{ 64, 41 }, 1, dip::DT_UINT16 };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 1000.0, 1100.0 );
+   // The rectangular kernel uses a summed-area table, the same shape given as an image uses the pixel table
+   dip::Image shape{ dip::UnsignedArray{ 10, 7 }, 1, dip::DT_BIN };
+   shape.Fill( 1 );
+   for( auto const& bc : { "mirror", "add zeros" } ) {
+      dip::Image result = dip::VarianceFilter( img, dip::Kernel( dip::Kernel::ShapeCode::RECTANGULAR, { 10, 7 } ), { bc } );
+      dip::Image expected = dip::VarianceFilter( img, dip::Kernel( shape ), { bc } );
+      DOCTEST_CHECK( result.DataType() == dip::DT_SFLOAT );
+      DOCTEST_CHECK( result.Sizes() == img.Sizes() );
+      DOCTEST_CHECK( dip::MaximumAbsoluteError( result, expected ) < 1e-3 );
+   }
+}
+
+#endif // DIP__ENABLE_DOCTEST
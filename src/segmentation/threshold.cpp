@@ -28,6 +28,7 @@
 #include "diplib/framework.h"
 #include "diplib/overload.h"
 #include "diplib/lookup_table.h"
+#include "diplib/boundary.h"
 
 namespace dip {
 
@@ -250,4 +251,108 @@ void MultipleThresholds(
    DIP_STACK_TRACE_THIS( lut.Apply( in, out, LookupTable::InterpolationMode::ZERO_ORDER_HOLD ));
 }
 
+namespace {
+
+// Computes the mean and standard deviation in a window of size `sizes` around each pixel of `in`
+void LocalMeanAndStandardDeviation(
+      Image const& in,
+      UnsignedArray sizes,
+      StringArray const& boundaryCondition,
+      Image& mean,
+      Image& stdev
+) {
+   DIP_THROW_IF( !in.IsForged(), E::IMAGE_NOT_FORGED );
+   DIP_THROW_IF( !in.IsScalar(), E::IMAGE_NOT_SCALAR );
+   DIP_THROW_IF( !in.DataType().IsReal(), E::DATA_TYPE_NOT_SUPPORTED );
+   dip::uint nDims = in.Dimensionality();
+   DIP_THROW_IF( nDims < 1, E::DIMENSIONALITY_NOT_SUPPORTED );
+   DIP_STACK_TRACE_THIS( ArrayUseParameter( sizes, nDims, dip::uint( 15 )));
+   // The window around pixel `x` is [ x - sizes/2, x - sizes/2 + sizes ), as for rectangular kernels.
+   // In the extended image, the box at `x` is thus the box for input pixel `x`.
+   UnsignedArray border( nDims );
+   RangeArray crop( nDims );
+   for( dip::uint ii = 0; ii < nDims; ++ii ) {
+      DIP_THROW_IF( sizes[ ii ] == 0, E::INVALID_PARAMETER );
+      border[ ii ] = sizes[ ii ] / 2;
+      crop[ ii ] = Range{ 0, static_cast< dip::sint >( in.Size( ii )) - 1 };
+   }
+   Image extended;
+   DIP_STACK_TRACE_THIS( ExtendImage( in, extended, border, StringArrayToBoundaryConditionArray( boundaryCondition )));
+   SummedAreaTable table( extended );
+   extended.Strip();
+   table.BoxMeans( sizes, mean );
+   mean = mean.At( crop );
+   table.BoxVariances( sizes, stdev );
+   stdev = stdev.At( crop );
+   Sqrt( stdev, stdev );
+}
+
+} // namespace
+
+void NiblackThreshold(
+      Image const& in,
+      Image& out,
+      UnsignedArray const& sizes,
+      dfloat k,
+      StringArray const& boundaryCondition
+) {
+   DIP_START_STACK_TRACE
+      Image threshold;
+      Image stdev;
+      LocalMeanAndStandardDeviation( in, sizes, boundaryCondition, threshold, stdev );
+      // threshold = mean + k * stdev
+      stdev *= k;
+      threshold += stdev;
+      NotLesser( in, threshold, out );
+   DIP_END_STACK_TRACE
+}
+
+void SauvolaThreshold(
+      Image const& in,
+      Image& out,
+      UnsignedArray const& sizes,
+      dfloat k,
+      dfloat range,
+      StringArray const& boundaryCondition
+) {
+   DIP_THROW_IF( range <= 0, E::PARAMETER_OUT_OF_RANGE );
+   DIP_START_STACK_TRACE
+      Image threshold;
+      Image stdev;
+      LocalMeanAndStandardDeviation( in, sizes, boundaryCondition, threshold, stdev );
+      // threshold = mean * ( 1 + k * ( stdev / range - 1 ))
+      stdev *= k / range;
+      stdev += 1.0 - k;
+      threshold *= stdev;
+      NotLesser( in, threshold, out );
+   DIP_END_STACK_TRACE
+}
+
 } // namespace dip
+
+#ifdef DIP__ENABLE_DOCTEST
+#include "doctest.h"
+#include "diplib/linear.h"
+#include "diplib/nonlinear.h"
+
+DOCTEST_TEST_CASE("[DIPlib] testing the local thresholds") {
+   dip::Image img{ dip::UnsignedArray{ 50, 40 }, 1, dip::DT_UINT8 };
+   img.Fill( 0 );
+   dip::Random random( 0 );
+   dip::UniformNoise( img, img, random, 20.0, 230.0 );
+   dip::Kernel kernel( dip::Kernel::ShapeCode::RECTANGULAR, { 9, 7 } );
+   dip::Image mean = dip::Uniform( img, kernel, { "mirror" } );
+   dip::Image stdev = dip::Sqrt( dip::VarianceFilter( img, kernel, { "mirror" } ));
+   // Pixels very close to the threshold could go either way due to rounding errors, we skip those
+   dip::Image niblack = dip::NiblackThreshold( img, { 9, 7 }, -0.2, { "mirror" } );
+   dip::Image threshold = mean + stdev * -0.2;
+   dip::Image safe = dip::Abs( img - threshold ) > 1e-3;
+   DOCTEST_CHECK( niblack.DataType() == dip::DT_BIN );
+   DOCTEST_CHECK( dip::Count( ( niblack != ( img >= threshold )) & safe ) == 0 );
+   dip::Image sauvola = dip::SauvolaThreshold( img, { 9, 7 }, 0.5, 128, { "mirror" } );
+   threshold = mean * (( stdev / 128.0 - 1.0 ) * 0.5 + 1.0 );
+   safe = dip::Abs( img - threshold ) > 1e-3;
+   DOCTEST_CHECK( dip::Count( ( sauvola != ( img >= threshold )) & safe ) == 0 );
+}
+
+#endif // DIP__ENABLE_DOCTEST